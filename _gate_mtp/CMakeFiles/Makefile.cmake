@@ -0,0 +1,165 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "CMakeFiles/VerifyGlobs.cmake"
+  "CMakeFiles/cmake.verify_globs"
+  "/root/repo/build-support/3rd-party/FindEigen3.cmake"
+  "/root/repo/build-support/3rd-party/FindHarfBuzz.cmake"
+  "/root/repo/build-support/3rd-party/FindSphinx.cmake"
+  "/root/repo/build-support/3rd-party/colored-messages.cmake"
+  "/root/repo/build-support/3rd-party/find-program-hints.cmake"
+  "/root/repo/build-support/Config.cmake.in"
+  "/root/repo/build-support/config-store-config-template.h"
+  "/root/repo/build-support/core-config-template.h"
+  "/root/repo/build-support/custom-modules/ns3-cmake-package.cmake"
+  "/root/repo/build-support/custom-modules/ns3-compiler-workarounds.cmake"
+  "/root/repo/build-support/custom-modules/ns3-configtable.cmake"
+  "/root/repo/build-support/custom-modules/ns3-contributions.cmake"
+  "/root/repo/build-support/custom-modules/ns3-lock.cmake"
+  "/root/repo/build-support/custom-modules/ns3-module-macros.cmake"
+  "/root/repo/build-support/custom-modules/ns3-versioning.cmake"
+  "/root/repo/build-support/macros-and-definitions.cmake"
+  "/root/repo/build-support/pkgconfig-template.pc.in"
+  "/root/repo/examples/CMakeLists.txt"
+  "/root/repo/scratch/CMakeLists.txt"
+  "/root/repo/scratch/nested-subdir/CMakeLists.txt"
+  "/root/repo/src/CMakeLists.txt"
+  "/root/repo/src/core/CMakeLists.txt"
+  "/root/repo/src/mtp/CMakeLists.txt"
+  "/root/repo/src/network/CMakeLists.txt"
+  "/root/repo/src/stats/CMakeLists.txt"
+  "/root/repo/src/test/CMakeLists.txt"
+  "/root/repo/utils/CMakeLists.txt"
+  "/usr/lib/x86_64-linux-gnu/cmake/Boost-1.74.0/BoostConfig.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/Boost-1.74.0/BoostConfigVersion.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_headers-1.74.0/boost_headers-config-version.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_headers-1.74.0/boost_headers-config.cmake"
+  "/usr/share/cmake-3.25/Modules/BasicConfigVersion-ExactVersion.cmake.in"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakePackageConfigHelpers.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckFunctionExists.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindBoost.cmake"
+  "/usr/share/cmake-3.25/Modules/FindGSL.cmake"
+  "/usr/share/cmake-3.25/Modules/FindLibXml2.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPkgConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/FindZLIB.cmake"
+  "/usr/share/cmake-3.25/Modules/GNUInstallDirs.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/ProcessorCount.cmake"
+  "/usr/share/cmake-3.25/Modules/SelectLibraryConfigurations.cmake"
+  "/usr/share/cmake-3.25/Modules/WriteBasicConfigVersionFile.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "/root/repo/build/include/ns3/config-store-config.h"
+  "/root/repo/build/include/ns3/core-config.h"
+  "pkgconfig/ns3-stats.pc"
+  "pkgconfig/ns3-network.pc"
+  "pkgconfig/ns3-mtp.pc"
+  "pkgconfig/ns3-core.pc"
+  "ns3Config.cmake"
+  "ns3ConfigVersion.cmake"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/core/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/mtp/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/network/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/stats/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "scratch/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "scratch/nested-subdir/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "utils/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/uninstall.dir/DependInfo.cmake"
+  "CMakeFiles/copy_all_headers.dir/DependInfo.cmake"
+  "CMakeFiles/check-version.dir/DependInfo.cmake"
+  "CMakeFiles/test-runner-examples-as-tests.dir/DependInfo.cmake"
+  "CMakeFiles/all-test-targets.dir/DependInfo.cmake"
+  "CMakeFiles/run_test_py.dir/DependInfo.cmake"
+  "CMakeFiles/run-print-introspected-doxygen.dir/DependInfo.cmake"
+  "CMakeFiles/run-introspected-command-line.dir/DependInfo.cmake"
+  "CMakeFiles/assemble-introspected-command-line.dir/DependInfo.cmake"
+  "CMakeFiles/update_doxygen_version.dir/DependInfo.cmake"
+  "CMakeFiles/doxygen.dir/DependInfo.cmake"
+  "CMakeFiles/doxygen-no-build.dir/DependInfo.cmake"
+  "CMakeFiles/sphinx.dir/DependInfo.cmake"
+  "CMakeFiles/sphinx_manual.dir/DependInfo.cmake"
+  "CMakeFiles/sphinx_models.dir/DependInfo.cmake"
+  "CMakeFiles/sphinx_tutorial.dir/DependInfo.cmake"
+  "CMakeFiles/sphinx_contributing.dir/DependInfo.cmake"
+  "CMakeFiles/sphinx_installation.dir/DependInfo.cmake"
+  "CMakeFiles/stdlib_pch-debug.dir/DependInfo.cmake"
+  "CMakeFiles/stdlib_pch_exec.dir/DependInfo.cmake"
+  "CMakeFiles/uninstall_pkgconfig_stats.dir/DependInfo.cmake"
+  "CMakeFiles/uninstall_pkgconfig_network.dir/DependInfo.cmake"
+  "CMakeFiles/uninstall_pkgconfig_mtp.dir/DependInfo.cmake"
+  "CMakeFiles/uninstall_pkgconfig_core.dir/DependInfo.cmake"
+  "src/core/CMakeFiles/libcore-obj.dir/DependInfo.cmake"
+  "src/core/CMakeFiles/libcore.dir/DependInfo.cmake"
+  "src/core/CMakeFiles/libcore-test.dir/DependInfo.cmake"
+  "src/mtp/CMakeFiles/libmtp-obj.dir/DependInfo.cmake"
+  "src/mtp/CMakeFiles/libmtp.dir/DependInfo.cmake"
+  "src/mtp/CMakeFiles/libmtp-test.dir/DependInfo.cmake"
+  "src/network/CMakeFiles/libnetwork-obj.dir/DependInfo.cmake"
+  "src/network/CMakeFiles/libnetwork.dir/DependInfo.cmake"
+  "src/network/CMakeFiles/libnetwork-test.dir/DependInfo.cmake"
+  "src/test/CMakeFiles/libtest.dir/DependInfo.cmake"
+  "src/stats/CMakeFiles/libstats-obj.dir/DependInfo.cmake"
+  "src/stats/CMakeFiles/libstats.dir/DependInfo.cmake"
+  "src/stats/CMakeFiles/libstats-test.dir/DependInfo.cmake"
+  "scratch/CMakeFiles/scratch_scratch-simulator.dir/DependInfo.cmake"
+  "scratch/CMakeFiles/scratch_subdir_scratch-subdir.dir/DependInfo.cmake"
+  "scratch/nested-subdir/CMakeFiles/scratch-nested-subdir-lib.dir/DependInfo.cmake"
+  "scratch/nested-subdir/CMakeFiles/scratch_nested-subdir_scratch-nested-subdir-executable.dir/DependInfo.cmake"
+  "utils/CMakeFiles/test-runner.dir/DependInfo.cmake"
+  "utils/CMakeFiles/bench-scheduler.dir/DependInfo.cmake"
+  "utils/CMakeFiles/bench-packets.dir/DependInfo.cmake"
+  "utils/CMakeFiles/print-introspected-doxygen.dir/DependInfo.cmake"
+  "utils/CMakeFiles/perf-io.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/stdlib_pch-debug.dir/build-support/empty.cc.o"
+  "CMakeFiles/stdlib_pch-debug.dir/build-support/empty.cc.o.d"
+  "CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx.gch"
+  "CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx.gch.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/stdlib_pch-debug.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
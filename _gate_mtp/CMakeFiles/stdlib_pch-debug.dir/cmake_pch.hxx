@@ -0,0 +1,23 @@
+/* generated by CMake */
+
+#pragma GCC system_header
+#ifdef __cplusplus
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <math.h>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#endif // __cplusplus
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/scratch/nested-subdir
+# Build directory: /root/repo/_gate_mtp/scratch/nested-subdir
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(ctest-scratch_nested-subdir_scratch-nested-subdir-executable "ns3-dev-scratch-nested-subdir-executable-debug")
+set_tests_properties(ctest-scratch_nested-subdir_scratch-nested-subdir-executable PROPERTIES  WORKING_DIRECTORY "/root/repo/build/scratch/nested-subdir/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1600;add_test;/root/repo/build-support/macros-and-definitions.cmake;1675;set_runtime_outputdirectory;/root/repo/scratch/nested-subdir/CMakeLists.txt;8;build_exec;/root/repo/scratch/nested-subdir/CMakeLists.txt;0;")
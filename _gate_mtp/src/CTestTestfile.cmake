@@ -0,0 +1,11 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/src
+# Build directory: /root/repo/_gate_mtp/src
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("core")
+subdirs("mtp")
+subdirs("network")
+subdirs("test")
+subdirs("stats")
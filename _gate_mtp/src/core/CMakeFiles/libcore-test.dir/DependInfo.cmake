@@ -0,0 +1,83 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/test/attribute-container-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/attribute-container-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/attribute-container-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/attribute-container-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/attribute-container-test-suite.cc.o.d"
+  "/root/repo/src/core/test/attribute-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/attribute-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/attribute-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/attribute-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/attribute-test-suite.cc.o.d"
+  "/root/repo/src/core/test/build-profile-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/build-profile-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/build-profile-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/build-profile-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/build-profile-test-suite.cc.o.d"
+  "/root/repo/src/core/test/callback-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/callback-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/callback-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/callback-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/callback-test-suite.cc.o.d"
+  "/root/repo/src/core/test/command-line-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/command-line-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/command-line-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/command-line-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/command-line-test-suite.cc.o.d"
+  "/root/repo/src/core/test/config-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/config-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/config-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/config-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/config-test-suite.cc.o.d"
+  "/root/repo/src/core/test/environment-variable-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/environment-variable-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/environment-variable-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/environment-variable-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/environment-variable-test-suite.cc.o.d"
+  "/root/repo/src/core/test/event-garbage-collector-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/event-garbage-collector-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/event-garbage-collector-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/event-garbage-collector-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/event-garbage-collector-test-suite.cc.o.d"
+  "/root/repo/src/core/test/global-value-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/global-value-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/global-value-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/global-value-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/global-value-test-suite.cc.o.d"
+  "/root/repo/src/core/test/hash-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/hash-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/hash-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/hash-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/hash-test-suite.cc.o.d"
+  "/root/repo/src/core/test/int64x64-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/int64x64-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/int64x64-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/int64x64-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/int64x64-test-suite.cc.o.d"
+  "/root/repo/src/core/test/length-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/length-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/length-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/length-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/length-test-suite.cc.o.d"
+  "/root/repo/src/core/test/many-uniform-random-variables-one-get-value-call-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/many-uniform-random-variables-one-get-value-call-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/many-uniform-random-variables-one-get-value-call-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/many-uniform-random-variables-one-get-value-call-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/many-uniform-random-variables-one-get-value-call-test-suite.cc.o.d"
+  "/root/repo/src/core/test/matrix-array-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/matrix-array-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/matrix-array-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/matrix-array-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/matrix-array-test-suite.cc.o.d"
+  "/root/repo/src/core/test/names-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/names-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/names-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/names-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/names-test-suite.cc.o.d"
+  "/root/repo/src/core/test/object-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/object-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/object-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/object-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/object-test-suite.cc.o.d"
+  "/root/repo/src/core/test/one-uniform-random-variable-many-get-value-calls-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/one-uniform-random-variable-many-get-value-calls-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/one-uniform-random-variable-many-get-value-calls-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/one-uniform-random-variable-many-get-value-calls-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/one-uniform-random-variable-many-get-value-calls-test-suite.cc.o.d"
+  "/root/repo/src/core/test/pair-value-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/pair-value-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/pair-value-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/pair-value-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/pair-value-test-suite.cc.o.d"
+  "/root/repo/src/core/test/ptr-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/ptr-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/ptr-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/ptr-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/ptr-test-suite.cc.o.d"
+  "/root/repo/src/core/test/sample-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/sample-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/sample-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/sample-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/sample-test-suite.cc.o.d"
+  "/root/repo/src/core/test/simulator-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/simulator-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/simulator-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/simulator-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/simulator-test-suite.cc.o.d"
+  "/root/repo/src/core/test/splitstring-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/splitstring-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/splitstring-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/splitstring-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/splitstring-test-suite.cc.o.d"
+  "/root/repo/src/core/test/threaded-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/threaded-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/threaded-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/threaded-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/threaded-test-suite.cc.o.d"
+  "/root/repo/src/core/test/time-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/time-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/time-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/time-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/time-test-suite.cc.o.d"
+  "/root/repo/src/core/test/timer-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/timer-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/timer-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/timer-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/timer-test-suite.cc.o.d"
+  "/root/repo/src/core/test/traced-callback-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/traced-callback-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/traced-callback-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/traced-callback-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/traced-callback-test-suite.cc.o.d"
+  "/root/repo/src/core/test/trickle-timer-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/trickle-timer-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/trickle-timer-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/trickle-timer-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/trickle-timer-test-suite.cc.o.d"
+  "/root/repo/src/core/test/tuple-value-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/tuple-value-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/tuple-value-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/tuple-value-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/tuple-value-test-suite.cc.o.d"
+  "/root/repo/src/core/test/type-id-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/type-id-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/type-id-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/type-id-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/type-id-test-suite.cc.o.d"
+  "/root/repo/src/core/test/type-traits-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/type-traits-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/type-traits-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/type-traits-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/type-traits-test-suite.cc.o.d"
+  "/root/repo/src/core/test/val-array-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/val-array-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/val-array-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/val-array-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/val-array-test-suite.cc.o.d"
+  "/root/repo/src/core/test/watchdog-test-suite.cc" "src/core/CMakeFiles/libcore-test.dir/test/watchdog-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/watchdog-test-suite.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/core/CMakeFiles/libcore-test.dir/test/watchdog-test-suite.cc.o" "gcc" "src/core/CMakeFiles/libcore-test.dir/test/watchdog-test-suite.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_mtp/src/core/CMakeFiles/libcore.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
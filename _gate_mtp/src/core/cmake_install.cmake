@@ -0,0 +1,176 @@
+# Install script for directory: /root/repo/src/core
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/usr/local")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "debug")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  if(EXISTS "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so" AND
+     NOT IS_SYMLINK "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so")
+    file(RPATH_CHECK
+         FILE "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so"
+         RPATH "/usr/local/lib:$ORIGIN/:$ORIGIN/../lib")
+  endif()
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/lib" TYPE SHARED_LIBRARY FILES "/root/repo/build/lib/libns3-dev-core-debug.so")
+  if(EXISTS "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so" AND
+     NOT IS_SYMLINK "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so")
+    file(RPATH_CHANGE
+         FILE "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so"
+         OLD_RPATH "/root/repo/build/lib::::::::::::::::::"
+         NEW_RPATH "/usr/local/lib:$ORIGIN/:$ORIGIN/../lib")
+    if(CMAKE_INSTALL_DO_STRIP)
+      execute_process(COMMAND "/usr/bin/strip" "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-core-debug.so")
+    endif()
+  endif()
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include/ns3" TYPE FILE FILES
+    "/root/repo/src/core/model/int64x64-128.h"
+    "/root/repo/src/core/helper/csv-reader.h"
+    "/root/repo/src/core/helper/event-garbage-collector.h"
+    "/root/repo/src/core/helper/random-variable-stream-helper.h"
+    "/root/repo/src/core/model/abort.h"
+    "/root/repo/src/core/model/ascii-file.h"
+    "/root/repo/src/core/model/ascii-test.h"
+    "/root/repo/src/core/model/assert.h"
+    "/root/repo/src/core/model/attribute-accessor-helper.h"
+    "/root/repo/src/core/model/attribute-construction-list.h"
+    "/root/repo/src/core/model/attribute-container.h"
+    "/root/repo/src/core/model/attribute-helper.h"
+    "/root/repo/src/core/model/attribute.h"
+    "/root/repo/src/core/model/boolean.h"
+    "/root/repo/src/core/model/breakpoint.h"
+    "/root/repo/src/core/model/build-profile.h"
+    "/root/repo/src/core/model/calendar-scheduler.h"
+    "/root/repo/src/core/model/callback.h"
+    "/root/repo/src/core/model/command-line.h"
+    "/root/repo/src/core/model/config.h"
+    "/root/repo/src/core/model/default-deleter.h"
+    "/root/repo/src/core/model/default-simulator-impl.h"
+    "/root/repo/src/core/model/deprecated.h"
+    "/root/repo/src/core/model/des-metrics.h"
+    "/root/repo/src/core/model/double.h"
+    "/root/repo/src/core/model/enum.h"
+    "/root/repo/src/core/model/event-id.h"
+    "/root/repo/src/core/model/event-impl.h"
+    "/root/repo/src/core/model/fatal-error.h"
+    "/root/repo/src/core/model/fatal-impl.h"
+    "/root/repo/src/core/model/fd-reader.h"
+    "/root/repo/src/core/model/environment-variable.h"
+    "/root/repo/src/core/model/global-value.h"
+    "/root/repo/src/core/model/hash-fnv.h"
+    "/root/repo/src/core/model/hash-function.h"
+    "/root/repo/src/core/model/hash-murmur3.h"
+    "/root/repo/src/core/model/hash.h"
+    "/root/repo/src/core/model/heap-scheduler.h"
+    "/root/repo/src/core/model/int-to-type.h"
+    "/root/repo/src/core/model/int64x64-double.h"
+    "/root/repo/src/core/model/int64x64.h"
+    "/root/repo/src/core/model/integer.h"
+    "/root/repo/src/core/model/ladder-scheduler.h"
+    "/root/repo/src/core/model/length.h"
+    "/root/repo/src/core/model/list-scheduler.h"
+    "/root/repo/src/core/model/log-macros-disabled.h"
+    "/root/repo/src/core/model/log-macros-enabled.h"
+    "/root/repo/src/core/model/log.h"
+    "/root/repo/src/core/model/make-event.h"
+    "/root/repo/src/core/model/map-scheduler.h"
+    "/root/repo/src/core/model/math.h"
+    "/root/repo/src/core/model/names.h"
+    "/root/repo/src/core/model/node-printer.h"
+    "/root/repo/src/core/model/nstime.h"
+    "/root/repo/src/core/model/object-base.h"
+    "/root/repo/src/core/model/object-factory.h"
+    "/root/repo/src/core/model/object-map.h"
+    "/root/repo/src/core/model/object-ptr-container.h"
+    "/root/repo/src/core/model/object-vector.h"
+    "/root/repo/src/core/model/object.h"
+    "/root/repo/src/core/model/pair.h"
+    "/root/repo/src/core/model/pointer.h"
+    "/root/repo/src/core/model/priority-queue-scheduler.h"
+    "/root/repo/src/core/model/ptr.h"
+    "/root/repo/src/core/model/random-variable-stream.h"
+    "/root/repo/src/core/model/rng-seed-manager.h"
+    "/root/repo/src/core/model/rng-stream.h"
+    "/root/repo/src/core/model/scheduler.h"
+    "/root/repo/src/core/model/show-progress.h"
+    "/root/repo/src/core/model/simple-ref-count.h"
+    "/root/repo/src/core/model/simulation-singleton.h"
+    "/root/repo/src/core/model/simulator-impl.h"
+    "/root/repo/src/core/model/simulator.h"
+    "/root/repo/src/core/model/singleton.h"
+    "/root/repo/src/core/model/string.h"
+    "/root/repo/src/core/model/synchronizer.h"
+    "/root/repo/src/core/model/system-path.h"
+    "/root/repo/src/core/model/system-wall-clock-ms.h"
+    "/root/repo/src/core/model/system-wall-clock-timestamp.h"
+    "/root/repo/src/core/model/test.h"
+    "/root/repo/src/core/model/time-printer.h"
+    "/root/repo/src/core/model/timer-impl.h"
+    "/root/repo/src/core/model/timer.h"
+    "/root/repo/src/core/model/trace-source-accessor.h"
+    "/root/repo/src/core/model/traced-callback.h"
+    "/root/repo/src/core/model/traced-value.h"
+    "/root/repo/src/core/model/trickle-timer.h"
+    "/root/repo/src/core/model/tuple.h"
+    "/root/repo/src/core/model/type-id.h"
+    "/root/repo/src/core/model/type-name.h"
+    "/root/repo/src/core/model/type-traits.h"
+    "/root/repo/src/core/model/uinteger.h"
+    "/root/repo/src/core/model/unused.h"
+    "/root/repo/src/core/model/valgrind.h"
+    "/root/repo/src/core/model/vector.h"
+    "/root/repo/src/core/model/warnings.h"
+    "/root/repo/src/core/model/watchdog.h"
+    "/root/repo/src/core/model/realtime-simulator-impl.h"
+    "/root/repo/src/core/model/wall-clock-synchronizer.h"
+    "/root/repo/src/core/model/val-array.h"
+    "/root/repo/src/core/model/matrix-array.h"
+    "/root/repo/build/include/ns3/config-store-config.h"
+    "/root/repo/build/include/ns3/core-config.h"
+    "/root/repo/build/include/ns3/core-module.h"
+    )
+endif()
+
@@ -0,0 +1,20 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/mtp/model/multithreaded-simulator-impl.cc" "src/mtp/CMakeFiles/libmtp-obj.dir/model/multithreaded-simulator-impl.cc.o" "gcc" "src/mtp/CMakeFiles/libmtp-obj.dir/model/multithreaded-simulator-impl.cc.o.d"
+  "/root/repo/_gate_mtp/CMakeFiles/stdlib_pch-debug.dir/cmake_pch.hxx" "src/mtp/CMakeFiles/libmtp-obj.dir/model/multithreaded-simulator-impl.cc.o" "gcc" "src/mtp/CMakeFiles/libmtp-obj.dir/model/multithreaded-simulator-impl.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
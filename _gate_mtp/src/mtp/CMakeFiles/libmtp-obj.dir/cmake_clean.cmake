@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/libmtp-obj.dir/model/multithreaded-simulator-impl.cc.o"
+  "CMakeFiles/libmtp-obj.dir/model/multithreaded-simulator-impl.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/libmtp-obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
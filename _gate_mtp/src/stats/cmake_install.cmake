@@ -0,0 +1,104 @@
+# Install script for directory: /root/repo/src/stats
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/usr/local")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "debug")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  if(EXISTS "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so" AND
+     NOT IS_SYMLINK "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so")
+    file(RPATH_CHECK
+         FILE "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so"
+         RPATH "/usr/local/lib:$ORIGIN/:$ORIGIN/../lib")
+  endif()
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/lib" TYPE SHARED_LIBRARY FILES "/root/repo/build/lib/libns3-dev-stats-debug.so")
+  if(EXISTS "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so" AND
+     NOT IS_SYMLINK "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so")
+    file(RPATH_CHANGE
+         FILE "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so"
+         OLD_RPATH "/root/repo/build/lib::::::::::::::::::"
+         NEW_RPATH "/usr/local/lib:$ORIGIN/:$ORIGIN/../lib")
+    if(CMAKE_INSTALL_DO_STRIP)
+      execute_process(COMMAND "/usr/bin/strip" "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/lib/libns3-dev-stats-debug.so")
+    endif()
+  endif()
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include/ns3" TYPE FILE FILES "/root/repo/src/stats/model/sqlite-output.h")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include/ns3" TYPE FILE FILES
+    "/root/repo/src/stats/model/sqlite-data-output.h"
+    "/root/repo/src/stats/helper/file-helper.h"
+    "/root/repo/src/stats/helper/gnuplot-helper.h"
+    "/root/repo/src/stats/model/average.h"
+    "/root/repo/src/stats/model/basic-data-calculators.h"
+    "/root/repo/src/stats/model/boolean-probe.h"
+    "/root/repo/src/stats/model/columnar-file-writer.h"
+    "/root/repo/src/stats/model/data-calculator.h"
+    "/root/repo/src/stats/model/data-collection-object.h"
+    "/root/repo/src/stats/model/data-collector.h"
+    "/root/repo/src/stats/model/data-output-interface.h"
+    "/root/repo/src/stats/model/double-probe.h"
+    "/root/repo/src/stats/model/file-aggregator.h"
+    "/root/repo/src/stats/model/get-wildcard-matches.h"
+    "/root/repo/src/stats/model/gnuplot-aggregator.h"
+    "/root/repo/src/stats/model/gnuplot.h"
+    "/root/repo/src/stats/model/histogram.h"
+    "/root/repo/src/stats/model/log-histogram.h"
+    "/root/repo/src/stats/model/omnet-data-output.h"
+    "/root/repo/src/stats/model/probe.h"
+    "/root/repo/src/stats/model/stats.h"
+    "/root/repo/src/stats/model/time-data-calculators.h"
+    "/root/repo/src/stats/model/time-probe.h"
+    "/root/repo/src/stats/model/time-series-adaptor.h"
+    "/root/repo/src/stats/model/uinteger-16-probe.h"
+    "/root/repo/src/stats/model/uinteger-32-probe.h"
+    "/root/repo/src/stats/model/uinteger-8-probe.h"
+    "/root/repo/build/include/ns3/stats-module.h"
+    )
+endif()
+
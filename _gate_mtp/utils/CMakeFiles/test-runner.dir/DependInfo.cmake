@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/utils/test-runner.cc" "utils/CMakeFiles/test-runner.dir/test-runner.cc.o" "gcc" "utils/CMakeFiles/test-runner.dir/test-runner.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_mtp/src/stats/CMakeFiles/libstats-test.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/network/CMakeFiles/libnetwork-test.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/mtp/CMakeFiles/libmtp-test.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/core/CMakeFiles/libcore-test.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/mtp/CMakeFiles/libmtp.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/network/CMakeFiles/libnetwork.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/stats/CMakeFiles/libstats.dir/DependInfo.cmake"
+  "/root/repo/_gate_mtp/src/core/CMakeFiles/libcore.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,16 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/utils
+# Build directory: /root/repo/_gate_mtp/utils
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(ctest-test-runner "ns3-dev-test-runner-debug")
+set_tests_properties(ctest-test-runner PROPERTIES  WORKING_DIRECTORY "/root/repo/build/utils/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1600;add_test;/root/repo/utils/CMakeLists.txt;40;set_runtime_outputdirectory;/root/repo/utils/CMakeLists.txt;0;")
+add_test(ctest-bench-scheduler "ns3-dev-bench-scheduler-debug")
+set_tests_properties(ctest-bench-scheduler PROPERTIES  WORKING_DIRECTORY "/root/repo/build/utils/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1600;add_test;/root/repo/build-support/macros-and-definitions.cmake;1675;set_runtime_outputdirectory;/root/repo/utils/CMakeLists.txt;47;build_exec;/root/repo/utils/CMakeLists.txt;0;")
+add_test(ctest-bench-packets "ns3-dev-bench-packets-debug")
+set_tests_properties(ctest-bench-packets PROPERTIES  WORKING_DIRECTORY "/root/repo/build/utils/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1600;add_test;/root/repo/build-support/macros-and-definitions.cmake;1675;set_runtime_outputdirectory;/root/repo/utils/CMakeLists.txt;55;build_exec;/root/repo/utils/CMakeLists.txt;0;")
+add_test(ctest-print-introspected-doxygen "ns3-dev-print-introspected-doxygen-debug")
+set_tests_properties(ctest-print-introspected-doxygen PROPERTIES  WORKING_DIRECTORY "/root/repo/build/utils/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1600;add_test;/root/repo/build-support/macros-and-definitions.cmake;1675;set_runtime_outputdirectory;/root/repo/utils/CMakeLists.txt;62;build_exec;/root/repo/utils/CMakeLists.txt;0;")
+add_test(ctest-perf-io "ns3-dev-perf-io-debug")
+set_tests_properties(ctest-perf-io PROPERTIES  WORKING_DIRECTORY "/root/repo/build/utils/perf/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1600;add_test;/root/repo/build-support/macros-and-definitions.cmake;1675;set_runtime_outputdirectory;/root/repo/utils/CMakeLists.txt;80;build_exec;/root/repo/utils/CMakeLists.txt;0;")
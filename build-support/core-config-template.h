@@ -15,5 +15,6 @@
 #cmakedefine01 HAVE_STDLIB_H
 #cmakedefine01 HAVE_GETENV
 #cmakedefine01 HAVE_SIGNAL_H
+#cmakedefine NS3_MTP
 
 #endif // NS3_CORE_CONFIG_H
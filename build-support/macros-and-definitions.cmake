@@ -1050,6 +1050,15 @@ macro(process_options)
     endif()
   endif()
 
+  # NS3_MTP changes the layout of classes of the core and network modules,
+  # hence it is defined in core-config.h rather than on the command line, so
+  # that the users of the installed headers see the same layout as the
+  # libraries
+  set(ENABLE_MTP FALSE)
+  if(${NS3_MTP})
+    set(ENABLE_MTP TRUE)
+  endif()
+
   mark_as_advanced(Boost_INCLUDE_DIR)
   find_package(Boost)
   if(${Boost_FOUND})
@@ -1376,6 +1385,10 @@ macro(process_options)
     list(REMOVE_ITEM libs_to_build mpi)
   endif()
 
+  if(NOT ${ENABLE_MTP})
+    list(REMOVE_ITEM libs_to_build mtp)
+  endif()
+
   if(NOT ${ENABLE_VISUALIZER})
     list(REMOVE_ITEM libs_to_build visualizer)
   endif()
@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/a3-rsrp-handover-algorithm.h"
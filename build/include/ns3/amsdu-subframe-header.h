@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/amsdu-subframe-header.h"
@@ -0,0 +1 @@
+#include "../../../src/stats/model/columnar-file-writer.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/cqa-ff-mac-scheduler.h"
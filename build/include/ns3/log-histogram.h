@@ -0,0 +1 @@
+#include "../../../src/stats/model/log-histogram.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/lte-ue-power-control.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/originator-block-ack-agreement.h"
@@ -0,0 +1 @@
+#include "../../../src/network/model/packet-data-allocator.h"
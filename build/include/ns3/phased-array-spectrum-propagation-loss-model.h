@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/phased-array-spectrum-propagation-loss-model.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/network/utils/segmentation-offload-tag.h"
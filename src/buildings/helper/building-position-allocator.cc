@@ -188,19 +188,17 @@ OutdoorPositionAllocator::GetNext() const
         NS_LOG_INFO("Position " << position);
 
         bool inside = false;
-        for (BuildingList::Iterator bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+        std::vector<Ptr<Building>> buildings = BuildingList::GetBuildingsContaining(position);
+        if (!buildings.empty())
         {
-            if ((*bit)->IsInside(position))
-            {
-                NS_LOG_INFO("Position "
-                            << position << " is inside the building with boundaries "
-                            << (*bit)->GetBoundaries().xMin << " " << (*bit)->GetBoundaries().xMax
-                            << " " << (*bit)->GetBoundaries().yMin << " "
-                            << (*bit)->GetBoundaries().yMax << " " << (*bit)->GetBoundaries().zMin
-                            << " " << (*bit)->GetBoundaries().zMax);
-                inside = true;
-                break;
-            }
+            NS_LOG_INFO("Position " << position << " is inside the building with boundaries "
+                                    << buildings.front()->GetBoundaries().xMin << " "
+                                    << buildings.front()->GetBoundaries().xMax << " "
+                                    << buildings.front()->GetBoundaries().yMin << " "
+                                    << buildings.front()->GetBoundaries().yMax << " "
+                                    << buildings.front()->GetBoundaries().zMin << " "
+                                    << buildings.front()->GetBoundaries().zMax);
+            inside = true;
         }
 
         if (inside)
@@ -28,6 +28,11 @@
 #include "ns3/object-vector.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -77,6 +82,30 @@ class BuildingListPriv : public Object
      * \returns the container size
      */
     uint32_t GetNBuildings();
+    /**
+     * Gets the buildings containing a position
+     * \param position the position
+     * \returns the buildings, in the order of their index
+     */
+    std::vector<Ptr<Building>> GetBuildingsContaining(const Vector& position);
+    /**
+     * Gets the buildings intersecting a line segment
+     * \param l1 the first point of the line segment
+     * \param l2 the second point of the line segment
+     * \returns the buildings, in the order of their index
+     */
+    std::vector<Ptr<Building>> GetBuildingsIntersecting(const Vector& l1, const Vector& l2);
+    /**
+     * Checks if a building intersects a line segment
+     * \param l1 the first point of the line segment
+     * \param l2 the second point of the line segment
+     * \returns true if a building intersects the line segment
+     */
+    bool IsIntersectingAnyBuilding(const Vector& l1, const Vector& l2);
+    /**
+     * Invalidate the spatial index of the buildings
+     */
+    void NotifyBoundariesChanged();
 
     /**
      * Get the Singleton instance of BuildingListPriv (or create one)
@@ -98,7 +127,47 @@ class BuildingListPriv : public Object
      *
      */
     static void Delete();
+
+    /// Key identifying a cell of the grid
+    typedef uint64_t CellKey;
+
+    /**
+     * Build the spatial index of the buildings again, if a building was added
+     * or its boundaries changed since it was last built
+     */
+    void UpdateIndex();
+    /**
+     * \param value a coordinate (m)
+     * \returns the index of the cell containing the coordinate
+     */
+    int32_t GetCellCoordinate(double value) const;
+    /**
+     * \param x the index of the cell along the x axis
+     * \param y the index of the cell along the y axis
+     * \returns the key of the cell
+     */
+    static CellKey GetCellKey(int32_t x, int32_t y);
+    /**
+     * Visit, once each, the buildings which may intersect a line segment,
+     * i.e., the buildings of the cells which the projection of the segment on
+     * the x-y plane crosses, until the visitor returns true
+     * \tparam Visitor the type of the visitor, called with the index of a building
+     * \param l1 the first point of the line segment
+     * \param l2 the second point of the line segment
+     * \param visit the visitor
+     * \returns true if the visitor returned true
+     */
+    template <class Visitor>
+    bool VisitBuildings(const Vector& l1, const Vector& l2, Visitor visit);
+
     std::vector<Ptr<Building>> m_buildings; //!< Container of Building
+    bool m_indexValid;                      //!< Whether the spatial index is up to date
+    double m_cellSize;                      //!< Size of the cells of the spatial index (m)
+    /// Indexes of the buildings overlapping each non-empty cell
+    std::unordered_map<CellKey, std::vector<uint32_t>> m_cells;
+    std::vector<uint32_t> m_largeBuildings; //!< Indexes of the buildings spanning too many cells
+    std::vector<uint64_t> m_lastVisit;      //!< Last visit of each building
+    uint64_t m_visit;                       //!< Number of visits of the buildings
 };
 
 NS_OBJECT_ENSURE_REGISTERED(BuildingListPriv);
@@ -146,6 +215,9 @@ BuildingListPriv::Delete()
 }
 
 BuildingListPriv::BuildingListPriv()
+    : m_indexValid(false),
+      m_cellSize(1),
+      m_visit(0)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -165,6 +237,10 @@ BuildingListPriv::DoDispose()
         *i = nullptr;
     }
     m_buildings.erase(m_buildings.begin(), m_buildings.end());
+    m_cells.clear();
+    m_largeBuildings.clear();
+    m_lastVisit.clear();
+    m_indexValid = false;
     Object::DoDispose();
 }
 
@@ -173,6 +249,7 @@ BuildingListPriv::Add(Ptr<Building> building)
 {
     uint32_t index = m_buildings.size();
     m_buildings.push_back(building);
+    m_indexValid = false;
     Simulator::ScheduleWithContext(index, TimeStep(0), &Building::Initialize, building);
     return index;
 }
@@ -204,6 +281,219 @@ BuildingListPriv::GetBuilding(uint32_t n)
     return m_buildings.at(n);
 }
 
+void
+BuildingListPriv::NotifyBoundariesChanged()
+{
+    m_indexValid = false;
+}
+
+int32_t
+BuildingListPriv::GetCellCoordinate(double value) const
+{
+    double cell = std::floor(value / m_cellSize);
+    cell = std::max<double>(cell, std::numeric_limits<int32_t>::min());
+    cell = std::min<double>(cell, std::numeric_limits<int32_t>::max());
+    return static_cast<int32_t>(cell);
+}
+
+BuildingListPriv::CellKey
+BuildingListPriv::GetCellKey(int32_t x, int32_t y)
+{
+    return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void
+BuildingListPriv::UpdateIndex()
+{
+    if (m_indexValid)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << m_buildings.size());
+
+    // the cells are as large as the buildings on average
+    double sumSize = 0;
+    uint32_t nSizes = 0;
+    for (const auto& building : m_buildings)
+    {
+        Box box = building->GetBoundaries();
+        double size = std::max(box.xMax - box.xMin, box.yMax - box.yMin);
+        if (std::isfinite(size))
+        {
+            sumSize += size;
+            nSizes++;
+        }
+    }
+    m_cellSize = nSizes > 0 ? std::max(sumSize / nSizes, 1.0) : 1.0;
+
+    // the buildings spanning many more cells than the average are always
+    // visited rather than stored in all their cells
+    const int64_t maxCells = 4096;
+    m_cells.clear();
+    m_largeBuildings.clear();
+    for (uint32_t i = 0; i < m_buildings.size(); i++)
+    {
+        Box box = m_buildings[i]->GetBoundaries();
+        int32_t xFirst = GetCellCoordinate(box.xMin);
+        int32_t xLast = GetCellCoordinate(box.xMax);
+        int32_t yFirst = GetCellCoordinate(box.yMin);
+        int32_t yLast = GetCellCoordinate(box.yMax);
+        int64_t nCells = (static_cast<int64_t>(xLast) - xFirst + 1) *
+                         (static_cast<int64_t>(yLast) - yFirst + 1);
+        if (nCells > maxCells)
+        {
+            m_largeBuildings.push_back(i);
+            continue;
+        }
+        for (int32_t x = xFirst; x <= xLast; x++)
+        {
+            for (int32_t y = yFirst; y <= yLast; y++)
+            {
+                m_cells[GetCellKey(x, y)].push_back(i);
+            }
+        }
+    }
+    m_lastVisit.assign(m_buildings.size(), 0);
+    m_visit = 0;
+    m_indexValid = true;
+    NS_LOG_LOGIC("indexed " << m_buildings.size() << " buildings in " << m_cells.size()
+                            << " cells of " << m_cellSize << " m, " << m_largeBuildings.size()
+                            << " large buildings");
+}
+
+std::vector<Ptr<Building>>
+BuildingListPriv::GetBuildingsContaining(const Vector& position)
+{
+    UpdateIndex();
+    std::vector<Ptr<Building>> buildings;
+    auto cell = m_cells.find(
+        GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.y)));
+    if (cell != m_cells.end())
+    {
+        for (uint32_t i : cell->second)
+        {
+            if (m_buildings[i]->IsInside(position))
+            {
+                buildings.push_back(m_buildings[i]);
+            }
+        }
+    }
+    for (uint32_t i : m_largeBuildings)
+    {
+        if (m_buildings[i]->IsInside(position))
+        {
+            buildings.push_back(m_buildings[i]);
+        }
+    }
+    std::sort(buildings.begin(), buildings.end(), [](Ptr<Building> a, Ptr<Building> b) {
+        return a->GetId() < b->GetId();
+    });
+    return buildings;
+}
+
+template <class Visitor>
+bool
+BuildingListPriv::VisitBuildings(const Vector& l1, const Vector& l2, Visitor visit)
+{
+    UpdateIndex();
+    double xMin = std::min(l1.x, l2.x);
+    double xMax = std::max(l1.x, l2.x);
+    double yMin = std::min(l1.y, l2.y);
+    double yMax = std::max(l1.y, l2.y);
+    // the cells are extended by a margin, so that the rounding errors do not
+    // miss the cells which the segment only touches
+    double margin = 1e-9 * m_cellSize;
+    int32_t xFirst = GetCellCoordinate(xMin - margin);
+    int32_t xLast = GetCellCoordinate(xMax + margin);
+    int64_t nCells = (static_cast<int64_t>(xLast) - xFirst + 1) +
+                     (static_cast<int64_t>(GetCellCoordinate(yMax + margin)) -
+                      GetCellCoordinate(yMin - margin) + 1);
+    if (nCells > static_cast<int64_t>(m_buildings.size()))
+    {
+        // the segment crosses more cells than there are buildings
+        for (uint32_t i = 0; i < m_buildings.size(); i++)
+        {
+            if (visit(i))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (uint32_t i : m_largeBuildings)
+    {
+        if (visit(i))
+        {
+            return true;
+        }
+    }
+    m_visit++;
+    for (int32_t x = xFirst; x <= xLast; x++)
+    {
+        // the range of y of the segment within the column of cells
+        double yLow = yMin;
+        double yHigh = yMax;
+        if (l1.x != l2.x)
+        {
+            double slope = (l2.y - l1.y) / (l2.x - l1.x);
+            double x1 = std::max(xMin, x * m_cellSize - margin);
+            double x2 = std::min(xMax, (x + 1.0) * m_cellSize + margin);
+            double y1 = l1.y + (x1 - l1.x) * slope;
+            double y2 = l1.y + (x2 - l1.x) * slope;
+            yLow = std::max(yMin, std::min(y1, y2));
+            yHigh = std::min(yMax, std::max(y1, y2));
+        }
+        int32_t yLast = GetCellCoordinate(yHigh + margin);
+        for (int32_t y = GetCellCoordinate(yLow - margin); y <= yLast; y++)
+        {
+            auto cell = m_cells.find(GetCellKey(x, y));
+            if (cell == m_cells.end())
+            {
+                continue;
+            }
+            for (uint32_t i : cell->second)
+            {
+                if (m_lastVisit[i] != m_visit)
+                {
+                    m_lastVisit[i] = m_visit;
+                    if (visit(i))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<Ptr<Building>>
+BuildingListPriv::GetBuildingsIntersecting(const Vector& l1, const Vector& l2)
+{
+    std::vector<uint32_t> indexes;
+    VisitBuildings(l1, l2, [&](uint32_t i) {
+        if (m_buildings[i]->IsIntersect(l1, l2))
+        {
+            indexes.push_back(i);
+        }
+        return false;
+    });
+    std::sort(indexes.begin(), indexes.end());
+    std::vector<Ptr<Building>> buildings;
+    for (uint32_t i : indexes)
+    {
+        buildings.push_back(m_buildings[i]);
+    }
+    return buildings;
+}
+
+bool
+BuildingListPriv::IsIntersectingAnyBuilding(const Vector& l1, const Vector& l2)
+{
+    return VisitBuildings(l1, l2, [&](uint32_t i) { return m_buildings[i]->IsIntersect(l1, l2); });
+}
+
 } // namespace ns3
 
 /**
@@ -244,4 +534,28 @@ BuildingList::GetNBuildings()
     return BuildingListPriv::Get()->GetNBuildings();
 }
 
+std::vector<Ptr<Building>>
+BuildingList::GetBuildingsContaining(const Vector& position)
+{
+    return BuildingListPriv::Get()->GetBuildingsContaining(position);
+}
+
+std::vector<Ptr<Building>>
+BuildingList::GetBuildingsIntersecting(const Vector& l1, const Vector& l2)
+{
+    return BuildingListPriv::Get()->GetBuildingsIntersecting(l1, l2);
+}
+
+bool
+BuildingList::IsIntersectingAnyBuilding(const Vector& l1, const Vector& l2)
+{
+    return BuildingListPriv::Get()->IsIntersectingAnyBuilding(l1, l2);
+}
+
+void
+BuildingList::NotifyBoundariesChanged()
+{
+    BuildingListPriv::Get()->NotifyBoundariesChanged();
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #define BUILDING_LIST_H_
 
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 #include <vector>
 
@@ -33,6 +34,13 @@ class Building;
 
 /**
  * Container for Building class
+ *
+ * The list indexes the footprints of the buildings with a uniform grid over
+ * the x-y plane, whose cells are about as large as the buildings, so that
+ * the buildings containing a position, or intersecting a line segment, are
+ * found by checking the buildings of the cells around the position, or along
+ * the segment, only. The index is built again on the first query after a
+ * building was added or its boundaries changed.
  */
 class BuildingList
 {
@@ -67,6 +75,34 @@ class BuildingList
      * \returns the number of buildings currently in the list.
      */
     static uint32_t GetNBuildings();
+    /**
+     * \param position a position
+     * \returns the buildings whose boundaries contain the position, in the
+     *          order of their index
+     */
+    static std::vector<Ptr<Building>> GetBuildingsContaining(const Vector& position);
+    /**
+     * \param l1 the first point of a line segment
+     * \param l2 the second point of a line segment
+     * \returns the buildings whose boundaries intersect the line segment, in
+     *          the order of their index
+     */
+    static std::vector<Ptr<Building>> GetBuildingsIntersecting(const Vector& l1,
+                                                               const Vector& l2);
+    /**
+     * \param l1 the first point of a line segment
+     * \param l2 the second point of a line segment
+     * \returns true if the boundaries of a building intersect the line segment
+     */
+    static bool IsIntersectingAnyBuilding(const Vector& l1, const Vector& l2);
+    /**
+     * Notify the list that the boundaries of a building changed, so that the
+     * spatial index of the buildings is built again.
+     *
+     * This method is called automatically from Building::SetBoundaries so
+     * the user has little reason to call it himself.
+     */
+    static void NotifyBoundariesChanged();
 };
 
 } // namespace ns3
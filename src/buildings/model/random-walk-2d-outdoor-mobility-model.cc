@@ -215,24 +215,23 @@ RandomWalk2dOutdoorMobilityModel::IsLineClearOfBuildings(Vector currentPosition,
     double minIntersectionDistance = std::numeric_limits<double>::max();
     Ptr<Building> minIntersectionDistanceBuilding;
 
-    for (BuildingList::Iterator bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+    // the buildings which intersect the line between the current and next positions,
+    // including the building the next position may be inside
+    std::vector<Ptr<Building>> buildings =
+        BuildingList::GetBuildingsIntersecting(currentPosition, nextPosition);
+    for (const auto& building : buildings)
     {
-        // check if this building intersects the line between the current and next positions
-        // this checks also if the next position is inside the building
-        if ((*bit)->IsIntersect(currentPosition, nextPosition))
+        NS_LOG_LOGIC("Building " << building->GetBoundaries() << " intersects the line between "
+                                 << currentPosition << " and " << nextPosition);
+        auto intersection = CalculateIntersectionFromOutside(currentPosition,
+                                                             nextPosition,
+                                                             building->GetBoundaries());
+        double distance = CalculateDistance(intersection, currentPosition);
+        intersectBuilding = true;
+        if (distance < minIntersectionDistance)
         {
-            NS_LOG_LOGIC("Building " << (*bit)->GetBoundaries() << " intersects the line between "
-                                     << currentPosition << " and " << nextPosition);
-            auto intersection = CalculateIntersectionFromOutside(currentPosition,
-                                                                 nextPosition,
-                                                                 (*bit)->GetBoundaries());
-            double distance = CalculateDistance(intersection, currentPosition);
-            intersectBuilding = true;
-            if (distance < minIntersectionDistance)
-            {
-                minIntersectionDistance = distance;
-                minIntersectionDistanceBuilding = (*bit);
-            }
+            minIntersectionDistance = distance;
+            minIntersectionDistanceBuilding = building;
         }
     }
 
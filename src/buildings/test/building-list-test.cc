@@ -0,0 +1,179 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/building-list.h"
+#include "ns3/building.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BuildingListTest");
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * Test case for the spatial index of the BuildingList. It deploys random
+ * buildings, and checks that the buildings containing random positions, and
+ * intersecting random line segments, are the ones found by checking all the
+ * buildings, also after the boundaries of a building changed.
+ */
+class BuildingListTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    BuildingListTestCase();
+
+    /**
+     * Destructor
+     */
+    ~BuildingListTestCase() override;
+
+  private:
+    /**
+     * Builds the simulation scenario and perform the tests
+     */
+    void DoRun() override;
+
+    /**
+     * Check the buildings containing a position, and intersecting a line
+     * segment, against the ones found by checking all the buildings
+     * \param l1 the position, and the first point of the line segment
+     * \param l2 the second point of the line segment
+     */
+    void CheckQueries(const Vector& l1, const Vector& l2);
+};
+
+BuildingListTestCase::BuildingListTestCase()
+    : TestCase("Test case for the spatial index of the BuildingList")
+{
+}
+
+BuildingListTestCase::~BuildingListTestCase()
+{
+}
+
+void
+BuildingListTestCase::CheckQueries(const Vector& l1, const Vector& l2)
+{
+    std::vector<Ptr<Building>> containing;
+    std::vector<Ptr<Building>> intersecting;
+    for (BuildingList::Iterator bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+    {
+        if ((*bit)->IsInside(l1))
+        {
+            containing.push_back(*bit);
+        }
+        if ((*bit)->IsIntersect(l1, l2))
+        {
+            intersecting.push_back(*bit);
+        }
+    }
+
+    NS_TEST_EXPECT_MSG_EQ((BuildingList::GetBuildingsContaining(l1) == containing),
+                          true,
+                          "Unexpected buildings containing " << l1);
+    NS_TEST_EXPECT_MSG_EQ((BuildingList::GetBuildingsIntersecting(l1, l2) == intersecting),
+                          true,
+                          "Unexpected buildings intersecting " << l1 << " - " << l2);
+    NS_TEST_EXPECT_MSG_EQ(BuildingList::IsIntersectingAnyBuilding(l1, l2),
+                          !intersecting.empty(),
+                          "Unexpected intersection of " << l1 << " - " << l2);
+}
+
+void
+BuildingListTestCase::DoRun()
+{
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    random->SetStream(1);
+
+    // small buildings, which may overlap
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        double x = random->GetValue(0, 1000);
+        double y = random->GetValue(0, 1000);
+        Ptr<Building> building = CreateObject<Building>();
+        building->SetBoundaries(Box(x,
+                                    x + random->GetValue(5, 40),
+                                    y,
+                                    y + random->GetValue(5, 40),
+                                    0,
+                                    random->GetValue(10, 30)));
+    }
+    // a building spanning many cells
+    Ptr<Building> large = CreateObject<Building>();
+    large->SetBoundaries(Box(-5000, 5000, 1200, 2100, 0, 20));
+
+    auto randomPosition = [&random]() {
+        return Vector(random->GetValue(-100, 1500),
+                      random->GetValue(-100, 1500),
+                      random->GetValue(0, 40));
+    };
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        CheckQueries(randomPosition(), randomPosition());
+    }
+    // short, vertical and very long line segments, and segments along the cells
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        Vector l1 = randomPosition();
+        CheckQueries(l1, Vector(l1.x + random->GetValue(-1, 1), l1.y, l1.z));
+        CheckQueries(l1, Vector(l1.x, l1.y, random->GetValue(0, 40)));
+        CheckQueries(l1, Vector(-l1.x * 1e3, l1.y * 1e3, l1.z));
+        CheckQueries(Vector(0, l1.y, 5), Vector(1000, l1.y, 5));
+    }
+
+    // the index is built again after the boundaries of a building changed
+    Ptr<Building> moved = BuildingList::GetBuilding(0);
+    moved->SetBoundaries(Box(3000, 3010, 3000, 3010, 0, 10));
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::GetBuildingsContaining(Vector(3005, 3005, 5)).size(),
+                          1,
+                          "The moved building was not found");
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::IsIntersectingAnyBuilding(Vector(2900, 3005, 5),
+                                                                  Vector(3100, 3005, 5)),
+                          true,
+                          "The moved building was not intersected");
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        CheckQueries(randomPosition(), randomPosition());
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ * Test suite for the BuildingList
+ */
+class BuildingListTestSuite : public TestSuite
+{
+  public:
+    BuildingListTestSuite();
+};
+
+BuildingListTestSuite::BuildingListTestSuite()
+    : TestSuite("building-list", UNIT)
+{
+    AddTestCase(new BuildingListTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static BuildingListTestSuite g_buildingListTestSuite;
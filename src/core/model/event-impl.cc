@@ -21,6 +21,8 @@
 
 #include "log.h"
 
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +34,121 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Size granularity of the event free lists, in bytes. */
+constexpr std::size_t EVENT_FREE_LIST_GRANULARITY = 16;
+/** Number of event free lists: larger events use the system allocator. */
+constexpr std::size_t EVENT_FREE_LIST_COUNT = 16;
+/** Maximum number of blocks kept in a free list. */
+constexpr uint32_t EVENT_FREE_LIST_MAX_SIZE = 4096;
+
+/** A free block of an event free list. */
+struct EventFreeBlock
+{
+    EventFreeBlock* next; //!< Next free block of the list
+};
+
+/*
+ * The free lists are plain thread-local data, which remain usable after
+ * the thread-local destructors have run, e.g. when events are released by
+ * the destructors of static objects.
+ */
+/** The free lists of the calling thread, by size class. */
+thread_local EventFreeBlock* g_eventFreeLists[EVENT_FREE_LIST_COUNT];
+/** The number of blocks in the free lists of the calling thread. */
+thread_local uint32_t g_eventFreeListSizes[EVENT_FREE_LIST_COUNT];
+/** Whether the free lists of the calling thread are enabled. */
+thread_local bool g_eventFreeListsEnabled = true;
+
+/** Release the free lists of a thread when it exits. */
+struct EventFreeListsReleaser
+{
+    /** Destructor. */
+    ~EventFreeListsReleaser()
+    {
+        g_eventFreeListsEnabled = false;
+        EventImpl::ReleaseFreeBlocks();
+    }
+};
+
+/**
+ * \param [in] size The size of an event.
+ * \returns The index of the free list of the event.
+ */
+inline std::size_t
+GetEventSizeClass(std::size_t size)
+{
+    return (size - 1) / EVENT_FREE_LIST_GRANULARITY;
+}
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    std::size_t sizeClass = GetEventSizeClass(size);
+    if (sizeClass >= EVENT_FREE_LIST_COUNT)
+    {
+        return ::operator new(size);
+    }
+    EventFreeBlock* block = g_eventFreeLists[sizeClass];
+    if (block != nullptr)
+    {
+        g_eventFreeLists[sizeClass] = block->next;
+        g_eventFreeListSizes[sizeClass]--;
+        return block;
+    }
+    // allocate the full size class, so that the block can be reused by any event of the class
+    return ::operator new((sizeClass + 1) * EVENT_FREE_LIST_GRANULARITY);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    std::size_t sizeClass = GetEventSizeClass(size);
+    if (sizeClass >= EVENT_FREE_LIST_COUNT || !g_eventFreeListsEnabled ||
+        g_eventFreeListSizes[sizeClass] >= EVENT_FREE_LIST_MAX_SIZE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    // register the release of the free lists at the exit of the thread
+    static thread_local EventFreeListsReleaser releaser;
+    auto block = static_cast<EventFreeBlock*>(p);
+    block->next = g_eventFreeLists[sizeClass];
+    g_eventFreeLists[sizeClass] = block;
+    g_eventFreeListSizes[sizeClass]++;
+}
+
+uint32_t
+EventImpl::GetFreeBlockCount()
+{
+    uint32_t count = 0;
+    for (std::size_t i = 0; i < EVENT_FREE_LIST_COUNT; i++)
+    {
+        count += g_eventFreeListSizes[i];
+    }
+    return count;
+}
+
+void
+EventImpl::ReleaseFreeBlocks()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    for (std::size_t i = 0; i < EVENT_FREE_LIST_COUNT; i++)
+    {
+        while (g_eventFreeLists[i] != nullptr)
+        {
+            EventFreeBlock* block = g_eventFreeLists[i];
+            g_eventFreeLists[i] = block->next;
+            ::operator delete(block);
+        }
+        g_eventFreeListSizes[i] = 0;
+    }
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -41,10 +42,39 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Since events are created and destroyed at a high rate, the memory of
+ * the events is recycled through per-thread free lists, one per size
+ * class, rather than returned to the system allocator.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
   public:
+    /**
+     * Allocate the memory of an event, from the free list of its size
+     * class if possible.
+     *
+     * \param [in] size The size of the event.
+     * \returns The allocated memory.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the memory of an event to the free list of its size class.
+     *
+     * \param [in] p The memory of the event.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * \returns The number of blocks in the free lists of the calling thread.
+     */
+    static uint32_t GetFreeBlockCount();
+    /**
+     * Return the blocks of the free lists of the calling thread to the
+     * system allocator.
+     */
+    static void ReleaseFreeBlocks();
+
     /** Default constructor. */
     EventImpl();
     /** Destructor. */
@@ -0,0 +1,324 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "type-id.h"
+#include "uinteger.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("Threshold",
+                          "Largest number of events of a bucket which are sorted at once: "
+                          "larger buckets are spread over a new rung",
+                          TypeId::ATTR_CONSTRUCT,
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRungs",
+                          "Maximum number of rungs of the ladder",
+                          TypeId::ATTR_CONSTRUCT,
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxRungs),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(UINT64_MAX),
+      m_topMax(0),
+      m_topStart(0),
+      m_nRungs(0),
+      m_bottomHead(0),
+      m_qSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::GetCurrentStart(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+LadderScheduler::Rung&
+LadderScheduler::AddRung(uint64_t start, uint64_t end, uint32_t nEvents)
+{
+    NS_LOG_FUNCTION(this << start << end << nEvents);
+    NS_ASSERT(start < end && nEvents > 0);
+
+    uint64_t span = end - start;
+    uint64_t nBuckets = std::min<uint64_t>(nEvents, span);
+    uint64_t width = span / nBuckets + (span % nBuckets != 0 ? 1 : 0);
+
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+    rung.start = start;
+    rung.width = width;
+    rung.nBuckets = nBuckets;
+    rung.current = 0;
+    rung.count = 0;
+    // The buckets of the rungs no longer in use are empty, but keep their capacity.
+    if (rung.buckets.size() < nBuckets)
+    {
+        rung.buckets.resize(nBuckets);
+    }
+    NS_LOG_LOGIC("rung " << m_nRungs - 1 << ": start=" << start << ", width=" << width
+                         << ", buckets=" << nBuckets);
+    return rung;
+}
+
+uint32_t
+LadderScheduler::FindRung(uint64_t ts) const
+{
+    // The rungs cover consecutive time intervals, from the last one (the
+    // earliest events) to the first one, up to m_topStart.
+    for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+        if (ts >= GetCurrentStart(m_rungs[i]))
+        {
+            return i;
+        }
+    }
+    return m_nRungs;
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.key.m_ts << ev.key.m_uid);
+    auto it = std::lower_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+    m_bottom.insert(it, ev);
+}
+
+void
+LadderScheduler::TransferTop()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_nRungs == 0 && !m_top.empty());
+
+    Rung& rung = AddRung(m_topMin, m_topMax + 1, m_top.size());
+    for (const auto& ev : m_top)
+    {
+        rung.buckets[(ev.key.m_ts - rung.start) / rung.width].push_back(ev);
+    }
+    rung.count = m_top.size();
+    m_topStart = rung.start + rung.nBuckets * rung.width;
+    m_top.clear();
+    m_topMin = UINT64_MAX;
+    m_topMax = 0;
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_qSize > 0);
+
+    m_bottom.clear();
+    m_bottomHead = 0;
+    while (m_bottom.empty())
+    {
+        if (m_nRungs == 0)
+        {
+            TransferTop();
+        }
+        uint32_t index = m_nRungs - 1;
+        Rung& rung = m_rungs[index];
+        if (rung.count == 0)
+        {
+            m_nRungs--;
+            continue;
+        }
+        while (rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        uint32_t current = rung.current++;
+        uint64_t end = GetCurrentStart(rung);
+        uint32_t size = rung.buckets[current].size();
+        rung.count -= size;
+
+        if (size > m_threshold && rung.width > 1 && m_nRungs < m_maxRungs)
+        {
+            uint64_t start = end;
+            for (const auto& ev : rung.buckets[current])
+            {
+                start = std::min(start, ev.key.m_ts);
+            }
+            // AddRung may reallocate the rungs: do not use 'rung' past this point.
+            Rung& child = AddRung(start, end, size);
+            Bucket& bucket = m_rungs[index].buckets[current];
+            for (const auto& ev : bucket)
+            {
+                child.buckets[(ev.key.m_ts - child.start) / child.width].push_back(ev);
+            }
+            child.count = size;
+            bucket.clear();
+        }
+        else
+        {
+            Bucket& bucket = rung.buckets[current];
+            m_bottom.assign(bucket.begin(), bucket.end());
+            std::sort(m_bottom.begin(), m_bottom.end());
+            bucket.clear();
+        }
+    }
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+    }
+    else
+    {
+        uint32_t index = FindRung(ts);
+        if (index < m_nRungs)
+        {
+            Rung& rung = m_rungs[index];
+            rung.buckets[(ts - rung.start) / rung.width].push_back(ev);
+            rung.count++;
+        }
+        else
+        {
+            InsertBottom(ev);
+        }
+    }
+    m_qSize++;
+    if (m_bottomHead == m_bottom.size())
+    {
+        Refill();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Scheduler::Event ev = m_bottom[m_bottomHead++];
+    m_qSize--;
+    if (m_bottomHead == m_bottom.size())
+    {
+        if (m_qSize > 0)
+        {
+            Refill();
+        }
+    }
+    else if (m_bottomHead > m_threshold && m_bottomHead * 2 > m_bottom.size())
+    {
+        // events keep being inserted in the bottom: drop the dequeued ones
+        m_bottom.erase(m_bottom.begin(), m_bottom.begin() + m_bottomHead);
+        m_bottomHead = 0;
+    }
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = ev.key.m_ts;
+    Bucket* bucket;
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else
+    {
+        uint32_t index = FindRung(ts);
+        if (index == m_nRungs)
+        {
+            auto it = std::lower_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+            NS_ASSERT(it != m_bottom.end() && it->key.m_uid == ev.key.m_uid);
+            NS_ASSERT(it->impl == ev.impl);
+            m_bottom.erase(it);
+            m_qSize--;
+            if (m_bottomHead == m_bottom.size() && m_qSize > 0)
+            {
+                Refill();
+            }
+            return;
+        }
+        Rung& rung = m_rungs[index];
+        bucket = &rung.buckets[(ts - rung.start) / rung.width];
+        rung.count--;
+    }
+
+    // buckets are not sorted: swap the event with the last one
+    auto it = std::find(bucket->begin(), bucket->end(), ev);
+    NS_ASSERT(it != bucket->end());
+    NS_ASSERT(it->impl == ev.impl);
+    *it = bucket->back();
+    bucket->pop_back();
+    m_qSize--;
+}
+
+} // namespace ns3
@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the Ladder Queue published in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The events are stored in three tiers:
+ *
+ * - the *top* is an unsorted vector of the events which are further in
+ *   the future than the end of the ladder;
+ * - the *ladder* is a set of rungs, each one made of buckets covering a
+ *   uniform time span. When the events of the top are needed, they are
+ *   moved to the first rung, which has one bucket per event. When a
+ *   bucket holding more than \c m_threshold events has to be sorted, its
+ *   events are spread over a new rung, with a finer bucket width;
+ * - the *bottom* is a sorted vector of the earliest events, filled from
+ *   a bucket of the ladder when it becomes empty.
+ *
+ * Contrary to the CalendarScheduler, the bucket width is adapted to the
+ * local density of the events, rather than to an estimate of the average
+ * separation of the first events. Hence, the ladder queue is well suited
+ * to skewed and bursty distributions, such as a large number of near-future
+ * timers with a long tail of far-future events.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to top or bucket; sorted insertion in bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | First entry of bottom
+ * Remove()     | Linear          | Linear search of the top or of a bucket, erase from bottom
+ * RemoveNext() | ~Constant       | Pop from bottom; amortized refill from ladder
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 2 x 24 bytes + rungs             | `std::vector` for top and bottom
+ * Per Event | ~24 bytes                        | One `std::vector` bucket per event in a rung
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Bucket type: an unsorted vector of Events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        uint64_t start;              //!< Timestamp at the start of the first bucket
+        uint64_t width;              //!< Duration of a bucket, in dimensionless time units
+        uint32_t nBuckets;           //!< Number of buckets in use
+        uint32_t current;            //!< Index of the first bucket not yet dequeued
+        uint32_t count;              //!< Number of events in the rung
+        std::vector<Bucket> buckets; //!< The buckets, at least \c nBuckets
+    };
+
+    /**
+     * Create a new rung at the bottom of the ladder.
+     *
+     * The rung covers the time interval <tt>[start, end)</tt> with at
+     * most \p nEvents buckets.
+     *
+     * \param [in] start The start of the time interval.
+     * \param [in] end The end of the time interval.
+     * \param [in] nEvents The number of events to be stored in the rung.
+     * \returns The new rung.
+     */
+    Rung& AddRung(uint64_t start, uint64_t end, uint32_t nEvents);
+    /**
+     * \param [in] rung A rung.
+     * \returns The timestamp at the start of the current bucket of the rung.
+     */
+    static uint64_t GetCurrentStart(const Rung& rung);
+    /**
+     * Find the rung an event belongs to.
+     *
+     * \param [in] ts The timestamp of the event.
+     * \returns The index of the rung, or the number of rungs if the event
+     * belongs to the bottom.
+     */
+    uint32_t FindRung(uint64_t ts) const;
+    /**
+     * Insert an event into the bottom, keeping it sorted.
+     *
+     * \param [in] ev The event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+    /** Move the events of the top to a new rung. */
+    void TransferTop();
+    /** Refill the bottom with the earliest events of the ladder, or of the top. */
+    void Refill();
+
+    /** Events further in the future than the end of the ladder. */
+    Bucket m_top;
+    /** Smallest timestamp of the events of the top. */
+    uint64_t m_topMin;
+    /** Largest timestamp of the events of the top. */
+    uint64_t m_topMax;
+    /** Smallest timestamp of the events which belong to the top. */
+    uint64_t m_topStart;
+    /** The rungs of the ladder, the first \c m_nRungs being in use. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** Earliest events, sorted in increasing order. */
+    Bucket m_bottom;
+    /** Index of the first event of the bottom not yet dequeued. */
+    uint32_t m_bottomHead;
+    /** Number of events in queue. */
+    uint32_t m_qSize;
+    /** Largest number of events in a bucket moved to the bottom without a new rung. */
+    uint32_t m_threshold;
+    /** Maximum number of rungs. */
+    uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
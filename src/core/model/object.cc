@@ -170,11 +170,14 @@ Object::DoGetObject(TypeId tid) const
             // we are likely to perform the same lookup later so, we make sure
             // that the aggregate array is sorted by the number of accesses
             // to each object.
-
+            // This is skipped in multithreaded builds, since the aggregates
+            // of an object may be looked up concurrently.
+#ifndef NS3_MTP
             // first, increment the access count
             current->m_getObjectCount++;
             // then, update the sort
             UpdateSortedArray(m_aggregates, i);
+#endif
             // finally, return the match
             return const_cast<Object*>(current);
         }
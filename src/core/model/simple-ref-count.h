@@ -24,9 +24,15 @@
 #include "assert.h"
 #include "default-deleter.h"
 
+#include "ns3/core-config.h"
+
 #include <limits>
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup ptr
@@ -125,8 +131,7 @@ class SimpleRefCount : public PARENT
      */
     inline void Unref() const
     {
-        m_count--;
-        if (m_count == 0)
+        if (--m_count == 0)
         {
             DELETER::Delete(static_cast<T*>(const_cast<SimpleRefCount*>(this)));
         }
@@ -149,9 +154,15 @@ class SimpleRefCount : public PARENT
      *
      * \internal
      * Note we make this mutable so that the const methods can still
-     * change it.
+     * change it. When built with multithreading support (NS3_MTP),
+     * the counter is atomic since the same object may be referenced
+     * from several simulation threads.
      */
+#ifdef NS3_MTP
+    mutable std::atomic<uint32_t> m_count;
+#else
     mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
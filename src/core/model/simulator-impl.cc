@@ -40,4 +40,10 @@ SimulatorImpl::GetTypeId()
     return tid;
 }
 
+uint64_t
+SimulatorImpl::AllocateUid(uint32_t& counter)
+{
+    return static_cast<uint64_t>(GetSystemId()) << 32 | counter++;
+}
+
 } // namespace ns3
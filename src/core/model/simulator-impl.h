@@ -100,6 +100,21 @@ class SimulatorImpl : public Object
     virtual uint32_t GetContext() const = 0;
     /** \copydoc Simulator::GetEventCount */
     virtual uint64_t GetEventCount() const = 0;
+    /**
+     * Allocate the unique identifier of an object, e.g. a Packet, created
+     * by the calling thread.
+     *
+     * The default implementation stores the system id in the upper 32 bits
+     * and increments the given counter. Implementations running several
+     * logical processes on different threads rather keep one counter per
+     * logical process, and store the identifier of the logical process in
+     * the upper 32 bits, so that the identifiers do not depend on the
+     * scheduling of the threads.
+     *
+     * \param [in,out] counter The counter of the identifiers allocated so far.
+     * \return The unique identifier.
+     */
+    virtual uint64_t AllocateUid(uint32_t& counter);
 
     /**
      * Hook called before processing each event.
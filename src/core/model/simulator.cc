@@ -332,6 +332,16 @@ Simulator::GetSystemId()
     }
 }
 
+uint64_t
+Simulator::AllocateUid(uint32_t& counter)
+{
+    if (*PeekImpl() != nullptr)
+    {
+        return GetImpl()->AllocateUid(counter);
+    }
+    return counter++;
+}
+
 void
 Simulator::SetImplementation(Ptr<SimulatorImpl> impl)
 {
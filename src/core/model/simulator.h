@@ -507,6 +507,15 @@ class Simulator
      */
     static uint32_t GetSystemId();
 
+    /**
+     * Allocate the unique identifier of an object, e.g. a Packet.
+     *
+     * @see SimulatorImpl::AllocateUid
+     * @param [in,out] counter The counter of the identifiers allocated so far.
+     * @return The unique identifier.
+     */
+    static uint64_t AllocateUid(uint32_t& counter);
+
   private:
     /**
      * Implementation of the various Schedule methods.
@@ -18,11 +18,18 @@
  */
 #include "ns3/calendar-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <array>
+#include <set>
+#include <vector>
 
 using namespace ns3;
 
@@ -707,6 +714,217 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the memory of the events is recycled, without changing
+ * the semantics of the event identifiers.
+ */
+class SimulatorEventMemoryTestCase : public TestCase
+{
+  public:
+    SimulatorEventMemoryTestCase();
+    void DoRun() override;
+
+  private:
+    /** Test event. */
+    void Count();
+
+    uint32_t m_count; //!< Number of events run.
+};
+
+SimulatorEventMemoryTestCase::SimulatorEventMemoryTestCase()
+    : TestCase("Check that the memory of the events is recycled")
+{
+}
+
+void
+SimulatorEventMemoryTestCase::Count()
+{
+    m_count++;
+}
+
+void
+SimulatorEventMemoryTestCase::DoRun()
+{
+    m_count = 0;
+
+    // start from empty free lists, which the events released by the other
+    // tests may have filled up
+    EventImpl::ReleaseFreeBlocks();
+    NS_TEST_ASSERT_MSG_EQ(EventImpl::GetFreeBlockCount(), 0, "The free lists should be empty");
+
+    EventImpl* first = MakeEvent(&SimulatorEventMemoryTestCase::Count, this);
+    first->Unref();
+    NS_TEST_EXPECT_MSG_EQ(EventImpl::GetFreeBlockCount(), 1, "The event should have been recycled");
+    EventImpl* second = MakeEvent(&SimulatorEventMemoryTestCase::Count, this);
+    NS_TEST_EXPECT_MSG_EQ(EventImpl::GetFreeBlockCount(),
+                          0,
+                          "The memory of the event should have been reused");
+    NS_TEST_EXPECT_MSG_EQ(second, first, "The memory of the event should have been reused");
+
+    std::array<uint32_t, 16> data{};
+    data[0] = 1;
+    EventImpl* large = MakeEvent([this, data]() { m_count += data[0]; });
+    NS_TEST_EXPECT_MSG_NE(large, second, "Live events should not share memory");
+    large->Invoke();
+    NS_TEST_EXPECT_MSG_EQ(m_count, 1, "The event should have run");
+    second->Unref();
+    large->Unref();
+    NS_TEST_EXPECT_MSG_EQ(EventImpl::GetFreeBlockCount(), 2, "The events should have been recycled");
+    EventImpl* third = MakeEvent([this, data]() { m_count += data[0]; });
+    NS_TEST_EXPECT_MSG_EQ(EventImpl::GetFreeBlockCount(),
+                          1,
+                          "The memory of the event should have been reused");
+    NS_TEST_EXPECT_MSG_EQ(third, large, "The memory of the event should have been reused");
+    third->Unref();
+    EventImpl::ReleaseFreeBlocks();
+    NS_TEST_EXPECT_MSG_EQ(EventImpl::GetFreeBlockCount(), 0, "The free lists should be empty");
+
+    m_count = 0;
+    EventId expired =
+        Simulator::Schedule(MicroSeconds(1), &SimulatorEventMemoryTestCase::Count, this);
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(expired.IsExpired(), true, "The event has run: it should be expired");
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        Simulator::Schedule(MicroSeconds(i), &SimulatorEventMemoryTestCase::Count, this);
+    }
+    EventId pending =
+        Simulator::Schedule(MicroSeconds(200), &SimulatorEventMemoryTestCase::Count, this);
+    NS_TEST_EXPECT_MSG_NE(pending.PeekEventImpl(),
+                          expired.PeekEventImpl(),
+                          "The memory of a referenced event should not be reused");
+    expired.Cancel();
+    NS_TEST_EXPECT_MSG_EQ(pending.IsExpired(), false, "The pending event should not be canceled");
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_count, 102, "All the events should have run");
+    NS_TEST_EXPECT_MSG_EQ(expired.IsExpired(), true, "The event should still be expired");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that a scheduler returns the events in order, with a mix of
+ * near-future, far-future and simultaneous events, and random removals.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the order of the events with " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+
+    std::set<Scheduler::EventKey> expected;
+    std::vector<Scheduler::EventKey> pending;
+    uint64_t now = 0;
+    uint32_t uid = 0;
+
+    // remove the next event, returning it along with the expected one and
+    // the result of PeekNext, so that the checks are made by DoRun itself
+    struct Removed
+    {
+        Scheduler::EventKey peek;     //!< the key returned by PeekNext
+        Scheduler::EventKey key;      //!< the key returned by RemoveNext
+        Scheduler::EventKey expected; //!< the expected key
+    };
+
+    auto removeNext = [&]() {
+        Removed removed;
+        removed.peek = scheduler->PeekNext().key;
+        removed.key = scheduler->RemoveNext().key;
+        removed.expected = *expected.begin();
+        expected.erase(expected.begin());
+        now = removed.key.m_ts;
+        return removed;
+    };
+
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        double op = rng->GetValue();
+        if (op < 0.55 || expected.empty())
+        {
+            Scheduler::Event ev;
+            ev.impl = nullptr;
+            ev.key.m_context = 0;
+            ev.key.m_uid = uid++;
+            double kind = rng->GetValue();
+            if (kind < 0.8)
+            {
+                ev.key.m_ts = now + rng->GetInteger(0, 100);
+            }
+            else if (kind < 0.95)
+            {
+                ev.key.m_ts = now + rng->GetInteger(0, 1000000000);
+            }
+            else
+            {
+                ev.key.m_ts = now;
+            }
+            scheduler->Insert(ev);
+            expected.insert(ev.key);
+            pending.push_back(ev.key);
+        }
+        else if (op < 0.9)
+        {
+            Removed removed = removeNext();
+            NS_TEST_ASSERT_MSG_EQ(removed.peek.m_uid,
+                                  removed.key.m_uid,
+                                  "PeekNext differs from RemoveNext");
+            NS_TEST_ASSERT_MSG_EQ(removed.key.m_uid, removed.expected.m_uid, "unexpected event");
+            NS_TEST_ASSERT_MSG_EQ(removed.key.m_ts,
+                                  removed.expected.m_ts,
+                                  "unexpected timestamp");
+        }
+        else
+        {
+            // remove a random event, skipping the ones already dequeued
+            uint32_t index = rng->GetInteger(0, pending.size() - 1);
+            Scheduler::EventKey key = pending[index];
+            pending[index] = pending.back();
+            pending.pop_back();
+            if (expected.erase(key) == 1)
+            {
+                Scheduler::Event ev;
+                ev.impl = nullptr;
+                ev.key = key;
+                scheduler->Remove(ev);
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), expected.empty(), "unexpected queue size");
+    }
+    while (!expected.empty())
+    {
+        Removed removed = removeNext();
+        NS_TEST_ASSERT_MSG_EQ(removed.peek.m_uid,
+                              removed.key.m_uid,
+                              "PeekNext differs from RemoveNext");
+        NS_TEST_ASSERT_MSG_EQ(removed.key.m_uid, removed.expected.m_uid, "unexpected event");
+        NS_TEST_ASSERT_MSG_EQ(removed.key.m_ts, removed.expected.m_ts, "unexpected timestamp");
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "the queue should be empty");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -730,6 +948,25 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+
+        AddTestCase(new SimulatorEventMemoryTestCase(), TestCase::QUICK);
+
+        factory.SetTypeId(MapScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(HeapScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(CalendarScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        factory.Set("Threshold", UintegerValue(4));
+        factory.Set("MaxRungs", UintegerValue(3));
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
     }
 };
 
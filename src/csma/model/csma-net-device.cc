@@ -30,6 +30,7 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
@@ -380,7 +381,7 @@ CsmaNetDevice::AddHeader(Ptr<Packet> p,
             p->AddAtEnd(padd);
         }
 
-        NS_ASSERT_MSG(p->GetSize() <= GetMtu(),
+        NS_ASSERT_MSG(SegmentationOffloadTag::GetMaxSegmentSize(p) <= GetMtu(),
                       "CsmaNetDevice::AddHeader(): 802.3 Length/Type field with LLC/SNAP: "
                       "length interpretation must not exceed device frame size minus overhead");
     }
@@ -528,7 +529,12 @@ CsmaNetDevice::TransmitStart()
             m_backoff.ResetBackoffTime();
             m_txMachineState = BUSY;
 
-            Time tEvent = m_bps.CalculateBytesTxTime(m_currentPkt->GetSize());
+            // The segments of a super-segment are transmitted back to back,
+            // each with its own headers
+            uint32_t segments = SegmentationOffloadTag::GetSegments(m_currentPkt);
+            Time tEvent =
+                m_bps.CalculateBytesTxTime(SegmentationOffloadTag::GetWireSize(m_currentPkt)) +
+                m_tInterframeGap * (segments - 1);
             NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << tEvent.As(Time::S));
             Simulator::Schedule(tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
@@ -171,4 +171,15 @@ FlowMonitorHelper::SerializeToXmlFile(std::string fileName,
     }
 }
 
+void
+FlowMonitorHelper::SerializeToColumnarFile(std::string fileName,
+                                           bool enableHistograms,
+                                           bool enableProbes)
+{
+    if (m_flowMonitor)
+    {
+        m_flowMonitor->SerializeToColumnarFile(fileName, enableHistograms, enableProbes);
+    }
+}
+
 } // namespace ns3
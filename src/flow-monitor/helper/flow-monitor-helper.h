@@ -119,6 +119,14 @@ class FlowMonitorHelper
      */
     void SerializeToXmlFile(std::string fileName, bool enableHistograms, bool enableProbes);
 
+    /**
+     * Serializes the results to a binary ColumnarFileWriter file
+     * \param fileName name or path of the output file that will be created
+     * \param enableHistograms if true, include also the histograms in the output
+     * \param enableProbes if true, include also the per-probe/flow pair statistics in the output
+     */
+    void SerializeToColumnarFile(std::string fileName, bool enableHistograms, bool enableProbes);
+
   private:
     ObjectFactory m_monitorFactory;        //!< Object factory
     Ptr<FlowMonitor> m_flowMonitor;        //!< the FlowMonitor object
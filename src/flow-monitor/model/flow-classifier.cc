@@ -37,4 +37,9 @@ FlowClassifier::GetNewFlowId()
     return ++m_lastNewFlowId;
 }
 
+void
+FlowClassifier::SerializeToColumnarFile(ColumnarFileWriter& writer) const
+{
+}
+
 } // namespace ns3
@@ -27,6 +27,8 @@
 namespace ns3
 {
 
+class ColumnarFileWriter;
+
 /**
  * \ingroup flow-monitor
  * \brief Abstract identifier of a packet flow
@@ -68,6 +70,11 @@ class FlowClassifier : public SimpleRefCount<FlowClassifier>
     /// \param indent number of spaces to use as base indentation level
     virtual void SerializeToXmlStream(std::ostream& os, uint16_t indent) const = 0;
 
+    /// Serializes the flow identifiers to tables of a binary columnar file.
+    /// The default implementation writes nothing.
+    /// \param writer the columnar file writer
+    virtual void SerializeToColumnarFile(ColumnarFileWriter& writer) const;
+
   protected:
     /// Returns a new, unique Flow Identifier
     /// \returns a new FlowId
@@ -19,6 +19,8 @@
 
 #include "flow-monitor.h"
 
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -35,6 +37,25 @@ NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
+/// The columns of the "flows" table of the columnar files: the times are in nanoseconds
+static const std::vector<ColumnarFileWriter::ColumnDefinition> COLUMNAR_FLOW_COLUMNS = {
+    {"time", ColumnarFileWriter::INT64},
+    {"flowId", ColumnarFileWriter::UINT64},
+    {"timeFirstTxPacket", ColumnarFileWriter::INT64},
+    {"timeFirstRxPacket", ColumnarFileWriter::INT64},
+    {"timeLastTxPacket", ColumnarFileWriter::INT64},
+    {"timeLastRxPacket", ColumnarFileWriter::INT64},
+    {"delaySum", ColumnarFileWriter::INT64},
+    {"jitterSum", ColumnarFileWriter::INT64},
+    {"lastDelay", ColumnarFileWriter::INT64},
+    {"txBytes", ColumnarFileWriter::UINT64},
+    {"rxBytes", ColumnarFileWriter::UINT64},
+    {"txPackets", ColumnarFileWriter::UINT64},
+    {"rxPackets", ColumnarFileWriter::UINT64},
+    {"lostPackets", ColumnarFileWriter::UINT64},
+    {"timesForwarded", ColumnarFileWriter::UINT64},
+};
+
 TypeId
 FlowMonitor::GetTypeId()
 {
@@ -80,7 +101,14 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("DelayJitterSketches",
+                          "If true, record the delays and jitters of the flows in sketches "
+                          "with a relative precision and a size bounded by the ratio of the "
+                          "extreme values, instead of histograms with fixed-width bins.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FlowMonitor::m_delayJitterSketches),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -91,7 +119,10 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_oldestTracked(nullptr),
+      m_newestTracked(nullptr),
+      m_enabled(false),
+      m_columnarFlows(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -102,6 +133,13 @@ FlowMonitor::DoDispose()
     NS_LOG_FUNCTION(this);
     Simulator::Cancel(m_startEvent);
     Simulator::Cancel(m_stopEvent);
+    Simulator::Cancel(m_columnarExportEvent);
+    if (m_columnarExport)
+    {
+        m_columnarExport->Close();
+        m_columnarExport = nullptr;
+        m_columnarFlows = nullptr;
+    }
     for (std::list<Ptr<FlowClassifier>>::iterator iter = m_classifiers.begin();
          iter != m_classifiers.end();
          iter++)
@@ -113,6 +151,9 @@ FlowMonitor::DoDispose()
         m_flowProbes[i]->Dispose();
         m_flowProbes[i] = nullptr;
     }
+    m_trackedPackets.clear();
+    m_oldestTracked = nullptr;
+    m_newestTracked = nullptr;
     Object::DoDispose();
 }
 
@@ -120,11 +161,22 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    FlowStatsContainerI iter;
-    iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    if (m_columnarExport)
+    {
+        NotifyFlowUpdated(flowId);
+    }
+    if (flowId < m_flowStatsIndex.size() && m_flowStatsIndex[flowId] != nullptr)
+    {
+        return *m_flowStatsIndex[flowId];
+    }
+    else
     {
         FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+        if (flowId >= m_flowStatsIndex.size())
+        {
+            m_flowStatsIndex.resize(flowId + 1, nullptr);
+        }
+        m_flowStatsIndex[flowId] = &ref;
         ref.delaySum = Seconds(0);
         ref.jitterSum = Seconds(0);
         ref.lastDelay = Seconds(0);
@@ -140,9 +192,48 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
         ref.flowInterruptionsHistogram.SetDefaultBinWidth(m_flowInterruptionsBinWidth);
         return ref;
     }
+}
+
+uint64_t
+FlowMonitor::GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
+void
+FlowMonitor::AppendTrackedPacket(TrackedPacket& tracked)
+{
+    tracked.older = m_newestTracked;
+    tracked.newer = nullptr;
+    if (m_newestTracked != nullptr)
+    {
+        m_newestTracked->newer = &tracked;
+    }
     else
     {
-        return iter->second;
+        m_oldestTracked = &tracked;
+    }
+    m_newestTracked = &tracked;
+}
+
+void
+FlowMonitor::UnlinkTrackedPacket(TrackedPacket& tracked)
+{
+    if (tracked.older != nullptr)
+    {
+        tracked.older->newer = tracked.newer;
+    }
+    else
+    {
+        m_oldestTracked = tracked.newer;
+    }
+    if (tracked.newer != nullptr)
+    {
+        tracked.newer->older = tracked.older;
+    }
+    else
+    {
+        m_newestTracked = tracked.older;
     }
 }
 
@@ -159,10 +250,18 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    uint64_t key = GetTrackedPacketKey(flowId, packetId);
+    auto inserted = m_trackedPackets.try_emplace(key);
+    TrackedPacket& tracked = inserted.first->second;
+    if (!inserted.second)
+    {
+        UnlinkTrackedPacket(tracked);
+    }
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
+    tracked.key = key;
+    AppendTrackedPacket(tracked);
     NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
                                                                  << packetId << ").");
 
@@ -190,8 +289,8 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(key);
+    TrackedPacketMap::iterator tracked =
+        m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet forward report (flowId="
@@ -201,6 +300,8 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
 
     tracked->second.timesForwarded++;
     tracked->second.lastSeenTime = Simulator::Now();
+    UnlinkTrackedPacket(tracked->second);
+    AppendTrackedPacket(tracked->second);
 
     Time delay = (Simulator::Now() - tracked->second.firstSeenTime);
     probe->AddPacketStats(flowId, packetSize, delay);
@@ -218,7 +319,8 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    TrackedPacketMap::iterator tracked =
+        m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet last-tx report (flowId="
@@ -232,19 +334,25 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
 
     FlowStats& stats = GetStatsForFlow(flowId);
     stats.delaySum += delay;
-    stats.delayHistogram.AddValue(delay.GetSeconds());
+    if (m_delayJitterSketches)
+    {
+        stats.delaySketch.AddValue(delay.GetSeconds());
+    }
+    else
+    {
+        stats.delayHistogram.AddValue(delay.GetSeconds());
+    }
     if (stats.rxPackets > 0)
     {
-        Time jitter = stats.lastDelay - delay;
-        if (jitter > Seconds(0))
+        Time jitter = Abs(stats.lastDelay - delay);
+        stats.jitterSum += jitter;
+        if (m_delayJitterSketches)
         {
-            stats.jitterSum += jitter;
-            stats.jitterHistogram.AddValue(jitter.GetSeconds());
+            stats.jitterSketch.AddValue(jitter.GetSeconds());
         }
         else
         {
-            stats.jitterSum -= jitter;
-            stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            stats.jitterHistogram.AddValue(jitter.GetSeconds());
         }
     }
     stats.lastDelay = delay;
@@ -271,7 +379,9 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                   << packetId << ").");
 
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+    // we don't need to track this packet anymore
+    UnlinkTrackedPacket(tracked->second);
+    m_trackedPackets.erase(tracked);
 }
 
 void
@@ -302,13 +412,15 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    TrackedPacketMap::iterator tracked =
+        m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked != m_trackedPackets.end())
     {
         // we don't need to track this packet anymore
         // FIXME: this will not necessarily be true with broadcast/multicast
         NS_LOG_DEBUG("ReportDrop: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                     << packetId << ").");
+        UnlinkTrackedPacket(tracked->second);
         m_trackedPackets.erase(tracked);
     }
 }
@@ -325,23 +437,24 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
     NS_LOG_FUNCTION(this << maxDelay.As(Time::S));
     Time now = Simulator::Now();
 
-    for (TrackedPacketMap::iterator iter = m_trackedPackets.begin();
-         iter != m_trackedPackets.end();)
+    // the tracked packets are listed in the order they were last seen, so
+    // only the packets lost and the oldest packet still in flight are visited
+    while (m_oldestTracked != nullptr && now - m_oldestTracked->lastSeenTime >= maxDelay)
     {
-        if (now - iter->second.lastSeenTime >= maxDelay)
-        {
-            // packet is considered lost, add it to the loss statistics
-            FlowStatsContainerI flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
+        TrackedPacket& tracked = *m_oldestTracked;
 
-            // we won't track it anymore
-            m_trackedPackets.erase(iter++);
-        }
-        else
+        // packet is considered lost, add it to the loss statistics
+        auto flowId = static_cast<FlowId>(tracked.key >> 32);
+        NS_ASSERT(flowId < m_flowStatsIndex.size() && m_flowStatsIndex[flowId] != nullptr);
+        m_flowStatsIndex[flowId]->lostPackets++;
+        if (m_columnarExport)
         {
-            iter++;
+            NotifyFlowUpdated(flowId);
         }
+
+        // we won't track it anymore
+        UnlinkTrackedPacket(tracked);
+        m_trackedPackets.erase(tracked.key);
     }
 }
 
@@ -484,6 +597,11 @@ FlowMonitor::SerializeToXmlStream(std::ostream& os,
                 os,
                 indent,
                 "flowInterruptionsHistogram");
+            if (m_delayJitterSketches)
+            {
+                flowI->second.delaySketch.SerializeToXmlStream(os, indent, "delaySketch");
+                flowI->second.jitterSketch.SerializeToXmlStream(os, indent, "jitterSketch");
+            }
         }
         indent -= 2;
 
@@ -534,6 +652,234 @@ FlowMonitor::SerializeToXmlFile(std::string fileName, bool enableHistograms, boo
     os.close();
 }
 
+void
+FlowMonitor::WriteColumnarFlow(ColumnarFileWriter::Table& table,
+                               FlowId flowId,
+                               const FlowStats& stats)
+{
+    table.AddInt(Simulator::Now().GetNanoSeconds())
+        .AddUint(flowId)
+        .AddInt(stats.timeFirstTxPacket.GetNanoSeconds())
+        .AddInt(stats.timeFirstRxPacket.GetNanoSeconds())
+        .AddInt(stats.timeLastTxPacket.GetNanoSeconds())
+        .AddInt(stats.timeLastRxPacket.GetNanoSeconds())
+        .AddInt(stats.delaySum.GetNanoSeconds())
+        .AddInt(stats.jitterSum.GetNanoSeconds())
+        .AddInt(stats.lastDelay.GetNanoSeconds())
+        .AddUint(stats.txBytes)
+        .AddUint(stats.rxBytes)
+        .AddUint(stats.txPackets)
+        .AddUint(stats.rxPackets)
+        .AddUint(stats.lostPackets)
+        .AddUint(stats.timesForwarded)
+        .EndRow();
+}
+
+void
+FlowMonitor::WriteColumnarDetails(ColumnarFileWriter& writer,
+                                  bool enableHistograms,
+                                  bool enableProbes)
+{
+    NS_LOG_FUNCTION(this << enableHistograms << enableProbes);
+    ColumnarFileWriter::Table& drops = writer.AddTable("drops",
+                                                       {{"flowId", ColumnarFileWriter::UINT64},
+                                                        {"reasonCode", ColumnarFileWriter::UINT64},
+                                                        {"packets", ColumnarFileWriter::UINT64},
+                                                        {"bytes", ColumnarFileWriter::UINT64}});
+    for (const auto& flow : m_flowStats)
+    {
+        for (uint32_t reasonCode = 0; reasonCode < flow.second.packetsDropped.size();
+             reasonCode++)
+        {
+            drops.AddUint(flow.first)
+                .AddUint(reasonCode)
+                .AddUint(flow.second.packetsDropped[reasonCode])
+                .AddUint(flow.second.bytesDropped[reasonCode])
+                .EndRow();
+        }
+    }
+
+    if (enableHistograms)
+    {
+        ColumnarFileWriter::Table& histograms =
+            writer.AddTable("histograms",
+                            {{"flowId", ColumnarFileWriter::UINT64},
+                             {"histogram", ColumnarFileWriter::STRING},
+                             {"start", ColumnarFileWriter::DOUBLE},
+                             {"end", ColumnarFileWriter::DOUBLE},
+                             {"count", ColumnarFileWriter::UINT64}});
+        for (const auto& flow : m_flowStats)
+        {
+            const std::pair<const char*, const Histogram*> fixedWidth[] = {
+                {"delayHistogram", &flow.second.delayHistogram},
+                {"jitterHistogram", &flow.second.jitterHistogram},
+                {"packetSizeHistogram", &flow.second.packetSizeHistogram},
+                {"flowInterruptionsHistogram", &flow.second.flowInterruptionsHistogram}};
+            for (const auto& histogram : fixedWidth)
+            {
+                for (uint32_t index = 0; index < histogram.second->GetNBins(); index++)
+                {
+                    if (histogram.second->GetBinCount(index))
+                    {
+                        histograms.AddUint(flow.first)
+                            .AddString(histogram.first)
+                            .AddDouble(histogram.second->GetBinStart(index))
+                            .AddDouble(histogram.second->GetBinEnd(index))
+                            .AddUint(histogram.second->GetBinCount(index))
+                            .EndRow();
+                    }
+                }
+            }
+            if (!m_delayJitterSketches)
+            {
+                continue;
+            }
+            const std::pair<const char*, const LogHistogram*> sketches[] = {
+                {"delaySketch", &flow.second.delaySketch},
+                {"jitterSketch", &flow.second.jitterSketch}};
+            for (const auto& sketch : sketches)
+            {
+                if (sketch.second->GetZeroCount())
+                {
+                    histograms.AddUint(flow.first)
+                        .AddString(sketch.first)
+                        .AddDouble(0)
+                        .AddDouble(0)
+                        .AddUint(sketch.second->GetZeroCount())
+                        .EndRow();
+                }
+                for (uint32_t index = 0; index < sketch.second->GetNBins(); index++)
+                {
+                    if (sketch.second->GetBinCount(index))
+                    {
+                        histograms.AddUint(flow.first)
+                            .AddString(sketch.first)
+                            .AddDouble(sketch.second->GetBinStart(index))
+                            .AddDouble(sketch.second->GetBinEnd(index))
+                            .AddUint(sketch.second->GetBinCount(index))
+                            .EndRow();
+                    }
+                }
+            }
+        }
+    }
+
+    for (const auto& classifier : m_classifiers)
+    {
+        classifier->SerializeToColumnarFile(writer);
+    }
+
+    if (enableProbes)
+    {
+        ColumnarFileWriter::Table& probeFlows =
+            writer.AddTable("probeFlows",
+                            {{"probe", ColumnarFileWriter::UINT64},
+                             {"flowId", ColumnarFileWriter::UINT64},
+                             {"packets", ColumnarFileWriter::UINT64},
+                             {"bytes", ColumnarFileWriter::UINT64},
+                             {"delayFromFirstProbeSum", ColumnarFileWriter::INT64}});
+        for (uint32_t i = 0; i < m_flowProbes.size(); i++)
+        {
+            for (const auto& flow : m_flowProbes[i]->GetStats())
+            {
+                probeFlows.AddUint(i)
+                    .AddUint(flow.first)
+                    .AddUint(flow.second.packets)
+                    .AddUint(flow.second.bytes)
+                    .AddInt(flow.second.delayFromFirstProbeSum.GetNanoSeconds())
+                    .EndRow();
+            }
+        }
+    }
+}
+
+void
+FlowMonitor::SerializeToColumnarFile(std::string fileName,
+                                     bool enableHistograms,
+                                     bool enableProbes)
+{
+    NS_LOG_FUNCTION(this << fileName << enableHistograms << enableProbes);
+    CheckForLostPackets();
+
+    ColumnarFileWriter writer(fileName);
+    ColumnarFileWriter::Table& flows = writer.AddTable("flows", COLUMNAR_FLOW_COLUMNS);
+    for (const auto& flow : m_flowStats)
+    {
+        WriteColumnarFlow(flows, flow.first, flow.second);
+    }
+    WriteColumnarDetails(writer, enableHistograms, enableProbes);
+    writer.Close();
+}
+
+void
+FlowMonitor::StartColumnarExport(std::string fileName, Time interval)
+{
+    NS_LOG_FUNCTION(this << fileName << interval.As(Time::S));
+    NS_ABORT_MSG_IF(m_columnarExport, "The columnar export is already started");
+    NS_ABORT_MSG_IF(!interval.IsStrictlyPositive(), "Invalid columnar export interval");
+    m_columnarExport = Create<ColumnarFileWriter>(fileName);
+    m_columnarFlows = &m_columnarExport->AddTable("flows", COLUMNAR_FLOW_COLUMNS);
+    m_columnarExportInterval = interval;
+    for (const auto& flow : m_flowStats)
+    {
+        NotifyFlowUpdated(flow.first);
+    }
+    m_columnarExportEvent =
+        Simulator::Schedule(interval, &FlowMonitor::PeriodicColumnarExport, this);
+}
+
+void
+FlowMonitor::NotifyFlowUpdated(FlowId flowId)
+{
+    if (flowId >= m_flowUpdated.size())
+    {
+        m_flowUpdated.resize(flowId + 1, false);
+    }
+    if (!m_flowUpdated[flowId])
+    {
+        m_flowUpdated[flowId] = true;
+        m_updatedFlows.push_back(flowId);
+    }
+}
+
+void
+FlowMonitor::WriteColumnarUpdatedFlows()
+{
+    NS_LOG_FUNCTION(this << m_updatedFlows.size());
+    for (FlowId flowId : m_updatedFlows)
+    {
+        WriteColumnarFlow(*m_columnarFlows, flowId, *m_flowStatsIndex[flowId]);
+        m_flowUpdated[flowId] = false;
+    }
+    m_updatedFlows.clear();
+}
+
+void
+FlowMonitor::PeriodicColumnarExport()
+{
+    NS_LOG_FUNCTION(this);
+    WriteColumnarUpdatedFlows();
+    // write each interval in its own batch, so that the file can be read during the simulation
+    m_columnarExport->Flush();
+    m_columnarExportEvent = Simulator::Schedule(m_columnarExportInterval,
+                                                &FlowMonitor::PeriodicColumnarExport,
+                                                this);
+}
+
+void
+FlowMonitor::StopColumnarExport(bool enableHistograms, bool enableProbes)
+{
+    NS_LOG_FUNCTION(this << enableHistograms << enableProbes);
+    NS_ABORT_MSG_IF(!m_columnarExport, "The columnar export is not started");
+    Simulator::Cancel(m_columnarExportEvent);
+    CheckForLostPackets();
+    WriteColumnarUpdatedFlows();
+    WriteColumnarDetails(*m_columnarExport, enableHistograms, enableProbes);
+    m_columnarExport->Close();
+    m_columnarExport = nullptr;
+    m_columnarFlows = nullptr;
+}
+
 void
 FlowMonitor::ResetAllStats()
 {
@@ -558,6 +904,12 @@ FlowMonitor::ResetAllStats()
         flowStat.jitterHistogram.Clear();
         flowStat.packetSizeHistogram.Clear();
         flowStat.flowInterruptionsHistogram.Clear();
+        flowStat.delaySketch.Clear();
+        flowStat.jitterSketch.Clear();
+        if (m_columnarExport)
+        {
+            NotifyFlowUpdated(iter.first);
+        }
     }
 }
 
@@ -20,15 +20,18 @@
 #ifndef FLOW_MONITOR_H
 #define FLOW_MONITOR_H
 
+#include "ns3/columnar-file-writer.h"
 #include "ns3/event-id.h"
 #include "ns3/flow-classifier.h"
 #include "ns3/flow-probe.h"
 #include "ns3/histogram.h"
+#include "ns3/log-histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -115,6 +118,12 @@ class FlowMonitor : public Object
         Histogram jitterHistogram;
         /// Histogram of the packet sizes
         Histogram packetSizeHistogram;
+        /// Sketch of the packet delays, used instead of delayHistogram
+        /// when the DelayJitterSketches attribute is true
+        LogHistogram delaySketch;
+        /// Sketch of the packet jitters, used instead of jitterHistogram
+        /// when the DelayJitterSketches attribute is true
+        LogHistogram jitterSketch;
 
         /// This attribute also tracks the number of lost packets and
         /// bytes, but discriminates the losses by a _reason code_.  This
@@ -273,6 +282,32 @@ class FlowMonitor : public Object
     /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
     void SerializeToXmlFile(std::string fileName, bool enableHistograms, bool enableProbes);
 
+    /// Serializes the results to a binary ColumnarFileWriter file.  The
+    /// "flows" table holds the statistics of the flows; the "drops",
+    /// "histograms" and "probeFlows" tables hold the drops by reason code,
+    /// the bins of the histograms and the per-probe/flow pair statistics;
+    /// the classifiers add the tables of the flow identifiers.
+    /// \param fileName name or path of the output file that will be created
+    /// \param enableHistograms if true, include also the histograms in the output
+    /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
+    void SerializeToColumnarFile(std::string fileName, bool enableHistograms, bool enableProbes);
+
+    /// Start writing the statistics of the flows to a binary
+    /// ColumnarFileWriter file during the simulation.  At each interval,
+    /// the statistics of the flows updated since the previous interval are
+    /// added to the "flows" table, with the time in its "time" column, so
+    /// that the file grows in batches instead of being written at the end.
+    /// \param fileName name or path of the output file that will be created
+    /// \param interval the interval between the writes
+    void StartColumnarExport(std::string fileName, Time interval);
+
+    /// Stop writing the statistics of the flows during the simulation: write
+    /// the statistics of the flows updated since the last interval and the
+    /// other tables of SerializeToColumnarFile, and close the file.
+    /// \param enableHistograms if true, include also the histograms in the output
+    /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
+    void StopColumnarExport(bool enableHistograms, bool enableProbes);
+
     /// Reset all the statistics
     void ResetAllStats();
 
@@ -287,14 +322,21 @@ class FlowMonitor : public Object
         Time firstSeenTime;      //!< absolute time when the packet was first seen by a probe
         Time lastSeenTime;       //!< absolute time when the packet was last seen by a probe
         uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+        uint64_t key;            //!< key of the packet in m_trackedPackets
+        TrackedPacket* older;    //!< packet last seen before this one
+        TrackedPacket* newer;    //!< packet last seen after this one
     };
 
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
-
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
-    TrackedPacketMap m_trackedPackets; //!< Tracked packets
+    /// FlowId --> FlowStats in m_flowStats, or nullptr
+    std::vector<FlowStats*> m_flowStatsIndex;
+
+    /// (FlowId << 32 | PacketId) --> TrackedPacket
+    typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
+    TrackedPacketMap m_trackedPackets; //!< Tracked packets, listed in the order they were last seen
+    TrackedPacket* m_oldestTracked;    //!< The tracked packet seen first
+    TrackedPacket* m_newestTracked;    //!< The tracked packet seen last
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
 
@@ -309,6 +351,14 @@ class FlowMonitor : public Object
     double m_packetSizeBinWidth;        //!< packet size bin width (for histograms)
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
+    bool m_delayJitterSketches;         //!< Record the delays and jitters in sketches
+
+    Ptr<ColumnarFileWriter> m_columnarExport;  //!< The file of the columnar export
+    ColumnarFileWriter::Table* m_columnarFlows; //!< The "flows" table of the columnar export
+    EventId m_columnarExportEvent;              //!< Next write of the columnar export
+    Time m_columnarExportInterval;              //!< Interval of the columnar export
+    std::vector<FlowId> m_updatedFlows;         //!< Flows updated since the last export
+    std::vector<bool> m_flowUpdated;            //!< FlowId --> whether in m_updatedFlows
 
     /// Get the stats for a given flow
     /// \param flowId the Flow identification
@@ -317,6 +367,43 @@ class FlowMonitor : public Object
 
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
+
+    /// Periodic function to write the flows updated to the columnar export
+    void PeriodicColumnarExport();
+
+    /// Write the flows updated since the last write to the columnar export
+    void WriteColumnarUpdatedFlows();
+
+    /// Record that the statistics of a flow changed, for the columnar export
+    /// \param flowId the Flow identification
+    void NotifyFlowUpdated(FlowId flowId);
+
+    /// Write the statistics of a flow to a "flows" table
+    /// \param table the table
+    /// \param flowId the Flow identification
+    /// \param stats the statistics of the flow
+    static void WriteColumnarFlow(ColumnarFileWriter::Table& table,
+                                  FlowId flowId,
+                                  const FlowStats& stats);
+
+    /// Write the tables other than "flows" of SerializeToColumnarFile
+    /// \param writer the columnar file writer
+    /// \param enableHistograms if true, include also the histograms in the output
+    /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
+    void WriteColumnarDetails(ColumnarFileWriter& writer, bool enableHistograms, bool enableProbes);
+
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet identification
+    /// \returns the key of the packet in m_trackedPackets
+    static uint64_t GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId);
+
+    /// Add a tracked packet at the newest end of the tracked packet list
+    /// \param tracked the tracked packet
+    void AppendTrackedPacket(TrackedPacket& tracked);
+
+    /// Remove a tracked packet from the tracked packet list
+    /// \param tracked the tracked packet
+    void UnlinkTrackedPacket(TrackedPacket& tracked);
 };
 
 } // namespace ns3
@@ -19,11 +19,15 @@
 
 #include "ipv4-flow-classifier.h"
 
+#include "ns3/columnar-file-writer.h"
 #include "ns3/packet.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-header.h"
 
 #include <algorithm>
+#include <functional>
+#include <numeric>
+#include <sstream>
 
 namespace ns3
 {
@@ -91,6 +95,21 @@ operator==(const Ipv4FlowClassifier::FiveTuple& t1, const Ipv4FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+std::size_t
+Ipv4FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t ports = (uint64_t(tuple.protocol) << 32) | (uint32_t(tuple.sourcePort) << 16) |
+                     tuple.destinationPort;
+    std::size_t hash = Ipv4AddressHash()(tuple.sourceAddress);
+    std::size_t values[] = {Ipv4AddressHash()(tuple.destinationAddress),
+                            std::hash<uint64_t>()(ports)};
+    for (std::size_t value : values)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
 Ipv4FlowClassifier::Ipv4FlowClassifier()
 {
 }
@@ -145,36 +164,42 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
     tuple.destinationPort = dstPort;
 
     // try to insert the tuple, but check if it already exists
-    std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert =
-        m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
+    auto insert = m_flowMap.try_emplace(tuple, 0);
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
+        NS_ASSERT(newFlowId == m_flows.size() + 1);
         insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        m_flows.push_back({tuple, 0, {}});
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        m_flows[insert.first->second - 1].lastPacketId++;
     }
+    FlowInfo& flow = m_flows[insert.first->second - 1];
 
     // increment the counter of packets with the same DSCP value
     Ipv4Header::DscpType dscp = ipHeader.GetDscp();
-    std::pair<std::map<Ipv4Header::DscpType, uint32_t>::iterator, bool> dscpInserter =
-        m_flowDscpMap[insert.first->second].insert(
-            std::pair<Ipv4Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
+    auto dscpCount = std::lower_bound(flow.dscpCounts.begin(),
+                                      flow.dscpCounts.end(),
+                                      dscp,
+                                      [](const std::pair<Ipv4Header::DscpType, uint32_t>& count,
+                                         Ipv4Header::DscpType value) {
+                                          return count.first < value;
+                                      });
+    if (dscpCount == flow.dscpCounts.end() || dscpCount->first != dscp)
     {
-        m_flowDscpMap[insert.first->second][dscp]++;
+        flow.dscpCounts.emplace(dscpCount, dscp, 1);
+    }
+    else
+    {
+        dscpCount->second++;
     }
 
     *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_packetId = flow.lastPacketId;
 
     return true;
 }
@@ -182,18 +207,11 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow(FlowId flowId) const
 {
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    if (flowId == 0 || flowId > m_flows.size())
     {
-        if (iter->second == flowId)
-        {
-            return iter->first;
-        }
+        NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
-    NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
-    FiveTuple retval = {Ipv4Address::GetZero(), Ipv4Address::GetZero(), 0, 0, 0};
-    return retval;
+    return m_flows[flowId - 1].tuple;
 }
 
 bool
@@ -206,16 +224,12 @@ Ipv4FlowClassifier::SortByCount::operator()(std::pair<Ipv4Header::DscpType, uint
 std::vector<std::pair<Ipv4Header::DscpType, uint32_t>>
 Ipv4FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
-    std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>>::const_iterator flow =
-        m_flowDscpMap.find(flowId);
-
-    if (flow == m_flowDscpMap.end())
+    if (flowId == 0 || flowId > m_flows.size())
     {
         NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
 
-    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v(flow->second.begin(),
-                                                             flow->second.end());
+    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v = m_flows[flowId - 1].dscpCounts;
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -226,33 +240,31 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv4FlowClassifier>\n";
 
+    // the flows are written in the order of their FiveTuples
+    std::vector<FlowId> flowIds(m_flows.size());
+    std::iota(flowIds.begin(), flowIds.end(), 1);
+    std::sort(flowIds.begin(), flowIds.end(), [this](FlowId a, FlowId b) {
+        return m_flows[a - 1].tuple < m_flows[b - 1].tuple;
+    });
+
     indent += 2;
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    for (FlowId flowId : flowIds)
     {
+        const FlowInfo& flow = m_flows[flowId - 1];
         Indent(os, indent);
-        os << "<Flow flowId=\"" << iter->second << "\""
-           << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-           << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-           << " protocol=\"" << int(iter->first.protocol) << "\""
-           << " sourcePort=\"" << iter->first.sourcePort << "\""
-           << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+        os << "<Flow flowId=\"" << flowId << "\""
+           << " sourceAddress=\"" << flow.tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow.tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow.tuple.protocol) << "\""
+           << " sourcePort=\"" << flow.tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow.tuple.destinationPort << "\">\n";
 
         indent += 2;
-        std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>>::const_iterator flow =
-            m_flowDscpMap.find(iter->second);
-
-        if (flow != m_flowDscpMap.end())
+        for (const auto& dscpCount : flow.dscpCounts)
         {
-            for (std::map<Ipv4Header::DscpType, uint32_t>::const_iterator i = flow->second.begin();
-                 i != flow->second.end();
-                 i++)
-            {
-                Indent(os, indent);
-                os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
-                   << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(dscpCount.first) << "\""
+               << " packets=\"" << std::dec << dscpCount.second << "\" />\n";
         }
 
         indent -= 2;
@@ -265,4 +277,40 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "</Ipv4FlowClassifier>\n";
 }
 
+void
+Ipv4FlowClassifier::SerializeToColumnarFile(ColumnarFileWriter& writer) const
+{
+    ColumnarFileWriter::Table& flows =
+        writer.AddTable("ipv4Flows",
+                        {{"flowId", ColumnarFileWriter::UINT64},
+                         {"sourceAddress", ColumnarFileWriter::STRING},
+                         {"destinationAddress", ColumnarFileWriter::STRING},
+                         {"protocol", ColumnarFileWriter::UINT64},
+                         {"sourcePort", ColumnarFileWriter::UINT64},
+                         {"destinationPort", ColumnarFileWriter::UINT64}});
+    ColumnarFileWriter::Table& dscps = writer.AddTable("ipv4Dscp",
+                                                       {{"flowId", ColumnarFileWriter::UINT64},
+                                                        {"dscp", ColumnarFileWriter::UINT64},
+                                                        {"packets", ColumnarFileWriter::UINT64}});
+    for (FlowId flowId = 1; flowId <= m_flows.size(); flowId++)
+    {
+        const FlowInfo& flow = m_flows[flowId - 1];
+        std::ostringstream source;
+        std::ostringstream destination;
+        source << flow.tuple.sourceAddress;
+        destination << flow.tuple.destinationAddress;
+        flows.AddUint(flowId)
+            .AddString(source.str())
+            .AddString(destination.str())
+            .AddUint(flow.tuple.protocol)
+            .AddUint(flow.tuple.sourcePort)
+            .AddUint(flow.tuple.destinationPort)
+            .EndRow();
+        for (const auto& dscpCount : flow.dscpCounts)
+        {
+            dscps.AddUint(flowId).AddUint(dscpCount.first).AddUint(dscpCount.second).EndRow();
+        }
+    }
+}
+
 } // namespace ns3
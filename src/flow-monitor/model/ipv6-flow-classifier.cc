@@ -20,11 +20,15 @@
 
 #include "ipv6-flow-classifier.h"
 
+#include "ns3/columnar-file-writer.h"
 #include "ns3/packet.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-header.h"
 
 #include <algorithm>
+#include <functional>
+#include <numeric>
+#include <sstream>
 
 namespace ns3
 {
@@ -92,6 +96,21 @@ operator==(const Ipv6FlowClassifier::FiveTuple& t1, const Ipv6FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+std::size_t
+Ipv6FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t ports = (uint64_t(tuple.protocol) << 32) | (uint32_t(tuple.sourcePort) << 16) |
+                     tuple.destinationPort;
+    std::size_t hash = Ipv6AddressHash()(tuple.sourceAddress);
+    std::size_t values[] = {Ipv6AddressHash()(tuple.destinationAddress),
+                            std::hash<uint64_t>()(ports)};
+    for (std::size_t value : values)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
 Ipv6FlowClassifier::Ipv6FlowClassifier()
 {
 }
@@ -146,36 +165,42 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
     tuple.destinationPort = dstPort;
 
     // try to insert the tuple, but check if it already exists
-    std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert =
-        m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
+    auto insert = m_flowMap.try_emplace(tuple, 0);
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
+        NS_ASSERT(newFlowId == m_flows.size() + 1);
         insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        m_flows.push_back({tuple, 0, {}});
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        m_flows[insert.first->second - 1].lastPacketId++;
     }
+    FlowInfo& flow = m_flows[insert.first->second - 1];
 
     // increment the counter of packets with the same DSCP value
     Ipv6Header::DscpType dscp = ipHeader.GetDscp();
-    std::pair<std::map<Ipv6Header::DscpType, uint32_t>::iterator, bool> dscpInserter =
-        m_flowDscpMap[insert.first->second].insert(
-            std::pair<Ipv6Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
+    auto dscpCount = std::lower_bound(flow.dscpCounts.begin(),
+                                      flow.dscpCounts.end(),
+                                      dscp,
+                                      [](const std::pair<Ipv6Header::DscpType, uint32_t>& count,
+                                         Ipv6Header::DscpType value) {
+                                          return count.first < value;
+                                      });
+    if (dscpCount == flow.dscpCounts.end() || dscpCount->first != dscp)
     {
-        m_flowDscpMap[insert.first->second][dscp]++;
+        flow.dscpCounts.emplace(dscpCount, dscp, 1);
+    }
+    else
+    {
+        dscpCount->second++;
     }
 
     *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_packetId = flow.lastPacketId;
 
     return true;
 }
@@ -183,18 +208,11 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow(FlowId flowId) const
 {
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    if (flowId == 0 || flowId > m_flows.size())
     {
-        if (iter->second == flowId)
-        {
-            return iter->first;
-        }
+        NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
-    NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
-    FiveTuple retval = {Ipv6Address::GetZero(), Ipv6Address::GetZero(), 0, 0, 0};
-    return retval;
+    return m_flows[flowId - 1].tuple;
 }
 
 bool
@@ -207,16 +225,12 @@ Ipv6FlowClassifier::SortByCount::operator()(std::pair<Ipv6Header::DscpType, uint
 std::vector<std::pair<Ipv6Header::DscpType, uint32_t>>
 Ipv6FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>>::const_iterator flow =
-        m_flowDscpMap.find(flowId);
-
-    if (flow == m_flowDscpMap.end())
+    if (flowId == 0 || flowId > m_flows.size())
     {
         NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
 
-    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v(flow->second.begin(),
-                                                             flow->second.end());
+    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v = m_flows[flowId - 1].dscpCounts;
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -227,33 +241,31 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv6FlowClassifier>\n";
 
+    // the flows are written in the order of their FiveTuples
+    std::vector<FlowId> flowIds(m_flows.size());
+    std::iota(flowIds.begin(), flowIds.end(), 1);
+    std::sort(flowIds.begin(), flowIds.end(), [this](FlowId a, FlowId b) {
+        return m_flows[a - 1].tuple < m_flows[b - 1].tuple;
+    });
+
     indent += 2;
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    for (FlowId flowId : flowIds)
     {
+        const FlowInfo& flow = m_flows[flowId - 1];
         Indent(os, indent);
-        os << "<Flow flowId=\"" << iter->second << "\""
-           << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-           << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-           << " protocol=\"" << int(iter->first.protocol) << "\""
-           << " sourcePort=\"" << iter->first.sourcePort << "\""
-           << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+        os << "<Flow flowId=\"" << flowId << "\""
+           << " sourceAddress=\"" << flow.tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow.tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow.tuple.protocol) << "\""
+           << " sourcePort=\"" << flow.tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow.tuple.destinationPort << "\">\n";
 
         indent += 2;
-        std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>>::const_iterator flow =
-            m_flowDscpMap.find(iter->second);
-
-        if (flow != m_flowDscpMap.end())
+        for (const auto& dscpCount : flow.dscpCounts)
         {
-            for (std::map<Ipv6Header::DscpType, uint32_t>::const_iterator i = flow->second.begin();
-                 i != flow->second.end();
-                 i++)
-            {
-                Indent(os, indent);
-                os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
-                   << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(dscpCount.first) << "\""
+               << " packets=\"" << std::dec << dscpCount.second << "\" />\n";
         }
 
         indent -= 2;
@@ -266,4 +278,40 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "</Ipv6FlowClassifier>\n";
 }
 
+void
+Ipv6FlowClassifier::SerializeToColumnarFile(ColumnarFileWriter& writer) const
+{
+    ColumnarFileWriter::Table& flows =
+        writer.AddTable("ipv6Flows",
+                        {{"flowId", ColumnarFileWriter::UINT64},
+                         {"sourceAddress", ColumnarFileWriter::STRING},
+                         {"destinationAddress", ColumnarFileWriter::STRING},
+                         {"protocol", ColumnarFileWriter::UINT64},
+                         {"sourcePort", ColumnarFileWriter::UINT64},
+                         {"destinationPort", ColumnarFileWriter::UINT64}});
+    ColumnarFileWriter::Table& dscps = writer.AddTable("ipv6Dscp",
+                                                       {{"flowId", ColumnarFileWriter::UINT64},
+                                                        {"dscp", ColumnarFileWriter::UINT64},
+                                                        {"packets", ColumnarFileWriter::UINT64}});
+    for (FlowId flowId = 1; flowId <= m_flows.size(); flowId++)
+    {
+        const FlowInfo& flow = m_flows[flowId - 1];
+        std::ostringstream source;
+        std::ostringstream destination;
+        source << flow.tuple.sourceAddress;
+        destination << flow.tuple.destinationAddress;
+        flows.AddUint(flowId)
+            .AddString(source.str())
+            .AddString(destination.str())
+            .AddUint(flow.tuple.protocol)
+            .AddUint(flow.tuple.sourcePort)
+            .AddUint(flow.tuple.destinationPort)
+            .EndRow();
+        for (const auto& dscpCount : flow.dscpCounts)
+        {
+            dscps.AddUint(flowId).AddUint(dscpCount.first).AddUint(dscpCount.second).EndRow();
+        }
+    }
+}
+
 } // namespace ns3
@@ -24,8 +24,9 @@
 #include "ns3/flow-classifier.h"
 #include "ns3/ipv6-header.h"
 
-#include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -92,13 +93,34 @@ class Ipv6FlowClassifier : public FlowClassifier
 
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
+    /// Serializes the flows to the "ipv6Flows" table (flowId and the
+    /// FiveTuple) and their DSCP counts to the "ipv6Dscp" table (flowId,
+    /// DSCP value and number of packets).
+    /// \param writer the columnar file writer
+    void SerializeToColumnarFile(ColumnarFileWriter& writer) const override;
+
   private:
+    /// Hash function of the FiveTuples
+    struct FiveTupleHash
+    {
+        /// \param tuple the FiveTuple to hash
+        /// \return the hash of the FiveTuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
+    /// The data of a flow
+    struct FlowInfo
+    {
+        FiveTuple tuple;           //!< The FiveTuple of the flow
+        FlowPacketId lastPacketId; //!< The FlowPacketId of the last packet of the flow
+        /// (DSCP value, packet count) pairs, sorted by DSCP value
+        std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> dscpCounts;
+    };
+
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// The data of the flows, indexed by FlowId - 1
+    std::vector<FlowInfo> m_flows;
 };
 
 /**
@@ -86,6 +86,8 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      * Users must first call PopulateRoutingTables() and then may subsequently
      * call RecomputeRoutingTables() at any later time in the simulation.
      *
+     * If the "GlobalRoutingIncremental" global value is set, only the nodes
+     * whose routes depend on a modified part of the topology recompute them.
      */
     static void RecomputeRoutingTables();
 };
@@ -29,14 +29,20 @@
 #include "ipv4.h"
 
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -45,6 +51,28 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * The number of threads running the SPF calculations of the routers.
+ */
+static GlobalValue g_globalRoutingThreads =
+    GlobalValue("GlobalRoutingThreads",
+                "The number of threads running the SPF calculations of the global routers "
+                "(0 for one thread per hardware thread)",
+                UintegerValue(1),
+                MakeUintegerChecker<uint32_t>());
+
+/**
+ * \ingroup globalrouting
+ * Whether the global routes are recomputed incrementally.
+ */
+static GlobalValue g_globalRoutingIncremental =
+    GlobalValue("GlobalRoutingIncremental",
+                "Only recompute the routes of the global routers whose shortest path tree "
+                "depends on a modified Link State Advertisement when the topology changes",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -473,9 +501,25 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
         m_extdatabase.push_back(lsa);
     }
-    else
+    else if (m_database.insert(LSDBPair_t(addr, lsa)).second)
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            auto it = m_linkDataIndex.find(lr->GetLinkData());
+            if (it == m_linkDataIndex.end())
+            {
+                m_linkDataIndex.insert({lr->GetLinkData(), LSDBPair_t(addr, lsa)});
+            }
+            else if (addr < it->second.first)
+            {
+                it->second = LSDBPair_t(addr, lsa);
+            }
+        }
     }
 }
 
@@ -500,13 +544,10 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    LSDBMap_t::const_iterator i;
-    for (i = m_database.begin(); i != m_database.end(); i++)
+    LSDBMap_t::const_iterator i = m_database.find(addr);
+    if (i != m_database.end())
     {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
+        return i->second;
     }
     return nullptr;
 }
@@ -516,24 +557,116 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the LinkData of one of its TransitNetwork link records.
     //
-    LSDBMap_t::const_iterator i;
-    for (i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_linkDataIndex.find(addr);
+    if (i != m_linkDataIndex.end())
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
+        return i->second.second;
+    }
+    return nullptr;
+}
+
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Copy() const
+{
+    NS_LOG_FUNCTION(this);
+    GlobalRouteManagerLSDB* lsdb = new GlobalRouteManagerLSDB();
+    for (const auto& entry : m_database)
+    {
+        GlobalRoutingLSA* lsa = new GlobalRoutingLSA();
+        *lsa = *entry.second;
+        lsdb->Insert(entry.first, lsa);
+    }
+    for (GlobalRoutingLSA* extlsa : m_extdatabase)
+    {
+        GlobalRoutingLSA* lsa = new GlobalRoutingLSA();
+        *lsa = *extlsa;
+        lsdb->Insert(lsa->GetLinkStateId(), lsa);
+    }
+    return lsdb;
+}
+
+bool
+GlobalRouteManagerLSDB::IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b)
+{
+    if (a->GetLSType() != b->GetLSType() || a->GetLinkStateId() != b->GetLinkStateId() ||
+        a->GetAdvertisingRouter() != b->GetAdvertisingRouter() ||
+        a->GetNetworkLSANetworkMask() != b->GetNetworkLSANetworkMask() ||
+        a->GetNLinkRecords() != b->GetNLinkRecords() ||
+        a->GetNAttachedRouters() != b->GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* la = a->GetLinkRecord(i);
+        GlobalRoutingLinkRecord* lb = b->GetLinkRecord(i);
+        if (la->GetLinkType() != lb->GetLinkType() || la->GetLinkId() != lb->GetLinkId() ||
+            la->GetLinkData() != lb->GetLinkData() || la->GetMetric() != lb->GetMetric())
         {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < a->GetNAttachedRouters(); i++)
+    {
+        if (a->GetAttachedRouter(i) != b->GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::set<Ipv4Address>
+GlobalRouteManagerLSDB::GetChangedLSAs(const GlobalRouteManagerLSDB* other) const
+{
+    NS_LOG_FUNCTION(this << other);
+    std::set<Ipv4Address> changed;
+    // Both maps are sorted by address: merge them.
+    auto i = m_database.begin();
+    auto j = other->m_database.begin();
+    while (i != m_database.end() || j != other->m_database.end())
+    {
+        if (j == other->m_database.end() || (i != m_database.end() && i->first < j->first))
+        {
+            changed.insert(i->first);
+            i++;
+        }
+        else if (i == m_database.end() || j->first < i->first)
+        {
+            changed.insert(j->first);
+            j++;
+        }
+        else
+        {
+            if (!IsSameLSA(i->second, j->second))
             {
-                return temp;
+                changed.insert(i->first);
             }
+            i++;
+            j++;
         }
     }
-    return nullptr;
+    return changed;
+}
+
+bool
+GlobalRouteManagerLSDB::HasSameExtLSAs(const GlobalRouteManagerLSDB* other) const
+{
+    NS_LOG_FUNCTION(this << other);
+    if (m_extdatabase.size() != other->m_extdatabase.size())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < m_extdatabase.size(); i++)
+    {
+        if (!IsSameLSA(m_extdatabase[i], other->m_extdatabase[i]))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -543,7 +676,8 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_spfroot(nullptr),
+      m_spfrootIpv4(nullptr)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
@@ -569,6 +703,20 @@ GlobalRouteManagerImpl::DebugUseLsdb(GlobalRouteManagerLSDB* lsdb)
     m_lsdb = lsdb;
 }
 
+void
+GlobalRouteManagerImpl::DeleteRoutes(Ptr<Ipv4GlobalRouting> gr)
+{
+    NS_LOG_FUNCTION(gr);
+    uint32_t nRoutes = gr->GetNRoutes();
+    // Each time we delete route 0, the route index shifts downward
+    // We can delete all routes if we delete the route numbered 0
+    // nRoutes times
+    for (uint32_t j = 0; j < nRoutes; j++)
+    {
+        gr->RemoveRoute(0);
+    }
+}
+
 void
 GlobalRouteManagerImpl::DeleteGlobalRoutes()
 {
@@ -582,20 +730,10 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         {
             continue;
         }
-        Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-        uint32_t j = 0;
-        uint32_t nRoutes = gr->GetNRoutes();
-        NS_LOG_LOGIC("Deleting " << gr->GetNRoutes() << " routes from node " << node->GetId());
-        // Each time we delete route 0, the route index shifts downward
-        // We can delete all routes if we delete the route numbered 0
-        // nRoutes times
-        for (j = 0; j < nRoutes; j++)
-        {
-            NS_LOG_LOGIC("Deleting global route " << j << " from node " << node->GetId());
-            gr->RemoveRoute(0);
-        }
-        NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
+        NS_LOG_LOGIC("Deleting global routes from node " << node->GetId());
+        DeleteRoutes(router->GetRoutingProtocol());
     }
+    m_dependencies.clear();
     if (m_lsdb)
     {
         NS_LOG_LOGIC("Deleting LSDB, creating new one");
@@ -700,10 +838,20 @@ void
 GlobalRouteManagerImpl::InitializeRoutes()
 {
     NS_LOG_FUNCTION(this);
+    NS_LOG_INFO("About to start SPF calculation");
+    m_dependencies.clear();
+    ComputeRoutes(GetRouters());
+    NS_LOG_INFO("Finished SPF calculation");
+}
+
+std::vector<GlobalRouteManagerImpl::Router>
+GlobalRouteManagerImpl::GetRouters() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Router> routers;
     //
     // Walk the list of nodes in the system.
     //
-    NS_LOG_INFO("About to start SPF calculation");
     NodeList::Iterator listEnd = NodeList::End();
     for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
     {
@@ -727,10 +875,182 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+            NS_ASSERT_MSG(ipv4,
+                          "GlobalRouteManagerImpl::GetRouters (): "
+                          "GetObject for <Ipv4> interface failed");
+            routers.push_back({rtr->GetRouterId(), ipv4, rtr->GetRoutingProtocol()});
+        }
+    }
+    return routers;
+}
+
+void
+GlobalRouteManagerImpl::ComputeRoutes(const std::vector<Router>& routers)
+{
+    NS_LOG_FUNCTION(this << routers.size());
+    UintegerValue threadsValue;
+    g_globalRoutingThreads.GetValue(threadsValue);
+    uint32_t nThreads = threadsValue.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<std::size_t>(nThreads, routers.size());
+    BooleanValue incremental;
+    g_globalRoutingIncremental.GetValue(incremental);
+
+    if (nThreads <= 1)
+    {
+        for (const auto& router : routers)
+        {
+            m_spfrootIpv4 = PeekPointer(router.ipv4);
+            SPFCalculate(router.id);
+            InstallRoutes(router, m_routes);
+            if (incremental.Get())
+            {
+                m_dependencies[router.id].assign(m_spfLSAs.begin(), m_spfLSAs.end());
+            }
+        }
+        m_spfrootIpv4 = nullptr;
+        m_routes.clear();
+        m_spfLSAs.clear();
+        return;
+    }
+
+    //
+    // The SPF calculation stores its state in the LSDB and in the members of the
+    // GlobalRouteManagerImpl, hence each thread uses its own GlobalRouteManagerImpl,
+    // working on a copy of the LSDB.  The threads only read the Ipv4 of their
+    // root node, through a raw pointer, since the reference counts may not be
+    // thread-safe.
+    //
+    std::vector<std::unique_ptr<GlobalRouteManagerImpl>> workers;
+    for (uint32_t i = 0; i < nThreads; i++)
+    {
+        workers.push_back(std::make_unique<GlobalRouteManagerImpl>());
+        workers.back()->DebugUseLsdb(m_lsdb->Copy());
+    }
+    std::vector<std::vector<SPFRoute>> routes(routers.size());
+    std::vector<std::vector<Ipv4Address>> dependencies(routers.size());
+    std::atomic<std::size_t> next(0);
+    auto run = [&](GlobalRouteManagerImpl* worker) {
+        for (std::size_t i = next++; i < routers.size(); i = next++)
+        {
+            worker->m_spfrootIpv4 = PeekPointer(routers[i].ipv4);
+            worker->SPFCalculate(routers[i].id);
+            routes[i].swap(worker->m_routes);
+            dependencies[i].assign(worker->m_spfLSAs.begin(), worker->m_spfLSAs.end());
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(run, workers[i].get());
+    }
+    run(workers[0].get());
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < routers.size(); i++)
+    {
+        InstallRoutes(routers[i], routes[i]);
+        if (incremental.Get())
+        {
+            m_dependencies[routers[i].id].swap(dependencies[i]);
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes(const Router& router, const std::vector<SPFRoute>& routes)
+{
+    NS_LOG_FUNCTION(router.id << routes.size());
+    for (const auto& route : routes)
+    {
+        switch (route.type)
+        {
+        case SPFRoute::HOST:
+            router.routing->AddHostRouteTo(route.dest, route.nextHop, route.outIf);
+            break;
+        case SPFRoute::NETWORK:
+            router.routing->AddNetworkRouteTo(route.dest, route.mask, route.nextHop, route.outIf);
+            break;
+        case SPFRoute::AS_EXTERNAL:
+            router.routing->AddASExternalRouteTo(route.dest,
+                                                 route.mask,
+                                                 route.nextHop,
+                                                 route.outIf);
+            break;
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::RecomputeRoutingTables()
+{
+    NS_LOG_FUNCTION(this);
+    BooleanValue incremental;
+    g_globalRoutingIncremental.GetValue(incremental);
+    if (!incremental.Get() || m_dependencies.empty())
+    {
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+
+    GlobalRouteManagerLSDB* previous = m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+    std::set<Ipv4Address> changed = m_lsdb->GetChangedLSAs(previous);
+    bool extChanged = !m_lsdb->HasSameExtLSAs(previous);
+    delete previous;
+    NS_LOG_LOGIC(changed.size() << " LSAs changed, external LSAs changed: " << extChanged);
+
+    //
+    // A router has to recompute its routes if its last SPF calculation read
+    // one of the modified LSAs.  The routers whose tree did not reach a
+    // modified LSA keep their routes.
+    //
+    std::vector<Router> affected;
+    std::map<Ipv4Address, std::vector<Ipv4Address>> unaffected;
+    for (const auto& router : GetRouters())
+    {
+        auto it = m_dependencies.find(router.id);
+        if (!extChanged && it != m_dependencies.end())
+        {
+            const std::vector<Ipv4Address>& lsas = it->second;
+            bool depends = std::any_of(changed.begin(), changed.end(), [&lsas](Ipv4Address id) {
+                return std::binary_search(lsas.begin(), lsas.end(), id);
+            });
+            if (!depends)
+            {
+                unaffected[router.id].swap(it->second);
+                continue;
+            }
+        }
+        affected.push_back(router);
+    }
+    NS_LOG_INFO("Recomputing the routes of " << affected.size() << " routers");
+
+    //
+    // Delete the routes of the affected routers, and of the nodes which are no
+    // longer taking part in the SPF calculation.
+    //
+    NodeList::Iterator listEnd = NodeList::End();
+    for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
+    {
+        Ptr<GlobalRouter> router = (*i)->GetObject<GlobalRouter>();
+        if (router && unaffected.find(router->GetRouterId()) == unaffected.end())
+        {
+            DeleteRoutes(router->GetRoutingProtocol());
+        }
+    }
+    m_dependencies.swap(unaffected);
+    ComputeRoutes(affected);
 }
 
 //
@@ -1243,7 +1563,19 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
+    std::vector<Router> routers = GetRouters();
+    auto router = std::find_if(routers.begin(), routers.end(), [root](const Router& r) {
+        return r.id == root;
+    });
+    m_spfrootIpv4 = router != routers.end() ? PeekPointer(router->ipv4) : nullptr;
     SPFCalculate(root);
+    if (router != routers.end())
+    {
+        InstallRoutes(*router, m_routes);
+    }
+    m_spfrootIpv4 = nullptr;
+    m_routes.clear();
+    m_spfLSAs.clear();
 }
 
 //
@@ -1300,6 +1632,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
             // Install default route to next hop
             // The link record LinkID is the router ID of the peer.
             // The Link Data is the local IP interface address
+            m_spfLSAs.insert(transitLink->GetLinkId());
             GlobalRoutingLSA* w_lsa = m_lsdb->GetLSA(transitLink->GetLinkId());
             uint32_t nLinkRecords = w_lsa->GetNLinkRecords();
             for (uint32_t j = 0; j < nLinkRecords; ++j)
@@ -1316,18 +1649,15 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                    NS_ASSERT(gr);
-                    gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
-                                          Ipv4Mask("0.0.0.0"),
-                                          lr->GetLinkData(),
-                                          FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                    int32_t outIf = FindOutgoingInterfaceId(transitLink->GetLinkData());
+                    m_routes.push_back({SPFRoute::NETWORK,
+                                        Ipv4Address("0.0.0.0"),
+                                        Ipv4Mask("0.0.0.0"),
+                                        lr->GetLinkData(),
+                                        static_cast<uint32_t>(outIf)});
                     NS_LOG_LOGIC("Inserting default route for node "
                                  << myRouterId << " to next hop " << lr->GetLinkData()
-                                 << " via interface "
-                                 << FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                                 << " via interface " << outIf);
                     return true;
                 }
             }
@@ -1344,6 +1674,13 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 
     SPFVertex* v;
     //
+    // The routes are buffered in m_routes, to be installed by the caller, and
+    // the LSAs read by the calculation are recorded in m_spfLSAs.
+    //
+    m_routes.clear();
+    m_spfLSAs.clear();
+    m_spfLSAs.insert(root);
+    //
     // Initialize the Link State Database.
     //
     m_lsdb->Initialize();
@@ -1376,7 +1713,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (m_spfrootIpv4 && CheckForStubNode(root))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
         delete m_spfroot;
@@ -1385,6 +1722,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 
     for (;;)
     {
+        SPFAddDependencies(v);
         //
         // The operations we need to do are given in the OSPF RFC which we reference
         // as we go along.
@@ -1552,110 +1890,17 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
     }
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
-
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Add a route to the external network, using the next hops and outgoing
+    // interfaces the root node uses to reach the advertising router 'v'.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
-        {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
-        }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+    SPFAddRoute(SPFRoute::AS_EXTERNAL, tempip, tempmask, v);
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
@@ -1712,116 +1957,17 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
         return;
     }
     NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // Add a route to the stub network, using the next hops and outgoing
+    // interfaces the root node uses to reach the stub network gateway 'v'.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
-        {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
-        }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+    SPFAddRoute(SPFRoute::NETWORK, tempip, tempmask, v);
 }
 
 //
@@ -1836,69 +1982,19 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
 {
     NS_LOG_FUNCTION(this << a << amask);
     //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    // We have an IP address <a> and the Ipv4 of the node at the root of the
+    // SPF tree, which the caller of SPFCalculate () looked up.  Look through
+    // the interfaces on this node for one that has the IP address we're
+    // looking for.  If we find one, return the corresponding interface index,
+    // or -1 if not found.
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
-    //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    if (!m_spfrootIpv4)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
-        }
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node "
+                     << m_spfroot->GetVertexId());
+        return -1;
     }
-    //
-    // Couldn't find it.
-    //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
-    return -1;
+    return m_spfrootIpv4->GetInterfaceForPrefix(a, amask);
 }
 
 //
@@ -1924,140 +2020,46 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
 
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    NS_LOG_LOGIC(" Root " << m_spfroot->GetVertexId() << " found " << nLinkRecords
+                          << " link records in LSA " << lsa << "with LinkStateId "
+                          << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // We're going to add a host route to the host address found in the
+        // m_linkData field of the point-to-point link record.  In the case of a
+        // point-to-point link, this is the local IP address of the node connected
+        // to the link.  The vertex <v> has the next hops and outgoing interfaces
+        // precalculated for us, possibly inherited from the root.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
-            }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+        SPFAddRoute(SPFRoute::HOST, lr->GetLinkData(), Ipv4Mask::GetOnes(), v);
     }
 }
 
@@ -2068,100 +2070,78 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
 
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  This is the network LSA of a transit network.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    SPFAddRoute(SPFRoute::NETWORK, tempip, tempmask, v);
+}
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+void
+GlobalRouteManagerImpl::SPFAddRoute(SPFRoute::Type type,
+                                    Ipv4Address dest,
+                                    Ipv4Mask mask,
+                                    SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << type << dest << mask << v);
+    // walk through all available exit directions due to ECMP,
+    // and add a route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            m_routes.push_back({type, dest, mask, nextHop, static_cast<uint32_t>(outIf)});
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " add route to " << dest << "/" << mask
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
+        else
+        {
+            NS_LOG_LOGIC("(Route " << i << ") Root " << m_spfroot->GetVertexId()
+                                   << " NOT able to add route to " << dest << "/" << mask
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
+        }
+    }
+}
 
-        if (rtr->GetRouterId() == routerId)
+void
+GlobalRouteManagerImpl::SPFAddDependencies(SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    m_spfLSAs.insert(lsa->GetLinkStateId());
+    if (v->GetVertexType() == SPFVertex::VertexRouter)
+    {
+        for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
+            GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+            if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint ||
+                l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
             {
-                continue;
+                m_spfLSAs.insert(l->GetLinkId());
             }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < lsa->GetNAttachedRouters(); i++)
+        {
+            GlobalRoutingLSA* w_lsa = m_lsdb->GetLSAByLinkData(lsa->GetAttachedRouter(i));
+            if (w_lsa)
             {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
+                m_spfLSAs.insert(w_lsa->GetLinkStateId());
             }
         }
     }
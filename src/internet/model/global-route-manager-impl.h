@@ -30,6 +30,7 @@
 #include <list>
 #include <map>
 #include <queue>
+#include <set>
 #include <stdint.h>
 #include <vector>
 
@@ -39,6 +40,7 @@ namespace ns3
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -672,7 +674,48 @@ class GlobalRouteManagerLSDB
      */
     uint32_t GetNumExtLSAs() const;
 
+    /**
+     * @brief Copy the database.
+     *
+     * The SPF computation stores its state in the Link State Advertisements,
+     * hence concurrent computations need their own copy of the database.
+     *
+     * @returns A new database holding a copy of each Link State Advertisement,
+     * to be deleted by the caller.
+     */
+    GlobalRouteManagerLSDB* Copy() const;
+
+    /**
+     * @brief Compare the Link State Advertisements with the ones of another
+     * database.
+     *
+     * @param other The other database.
+     * @returns The link state IDs of the Link State Advertisements which are
+     * present in only one of the databases or differ between them.
+     */
+    std::set<Ipv4Address> GetChangedLSAs(const GlobalRouteManagerLSDB* other) const;
+
+    /**
+     * @brief Compare the External Link State Advertisements with the ones of
+     * another database.
+     *
+     * @param other The other database.
+     * @returns true if both databases hold the same External Link State
+     * Advertisements, in the same order.
+     */
+    bool HasSameExtLSAs(const GlobalRouteManagerLSDB* other) const;
+
   private:
+    /**
+     * @brief Compare the content of two Link State Advertisements, regardless
+     * of their SPF status.
+     *
+     * @param a A Link State Advertisement.
+     * @param b Another Link State Advertisement.
+     * @returns true if the Link State Advertisements are the same.
+     */
+    static bool IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b);
+
     typedef std::map<Ipv4Address, GlobalRoutingLSA*>
         LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
     typedef std::pair<Ipv4Address, GlobalRoutingLSA*>
@@ -681,6 +724,12 @@ class GlobalRouteManagerLSDB
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
+    /**
+     * Index of the LinkData fields of the TransitNetwork link records: for each
+     * address, the first entry of the database, in address order, holding a
+     * TransitNetwork link record with this LinkData.
+     */
+    std::map<Ipv4Address, LSDBPair_t> m_linkDataIndex;
 };
 
 /**
@@ -725,6 +774,18 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Recompute the routes after a change of the topology.
+     *
+     * If the "GlobalRoutingIncremental" global value is set and the routes
+     * were computed before, the routing database is rebuilt and compared
+     * with the previous one; only the routers whose previous SPF computation
+     * read a modified Link State Advertisement recompute their routes.
+     * Otherwise, this is equivalent to DeleteGlobalRoutes (),
+     * BuildGlobalRoutingDatabase () and InitializeRoutes ().
+     */
+    virtual void RecomputeRoutingTables();
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -738,8 +799,96 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
+    /// A route computed by the SPF calculation, to be installed on the root node.
+    struct SPFRoute
+    {
+        /// The kind of route
+        enum Type
+        {
+            HOST,       //!< Host route
+            NETWORK,    //!< Network route
+            AS_EXTERNAL //!< External network route
+        };
+
+        Type type;           //!< The kind of route
+        Ipv4Address dest;    //!< The destination
+        Ipv4Mask mask;       //!< The destination mask, unused for host routes
+        Ipv4Address nextHop; //!< The next hop
+        uint32_t outIf;      //!< The outgoing interface
+    };
+
+    /// A node running the SPF calculation.
+    struct Router
+    {
+        Ipv4Address id;                 //!< The router ID
+        Ptr<Ipv4> ipv4;                 //!< The Ipv4 of the node
+        Ptr<Ipv4GlobalRouting> routing; //!< The routing protocol of the node
+    };
+
     SPFVertex* m_spfroot;           //!< the root node
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    Ipv4* m_spfrootIpv4;            //!< the Ipv4 of the root node, if any
+    std::vector<SPFRoute> m_routes; //!< the routes computed for the root node
+    std::set<Ipv4Address> m_spfLSAs; //!< the LSAs read by the SPF calculation of the root node
+    /**
+     * For each router, the link state IDs of the LSAs read by its last SPF
+     * calculation, in increasing order. Only kept for incremental updates.
+     */
+    std::map<Ipv4Address, std::vector<Ipv4Address>> m_dependencies;
+
+    /**
+     * \brief Get the nodes taking part in the SPF calculation, i.e., the global
+     * routers of this system having some Link State Advertisements.
+     *
+     * \returns The routers, in the order of the NodeList.
+     */
+    std::vector<Router> GetRouters() const;
+
+    /**
+     * \brief Run the SPF calculation of some routers and install their routes.
+     *
+     * The calculations are spread over the number of threads set by the
+     * "GlobalRoutingThreads" global value, each thread using its own copy of
+     * the LSDB. The routes are installed by the calling thread, in the order
+     * of the routers, hence the routing tables do not depend on the number
+     * of threads.
+     *
+     * \param routers The routers.
+     */
+    void ComputeRoutes(const std::vector<Router>& routers);
+
+    /**
+     * \brief Install the routes computed by the SPF calculation of a router.
+     *
+     * \param router The router.
+     * \param routes The routes.
+     */
+    static void InstallRoutes(const Router& router, const std::vector<SPFRoute>& routes);
+
+    /**
+     * \brief Delete all the routes of a global routing protocol.
+     *
+     * \param gr The routing protocol.
+     */
+    static void DeleteRoutes(Ptr<Ipv4GlobalRouting> gr);
+
+    /**
+     * \brief Add a route towards a vertex, for each of its root exit directions.
+     *
+     * \param type The kind of route.
+     * \param dest The destination.
+     * \param mask The destination mask.
+     * \param v The vertex the destination is reached through.
+     */
+    void SPFAddRoute(SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask, SPFVertex* v);
+
+    /**
+     * \brief Record the LSAs read by SPFNext () when examining the links of
+     * a vertex: the LSA of the vertex and the LSAs of its neighbors.
+     *
+     * \param v The vertex.
+     */
+    void SPFAddDependencies(SPFVertex* v);
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -57,6 +57,13 @@ GlobalRouteManager::InitializeRoutes()
     SimulationSingleton<GlobalRouteManagerImpl>::Get()->InitializeRoutes();
 }
 
+void
+GlobalRouteManager::RecomputeRoutingTables()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->RecomputeRoutingTables();
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId()
 {
@@ -70,6 +70,16 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Recompute the routes after a change of the topology.
+     *
+     * Equivalent to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+     * InitializeRoutes (), unless the "GlobalRoutingIncremental" global value
+     * is set, in which case only the routers whose shortest path tree depends
+     * on a modified Link State Advertisement recompute their routes.
+     */
+    static void RecomputeRoutingTables();
 };
 
 } // namespace ns3
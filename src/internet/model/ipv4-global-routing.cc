@@ -30,6 +30,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -64,7 +65,8 @@ Ipv4GlobalRouting::GetTypeId()
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_routeRank(0)
 {
     NS_LOG_FUNCTION(this);
 
@@ -83,6 +85,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    IndexRoute(m_hostRoutesIndex, route);
 }
 
 void
@@ -92,6 +95,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    IndexRoute(m_hostRoutesIndex, route);
 }
 
 void
@@ -104,6 +108,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    IndexRoute(m_networkRoutesIndex, route);
 }
 
 void
@@ -113,6 +118,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    IndexRoute(m_networkRoutesIndex, route);
 }
 
 void
@@ -125,6 +131,58 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_ASexternalRoutes.push_back(route);
+    IndexRoute(m_ASexternalRoutesIndex, route);
+}
+
+void
+Ipv4GlobalRouting::IndexRoute(RouteIndex& index, Ipv4RoutingTableEntry* route)
+{
+    NS_LOG_FUNCTION(this << route);
+    index.Insert(RouteIndex::GetKey(route->GetDestNetwork()),
+                 RouteIndex::GetLength(route->GetDestNetworkMask()),
+                 {m_routeRank++, route});
+}
+
+void
+Ipv4GlobalRouting::UnindexRoute(RouteIndex& index, Ipv4RoutingTableEntry* route)
+{
+    NS_LOG_FUNCTION(this << route);
+    [[maybe_unused]] bool removed =
+        index.Remove(RouteIndex::GetKey(route->GetDestNetwork()),
+                     RouteIndex::GetLength(route->GetDestNetworkMask()),
+                     [route](const IndexedRoute& r) { return r.route == route; });
+    NS_ASSERT(removed);
+}
+
+std::vector<Ipv4RoutingTableEntry*>
+Ipv4GlobalRouting::FindRoutes(const RouteIndex& index, Ipv4Address dest, Ptr<NetDevice> oif) const
+{
+    NS_LOG_FUNCTION(this << dest << oif);
+    // The index is keyed by the leading ones of the masks: check the full mask of the routes
+    std::vector<IndexedRoute> matches;
+    index.ForEachMatch(RouteIndex::GetKey(dest), [&](uint8_t, const IndexedRoute& r) {
+        if (!r.route->GetDestNetworkMask().IsMatch(dest, r.route->GetDestNetwork()))
+        {
+            return;
+        }
+        if (oif && oif != m_ipv4->GetNetDevice(r.route->GetInterface()))
+        {
+            NS_LOG_LOGIC("Not on requested interface, skipping");
+            return;
+        }
+        matches.push_back(r);
+    });
+    std::sort(matches.begin(), matches.end(), [](const IndexedRoute& a, const IndexedRoute& b) {
+        return a.rank < b.rank;
+    });
+    std::vector<Ipv4RoutingTableEntry*> routes;
+    routes.reserve(matches.size());
+    for (const auto& match : matches)
+    {
+        NS_LOG_LOGIC("Found global route " << match.route);
+        routes.push_back(match.route);
+    }
+    return routes;
 }
 
 Ptr<Ipv4Route>
@@ -138,65 +196,19 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     RouteVec_t allRoutes;
 
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (HostRoutesCI i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
-    {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
-        {
-            if (oif)
-            {
-                if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
-            }
-            allRoutes.push_back(*i);
-            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
-        }
-    }
+    allRoutes = FindRoutes(m_hostRoutesIndex, dest, oif);
     if (allRoutes.empty()) // if no host route is found
     {
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
-        {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
-            {
-                if (oif)
-                {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
-                }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
-            }
-        }
+        allRoutes = FindRoutes(m_networkRoutesIndex, dest, oif);
     }
     if (allRoutes.empty()) // consider external if no host/network found
     {
-        for (ASExternalRoutesI k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
+        allRoutes = FindRoutes(m_ASexternalRoutesIndex, dest, oif);
+        if (!allRoutes.empty())
         {
-            Ipv4Mask mask = (*k)->GetDestNetworkMask();
-            Ipv4Address entry = (*k)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
-            {
-                NS_LOG_LOGIC("Found external route" << *k);
-                if (oif)
-                {
-                    if (oif != m_ipv4->GetNetDevice((*k)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
-                }
-                allRoutes.push_back(*k);
-                break;
-            }
+            NS_LOG_LOGIC("Found external route" << allRoutes.front());
+            allRoutes.resize(1);
         }
     }
     if (!allRoutes.empty()) // if route(s) is found
@@ -297,6 +309,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             if (tmp == index)
             {
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
+                UnindexRoute(m_hostRoutesIndex, *i);
                 delete *i;
                 m_hostRoutes.erase(i);
                 NS_LOG_LOGIC("Done removing host route "
@@ -313,6 +326,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
+            UnindexRoute(m_networkRoutesIndex, *j);
             delete *j;
             m_networkRoutes.erase(j);
             NS_LOG_LOGIC("Done removing network route "
@@ -328,6 +342,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
+            UnindexRoute(m_ASexternalRoutesIndex, *k);
             delete *k;
             m_ASexternalRoutes.erase(k);
             NS_LOG_LOGIC("Done removing network route "
@@ -365,6 +380,9 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_hostRoutesIndex.Clear();
+    m_networkRoutesIndex.Clear();
+    m_ASexternalRoutesIndex.Clear();
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -533,9 +551,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutingTables();
     }
 }
 
@@ -545,9 +561,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutingTables();
     }
 }
 
@@ -557,9 +571,7 @@ Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress add
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutingTables();
     }
 }
 
@@ -569,9 +581,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutingTables();
     }
 }
 
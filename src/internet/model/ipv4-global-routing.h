@@ -23,11 +23,13 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -265,6 +267,16 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
     typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
 
+    /// A route indexed by destination prefix, with its rank in its container
+    struct IndexedRoute
+    {
+        uint64_t rank;                //!< rank of the route in its container
+        Ipv4RoutingTableEntry* route; //!< the route
+    };
+
+    /// index of the routes of a container by destination prefix
+    typedef Ipv4PrefixTrie<IndexedRoute> RouteIndex;
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -273,10 +285,40 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
 
+    /**
+     * \brief Add a route to the index of its container.
+     * \param index the index
+     * \param route the route
+     */
+    void IndexRoute(RouteIndex& index, Ipv4RoutingTableEntry* route);
+
+    /**
+     * \brief Remove a route from the index of its container.
+     * \param index the index
+     * \param route the route
+     */
+    void UnindexRoute(RouteIndex& index, Ipv4RoutingTableEntry* route);
+
+    /**
+     * \brief Find the routes of an index matching a destination.
+     * \param index the index
+     * \param dest destination address
+     * \param oif output interface if any (put 0 otherwise)
+     * \return the matching routes, in the order of their container
+     */
+    std::vector<Ipv4RoutingTableEntry*> FindRoutes(const RouteIndex& index,
+                                                   Ipv4Address dest,
+                                                   Ptr<NetDevice> oif) const;
+
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    RouteIndex m_hostRoutesIndex;       //!< Routes to hosts, by destination
+    RouteIndex m_networkRoutesIndex;    //!< Routes to networks, by destination
+    RouteIndex m_ASexternalRoutesIndex; //!< External routes imported, by destination
+    uint64_t m_routeRank;               //!< Rank of the next route added
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
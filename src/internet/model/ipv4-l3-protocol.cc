@@ -36,6 +36,7 @@
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/socket.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
@@ -1015,7 +1016,10 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        // The super-segments of a segmentation offload are sent whole if their
+        // segments fit in the MTU
+        if (SegmentationOffloadTag::GetMaxSegmentSize(packet) + ipHeader.GetSerializedSize() >
+            outInterface->GetDevice()->GetMtu())
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
             DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
@@ -36,6 +36,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 
 using std::make_pair;
@@ -58,7 +59,8 @@ Ipv4StaticRouting::GetTypeId()
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting()
-    : m_ipv4(nullptr)
+    : m_routeRank(0),
+      m_ipv4(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -78,8 +80,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
 
     if (!LookupRoute(route, metric))
     {
-        Ipv4RoutingTableEntry* routePtr = new Ipv4RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv4RoutingTableEntry(route), metric);
     }
 }
 
@@ -95,9 +96,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     if (!LookupRoute(route, metric))
     {
-        Ipv4RoutingTableEntry* routePtr = new Ipv4RoutingTableEntry(route);
-
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv4RoutingTableEntry(route), metric);
     }
 }
 
@@ -152,7 +151,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Address network = Ipv4Address("224.0.0.0");
     Ipv4Mask networkMask = Ipv4Mask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
-    m_networkRoutes.emplace_back(route, 0);
+    AddRoute(route, 0);
 }
 
 uint32_t
@@ -221,22 +220,66 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
     }
 }
 
+void
+Ipv4StaticRouting::AddRoute(Ipv4RoutingTableEntry* route, uint32_t metric)
+{
+    NS_LOG_FUNCTION(this << route << metric);
+    m_networkRoutes.emplace_back(route, metric);
+    m_networkRoutesIndex.Insert(NetworkRoutesIndex::GetKey(route->GetDestNetwork()),
+                                NetworkRoutesIndex::GetLength(route->GetDestNetworkMask()),
+                                {m_routeRank++, route, metric});
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::DeleteRoute(NetworkRoutesI it)
+{
+    NS_LOG_FUNCTION(this << it->first);
+    Ipv4RoutingTableEntry* route = it->first;
+    [[maybe_unused]] bool removed =
+        m_networkRoutesIndex.Remove(NetworkRoutesIndex::GetKey(route->GetDestNetwork()),
+                                    NetworkRoutesIndex::GetLength(route->GetDestNetworkMask()),
+                                    [route](const IndexedRoute& r) { return r.route == route; });
+    NS_ASSERT(removed);
+    delete route;
+    return m_networkRoutes.erase(it);
+}
+
+std::vector<Ipv4StaticRouting::IndexedRoute>
+Ipv4StaticRouting::FindRoutes(Ipv4Address dest) const
+{
+    // The index is keyed by the leading ones of the masks: check the full mask of the routes
+    std::vector<IndexedRoute> routes;
+    m_networkRoutesIndex.ForEachMatch(NetworkRoutesIndex::GetKey(dest),
+                                      [&routes, dest](uint8_t, const IndexedRoute& r) {
+                                          Ipv4Mask mask = r.route->GetDestNetworkMask();
+                                          if (mask.IsMatch(dest, r.route->GetDestNetwork()))
+                                          {
+                                              routes.push_back(r);
+                                          }
+                                      });
+    std::sort(routes.begin(), routes.end(), [](const IndexedRoute& a, const IndexedRoute& b) {
+        return a.rank < b.rank;
+    });
+    return routes;
+}
+
 bool
 Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
 {
-    for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
-    {
-        Ipv4RoutingTableEntry* rtentry = j->first;
-
-        if (rtentry->GetDest() == route.GetDest() &&
-            rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
-            rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() && j->second == metric)
-        {
-            return true;
-        }
-    }
-    return false;
+    bool found = false;
+    m_networkRoutesIndex.ForEachMatch(
+        NetworkRoutesIndex::GetKey(route.GetDest()),
+        [&found, &route, metric](uint8_t, const IndexedRoute& r) {
+            Ipv4RoutingTableEntry* rtentry = r.route;
+            if (rtentry->GetDest() == route.GetDest() &&
+                rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
+                rtentry->GetGateway() == route.GetGateway() &&
+                rtentry->GetInterface() == route.GetInterface() && r.metric == metric)
+            {
+                found = true;
+            }
+        });
+    return found;
 }
 
 Ptr<Ipv4Route>
@@ -261,10 +304,10 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (NetworkRoutesI i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    for (const auto& candidate : FindRoutes(dest))
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
+        Ipv4RoutingTableEntry* j = candidate.route;
+        uint32_t metric = candidate.metric;
         Ipv4Mask mask = (j)->GetDestNetworkMask();
         uint16_t masklen = mask.GetPrefixLength();
         Ipv4Address entry = (j)->GetDestNetwork();
@@ -457,8 +500,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
-            delete j->first;
-            m_networkRoutes.erase(j);
+            DeleteRoute(j);
             return;
         }
         tmp++;
@@ -593,6 +635,7 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_networkRoutesIndex.Clear();
     for (MulticastRoutesI i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -632,8 +675,7 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = DeleteRoute(it);
         }
         else
         {
@@ -677,8 +719,7 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkMask() == networkMask)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = DeleteRoute(it);
         }
         else
         {
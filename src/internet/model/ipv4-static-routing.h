@@ -25,12 +25,14 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/ptr.h"
 #include "ns3/socket.h"
 
 #include <list>
 #include <stdint.h>
 #include <utility>
+#include <vector>
 
 namespace ns3
 {
@@ -380,6 +382,38 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
     /// Iterator for container for the multicast routes
     typedef std::list<Ipv4MulticastRoutingTableEntry*>::iterator MulticastRoutesI;
 
+    /// A network route indexed by destination prefix, with its rank in the forwarding table
+    struct IndexedRoute
+    {
+        uint64_t rank;                //!< rank of the route in the forwarding table
+        Ipv4RoutingTableEntry* route; //!< the route
+        uint32_t metric;              //!< the metric of the route
+    };
+
+    /// Index of the network routes by destination prefix
+    typedef Ipv4PrefixTrie<IndexedRoute> NetworkRoutesIndex;
+
+    /**
+     * \brief Add a network route to the forwarding table.
+     * \param route route
+     * \param metric metric of route
+     */
+    void AddRoute(Ipv4RoutingTableEntry* route, uint32_t metric);
+
+    /**
+     * \brief Remove a network route from the forwarding table and delete it.
+     * \param it the route
+     * \return the iterator following the route
+     */
+    NetworkRoutesI DeleteRoute(NetworkRoutesI it);
+
+    /**
+     * \brief Find the network routes matching a destination.
+     * \param dest destination address
+     * \return the matching routes, in the order of the forwarding table
+     */
+    std::vector<IndexedRoute> FindRoutes(Ipv4Address dest) const;
+
     /**
      * \brief Checks if a route is already present in the forwarding table.
      * \param route route
@@ -410,6 +444,16 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the network routes, by destination.
+     */
+    NetworkRoutesIndex m_networkRoutesIndex;
+
+    /**
+     * \brief the rank of the next network route.
+     */
+    uint64_t m_routeRank;
+
     /**
      * \brief the forwarding table for multicast.
      */
@@ -40,6 +40,7 @@
 #include "ns3/mac64-address.h"
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
@@ -1268,7 +1269,10 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
         targetMtu = dev->GetMtu();
     }
 
-    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu)
+    // The super-segments of a segmentation offload are sent whole if their
+    // segments fit in the MTU
+    if (SegmentationOffloadTag::GetMaxSegmentSize(packet) + ipHeader.GetSerializedSize() >
+        targetMtu)
     {
         // Router => drop
         if (!fromMe)
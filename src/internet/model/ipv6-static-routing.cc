@@ -29,6 +29,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 
 namespace ns3
@@ -49,7 +50,8 @@ Ipv6StaticRouting::GetTypeId()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting()
-    : m_ipv6(nullptr)
+    : m_routeRank(0),
+      m_ipv6(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -181,8 +183,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
 
     if (!LookupRoute(route, metric))
     {
-        Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv6RoutingTableEntry(route), metric);
     }
 }
 
@@ -208,8 +209,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
                                                                               prefixToUse);
     if (!LookupRoute(route, metric))
     {
-        Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv6RoutingTableEntry(route), metric);
     }
 }
 
@@ -225,8 +225,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
         Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkPrefix, interface);
     if (!LookupRoute(route, metric))
     {
-        Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv6RoutingTableEntry(route), metric);
     }
 }
 
@@ -268,7 +267,7 @@ Ipv6StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv6Address network = Ipv6Address("ff00::"); /* RFC 3513 */
     Ipv6Prefix networkMask = Ipv6Prefix(8);
     *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
-    m_networkRoutes.emplace_back(route, 0);
+    AddRoute(route, 0);
 }
 
 uint32_t
@@ -344,13 +343,9 @@ Ipv6StaticRouting::HasNetworkDest(Ipv6Address network, uint32_t interfaceIndex)
     NS_LOG_FUNCTION(this << network << interfaceIndex);
 
     /* in the network table */
-    for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    for (const auto& candidate : FindRoutes(network))
     {
-        Ipv6RoutingTableEntry* rtentry = j->first;
-        Ipv6Prefix prefix = rtentry->GetDestNetworkPrefix();
-        Ipv6Address entry = rtentry->GetDestNetwork();
-
-        if (prefix.IsMatch(network, entry) && rtentry->GetInterface() == interfaceIndex)
+        if (candidate.route->GetInterface() == interfaceIndex)
         {
             return true;
         }
@@ -360,23 +355,67 @@ Ipv6StaticRouting::HasNetworkDest(Ipv6Address network, uint32_t interfaceIndex)
     return false;
 }
 
+void
+Ipv6StaticRouting::AddRoute(Ipv6RoutingTableEntry* route, uint32_t metric)
+{
+    NS_LOG_FUNCTION(this << route << metric);
+    m_networkRoutes.emplace_back(route, metric);
+    m_networkRoutesIndex.Insert(NetworkRoutesIndex::GetKey(route->GetDestNetwork()),
+                                NetworkRoutesIndex::GetLength(route->GetDestNetworkPrefix()),
+                                {m_routeRank++, route, metric});
+}
+
+Ipv6StaticRouting::NetworkRoutesI
+Ipv6StaticRouting::DeleteRoute(NetworkRoutesI it)
+{
+    NS_LOG_FUNCTION(this << it->first);
+    Ipv6RoutingTableEntry* route = it->first;
+    [[maybe_unused]] bool removed =
+        m_networkRoutesIndex.Remove(NetworkRoutesIndex::GetKey(route->GetDestNetwork()),
+                                    NetworkRoutesIndex::GetLength(route->GetDestNetworkPrefix()),
+                                    [route](const IndexedRoute& r) { return r.route == route; });
+    NS_ASSERT(removed);
+    delete route;
+    return m_networkRoutes.erase(it);
+}
+
+std::vector<Ipv6StaticRouting::IndexedRoute>
+Ipv6StaticRouting::FindRoutes(Ipv6Address dest) const
+{
+    // The index is keyed by the leading ones of the prefixes: check the full prefix of the routes
+    std::vector<IndexedRoute> routes;
+    m_networkRoutesIndex.ForEachMatch(NetworkRoutesIndex::GetKey(dest),
+                                      [&routes, dest](uint8_t, const IndexedRoute& r) {
+                                          Ipv6Prefix prefix = r.route->GetDestNetworkPrefix();
+                                          if (prefix.IsMatch(dest, r.route->GetDestNetwork()))
+                                          {
+                                              routes.push_back(r);
+                                          }
+                                      });
+    std::sort(routes.begin(), routes.end(), [](const IndexedRoute& a, const IndexedRoute& b) {
+        return a.rank < b.rank;
+    });
+    return routes;
+}
+
 bool
 Ipv6StaticRouting::LookupRoute(const Ipv6RoutingTableEntry& route, uint32_t metric)
 {
-    for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
-    {
-        Ipv6RoutingTableEntry* rtentry = j->first;
-
-        if (rtentry->GetDest() == route.GetDest() &&
-            rtentry->GetDestNetworkPrefix() == route.GetDestNetworkPrefix() &&
-            rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() &&
-            rtentry->GetPrefixToUse() == route.GetPrefixToUse() && j->second == metric)
-        {
-            return true;
-        }
-    }
-    return false;
+    bool found = false;
+    m_networkRoutesIndex.ForEachMatch(
+        NetworkRoutesIndex::GetKey(route.GetDest()),
+        [&found, &route, metric](uint8_t, const IndexedRoute& r) {
+            Ipv6RoutingTableEntry* rtentry = r.route;
+            if (rtentry->GetDest() == route.GetDest() &&
+                rtentry->GetDestNetworkPrefix() == route.GetDestNetworkPrefix() &&
+                rtentry->GetGateway() == route.GetGateway() &&
+                rtentry->GetInterface() == route.GetInterface() &&
+                rtentry->GetPrefixToUse() == route.GetPrefixToUse() && r.metric == metric)
+            {
+                found = true;
+            }
+        });
+    return found;
 }
 
 Ptr<Ipv6Route>
@@ -402,10 +441,10 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (NetworkRoutesI it = m_networkRoutes.begin(); it != m_networkRoutes.end(); it++)
+    for (const auto& candidate : FindRoutes(dst))
     {
-        Ipv6RoutingTableEntry* j = it->first;
-        uint32_t metric = it->second;
+        Ipv6RoutingTableEntry* j = candidate.route;
+        uint32_t metric = candidate.metric;
         Ipv6Prefix mask = j->GetDestNetworkPrefix();
         uint16_t maskLen = mask.GetPrefixLength();
         Ipv6Address entry = j->GetDestNetwork();
@@ -491,6 +530,7 @@ Ipv6StaticRouting::DoDispose()
         delete j->first;
     }
     m_networkRoutes.clear();
+    m_networkRoutesIndex.Clear();
 
     for (MulticastRoutesI i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
@@ -569,10 +609,10 @@ Ipv6StaticRouting::GetDefaultRoute()
     uint32_t shortestMetric = 0xffffffff;
     Ipv6RoutingTableEntry* result = nullptr;
 
-    for (NetworkRoutesI it = m_networkRoutes.begin(); it != m_networkRoutes.end(); it++)
+    for (const auto& candidate : FindRoutes(dst))
     {
-        Ipv6RoutingTableEntry* j = it->first;
-        uint32_t metric = it->second;
+        Ipv6RoutingTableEntry* j = candidate.route;
+        uint32_t metric = candidate.metric;
         Ipv6Prefix mask = j->GetDestNetworkPrefix();
         uint16_t maskLen = mask.GetPrefixLength();
         Ipv6Address entry = j->GetDestNetwork();
@@ -648,8 +688,7 @@ Ipv6StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
-            delete it->first;
-            m_networkRoutes.erase(it);
+            DeleteRoute(it);
             return;
         }
         tmp++;
@@ -671,8 +710,7 @@ Ipv6StaticRouting::RemoveRoute(Ipv6Address network,
         if (network == rtentry->GetDest() && rtentry->GetInterface() == ifIndex &&
             rtentry->GetPrefixToUse() == prefixToUse)
         {
-            delete it->first;
-            m_networkRoutes.erase(it);
+            DeleteRoute(it);
             return;
         }
     }
@@ -813,8 +851,7 @@ Ipv6StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = DeleteRoute(it);
         }
         else
         {
@@ -851,8 +888,7 @@ Ipv6StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkPrefix() == networkMask)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = DeleteRoute(it);
         }
         else
         {
@@ -909,8 +945,7 @@ Ipv6StaticRouting::NotifyRemoveRoute(Ipv6Address dst,
 
             if (dst == entry && prefix == mask && rtentry->GetInterface() == interface)
             {
-                delete j->first;
-                j = m_networkRoutes.erase(j);
+                j = DeleteRoute(j);
             }
             else
             {
@@ -24,10 +24,12 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
 #include "ns3/ipv6.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/ptr.h"
 
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -305,6 +307,38 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
     /// Iterator for container for the multicast routes
     typedef std::list<Ipv6MulticastRoutingTableEntry*>::iterator MulticastRoutesI;
 
+    /// A network route indexed by destination prefix, with its rank in the forwarding table
+    struct IndexedRoute
+    {
+        uint64_t rank;                //!< rank of the route in the forwarding table
+        Ipv6RoutingTableEntry* route; //!< the route
+        uint32_t metric;              //!< the metric of the route
+    };
+
+    /// Index of the network routes by destination prefix
+    typedef Ipv6PrefixTrie<IndexedRoute> NetworkRoutesIndex;
+
+    /**
+     * \brief Add a network route to the forwarding table.
+     * \param route route
+     * \param metric metric of route
+     */
+    void AddRoute(Ipv6RoutingTableEntry* route, uint32_t metric);
+
+    /**
+     * \brief Remove a network route from the forwarding table and delete it.
+     * \param it the route
+     * \return the iterator following the route
+     */
+    NetworkRoutesI DeleteRoute(NetworkRoutesI it);
+
+    /**
+     * \brief Find the network routes matching a destination.
+     * \param dest destination address
+     * \return the matching routes, in the order of the forwarding table
+     */
+    std::vector<IndexedRoute> FindRoutes(Ipv6Address dest) const;
+
     /**
      * \brief Checks if a route is already present in the forwarding table.
      * \param route route
@@ -335,6 +369,16 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the network routes, by destination.
+     */
+    NetworkRoutesIndex m_networkRoutesIndex;
+
+    /**
+     * \brief the rank of the next network route.
+     */
+    uint64_t m_routeRank;
+
     /**
      * \brief the forwarding table for multicast.
      */
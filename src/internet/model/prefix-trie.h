@@ -0,0 +1,462 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include "ns3/assert.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ *
+ * \brief A path-compressed binary trie, indexing values by address prefix.
+ *
+ * Each node of the trie holds a prefix, the values inserted with this
+ * exact prefix, and up to two children whose prefixes extend the prefix
+ * of the node by at least one bit. Nodes with no value and a single
+ * child are not kept, hence the trie has less than two nodes per prefix,
+ * and the values of all the prefixes matching an address are found by
+ * walking down at most one node per prefix length.
+ *
+ * The addresses are stored as arrays of 32-bit words, the most
+ * significant bit of the first word being the first bit of the address.
+ *
+ * \tparam W The number of 32-bit words of the addresses.
+ * \tparam T The value type.
+ */
+template <std::size_t W, typename T>
+class PrefixTrie
+{
+  public:
+    /** Address or prefix type. */
+    typedef std::array<uint32_t, W> Key;
+
+    /** The number of bits of the addresses. */
+    static constexpr uint8_t MAX_LENGTH = W * 32;
+
+    PrefixTrie() = default;
+
+    /**
+     * Insert a value, after the values already inserted with the same prefix.
+     *
+     * \param prefix The prefix; the bits past \p length are ignored.
+     * \param length The length of the prefix, in bits.
+     * \param value The value.
+     */
+    void Insert(const Key& prefix, uint8_t length, const T& value);
+
+    /**
+     * Remove the first value of a prefix satisfying a predicate.
+     *
+     * \param prefix The prefix; the bits past \p length are ignored.
+     * \param length The length of the prefix, in bits.
+     * \param pred The predicate, called with a value of the prefix.
+     * \return true if a value was removed.
+     */
+    template <typename P>
+    bool Remove(const Key& prefix, uint8_t length, P pred);
+
+    /** Remove all the values. */
+    void Clear();
+
+    /**
+     * \return true if the trie holds no value.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Call a function on the values of all the prefixes matching an
+     * address, from the shortest prefix to the longest one, and in
+     * insertion order for a given prefix.
+     *
+     * \param address The address.
+     * \param f The function, called with the prefix length and a value.
+     */
+    template <typename F>
+    void ForEachMatch(const Key& address, F f) const;
+
+    /**
+     * \param address An IPv4 address.
+     * \return The key of the address.
+     */
+    static Key GetKey(Ipv4Address address);
+
+    /**
+     * \param address An IPv6 address.
+     * \return The key of the address.
+     */
+    static Key GetKey(Ipv6Address address);
+
+    /**
+     * Get the length of the prefix under which a route with a given mask
+     * is indexed, i.e., the number of leading ones of the mask. The routes
+     * found with ForEachMatch have to be checked against their full mask
+     * when the masks are not contiguous.
+     *
+     * \param mask An IPv4 mask.
+     * \return The number of leading ones of the mask.
+     */
+    static uint8_t GetLength(Ipv4Mask mask);
+
+    /**
+     * \param prefix An IPv6 prefix.
+     * \return The number of leading ones of the prefix.
+     * \see GetLength(Ipv4Mask)
+     */
+    static uint8_t GetLength(Ipv6Prefix prefix);
+
+  private:
+    /** A node of the trie. */
+    struct Node
+    {
+        /**
+         * Constructor.
+         * \param p The prefix of the node, masked to its length.
+         * \param l The length of the prefix.
+         */
+        Node(const Key& p, uint8_t l)
+            : prefix(p),
+              length(l)
+        {
+        }
+
+        Key prefix;                        //!< The prefix
+        uint8_t length;                    //!< The length of the prefix, in bits
+        std::vector<T> values;             //!< The values of the prefix
+        std::unique_ptr<Node> children[2]; //!< The children, by value of the next bit
+    };
+
+    /**
+     * \param key A key.
+     * \param index The index of a bit, starting from the most significant one.
+     * \return The bit of the key.
+     */
+    static uint32_t GetBit(const Key& key, uint8_t index);
+
+    /**
+     * \param key A key.
+     * \param length A length, in bits.
+     * \return The key, with the bits past the given length cleared.
+     */
+    static Key Mask(const Key& key, uint8_t length);
+
+    /**
+     * \param a A key.
+     * \param b Another key.
+     * \param max The maximum length to compare.
+     * \return The length of the common prefix of the keys, up to \p max.
+     */
+    static uint8_t GetCommonLength(const Key& a, const Key& b, uint8_t max);
+
+    /**
+     * Remove a node which has no value and less than two children.
+     *
+     * \param slot The pointer to the node.
+     */
+    static void Compact(std::unique_ptr<Node>& slot);
+
+    /**
+     * Remove the first value of a prefix satisfying a predicate, in the
+     * sub-trie rooted at a node.
+     *
+     * \param slot The pointer to the node.
+     * \param prefix The masked prefix.
+     * \param length The length of the prefix.
+     * \param pred The predicate.
+     * \return true if a value was removed.
+     */
+    template <typename P>
+    static bool DoRemove(std::unique_ptr<Node>& slot, const Key& prefix, uint8_t length, P& pred);
+
+    std::unique_ptr<Node> m_root; //!< The root of the trie
+};
+
+/** A prefix trie for IPv4 addresses. */
+template <typename T>
+using Ipv4PrefixTrie = PrefixTrie<1, T>;
+
+/** A prefix trie for IPv6 addresses. */
+template <typename T>
+using Ipv6PrefixTrie = PrefixTrie<4, T>;
+
+/****************************************************************
+ *  Implementation of the templates declared above.
+ ****************************************************************/
+
+template <std::size_t W, typename T>
+uint32_t
+PrefixTrie<W, T>::GetBit(const Key& key, uint8_t index)
+{
+    return (key[index / 32] >> (31 - index % 32)) & 1;
+}
+
+template <std::size_t W, typename T>
+typename PrefixTrie<W, T>::Key
+PrefixTrie<W, T>::Mask(const Key& key, uint8_t length)
+{
+    Key masked;
+    for (std::size_t i = 0; i < W; i++)
+    {
+        if (length >= (i + 1) * 32)
+        {
+            masked[i] = key[i];
+        }
+        else if (length <= i * 32)
+        {
+            masked[i] = 0;
+        }
+        else
+        {
+            masked[i] = key[i] & ~(0xffffffffU >> (length - i * 32));
+        }
+    }
+    return masked;
+}
+
+template <std::size_t W, typename T>
+uint8_t
+PrefixTrie<W, T>::GetCommonLength(const Key& a, const Key& b, uint8_t max)
+{
+    for (std::size_t i = 0; i * 32 < max; i++)
+    {
+        uint32_t diff = a[i] ^ b[i];
+        if (diff != 0)
+        {
+            uint8_t length = i * 32;
+            while ((diff & 0x80000000U) == 0)
+            {
+                diff <<= 1;
+                length++;
+            }
+            return std::min(length, max);
+        }
+    }
+    return max;
+}
+
+template <std::size_t W, typename T>
+typename PrefixTrie<W, T>::Key
+PrefixTrie<W, T>::GetKey(Ipv4Address address)
+{
+    Key key{};
+    key[0] = address.Get();
+    return key;
+}
+
+template <std::size_t W, typename T>
+typename PrefixTrie<W, T>::Key
+PrefixTrie<W, T>::GetKey(Ipv6Address address)
+{
+    static_assert(W == 4, "IPv6 addresses require 4 words");
+    uint8_t buf[16];
+    address.GetBytes(buf);
+    Key key;
+    for (std::size_t i = 0; i < W; i++)
+    {
+        key[i] = (uint32_t(buf[4 * i]) << 24) | (uint32_t(buf[4 * i + 1]) << 16) |
+                 (uint32_t(buf[4 * i + 2]) << 8) | uint32_t(buf[4 * i + 3]);
+    }
+    return key;
+}
+
+template <std::size_t W, typename T>
+uint8_t
+PrefixTrie<W, T>::GetLength(Ipv4Mask mask)
+{
+    uint32_t bits = mask.Get();
+    uint8_t length = 0;
+    while ((bits & 0x80000000U) != 0)
+    {
+        bits <<= 1;
+        length++;
+    }
+    return length;
+}
+
+template <std::size_t W, typename T>
+uint8_t
+PrefixTrie<W, T>::GetLength(Ipv6Prefix prefix)
+{
+    uint8_t buf[16];
+    prefix.GetBytes(buf);
+    uint8_t length = 0;
+    for (uint8_t byte : buf)
+    {
+        if (byte != 0xff)
+        {
+            while ((byte & 0x80) != 0)
+            {
+                byte <<= 1;
+                length++;
+            }
+            break;
+        }
+        length += 8;
+    }
+    return length;
+}
+
+template <std::size_t W, typename T>
+void
+PrefixTrie<W, T>::Insert(const Key& prefix, uint8_t length, const T& value)
+{
+    NS_ASSERT(length <= MAX_LENGTH);
+    Key masked = Mask(prefix, length);
+    std::unique_ptr<Node>* slot = &m_root;
+    while (true)
+    {
+        if (!*slot)
+        {
+            *slot = std::make_unique<Node>(masked, length);
+            (*slot)->values.push_back(value);
+            return;
+        }
+        Node* node = slot->get();
+        uint8_t common = GetCommonLength(node->prefix, masked, std::min(node->length, length));
+        if (common < node->length)
+        {
+            // split the node at the first differing bit, or at the end of the new prefix
+            auto parent = std::make_unique<Node>(Mask(masked, common), common);
+            parent->children[GetBit(node->prefix, common)] = std::move(*slot);
+            *slot = std::move(parent);
+            node = slot->get();
+        }
+        if (node->length == length)
+        {
+            node->values.push_back(value);
+            return;
+        }
+        slot = &node->children[GetBit(masked, node->length)];
+    }
+}
+
+template <std::size_t W, typename T>
+void
+PrefixTrie<W, T>::Compact(std::unique_ptr<Node>& slot)
+{
+    Node* node = slot.get();
+    if (!node->values.empty() || (node->children[0] && node->children[1]))
+    {
+        return;
+    }
+    if (node->children[0])
+    {
+        slot = std::move(node->children[0]);
+    }
+    else if (node->children[1])
+    {
+        slot = std::move(node->children[1]);
+    }
+    else
+    {
+        slot.reset();
+    }
+}
+
+template <std::size_t W, typename T>
+template <typename P>
+bool
+PrefixTrie<W, T>::DoRemove(std::unique_ptr<Node>& slot,
+                           const Key& prefix,
+                           uint8_t length,
+                           P& pred)
+{
+    Node* node = slot.get();
+    if (!node || node->length > length ||
+        GetCommonLength(node->prefix, prefix, node->length) < node->length)
+    {
+        return false;
+    }
+    bool removed = false;
+    if (node->length == length)
+    {
+        for (auto it = node->values.begin(); it != node->values.end(); it++)
+        {
+            if (pred(*it))
+            {
+                node->values.erase(it);
+                removed = true;
+                break;
+            }
+        }
+    }
+    else
+    {
+        removed = DoRemove(node->children[GetBit(prefix, node->length)], prefix, length, pred);
+    }
+    if (removed)
+    {
+        Compact(slot);
+    }
+    return removed;
+}
+
+template <std::size_t W, typename T>
+template <typename P>
+bool
+PrefixTrie<W, T>::Remove(const Key& prefix, uint8_t length, P pred)
+{
+    NS_ASSERT(length <= MAX_LENGTH);
+    return DoRemove(m_root, Mask(prefix, length), length, pred);
+}
+
+template <std::size_t W, typename T>
+void
+PrefixTrie<W, T>::Clear()
+{
+    m_root.reset();
+}
+
+template <std::size_t W, typename T>
+bool
+PrefixTrie<W, T>::IsEmpty() const
+{
+    return !m_root;
+}
+
+template <std::size_t W, typename T>
+template <typename F>
+void
+PrefixTrie<W, T>::ForEachMatch(const Key& address, F f) const
+{
+    const Node* node = m_root.get();
+    while (node && GetCommonLength(node->prefix, address, node->length) == node->length)
+    {
+        for (const auto& value : node->values)
+        {
+            f(node->length, value);
+        }
+        if (node->length == MAX_LENGTH)
+        {
+            return;
+        }
+        node = node->children[GetBit(address, node->length)].get();
+    }
+}
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
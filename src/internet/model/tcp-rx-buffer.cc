@@ -22,6 +22,8 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <iterator>
+
 namespace ns3
 {
 
@@ -171,68 +173,53 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    BufIterator i = m_data.begin();
-    while (i != m_data.end() && i->first <= tailSeq)
+    // Store the bytes which fill the gaps between the ranges already stored
+    SequenceNumber32 seq = headSeq;
+    SequenceNumber32 storedHead = tailSeq;
+    SequenceNumber32 storedTail = headSeq;
+    while (seq < tailSeq)
     {
-        SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
-        if (lastByteSeq > headSeq)
+        BufIterator next = m_data.upper_bound(seq);
+        if (next != m_data.begin() && std::prev(next)->second.end > seq)
+        { // seq is already stored: skip to the end of its range
+            seq = std::prev(next)->second.end;
+            continue;
+        }
+        SequenceNumber32 gapEnd = tailSeq;
+        if (next != m_data.end() && next->first < tailSeq)
+        {
+            gapEnd = next->first;
+        }
+        uint32_t start = static_cast<uint32_t>(seq - tcph.GetSequenceNumber());
+        uint32_t length = static_cast<uint32_t>(gapEnd - seq);
+        Insert(p->CreateFragment(start, length), seq);
+        NS_LOG_LOGIC("Buffered packet of seqno=" << seq << " len=" << length);
+        m_size += length; // Occupancy
+        if (seq < storedHead)
         {
-            if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-                m_size -= i->second->GetSize();
-                m_data.erase(i++);
-                continue;
-            }
-            if (i->first <= headSeq)
-            { // Incoming head is overlapped
-                headSeq = lastByteSeq;
-            }
-            if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-                tailSeq = i->first;
-            }
+            storedHead = seq;
         }
-        ++i;
+        storedTail = gapEnd;
+        seq = gapEnd;
     }
-    // We now know how much we are going to store, trim the packet
-    if (headSeq >= tailSeq)
+    if (storedHead >= storedTail)
     {
         NS_LOG_LOGIC("Nothing to buffer");
         return false; // Nothing to buffer anyway
     }
-    else
-    {
-        uint32_t start = static_cast<uint32_t>(headSeq - tcph.GetSequenceNumber());
-        uint32_t length = static_cast<uint32_t>(tailSeq - headSeq);
-        p = p->CreateFragment(start, length);
-        NS_ASSERT(length == p->GetSize());
-    }
-    // Insert packet into buffer
-    NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
 
-    if (headSeq > m_nextRxSeq)
+    if (storedHead > m_nextRxSeq)
     {
         // Generate a new SACK block
-        UpdateSackList(headSeq, tailSeq);
+        UpdateSackList(storedHead, storedTail);
     }
 
-    NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
     // Update variables
-    m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    BufIterator first = m_data.begin();
+    if (first->first <= m_nextRxSeq && first->second.end > m_nextRxSeq)
     {
-        if (i->first < m_nextRxSeq)
-        {
-            continue;
-        }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
+        m_availBytes += static_cast<uint32_t>(first->second.end - m_nextRxSeq);
+        m_nextRxSeq = first->second.end;
         ClearSackList(m_nextRxSeq);
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -376,54 +363,110 @@ TcpRxBuffer::GetSackList() const
     return m_sackList;
 }
 
+void
+TcpRxBuffer::Insert(Ptr<Packet> p, const SequenceNumber32& head)
+{
+    NS_LOG_FUNCTION(this << p << head);
+
+    SequenceNumber32 tail = head + SequenceNumber32(p->GetSize());
+    BufIterator next = m_data.lower_bound(head);
+    NS_ASSERT(next == m_data.end() || next->first >= tail); // No overlap
+    bool joinsNext = (next != m_data.end() && next->first == tail);
+    if (next != m_data.begin() && std::prev(next)->second.end == head)
+    { // Append to the previous range
+        Range& previous = std::prev(next)->second;
+        previous.packets.push_back(p);
+        previous.end = tail;
+        if (joinsNext)
+        { // The gap between the two ranges is filled: coalesce them
+            previous.packets.splice(previous.packets.end(), next->second.packets);
+            previous.end = next->second.end;
+            m_data.erase(next);
+        }
+    }
+    else if (joinsNext)
+    { // Prepend to the next range, which now starts at head
+        auto node = m_data.extract(next);
+        node.key() = head;
+        node.mapped().packets.push_front(p);
+        m_data.insert(std::move(node));
+    }
+    else
+    { // A new range
+        Range& range = m_data[head];
+        range.end = tail;
+        range.packets.push_back(p);
+    }
+}
+
 Ptr<Packet>
 TcpRxBuffer::Extract(uint32_t maxSize)
 {
     NS_LOG_FUNCTION(this << maxSize);
 
+    std::list<Ptr<Packet>> packets;
+    if (Extract(maxSize, packets) == 0)
+    {
+        return nullptr; // No contiguous block to return
+    }
+    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
+    for (const auto& p : packets)
+    {
+        outPkt->AddAtEnd(p);
+    }
+    return outPkt;
+}
+
+uint32_t
+TcpRxBuffer::Extract(uint32_t maxSize, std::list<Ptr<Packet>>& packets)
+{
+    NS_LOG_FUNCTION(this << maxSize);
+
     uint32_t extractSize = std::min(maxSize, m_availBytes);
     NS_LOG_LOGIC("Requested to extract " << extractSize
                                          << " bytes from TcpRxBuffer of size=" << m_size);
     if (extractSize == 0)
     {
-        return nullptr; // No contiguous block to return
+        return 0; // No contiguous block to return
     }
-    NS_ASSERT(!m_data.empty());            // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
-    BufIterator i;
-    while (extractSize)
+    NS_ASSERT(!m_data.empty()); // At least we have something to extract
+    BufIterator i = m_data.begin();
+    NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
+    std::list<Ptr<Packet>>& stored = i->second.packets;
+    uint32_t extracted = 0;
+    while (extracted < extractSize)
     { // Check the buffered data for delivery
-        i = m_data.begin();
-        NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
+        NS_ASSERT(!stored.empty());
         // Check if we send the whole pkt or just a partial
-        uint32_t pktSize = i->second->GetSize();
-        if (pktSize <= extractSize)
+        uint32_t pktSize = stored.front()->GetSize();
+        if (pktSize <= extractSize - extracted)
         { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
-            m_data.erase(i);
-            m_size -= pktSize;
-            m_availBytes -= pktSize;
-            extractSize -= pktSize;
+            packets.splice(packets.end(), stored, stored.begin());
+            extracted += pktSize;
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
-            m_data[i->first + SequenceNumber32(extractSize)] =
-                i->second->CreateFragment(extractSize, pktSize - extractSize);
-            m_data.erase(i);
-            m_size -= extractSize;
-            m_availBytes -= extractSize;
-            extractSize = 0;
+            uint32_t partSize = extractSize - extracted;
+            packets.push_back(stored.front()->CreateFragment(0, partSize));
+            stored.front() = stored.front()->CreateFragment(partSize, pktSize - partSize);
+            extracted = extractSize;
         }
     }
-    if (outPkt->GetSize() == 0)
+    m_size -= extracted;
+    m_availBytes -= extracted;
+    if (stored.empty())
     {
-        NS_LOG_LOGIC("Nothing extracted.");
-        return nullptr;
+        m_data.erase(i);
     }
-    NS_LOG_LOGIC("Extracted " << outPkt->GetSize() << " bytes, bufsize=" << m_size
-                              << ", num pkts in buffer=" << m_data.size());
-    return outPkt;
+    else
+    { // The range now starts after the data extracted
+        auto node = m_data.extract(i);
+        node.key() = node.key() + SequenceNumber32(extracted);
+        m_data.insert(std::move(node));
+    }
+    NS_LOG_LOGIC("Extracted " << extracted << " bytes, bufsize=" << m_size
+                              << ", num ranges in buffer=" << m_data.size());
+    return extracted;
 }
 
 } // namespace ns3
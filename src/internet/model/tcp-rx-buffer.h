@@ -27,6 +27,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-value.h"
 
+#include <list>
 #include <map>
 
 namespace ns3
@@ -54,6 +55,13 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * The data is stored as a list of contiguous ranges of sequence numbers, each
+ * made of the packets received for it. The parts of a packet which overlap
+ * the data already stored are trimmed, and the ranges are coalesced when a
+ * packet fills the gap between them, without copying or concatenating the
+ * packets. The packets are only concatenated when extracted in a single
+ * packet; the data can also be extracted as the list of packets which hold it.
+ *
  * SACK list
  * ---------
  *
@@ -155,10 +163,21 @@ class TcpRxBuffer : public Object
      * The extracted data is going to be forwarded to the application.
      *
      * \param maxSize maximum number of bytes to extract
-     * \returns a packet
+     * \returns a new packet, without the tags of the segments received
      */
     Ptr<Packet> Extract(uint32_t maxSize);
 
+    /**
+     * Extract data from the head of the buffer as indicated by nextRxSeq, as
+     * the packets which hold it, without concatenating them. Only the last
+     * packet extracted can be a fragment of a packet stored.
+     *
+     * \param maxSize maximum number of bytes to extract
+     * \param packets the list to which the extracted packets are appended
+     * \returns the number of bytes extracted
+     */
+    uint32_t Extract(uint32_t maxSize, std::list<Ptr<Packet>>& packets);
+
     /**
      * \brief Get the sack list
      *
@@ -219,10 +238,29 @@ class TcpRxBuffer : public Object
      */
     void ClearSackList(const SequenceNumber32& seq);
 
-    TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
+    /// A contiguous range of data stored in the buffer
+    struct Range
+    {
+        SequenceNumber32 end;           //!< Seqnum following the last byte of the range
+        std::list<Ptr<Packet>> packets; //!< Packets holding the data of the range, in order
+    };
 
     /// container for data stored in the buffer
-    typedef std::map<SequenceNumber32, Ptr<Packet>>::iterator BufIterator;
+    typedef std::map<SequenceNumber32, Range>::iterator BufIterator;
+
+    /**
+     * \brief Store data which overlaps no data of the buffer
+     *
+     * The data is appended to the range which ends at its first byte, or
+     * prepended to the range which starts after its last byte, or both, in
+     * which case the two ranges are coalesced.
+     *
+     * \param p the packet holding the data
+     * \param head sequence number of the first byte of the data
+     */
+    void Insert(Ptr<Packet> p, const SequenceNumber32& head);
+
+    TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
     TracedValue<SequenceNumber32>
         m_nextRxSeq;           //!< Seqnum of the first missing byte in data (RCV.NXT)
     SequenceNumber32 m_finSeq; //!< Seqnum of the FIN packet
@@ -230,7 +268,7 @@ class TcpRxBuffer : public Object
     uint32_t m_size;       //!< Number of total data bytes in the buffer, not necessarily contiguous
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
-    std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    std::map<SequenceNumber32, Range> m_data; //!< Contiguous ranges of data, by first seqnum
 };
 
 } // namespace ns3
@@ -57,6 +57,7 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -161,6 +162,12 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_limitedTx),
                           MakeBooleanChecker())
+            .AddAttribute("TsoMaxSegments",
+                          "Maximum number of segments of new data sent in a single packet "
+                          "(segmentation offload); 1 disables the segmentation offload",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpSocketBase::m_tsoMaxSegments),
+                          MakeUintegerChecker<uint32_t>(1))
             .AddAttribute("UseEcn",
                           "Parameter to set ECN functionality",
                           EnumValue(TcpSocketState::Off),
@@ -368,6 +375,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
       m_limitedTx(sock.m_limitedTx),
+      m_tsoMaxSegments(sock.m_tsoMaxSegments),
       m_isFirstPartialAck(sock.m_isFirstPartialAck),
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
@@ -3168,6 +3176,11 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
 
     AddSocketTags(p);
 
+    if (sz > m_tcb->m_segmentSize)
+    { // A super-segment of the segmentation offload
+        p->AddPacketTag(SegmentationOffloadTag(sz, m_tcb->m_segmentSize));
+    }
+
     if (m_closeOnEmpty && (remainingData == 0))
     {
         flags |= TcpHeader::FIN;
@@ -3368,6 +3381,24 @@ TcpSocketBase::SendPendingData(bool withAck)
             uint32_t maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
 
+            // With the segmentation offload, the new data is sent in packets
+            // of up to m_tsoMaxSegments full segments, as allowed by the
+            // congestion and receiver windows and by the data available
+            if (m_tsoMaxSegments > 1 && next >= m_tcb->m_highTxMark &&
+                maxSizeToSend == m_tcb->m_segmentSize)
+            {
+                SequenceNumber32 rWndEnd = m_highRxAckMark + SequenceNumber32(m_rWnd);
+                uint32_t rWndLeft = rWndEnd > next ? static_cast<uint32_t>(rWndEnd - next) : 0;
+                uint32_t tsoSize = std::min({availableWindow,
+                                             availableData,
+                                             rWndLeft,
+                                             m_tsoMaxSegments * m_tcb->m_segmentSize});
+                if (tsoSize > m_tcb->m_segmentSize)
+                {
+                    s = tsoSize - tsoSize % m_tcb->m_segmentSize;
+                }
+            }
+
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
             //       retransmitted segment unless NextSeg () rule (4) was
@@ -3521,6 +3552,15 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     NS_LOG_DEBUG("Data segment, seq=" << tcpHeader.GetSequenceNumber()
                                       << " pkt size=" << p->GetSize());
 
+    // A super-segment of a segmentation offload counts as its segments for
+    // the delayed ACKs
+    uint32_t segments = 1;
+    SegmentationOffloadTag offloadTag;
+    if (p->RemovePacketTag(offloadTag))
+    {
+        segments = offloadTag.GetSegments();
+    }
+
     // Put into Rx buffer
     SequenceNumber32 expectedSeq = m_tcb->m_rxBuffer->NextRxSequence();
     if (!m_tcb->m_rxBuffer->Add(p, tcpHeader))
@@ -3577,7 +3617,8 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
     else
     { // In-sequence packet: ACK if delayed ack count allows
-        if (++m_delAckCount >= m_delAckMaxCount)
+        m_delAckCount += segments;
+        if (m_delAckCount >= m_delAckMaxCount)
         {
             m_delAckEvent.Cancel();
             m_delAckCount = 0;
@@ -61,7 +61,8 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_lostUpTo(n)
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
 }
@@ -177,6 +178,7 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostUpTo = seq;
 }
 
 bool
@@ -297,7 +299,7 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     NS_ASSERT(it != m_appList.end());
 
     m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    m_sentIndex[item->m_startSeq] = m_sentList.insert(m_sentList.end(), item);
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -311,37 +313,34 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    auto found = m_sentIndex.find(seq);
+    if (found != m_sentIndex.end())
     {
-        if ((*it)->m_startSeq == seq)
+        auto it = found->second;
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -440,11 +439,26 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     PacketList::iterator it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    // The items of the sent list are indexed by their first sequence number:
+    // jump to the item which holds seq, instead of walking the list
+    bool isSentList = (&list == &m_sentList);
+    auto& index = const_cast<TcpTxBuffer*>(this)->m_sentIndex;
+    if (isSentList)
+    {
+        auto found = index.upper_bound(seq);
+        if (found != index.begin())
+        {
+            --found;
+            it = found->second;
+            beginOfCurrentPacket = found->first;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(!isSentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -473,7 +487,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    index[firstPart->m_startSeq] = firstPartIt;
+                    index[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -517,8 +536,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     // current > outPacket in the list. Merge current with the
                     // previous, and recurse.
                     NS_ASSERT(it != list.begin());
-                    TcpTxItem* previous = *(--it);
+                    TcpTxItem* previous = *std::prev(it);
 
+                    if (isSentList)
+                    {
+                        index.erase(currentItem->m_startSeq);
+                    }
                     list.erase(it);
 
                     MergeItems(previous, currentItem);
@@ -539,7 +562,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    index[firstPart->m_startSeq] = firstPartIt;
+                    index[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -568,6 +596,10 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                      // in the previous if
 
             MergeItems(currentItem, next);
+            if (isSentList)
+            {
+                index.erase(next->m_startSeq);
+            }
             list.erase(it);
 
             delete next;
@@ -652,16 +684,16 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // the only item which can end at ack is the one holding ack - 1
+    auto found = m_sentIndex.upper_bound(ack - 1);
+    if (found == m_sentIndex.begin())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    --found;
+    TcpTxItem* item = *found->second;
+    Ptr<Packet> p = item->m_packet;
+    return item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -709,6 +741,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            m_sentIndex.erase(item->m_startSeq);
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -727,7 +760,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
             item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            m_sentIndex.erase(item->m_startSeq);
             item->m_startSeq += offset;
+            m_sentIndex[item->m_startSeq] = i;
             m_size -= offset;
             m_sentSize -= offset;
             m_firstByteSeq += offset;
@@ -758,8 +793,8 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             head->m_sacked = false;
             m_sackedOut -= head->m_packet->GetSize();
             NS_LOG_INFO("Moving the SACK flag from the HEAD to another segment");
-            AddRenoSack();
             MarkHeadAsLost();
+            AddRenoSack();
         }
 
         NS_ASSERT_MSG(head->m_startSeq == seq,
@@ -799,6 +834,15 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
             return bytesSacked;
         }
 
+        // Start from the item which holds the beginning of the block
+        auto found = m_sentIndex.upper_bound((*option_it).first);
+        if (found != m_sentIndex.begin())
+        {
+            --found;
+            item_it = found->second;
+            beginOfCurrentPacket = found->first;
+        }
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -891,9 +935,21 @@ TcpTxBuffer::UpdateLostCount()
                                                  << *(*m_highestSack.first));
     }
 
+    // End of the item from which all the items down to the head are SACKed
+    // or lost, once the walk is completed
+    SequenceNumber32 lostUpTo = m_lostUpTo;
+
     for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
         TcpTxItem* item = *it;
+        SequenceNumber32 endOfCurrentPacket = item->m_startSeq + item->m_packet->GetSize();
+        if (sacked >= m_dupAckThresh && endOfCurrentPacket <= m_lostUpTo)
+        {
+            // A previous update has already marked the rest of the list
+            NS_LOG_INFO("Items up to " << m_lostUpTo << " are already SACKed or lost");
+            break;
+        }
+
         if (item->m_sacked)
         {
             sacked++;
@@ -906,6 +962,10 @@ TcpTxBuffer::UpdateLostCount()
                 item->m_lost = true;
                 m_lostOut += item->m_packet->GetSize();
             }
+            if (lostUpTo < endOfCurrentPacket)
+            {
+                lostUpTo = endOfCurrentPacket;
+            }
         }
         beginOfCurrentPacket -= item->m_packet->GetSize();
     }
@@ -918,6 +978,7 @@ TcpTxBuffer::UpdateLostCount()
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
         }
+        m_lostUpTo = lostUpTo;
     }
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
@@ -936,9 +997,15 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Start from the first item which begins at or after seq
+    auto found = m_sentIndex.lower_bound(seq);
+    if (found != m_sentIndex.end())
+    {
+        beginOfCurrentPacket = found->first;
+    }
+    for (it = (found != m_sentIndex.end() ? found->second : m_sentList.end());
+         it != m_sentList.end();
+         ++it)
     {
         // Search for the right iterator before calling IsLost()
         if (beginOfCurrentPacket >= seq)
@@ -986,7 +1053,10 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     bool isSeqPerRule3Valid = false;
     SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-    for (it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Outside of the recovery, only the lost items are of interest: do not
+    // walk the list if there is none
+    it = (isRecovery || m_lostOut > 0) ? m_sentList.begin() : m_sentList.end();
+    for (; it != m_sentList.end(); ++it)
     {
         item = *it;
 
@@ -1226,6 +1296,7 @@ TcpTxBuffer::ResetRenoSack()
     }
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostUpTo = m_firstByteSeq;
 }
 
 void
@@ -1249,12 +1320,14 @@ TcpTxBuffer::ResetSentList()
         m_appList.push_front(item);
         m_sentList.pop_back();
     }
+    m_sentIndex.clear();
 
     m_sentSize = 0;
     m_lostOut = 0;
     m_retrans = 0;
     m_sackedOut = 0;
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostUpTo = m_firstByteSeq;
 }
 
 void
@@ -1265,6 +1338,7 @@ TcpTxBuffer::ResetLastSegmentSent()
     {
         TcpTxItem* item = m_sentList.back();
 
+        m_sentIndex.erase(item->m_startSeq);
         m_sentList.pop_back();
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
@@ -1272,6 +1346,10 @@ TcpTxBuffer::ResetLastSegmentSent()
             m_retrans -= item->m_packet->GetSize();
         }
         m_appList.insert(m_appList.begin(), item);
+        if (m_lostUpTo > m_firstByteSeq + m_sentSize)
+        {
+            m_lostUpTo = m_firstByteSeq + m_sentSize;
+        }
     }
     ConsistencyCheck();
 }
@@ -1287,6 +1365,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         m_sackedOut = 0;
         m_lostOut = m_sentSize;
         m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_lostUpTo = m_firstByteSeq;
     }
     else
     {
@@ -1453,8 +1532,15 @@ TcpTxBuffer::ConsistencyCheck() const
         {
             retrans += (*it)->m_packet->GetSize();
         }
+        auto found = m_sentIndex.find((*it)->m_startSeq);
+        NS_ASSERT_MSG(found != m_sentIndex.end() && found->second == it,
+                      "Item " << *(*it) << " not indexed");
+        NS_ASSERT_MSG((*it)->m_startSeq + (*it)->m_packet->GetSize() > m_lostUpTo ||
+                          (*it)->m_sacked || (*it)->m_lost,
+                      "Item " << *(*it) << " is below " << m_lostUpTo << " but not SACKed or lost");
     }
 
+    NS_ASSERT_MSG(m_sentIndex.size() == m_sentList.size(), "Stale items in the index");
     NS_ASSERT_MSG(sacked == m_sackedOut,
                   "Counted SACK: " << sacked << " stored SACK: " << m_sackedOut);
     NS_ASSERT_MSG(lost == m_lostOut, " Counted lost: " << lost << " stored lost: " << m_lostOut);
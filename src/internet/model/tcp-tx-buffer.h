@@ -27,6 +27,8 @@
 #include "ns3/tcp-tx-item.h"
 #include "ns3/traced-value.h"
 
+#include <map>
+
 namespace ns3
 {
 class Packet;
@@ -73,6 +75,13 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * With large windows, the sent list holds tens of thousands of items, and
+ * walking it for each SACK block would make the processing of an ACK linear
+ * in the window. The items of the sent list are therefore also indexed by
+ * their first sequence number, so that the item holding a given sequence
+ * number is found in logarithmic time, while the numbers of SACKed, lost and
+ * retransmitted bytes are kept as counters.
+ *
  * Item properties
  * ---------------
  *
@@ -427,9 +436,9 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
-     *
+     * and updates the lost count. It walks the list down from the highest
+     * SACKed item, and stops at the bytes which are already known to be SACKed
+     * or lost.
      */
     void UpdateLostCount();
 
@@ -612,6 +621,18 @@ class TcpTxBuffer : public Object
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
     std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
 
+    /**
+     * Index of the items of the sent list by their first sequence number, to
+     * find the item holding a sequence number without walking the list
+     */
+    std::map<SequenceNumber32, PacketList::iterator> m_sentIndex;
+
+    /**
+     * Every byte of the sent list before this sequence number is either
+     * SACKed or marked as lost, so that UpdateLostCount can stop there
+     */
+    SequenceNumber32 m_lostUpTo;
+
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
@@ -16,6 +16,7 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/global-value.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -41,6 +42,8 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1313,6 +1316,163 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting parallel and incremental SPF test
+ *
+ * Check that the routes computed with several threads are the same as the
+ * ones computed with a single thread, and that the routes recomputed
+ * incrementally after an interface goes down or up are the same as the
+ * ones of a full recomputation.
+ */
+class Ipv4GlobalRoutingRecomputeTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingRecomputeTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the global routes of the nodes.
+     * \param sorted Whether to sort the routes of each node.
+     * \return The routes of each node.
+     */
+    std::vector<std::vector<std::string>> GetRoutes(bool sorted) const;
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+Ipv4GlobalRoutingRecomputeTestCase::Ipv4GlobalRoutingRecomputeTestCase()
+    : TestCase("Global routing with parallel and incremental SPF calculations")
+{
+}
+
+std::vector<std::vector<std::string>>
+Ipv4GlobalRoutingRecomputeTestCase::GetRoutes(bool sorted) const
+{
+    std::vector<std::vector<std::string>> routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> globalRouting =
+            m_nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+        routes.emplace_back();
+        for (uint32_t j = 0; j < globalRouting->GetNRoutes(); j++)
+        {
+            std::ostringstream oss;
+            oss << *globalRouting->GetRoute(j);
+            routes.back().push_back(oss.str());
+        }
+        if (sorted)
+        {
+            std::sort(routes.back().begin(), routes.back().end());
+        }
+    }
+    return routes;
+}
+
+//
+// Network topology: a ring of 9 routers connected by point-to-point links, a
+// broadcast link between n0, n3 and n6, and a stub node n9 attached to n8.
+//
+// The shortest paths to the broadcast link are unique: the SPF calculation
+// assumes that the routers behind a network are reached through a single
+// exit from the root.
+//
+void
+Ipv4GlobalRoutingRecomputeTestCase::DoRun()
+{
+    Config::SetDefault("ns3::Ipv4GlobalRouting::RespondToInterfaceEvents", BooleanValue(false));
+
+    const uint32_t ring = 9;
+    m_nodes.Create(ring + 1);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    devHelper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer ringDevices;
+    for (uint32_t i = 0; i < ring; i++)
+    {
+        NetDeviceContainer devices =
+            devHelper.Install(NodeContainer(m_nodes.Get(i), m_nodes.Get((i + 1) % ring)));
+        ipv4.Assign(devices);
+        ipv4.NewNetwork();
+        ringDevices.Add(devices);
+    }
+    ipv4.Assign(devHelper.Install(NodeContainer(m_nodes.Get(ring - 1), m_nodes.Get(ring))));
+    ipv4.NewNetwork();
+    devHelper.SetNetDevicePointToPointMode(false);
+    NetDeviceContainer lanDevices =
+        devHelper.Install(NodeContainer(m_nodes.Get(0), m_nodes.Get(3), m_nodes.Get(6)));
+    ipv4.Assign(lanDevices);
+
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::vector<std::vector<std::string>> routes = GetRoutes(false);
+    std::vector<std::vector<std::string>> sortedRoutes = GetRoutes(true);
+
+    GlobalValue::Bind("GlobalRoutingThreads", UintegerValue(4));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ((GetRoutes(false) == routes),
+                          true,
+                          "The routes computed by several threads differ");
+
+    // The first recomputation is a full one, which records the trees.
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ((GetRoutes(false) == routes),
+                          true,
+                          "The routes computed for the incremental updates differ");
+
+    // Take down the link n5 - n6 of the ring, then the broadcast interface of
+    // n6, and bring them back up.
+    Ptr<Ipv4> ipv45 = m_nodes.Get(5)->GetObject<Ipv4>();
+    Ptr<Ipv4> ipv46 = m_nodes.Get(6)->GetObject<Ipv4>();
+    std::vector<std::pair<Ptr<Ipv4>, uint32_t>> interfaces = {
+        {ipv45, ipv45->GetInterfaceForDevice(ringDevices.Get(2 * 5))},
+        {ipv46, ipv46->GetInterfaceForDevice(lanDevices.Get(2))}};
+    for (bool up : {false, true})
+    {
+        for (const auto& interface : interfaces)
+        {
+            if (up)
+            {
+                interface.first->SetUp(interface.second);
+            }
+            else
+            {
+                interface.first->SetDown(interface.second);
+            }
+
+            GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(true));
+            Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+            std::vector<std::vector<std::string>> incremental = GetRoutes(true);
+
+            GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(false));
+            Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+            NS_TEST_EXPECT_MSG_EQ((GetRoutes(true) == incremental),
+                                  true,
+                                  "The routes recomputed incrementally differ");
+            // Record the trees again for the next incremental update.
+            GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(true));
+            Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ((GetRoutes(true) == sortedRoutes),
+                          true,
+                          "The routes differ once the interfaces are back up");
+
+    GlobalValue::Bind("GlobalRoutingThreads", UintegerValue(1));
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(false));
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1335,6 +1495,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingRecomputeTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -0,0 +1,249 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/prefix-trie.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief PrefixTrie insertion, matching and removal Test
+ */
+class PrefixTrieBasicTestCase : public TestCase
+{
+  public:
+    PrefixTrieBasicTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \param trie The trie.
+     * \param address An address.
+     * \return The prefix lengths and values matching the address, in the order of the trie.
+     */
+    static std::vector<std::pair<uint8_t, int>> Match(const Ipv4PrefixTrie<int>& trie,
+                                                      Ipv4Address address);
+};
+
+PrefixTrieBasicTestCase::PrefixTrieBasicTestCase()
+    : TestCase("Check the insertion, matching and removal of IPv4 and IPv6 prefixes")
+{
+}
+
+std::vector<std::pair<uint8_t, int>>
+PrefixTrieBasicTestCase::Match(const Ipv4PrefixTrie<int>& trie, Ipv4Address address)
+{
+    std::vector<std::pair<uint8_t, int>> matches;
+    trie.ForEachMatch(Ipv4PrefixTrie<int>::GetKey(address),
+                      [&matches](uint8_t length, int value) {
+                          matches.emplace_back(length, value);
+                      });
+    return matches;
+}
+
+void
+PrefixTrieBasicTestCase::DoRun()
+{
+    typedef Ipv4PrefixTrie<int> Trie;
+    typedef std::vector<std::pair<uint8_t, int>> Matches;
+
+    NS_TEST_EXPECT_MSG_EQ(unsigned(Trie::GetLength(Ipv4Mask("255.255.255.0"))),
+                          24,
+                          "Wrong length of a contiguous mask");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(Trie::GetLength(Ipv4Mask("255.0.255.0"))),
+                          8,
+                          "Wrong length of a non-contiguous mask");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(Trie::GetLength(Ipv4Mask::GetOnes())),
+                          32,
+                          "Wrong length of a host mask");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(Ipv6PrefixTrie<int>::GetLength(Ipv6Prefix(61))),
+                          61,
+                          "Wrong length of an IPv6 prefix");
+
+    Trie trie;
+    NS_TEST_EXPECT_MSG_EQ(trie.IsEmpty(), true, "A new trie should be empty");
+
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.2.0")), 24, 1);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.0.0.0")), 8, 2);
+    trie.Insert(Trie::GetKey(Ipv4Address("0.0.0.0")), 0, 3);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.2.3")), 32, 4);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.3.0")), 24, 5);
+    // the bits past the length are ignored
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.2.255")), 24, 6);
+    NS_TEST_EXPECT_MSG_EQ(trie.IsEmpty(), false, "The trie should not be empty");
+
+    Matches expected{{0, 3}, {8, 2}, {24, 1}, {24, 6}, {32, 4}};
+    NS_TEST_EXPECT_MSG_EQ((Match(trie, Ipv4Address("10.1.2.3")) == expected),
+                          true,
+                          "Wrong matches of 10.1.2.3");
+    expected = {{0, 3}, {8, 2}, {24, 1}, {24, 6}};
+    NS_TEST_EXPECT_MSG_EQ((Match(trie, Ipv4Address("10.1.2.4")) == expected),
+                          true,
+                          "Wrong matches of 10.1.2.4");
+    expected = {{0, 3}, {8, 2}, {24, 5}};
+    NS_TEST_EXPECT_MSG_EQ((Match(trie, Ipv4Address("10.1.3.1")) == expected),
+                          true,
+                          "Wrong matches of 10.1.3.1");
+    expected = {{0, 3}};
+    NS_TEST_EXPECT_MSG_EQ((Match(trie, Ipv4Address("11.1.2.3")) == expected),
+                          true,
+                          "Wrong matches of 11.1.2.3");
+
+    auto isValue = [](int v) { return [v](int value) { return value == v; }; };
+    NS_TEST_EXPECT_MSG_EQ(trie.Remove(Trie::GetKey(Ipv4Address("10.1.2.0")), 24, isValue(5)),
+                          false,
+                          "A value of another prefix should not be removed");
+    NS_TEST_EXPECT_MSG_EQ(trie.Remove(Trie::GetKey(Ipv4Address("10.1.2.0")), 24, isValue(1)),
+                          true,
+                          "The value should be removed");
+    NS_TEST_EXPECT_MSG_EQ(trie.Remove(Trie::GetKey(Ipv4Address("0.0.0.0")), 0, isValue(3)),
+                          true,
+                          "The default value should be removed");
+    expected = {{8, 2}, {24, 6}, {32, 4}};
+    NS_TEST_EXPECT_MSG_EQ((Match(trie, Ipv4Address("10.1.2.3")) == expected),
+                          true,
+                          "Wrong matches of 10.1.2.3 after removal");
+
+    trie.Clear();
+    NS_TEST_EXPECT_MSG_EQ(trie.IsEmpty(), true, "A cleared trie should be empty");
+
+    Ipv6PrefixTrie<int> trie6;
+    trie6.Insert(Ipv6PrefixTrie<int>::GetKey(Ipv6Address("2001:db8::")), 32, 1);
+    trie6.Insert(Ipv6PrefixTrie<int>::GetKey(Ipv6Address("2001:db8:0:1::")), 64, 2);
+    trie6.Insert(Ipv6PrefixTrie<int>::GetKey(Ipv6Address("2001:db8:0:1::1")), 128, 3);
+    std::vector<int> values;
+    trie6.ForEachMatch(Ipv6PrefixTrie<int>::GetKey(Ipv6Address("2001:db8:0:1::1")),
+                       [&values](uint8_t, int value) { values.push_back(value); });
+    NS_TEST_EXPECT_MSG_EQ((values == std::vector<int>{1, 2, 3}),
+                          true,
+                          "Wrong matches of 2001:db8:0:1::1");
+    values.clear();
+    trie6.ForEachMatch(Ipv6PrefixTrie<int>::GetKey(Ipv6Address("2001:db8:0:2::1")),
+                       [&values](uint8_t, int value) { values.push_back(value); });
+    NS_TEST_EXPECT_MSG_EQ((values == std::vector<int>{1}),
+                          true,
+                          "Wrong matches of 2001:db8:0:2::1");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief PrefixTrie comparison with a linear search Test
+ */
+class PrefixTrieRandomTestCase : public TestCase
+{
+  public:
+    PrefixTrieRandomTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PrefixTrieRandomTestCase::PrefixTrieRandomTestCase()
+    : TestCase("Check the matches of random prefixes against a linear search")
+{
+}
+
+void
+PrefixTrieRandomTestCase::DoRun()
+{
+    typedef Ipv4PrefixTrie<uint32_t> Trie;
+
+    /// A prefix and its length
+    struct Prefix
+    {
+        uint32_t address; //!< the prefix
+        uint8_t length;   //!< the length of the prefix
+        bool removed;     //!< whether the prefix has been removed from the trie
+    };
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+
+    // draw the prefixes within a small address range, so that they overlap
+    auto draw = [rng]() { return rng->GetInteger(0, 0xff) << 24 | rng->GetInteger(0, 0xff); };
+
+    Trie trie;
+    std::vector<Prefix> prefixes;
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        uint8_t length = rng->GetInteger(0, 32);
+        uint32_t address = draw();
+        address &= length == 0 ? 0 : ~uint32_t(0) << (32 - length);
+        prefixes.push_back({address, length, false});
+        trie.Insert(Trie::GetKey(Ipv4Address(address)), length, i);
+    }
+    for (uint32_t i = 0; i < prefixes.size(); i += 3)
+    {
+        prefixes[i].removed = true;
+        bool removed = trie.Remove(Trie::GetKey(Ipv4Address(prefixes[i].address)),
+                                   prefixes[i].length,
+                                   [i](uint32_t value) { return value == i; });
+        NS_TEST_ASSERT_MSG_EQ(removed, true, "The value " << i << " should be removed");
+    }
+
+    for (uint32_t n = 0; n < 1000; n++)
+    {
+        uint32_t address = draw();
+        std::vector<std::pair<uint8_t, uint32_t>> expected;
+        for (uint8_t length = 0; length <= 32; length++)
+        {
+            for (uint32_t i = 0; i < prefixes.size(); i++)
+            {
+                uint32_t mask = length == 0 ? 0 : ~uint32_t(0) << (32 - length);
+                if (!prefixes[i].removed && prefixes[i].length == length &&
+                    (address & mask) == prefixes[i].address)
+                {
+                    expected.emplace_back(length, i);
+                }
+            }
+        }
+        std::vector<std::pair<uint8_t, uint32_t>> matches;
+        trie.ForEachMatch(Trie::GetKey(Ipv4Address(address)),
+                          [&matches](uint8_t length, uint32_t value) {
+                              matches.emplace_back(length, value);
+                          });
+        NS_TEST_ASSERT_MSG_EQ((matches == expected),
+                              true,
+                              "Wrong matches of " << Ipv4Address(address));
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief PrefixTrie TestSuite
+ */
+class PrefixTrieTestSuite : public TestSuite
+{
+  public:
+    PrefixTrieTestSuite();
+};
+
+PrefixTrieTestSuite::PrefixTrieTestSuite()
+    : TestSuite("prefix-trie", UNIT)
+{
+    AddTestCase(new PrefixTrieBasicTestCase(), TestCase::QUICK);
+    AddTestCase(new PrefixTrieRandomTestCase(), TestCase::QUICK);
+}
+
+static PrefixTrieTestSuite g_prefixTrieTestSuite; //!< Static variable for test initialization
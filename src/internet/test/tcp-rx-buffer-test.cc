@@ -16,9 +16,12 @@
 
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/socket.h"
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
+#include <cstring>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpRxBufferTestSuite");
@@ -42,6 +45,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the storage of overlapping segments and their extraction.
+     */
+    void TestExtract();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +61,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestExtract();
 }
 
 void
@@ -289,6 +298,89 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestExtract()
+{
+    TcpRxBuffer rxBuf;
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+    uint8_t data[1000];
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        data[i] = i % 251;
+    }
+    // Add the bytes [head; head + size) of data, whose first byte has the seqnum 1
+    auto add = [&rxBuf, &data](uint32_t head, uint32_t size) {
+        TcpHeader h;
+        h.SetSequenceNumber(SequenceNumber32(head));
+        return rxBuf.Add(Create<Packet>(data + head - 1, size), h);
+    };
+
+    add(201, 200);
+    add(601, 200);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 400, "Wrong buffer occupancy");
+
+    // This segment overlaps both ranges, and fills the gap between them
+    NS_TEST_ASSERT_MSG_EQ(add(301, 400), true, "The segment should be stored");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 600, "Wrong buffer occupancy");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "No data should be available");
+    TcpOptionSack::SackList sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 1, "The SACK blocks should be merged");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().first,
+                          SequenceNumber32(201),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().second,
+                          SequenceNumber32(801),
+                          "SACK block different than expected");
+
+    // A duplicate segment is not stored
+    NS_TEST_ASSERT_MSG_EQ(add(401, 200), false, "The segment should not be stored");
+
+    // In order, overlapping the beginning of the range
+    add(1, 250);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(801),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 800, "Wrong available data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should contain no element");
+
+    // The packets are extracted as stored, except the last one
+    std::list<Ptr<Packet>> packets;
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(500, packets), 500, "Wrong extracted size");
+    NS_TEST_ASSERT_MSG_EQ(packets.size(), 3, "Wrong number of packets extracted");
+    uint8_t out[1000];
+    uint32_t offset = 0;
+    for (const auto& p : packets)
+    {
+        offset += p->CopyData(out + offset, p->GetSize());
+    }
+    NS_TEST_ASSERT_MSG_EQ(offset, 500, "Wrong extracted size");
+    NS_TEST_ASSERT_MSG_EQ(std::memcmp(out, data, 500), 0, "Wrong extracted data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 300, "Wrong available data");
+
+    Ptr<Packet> p = rxBuf.Extract(1000);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 300, "Wrong extracted size");
+    p->CopyData(out, 300);
+    NS_TEST_ASSERT_MSG_EQ(std::memcmp(out, data + 500, 300), 0, "Wrong extracted data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "The buffer should be empty");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(1000), nullptr, "Nothing should be extracted");
+
+    // The data are returned in a new packet, without the tags of the segments
+    Ptr<Packet> segment = Create<Packet>(data + 800, 100);
+    SocketPriorityTag priorityTag;
+    priorityTag.SetPriority(3);
+    segment->AddPacketTag(priorityTag);
+    TcpHeader h;
+    h.SetSequenceNumber(SequenceNumber32(801));
+    rxBuf.Add(segment, h);
+    add(901, 100);
+    p = rxBuf.Extract(1000);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 200, "Wrong extracted size");
+    p->CopyData(out, 200);
+    NS_TEST_ASSERT_MSG_EQ(std::memcmp(out, data + 800, 200), 0, "Wrong extracted data");
+    NS_TEST_ASSERT_MSG_EQ(segment->GetSize(), 100, "The segment should not be modified");
+    NS_TEST_ASSERT_MSG_EQ(p->PeekPacketTag(priorityTag), false, "The tag should not be returned");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+
+#include "ns3/log.h"
+#include "ns3/segmentation-offload-tag.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpTsoTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Test of the segmentation offload of TcpSocketBase
+ *
+ * The sender transfers the data of the application with the given
+ * TsoMaxSegments attribute. The test checks that the data packets hold up to
+ * TsoMaxSegments segments, that only the super-segments are tagged, and that
+ * all the data is received, in fewer packets when the offload is enabled.
+ */
+class TcpTsoTestCase : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param tsoMaxSegments The TsoMaxSegments attribute of the sender.
+     */
+    TcpTsoTestCase(uint32_t tsoMaxSegments);
+
+  protected:
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    uint32_t m_tsoMaxSegments;   //!< TsoMaxSegments attribute of the sender
+    uint32_t m_dataPackets{0};   //!< Number of data packets sent
+    uint32_t m_superSegments{0}; //!< Number of super-segments sent
+    uint32_t m_bytesReceived{0}; //!< Number of bytes received
+    uint32_t m_acksSent{0};      //!< Number of ACKs sent by the receiver
+};
+
+TcpTsoTestCase::TcpTsoTestCase(uint32_t tsoMaxSegments)
+    : TcpGeneralTest("Segmentation offload of up to " + std::to_string(tsoMaxSegments) +
+                     " segments"),
+      m_tsoMaxSegments(tsoMaxSegments)
+{
+}
+
+void
+TcpTsoTestCase::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(100);
+    SetAppPktSize(500);
+}
+
+void
+TcpTsoTestCase::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 10);
+    GetSenderSocket()->SetAttribute("TsoMaxSegments", UintegerValue(m_tsoMaxSegments));
+}
+
+void
+TcpTsoTestCase::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER)
+    {
+        m_acksSent++;
+        return;
+    }
+    if (who != SENDER || p->GetSize() == 0)
+    {
+        return;
+    }
+    m_dataPackets++;
+    uint32_t segSize = GetSegSize(SENDER);
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(p->GetSize(),
+                                m_tsoMaxSegments * segSize,
+                                "Too many segments in a packet");
+    SegmentationOffloadTag tag;
+    bool tagged = p->PeekPacketTag(tag);
+    NS_TEST_ASSERT_MSG_EQ(tagged, (p->GetSize() > segSize), "Only super-segments are tagged");
+    if (tagged)
+    {
+        m_superSegments++;
+        NS_TEST_ASSERT_MSG_EQ(tag.GetPayloadSize(), p->GetSize(), "Wrong payload size");
+        NS_TEST_ASSERT_MSG_EQ(tag.GetSegmentSize(), segSize, "Wrong segment size");
+        NS_TEST_ASSERT_MSG_EQ(p->GetSize() % segSize, 0, "Super-segments hold full segments");
+    }
+}
+
+void
+TcpTsoTestCase::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER)
+    {
+        m_bytesReceived += p->GetSize();
+    }
+}
+
+void
+TcpTsoTestCase::FinalChecks()
+{
+    uint32_t segments = GetPktSize() * GetPktCount() / GetSegSize(SENDER);
+    NS_TEST_ASSERT_MSG_EQ(m_bytesReceived, GetPktSize() * GetPktCount(), "Data not received");
+    if (m_tsoMaxSegments == 1)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_superSegments, 0, "No super-segment without the offload");
+        NS_TEST_ASSERT_MSG_EQ(m_dataPackets, segments, "Wrong number of data packets");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_GT(m_superSegments, 0, "The offload sent no super-segment");
+        NS_TEST_ASSERT_MSG_LT(m_dataPackets, segments, "The offload should send fewer packets");
+        // the receiver takes a super-segment as the segments it holds, which
+        // are enough to send an ACK without delay
+        NS_TEST_ASSERT_MSG_LT(m_acksSent, segments / 2, "The offload should send fewer ACKs");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TestSuite for the segmentation offload of TcpSocketBase
+ */
+class TcpTsoTestSuite : public TestSuite
+{
+  public:
+    TcpTsoTestSuite()
+        : TestSuite("tcp-tso", UNIT)
+    {
+        AddTestCase(new TcpTsoTestCase(1), TestCase::QUICK);
+        AddTestCase(new TcpTsoTestCase(4), TestCase::QUICK);
+        AddTestCase(new TcpTsoTestCase(16), TestCase::QUICK);
+    }
+};
+
+static TcpTsoTestSuite g_tcpTsoTestSuite; //!< Static variable for test initialization
@@ -53,6 +53,8 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test the scoreboard with a large window and many SACK blocks */
+    void TestLargeWindowScoreboard();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -100,6 +102,15 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Case for a large window:
+     *  -> every other segment is SACKed, one block at a time
+     *  -> the segments below the third highest SACKed one are lost
+     *  -> the scoreboard is still consistent after the retransmission of the
+     *     head and a cumulative ACK in the middle of the window
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestLargeWindowScoreboard, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -420,6 +431,69 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeWindowScoreboard()
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    SequenceNumber32 head(1);
+    txBuf->SetHeadSequence(head);
+    txBuf->SetMaxBufferSize(1000000);
+    txBuf->SetSegmentSize(1000);
+    txBuf->SetDupAckThresh(3);
+    const uint32_t segments = 1000;
+
+    txBuf->Add(Create<Packet>(segments * 1000));
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        txBuf->CopyFromSequence(1000, head + i * 1000);
+    }
+
+    // SACK the odd segments, from the lowest to the highest
+    uint32_t highestSacked = 0;
+    for (uint32_t i = 1; i < segments; i += 2)
+    {
+        Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+        sack->AddSackBlock(TcpOptionSack::SackBlock(head + i * 1000, head + (i + 1) * 1000));
+        NS_TEST_ASSERT_MSG_EQ(txBuf->Update(sack->GetSackList()), 1000, "Segment not SACKed");
+        highestSacked = i;
+    }
+
+    // The segments below the third highest SACKed one are lost
+    uint32_t lostBelow = highestSacked - 4;
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), segments / 2 * 1000, "Wrong SACKed count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), (lostBelow + 1) / 2 * 1000, "Wrong lost count");
+    for (uint32_t i = 0; i < segments; i += 2)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + i * 1000),
+                              (i < lostBelow),
+                              "Wrong lost state of segment " << i);
+    }
+
+    SequenceNumber32 ret;
+    SequenceNumber32 retHigh;
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true), true, "No segment to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, head, "The head should be retransmitted first");
+
+    // Retransmit the head, then ACK it along with half of the window
+    txBuf->CopyFromSequence(1000, head);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 1000, "Wrong retransmitted count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + 1000),
+                          true,
+                          "The retransmitted head should be ACKed");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + 3000),
+                          false,
+                          "This segment was not retransmitted");
+    txBuf->DiscardUpTo(head + segments / 2 * 1000);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 0, "Wrong retransmitted count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), segments / 4 * 1000, "Wrong SACKed count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(),
+                          (lostBelow + 1 - segments / 2) / 2 * 1000,
+                          "Wrong lost count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true), true, "No segment to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, head + segments / 2 * 1000, "The new head should be sent");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
@@ -20,25 +20,35 @@
 #include "radio-environment-map-helper.h"
 
 #include <ns3/abort.h>
+#include <ns3/antenna-model.h>
 #include <ns3/boolean.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/config.h>
 #include <ns3/constant-position-mobility-model.h>
 #include <ns3/double.h>
+#include <ns3/enum.h>
 #include <ns3/integer.h>
 #include <ns3/log.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
 #include <ns3/lte-spectrum-value-helper.h>
 #include <ns3/mobility-building-info.h>
 #include <ns3/node.h>
 #include <ns3/pointer.h>
+#include <ns3/propagation-loss-model.h>
 #include <ns3/rem-spectrum-phy.h>
 #include <ns3/simulator.h>
 #include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-converter.h>
 #include <ns3/string.h>
 #include <ns3/uinteger.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <limits>
+#include <thread>
 
 namespace ns3
 {
@@ -47,6 +57,60 @@ NS_LOG_COMPONENT_DEFINE("RadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED(RadioEnvironmentMapHelper);
 
+namespace
+{
+
+/** The magic number and version which start the files of the Tiled format. */
+const char TILED_REM_MAGIC[8] = {'N', 'S', '3', 'R', 'E', 'M', 'T', 1};
+
+/**
+ * Write an integer to a stream, in little-endian order.
+ * \param os the stream
+ * \param value the integer
+ * \param size the number of bytes of the integer
+ */
+void
+WriteLittleEndian(std::ostream& os, uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++)
+    {
+        os.put(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+/**
+ * Write a double to a stream, as its little-endian IEEE 754 representation.
+ * \param os the stream
+ * \param value the double
+ */
+void
+WriteDouble(std::ostream& os, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteLittleEndian(os, bits, 8);
+}
+
+/**
+ * Create the mobility model of a point of an offline map, or of a copy of a
+ * transmitter, with the building information that BuildingsHelper::Install
+ * would aggregate.
+ * \param position the position
+ * \return the mobility model
+ */
+Ptr<MobilityModel>
+CreateRemMobility(const Vector& position)
+{
+    Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo>();
+    mobility->AggregateObject(buildingInfo);
+    mobility->SetPosition(position);
+    buildingInfo->MakeConsistent(mobility);
+    return mobility;
+}
+
+} // unnamed namespace
+
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper()
 {
 }
@@ -169,7 +233,35 @@ RadioEnvironmentMapHelper::GetTypeId()
                           "default value is -1, what means REM will be averaged from all RBs",
                           IntegerValue(-1),
                           MakeIntegerAccessor(&RadioEnvironmentMapHelper::m_rbId),
-                          MakeIntegerChecker<int32_t>());
+                          MakeIntegerChecker<int32_t>())
+            .AddAttribute("Offline",
+                          "If true, the map is evaluated directly from the signals transmitted in "
+                          "the channel before its generation, with the antenna and propagation "
+                          "loss models of the channel, instead of being measured by listeners "
+                          "installed in the channel",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RadioEnvironmentMapHelper::m_offline),
+                          MakeBooleanChecker())
+            .AddAttribute("Threads",
+                          "The number of threads evaluating an offline map (0 for one thread per "
+                          "hardware thread)",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&RadioEnvironmentMapHelper::m_threads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("OutputFormat",
+                          "The format of the output file of an offline map",
+                          EnumValue(RadioEnvironmentMapHelper::TEXT),
+                          MakeEnumAccessor(&RadioEnvironmentMapHelper::m_outputFormat),
+                          MakeEnumChecker(RadioEnvironmentMapHelper::TEXT,
+                                          "Text",
+                                          RadioEnvironmentMapHelper::TILED,
+                                          "Tiled"))
+            .AddAttribute("TileSize",
+                          "The width (number of points) of the square tiles in which an offline "
+                          "map is evaluated and stored by the Tiled output format",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&RadioEnvironmentMapHelper::m_tileSize),
+                          MakeUintegerChecker<uint32_t>(1, std::numeric_limits<uint16_t>::max()));
     return tid;
 }
 
@@ -203,7 +295,7 @@ void
 RadioEnvironmentMapHelper::Install()
 {
     NS_LOG_FUNCTION(this);
-    if (!m_rem.empty())
+    if (!m_rem.empty() || !m_transmitters.empty())
     {
         NS_FATAL_ERROR("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -220,7 +312,12 @@ RadioEnvironmentMapHelper::Install()
                         "object at " << m_channelPath << " is not of type SpectrumChannel");
     }
 
-    m_outFile.open(m_outputFile.c_str());
+    std::ios::openmode mode = std::ios::out;
+    if (m_offline && m_outputFormat == TILED)
+    {
+        mode |= std::ios::binary;
+    }
+    m_outFile.open(m_outputFile.c_str(), mode);
     if (!m_outFile.is_open())
     {
         NS_FATAL_ERROR("Can't open file " << (m_outputFile));
@@ -235,9 +332,52 @@ RadioEnvironmentMapHelper::Install()
         startDelay = 0.5001;
     }
 
+    if (m_offline)
+    {
+        // the map is generated from the signals transmitted until then
+        m_channel->TraceConnectWithoutContext(
+            "TxSigParams",
+            MakeCallback(&RadioEnvironmentMapHelper::RecordSignal, this));
+        Simulator::Schedule(Seconds(startDelay), &RadioEnvironmentMapHelper::RenderOffline, this);
+        return;
+    }
+
     Simulator::Schedule(Seconds(startDelay), &RadioEnvironmentMapHelper::DelayedInstall, this);
 }
 
+void
+RadioEnvironmentMapHelper::Rerender()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!m_offline || !m_channel || m_outFile.is_open(),
+                    "Only an offline map which has been generated can be updated");
+
+    std::vector<Transmitter*> moved;
+    for (auto& [phy, tx] : m_transmitters)
+    {
+        if (tx.mobility->GetPosition() != tx.position)
+        {
+            moved.push_back(&tx);
+        }
+    }
+    NS_LOG_LOGIC(moved.size() << " of " << m_transmitters.size() << " transmitters moved");
+    ComputeRxPower(moved);
+
+    std::ios::openmode mode = std::ios::out;
+    if (m_outputFormat == TILED)
+    {
+        mode |= std::ios::binary;
+    }
+    m_outFile.open(m_outputFile.c_str(), mode);
+    if (!m_outFile.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << (m_outputFile));
+        return;
+    }
+    WriteOffline();
+    m_outFile.close();
+}
+
 void
 RadioEnvironmentMapHelper::DelayedInstall()
 {
@@ -359,6 +499,229 @@ RadioEnvironmentMapHelper::PrintAndReset()
     }
 }
 
+void
+RadioEnvironmentMapHelper::RecordSignal(Ptr<SpectrumSignalParameters> params)
+{
+    NS_LOG_FUNCTION(this << params);
+
+    // the signals which RemSpectrumPhy would measure
+    bool measured = m_useDataChannel
+                        ? bool(DynamicCast<LteSpectrumSignalParametersDataFrame>(params))
+                        : bool(DynamicCast<LteSpectrumSignalParametersDlCtrlFrame>(params));
+    if (!measured || !params->txPhy->GetMobility())
+    {
+        return;
+    }
+
+    Ptr<const SpectrumModel> rxSpectrumModel =
+        LteSpectrumValueHelper::GetSpectrumModel(m_earfcn, m_bandwidth);
+    Ptr<SpectrumValue> psd = params->psd;
+    if (psd->GetSpectrumModelUid() != rxSpectrumModel->GetUid())
+    {
+        psd = SpectrumConverter(psd->GetSpectrumModel(), rxSpectrumModel).Convert(psd);
+    }
+
+    // the last signal of each transmitter is used
+    Transmitter& tx = m_transmitters[params->txPhy];
+    tx.mobility = params->txPhy->GetMobility();
+    tx.antenna = params->txAntenna;
+    tx.power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral(*psd);
+}
+
+void
+RadioEnvironmentMapHelper::RenderOffline()
+{
+    NS_LOG_FUNCTION(this);
+    m_channel->TraceDisconnectWithoutContext(
+        "TxSigParams",
+        MakeCallback(&RadioEnvironmentMapHelper::RecordSignal, this));
+    m_xStep = (m_xMax - m_xMin) / (m_xRes - 1);
+    m_yStep = (m_yMax - m_yMin) / (m_yRes - 1);
+
+    std::vector<Transmitter*> transmitters;
+    for (auto& [phy, tx] : m_transmitters)
+    {
+        transmitters.push_back(&tx);
+    }
+    NS_LOG_LOGIC("generating the map of " << transmitters.size() << " transmitters");
+    ComputeRxPower(transmitters);
+    WriteOffline();
+    Finalize();
+}
+
+void
+RadioEnvironmentMapHelper::ComputeRxPower(const std::vector<Transmitter*>& transmitters)
+{
+    NS_LOG_FUNCTION(this << transmitters.size());
+    if (transmitters.empty())
+    {
+        return;
+    }
+
+    uint32_t xTiles = (m_xRes + m_tileSize - 1) / m_tileSize;
+    uint32_t yTiles = (m_yRes + m_tileSize - 1) / m_tileSize;
+    uint32_t nThreads = m_threads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min(nThreads, xTiles * yTiles);
+
+    DoubleValue maxLossDb;
+    m_channel->GetAttribute("MaxLossDb", maxLossDb);
+    PropagationLossModel* propagationLoss = PeekPointer(m_channel->GetPropagationLossModel());
+    if (nThreads > 1 && propagationLoss && !propagationLoss->IsPositionOnly())
+    {
+        // the models with a state, random variables, or using the buildings
+        // shared by the mobility models of all the threads, are not thread-safe
+        NS_LOG_WARN("The propagation loss model does not only depend on the positions, the map "
+                    "is evaluated on a single thread");
+        nThreads = 1;
+    }
+
+    //
+    // The reference counts of the objects may not be thread-safe, hence the
+    // objects used by the threads are created beforehand, and the threads
+    // only use the shared models through raw pointers: each thread evaluates
+    // the losses with its own mobility models, for the points of the map and
+    // for copies of the transmitters.
+    //
+    struct Worker
+    {
+        Ptr<MobilityModel> rx;               //!< Mobility model of the points
+        std::vector<Ptr<MobilityModel>> txs; //!< Copies of the transmitters
+    };
+
+    std::vector<Worker> workers(nThreads);
+    for (auto tx : transmitters)
+    {
+        tx->position = tx->mobility->GetPosition();
+        tx->rxPower.assign(static_cast<std::size_t>(m_xRes) * m_yRes, 0);
+    }
+    for (auto& worker : workers)
+    {
+        worker.rx = CreateRemMobility(Vector(m_xMin, m_yMin, m_z));
+        for (auto tx : transmitters)
+        {
+            worker.txs.push_back(CreateRemMobility(tx->position));
+        }
+    }
+
+    std::atomic<uint32_t> next(0);
+    auto run = [&](Worker* worker) {
+        MobilityBuildingInfo* buildingInfo =
+            PeekPointer(worker->rx->GetObject<MobilityBuildingInfo>());
+        for (uint32_t tile = next++; tile < xTiles * yTiles; tile = next++)
+        {
+            uint32_t xFirst = (tile / yTiles) * m_tileSize;
+            uint32_t yFirst = (tile % yTiles) * m_tileSize;
+            uint32_t xEnd = std::min<uint32_t>(xFirst + m_tileSize, m_xRes);
+            uint32_t yEnd = std::min<uint32_t>(yFirst + m_tileSize, m_yRes);
+            for (uint32_t i = xFirst; i < xEnd; i++)
+            {
+                for (uint32_t j = yFirst; j < yEnd; j++)
+                {
+                    Vector position(m_xMin + i * m_xStep, m_yMin + j * m_yStep, m_z);
+                    worker->rx->SetPosition(position);
+                    if (nThreads == 1)
+                    {
+                        buildingInfo->MakeConsistent(worker->rx);
+                    }
+                    // the losses of MultiModelSpectrumChannel::StartTxToRxPhys
+                    for (std::size_t t = 0; t < transmitters.size(); t++)
+                    {
+                        Transmitter* tx = transmitters[t];
+                        double pathLossDb = 0;
+                        if (tx->antenna)
+                        {
+                            Angles txAngles(position, tx->position);
+                            pathLossDb -= PeekPointer(tx->antenna)->GetGainDb(txAngles);
+                        }
+                        if (propagationLoss)
+                        {
+                            pathLossDb -=
+                                propagationLoss->CalcRxPower(0, worker->txs[t], worker->rx);
+                        }
+                        if (pathLossDb <= maxLossDb.Get())
+                        {
+                            tx->rxPower[i * m_yRes + j] =
+                                tx->power * std::pow(10.0, -pathLossDb / 10.0);
+                        }
+                    }
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(run, &workers[i]);
+    }
+    run(&workers[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void
+RadioEnvironmentMapHelper::WriteOffline()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<float> sinr(static_cast<std::size_t>(m_xRes) * m_yRes);
+    for (std::size_t k = 0; k < sinr.size(); k++)
+    {
+        // the strongest signal against the others, as in RemSpectrumPhy::GetSinr
+        double referenceSignalPower = 0;
+        double sumPower = 0;
+        for (const auto& [phy, tx] : m_transmitters)
+        {
+            sumPower += tx.rxPower[k];
+            referenceSignalPower = std::max<double>(referenceSignalPower, tx.rxPower[k]);
+        }
+        sinr[k] = referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+    }
+
+    if (m_outputFormat == TEXT)
+    {
+        for (uint32_t i = 0; i < m_xRes; i++)
+        {
+            for (uint32_t j = 0; j < m_yRes; j++)
+            {
+                m_outFile << m_xMin + i * m_xStep << "\t" << m_yMin + j * m_yStep << "\t" << m_z
+                          << "\t" << sinr[i * m_yRes + j] << "\n";
+            }
+        }
+        return;
+    }
+
+    m_outFile.write(TILED_REM_MAGIC, sizeof(TILED_REM_MAGIC));
+    WriteLittleEndian(m_outFile, m_xRes, 4);
+    WriteLittleEndian(m_outFile, m_yRes, 4);
+    WriteLittleEndian(m_outFile, m_tileSize, 4);
+    for (double value : {m_xMin, m_xMax, m_yMin, m_yMax, m_z})
+    {
+        WriteDouble(m_outFile, value);
+    }
+    for (uint32_t xFirst = 0; xFirst < m_xRes; xFirst += m_tileSize)
+    {
+        for (uint32_t yFirst = 0; yFirst < m_yRes; yFirst += m_tileSize)
+        {
+            for (uint32_t i = xFirst; i < std::min<uint32_t>(xFirst + m_tileSize, m_xRes); i++)
+            {
+                for (uint32_t j = yFirst; j < std::min<uint32_t>(yFirst + m_tileSize, m_yRes);
+                     j++)
+                {
+                    uint32_t bits;
+                    static_assert(sizeof(bits) == sizeof(float), "float is not 32 bits wide");
+                    std::memcpy(&bits, &sinr[i * m_yRes + j], sizeof(bits));
+                    WriteLittleEndian(m_outFile, bits, 4);
+                }
+            }
+        }
+    }
+}
+
 void
 RadioEnvironmentMapHelper::Finalize()
 {
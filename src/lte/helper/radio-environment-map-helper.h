@@ -21,8 +21,11 @@
 #define RADIO_ENVIRONMENT_MAP_HELPER_H
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 
 #include <fstream>
+#include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -33,6 +36,9 @@ class NetDevice;
 class SpectrumChannel;
 // class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class SpectrumPhy;
+class SpectrumSignalParameters;
 
 /**
  * \ingroup lte
@@ -40,10 +46,25 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is measured by listeners installed in the channel, a
+ * part of the map at a time. With the Offline attribute, the signals
+ * transmitted in the channel before the map generation are recorded, and the
+ * map is evaluated directly from the antenna and propagation loss models of
+ * the channel, on several threads, without simulating the reception of the
+ * signals. The received powers are kept, so that Rerender() can update the
+ * map after some transmitters moved.
  */
 class RadioEnvironmentMapHelper : public Object
 {
   public:
+    /// The formats of the output file
+    enum OutputFormat
+    {
+        TEXT,  //!< One line per point, with the coordinates and the SINR
+        TILED, //!< Binary, the SINR of the points grouped by square tiles
+    };
+
     RadioEnvironmentMapHelper();
     ~RadioEnvironmentMapHelper() override;
 
@@ -72,6 +93,14 @@ class RadioEnvironmentMapHelper : public Object
      */
     void Install();
 
+    /**
+     * Update an offline map after some of its transmitters moved: the
+     * received powers of the transmitters whose position changed since the
+     * last generation of the map are evaluated again, and the output file is
+     * rewritten.
+     */
+    void Rerender();
+
   private:
     /**
      * Scheduled by Install() to perform the actual generation of map.
@@ -104,6 +133,41 @@ class RadioEnvironmentMapHelper : public Object
     /// Called when the map generation procedure has been completed.
     void Finalize();
 
+    /**
+     * Record a signal transmitted in the channel before an offline map is
+     * generated.
+     *
+     * \param params the parameters of the signal
+     */
+    void RecordSignal(Ptr<SpectrumSignalParameters> params);
+
+    /// Generate the map from the signals recorded, instead of DelayedInstall().
+    void RenderOffline();
+
+    /// A transmitter of an offline map
+    struct Transmitter
+    {
+        Ptr<MobilityModel> mobility; //!< Mobility model of the transmitter
+        Ptr<AntennaModel> antenna;   //!< Antenna of the transmitter, if any
+        double power;                //!< Received power without losses (W)
+        Vector position;             //!< Position of the last evaluation of rxPower
+        std::vector<float> rxPower;  //!< Received power at each point of the map (W)
+    };
+
+    /**
+     * Evaluate the received powers of some transmitters at each point of the
+     * map, on m_threads threads.
+     *
+     * \param transmitters the transmitters
+     */
+    void ComputeRxPower(const std::vector<Transmitter*>& transmitters);
+
+    /// Write the SINR of an offline map to the output file.
+    void WriteOffline();
+
+    /// Transmitters of an offline map, by PHY
+    std::map<Ptr<SpectrumPhy>, Transmitter> m_transmitters;
+
     /// A complete Radio Environment Map is composed of many of this structure.
     struct RemPoint
     {
@@ -159,6 +223,11 @@ class RadioEnvironmentMapHelper : public Object
     bool m_useDataChannel; ///< The `UseDataChannel` attribute.
     int32_t m_rbId;        ///< The `RbId` attribute.
 
+    bool m_offline;              ///< The `Offline` attribute.
+    uint32_t m_threads;          ///< The `Threads` attribute.
+    OutputFormat m_outputFormat; ///< The `OutputFormat` attribute.
+    uint32_t m_tileSize;         ///< The `TileSize` attribute.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 } // namespace ns3
@@ -0,0 +1,299 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/lte-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/radio-environment-map-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("LteTestRadioEnvironmentMap");
+
+/**
+ * \ingroup lte-test
+ *
+ * \brief Test case checking that the offline maps of the
+ * RadioEnvironmentMapHelper, evaluated on one or several threads, in the
+ * Text or Tiled formats, are the maps measured by the listeners installed
+ * in the channel, and that Rerender() updates a map after a transmitter
+ * moved.
+ *
+ * Two eNBs transmit in a channel with the deterministic Friis propagation
+ * loss model.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+  public:
+    LteRadioEnvironmentMapTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Generate a map of the two eNBs.
+     *
+     * \param offline the value of the Offline attribute
+     * \param threads the value of the Threads attribute
+     * \param format the value of the OutputFormat attribute
+     * \param filename the output file
+     * \param enb2 the position of the second eNB
+     * \param rerender whether the second eNB moves to m_enb2Moved after the
+     * generation of the map, which is then updated with Rerender()
+     */
+    void GenerateMap(bool offline,
+                     uint32_t threads,
+                     RadioEnvironmentMapHelper::OutputFormat format,
+                     std::string filename,
+                     const Vector& enb2,
+                     bool rerender = false);
+
+    /**
+     * Read a map in the Text format.
+     * \param filename the file
+     * \param sinr the SINR of the points, the y coordinate varying first
+     */
+    void ReadText(std::string filename, std::vector<double>& sinr);
+
+    /**
+     * Read a map in the Tiled format.
+     * \param filename the file
+     * \param sinr the SINR of the points, the y coordinate varying first
+     */
+    void ReadTiled(std::string filename, std::vector<double>& sinr);
+
+    /**
+     * Check that two maps are equal.
+     * \param actual the map
+     * \param expected the expected map
+     * \param tolerance the relative tolerance on the SINR of each point
+     * \param name the name of the map
+     */
+    void CheckMap(const std::vector<double>& actual,
+                  const std::vector<double>& expected,
+                  double tolerance,
+                  std::string name);
+
+    static const uint32_t X_RES = 20;       //!< the resolution along the x axis
+    static const uint32_t Y_RES = 15;       //!< the resolution along the y axis
+    static const uint32_t TILE_SIZE = 8;    //!< the width of the tiles
+    const Vector m_enb1{200, 300, 30};      //!< the position of the first eNB
+    const Vector m_enb2{800, 300, 30};      //!< the initial position of the second eNB
+    const Vector m_enb2Moved{600, 500, 30}; //!< the position the second eNB moves to
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase()
+    : TestCase("Check the offline maps of the RadioEnvironmentMapHelper")
+{
+}
+
+void
+LteRadioEnvironmentMapTestCase::GenerateMap(bool offline,
+                                            uint32_t threads,
+                                            RadioEnvironmentMapHelper::OutputFormat format,
+                                            std::string filename,
+                                            const Vector& enb2,
+                                            bool rerender)
+{
+    Ptr<LteHelper> lteHelper = CreateObject<LteHelper>();
+    lteHelper->SetAttribute("PathlossModel", StringValue("ns3::FriisPropagationLossModel"));
+
+    NodeContainer enbNodes;
+    enbNodes.Create(2);
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator>();
+    positions->Add(m_enb1);
+    positions->Add(enb2);
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positions);
+    mobility.Install(enbNodes);
+    lteHelper->InstallEnbDevice(enbNodes);
+
+    Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper>();
+    remHelper->SetAttribute("Channel", PointerValue(lteHelper->GetDownlinkSpectrumChannel()));
+    remHelper->SetAttribute("OutputFile", StringValue(filename));
+    remHelper->SetAttribute("XMin", DoubleValue(0.0));
+    remHelper->SetAttribute("XMax", DoubleValue(1000.0));
+    remHelper->SetAttribute("YMin", DoubleValue(0.0));
+    remHelper->SetAttribute("YMax", DoubleValue(600.0));
+    remHelper->SetAttribute("XRes", UintegerValue(X_RES));
+    remHelper->SetAttribute("YRes", UintegerValue(Y_RES));
+    remHelper->SetAttribute("Z", DoubleValue(1.5));
+    remHelper->SetAttribute("Offline", BooleanValue(offline));
+    remHelper->SetAttribute("Threads", UintegerValue(threads));
+    remHelper->SetAttribute("OutputFormat", EnumValue(format));
+    remHelper->SetAttribute("TileSize", UintegerValue(TILE_SIZE));
+    remHelper->Install();
+
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    if (rerender)
+    {
+        enbNodes.Get(1)->GetObject<MobilityModel>()->SetPosition(m_enb2Moved);
+        remHelper->Rerender();
+    }
+    Simulator::Destroy();
+}
+
+void
+LteRadioEnvironmentMapTestCase::ReadText(std::string filename, std::vector<double>& sinr)
+{
+    std::ifstream file(filename);
+    NS_TEST_ASSERT_MSG_EQ(file.is_open(), true, "Can't open " << filename);
+    double x;
+    double y;
+    double z;
+    double value;
+    while (file >> x >> y >> z >> value)
+    {
+        sinr.push_back(value);
+    }
+}
+
+void
+LteRadioEnvironmentMapTestCase::ReadTiled(std::string filename, std::vector<double>& sinr)
+{
+    std::ifstream file(filename, std::ios::binary);
+    NS_TEST_ASSERT_MSG_EQ(file.is_open(), true, "Can't open " << filename);
+    auto readUint32 = [&file]() {
+        unsigned char bytes[4];
+        file.read(reinterpret_cast<char*>(bytes), 4);
+        return uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16 |
+               uint32_t(bytes[3]) << 24;
+    };
+
+    char magic[8];
+    file.read(magic, sizeof(magic));
+    NS_TEST_ASSERT_MSG_EQ(std::string(magic, 7), "NS3REMT", "Unexpected magic number");
+    NS_TEST_ASSERT_MSG_EQ(int(magic[7]), 1, "Unexpected version");
+    uint32_t xRes = readUint32();
+    uint32_t yRes = readUint32();
+    uint32_t tileSize = readUint32();
+    NS_TEST_ASSERT_MSG_EQ(xRes, X_RES, "Unexpected resolution along the x axis");
+    NS_TEST_ASSERT_MSG_EQ(yRes, Y_RES, "Unexpected resolution along the y axis");
+    NS_TEST_ASSERT_MSG_EQ(tileSize, TILE_SIZE, "Unexpected tile size");
+    // the bounds and the z coordinate
+    file.ignore(5 * 8);
+
+    sinr.assign(xRes * yRes, 0);
+    for (uint32_t xFirst = 0; xFirst < xRes; xFirst += tileSize)
+    {
+        for (uint32_t yFirst = 0; yFirst < yRes; yFirst += tileSize)
+        {
+            for (uint32_t i = xFirst; i < std::min(xFirst + tileSize, xRes); i++)
+            {
+                for (uint32_t j = yFirst; j < std::min(yFirst + tileSize, yRes); j++)
+                {
+                    uint32_t bits = readUint32();
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    sinr[i * yRes + j] = value;
+                }
+            }
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(bool(file), true, "The file is truncated");
+    file.get();
+    NS_TEST_ASSERT_MSG_EQ(file.eof(), true, "The file is too long");
+}
+
+void
+LteRadioEnvironmentMapTestCase::CheckMap(const std::vector<double>& actual,
+                                         const std::vector<double>& expected,
+                                         double tolerance,
+                                         std::string name)
+{
+    NS_TEST_ASSERT_MSG_EQ(actual.size(), X_RES * Y_RES, "Unexpected size of the " << name);
+    NS_TEST_ASSERT_MSG_EQ(expected.size(), X_RES * Y_RES, "Unexpected size of the reference");
+    for (std::size_t k = 0; k < actual.size(); k++)
+    {
+        NS_TEST_ASSERT_MSG_GT(expected[k], 0, "The reference map has no signal at point " << k);
+        NS_TEST_EXPECT_MSG_EQ_TOL(actual[k],
+                                  expected[k],
+                                  expected[k] * tolerance,
+                                  "Unexpected SINR of the " << name << " at point " << k);
+    }
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun()
+{
+    std::string online = CreateTempDirFilename("rem-online.out");
+    std::string offline = CreateTempDirFilename("rem-offline.out");
+    std::string tiled = CreateTempDirFilename("rem-tiled.out");
+    std::string moved = CreateTempDirFilename("rem-moved.out");
+    std::string rerendered = CreateTempDirFilename("rem-rerendered.out");
+
+    GenerateMap(false, 1, RadioEnvironmentMapHelper::TEXT, online, m_enb2);
+    GenerateMap(true, 1, RadioEnvironmentMapHelper::TEXT, offline, m_enb2);
+    GenerateMap(true, 4, RadioEnvironmentMapHelper::TILED, tiled, m_enb2);
+
+    std::vector<double> onlineMap;
+    std::vector<double> offlineMap;
+    std::vector<double> tiledMap;
+    ReadText(online, onlineMap);
+    ReadText(offline, offlineMap);
+    ReadTiled(tiled, tiledMap);
+    // the received powers are stored as floats, and the Text format has 6
+    // significant digits
+    CheckMap(offlineMap, onlineMap, 1e-4, "offline map");
+    CheckMap(tiledMap, onlineMap, 1e-4, "tiled map on 4 threads");
+
+    // the map updated after the second eNB moved is the one generated with
+    // the eNB at its new position
+    GenerateMap(true, 1, RadioEnvironmentMapHelper::TEXT, rerendered, m_enb2, true);
+    GenerateMap(false, 1, RadioEnvironmentMapHelper::TEXT, moved, m_enb2Moved);
+    std::vector<double> rerenderedMap;
+    std::vector<double> movedMap;
+    ReadText(rerendered, rerenderedMap);
+    ReadText(moved, movedMap);
+    CheckMap(rerenderedMap, movedMap, 1e-4, "rerendered map");
+}
+
+/**
+ * \ingroup lte-test
+ *
+ * \brief Test suite for the RadioEnvironmentMapHelper.
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+  public:
+    LteRadioEnvironmentMapTestSuite();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite()
+    : TestSuite("lte-radio-environment-map", SYSTEM)
+{
+    AddTestCase(new LteRadioEnvironmentMapTestCase, TestCase::QUICK);
+}
+
+/**
+ * \ingroup lte-test
+ * Static variable for test initialization
+ */
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite;
@@ -0,0 +1,280 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "spatial-index.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpatialIndex");
+
+NS_OBJECT_ENSURE_REGISTERED(SpatialIndex);
+
+TypeId
+SpatialIndex::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SpatialIndex").SetParent<Object>().SetGroupName("Mobility");
+    return tid;
+}
+
+SpatialIndex::SpatialIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(GridSpatialIndex);
+
+TypeId
+GridSpatialIndex::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::GridSpatialIndex")
+            .SetParent<SpatialIndex>()
+            .SetGroupName("Mobility")
+            .AddConstructor<GridSpatialIndex>()
+            .AddAttribute("CellSize",
+                          "The size (m) of the side of the square cells of the grid. "
+                          "It must not be changed once elements have been added.",
+                          DoubleValue(100.0),
+                          MakeDoubleAccessor(&GridSpatialIndex::m_cellSize),
+                          MakeDoubleChecker<double>(std::numeric_limits<double>::min()));
+    return tid;
+}
+
+GridSpatialIndex::GridSpatialIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+GridSpatialIndex::~GridSpatialIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+GridSpatialIndex::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& [id, item] : m_items)
+    {
+        // disconnect once per mobility model
+        if (m_idsByMobility.erase(PeekPointer(item.mobility)) > 0)
+        {
+            item.mobility->TraceDisconnectWithoutContext(
+                "CourseChange",
+                MakeCallback(&GridSpatialIndex::CourseChanged, this));
+        }
+    }
+    m_items.clear();
+    m_cells.clear();
+    m_moving.clear();
+    m_idsByMobility.clear();
+    SpatialIndex::DoDispose();
+}
+
+int32_t
+GridSpatialIndex::GetCellCoordinate(double value) const
+{
+    double cell = std::floor(value / m_cellSize);
+    cell = std::clamp<double>(cell,
+                              std::numeric_limits<int32_t>::min(),
+                              std::numeric_limits<int32_t>::max());
+    return static_cast<int32_t>(cell);
+}
+
+GridSpatialIndex::CellKey
+GridSpatialIndex::GetCellKey(int32_t x, int32_t y)
+{
+    return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void
+GridSpatialIndex::Insert(uint32_t id, Item& item)
+{
+    NS_LOG_FUNCTION(this << id);
+    if (item.mobility->GetVelocity() == Vector(0, 0, 0))
+    {
+        Vector position = item.mobility->GetPosition();
+        item.moving = false;
+        item.cell = GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.y));
+        m_cells[item.cell].push_back(id);
+    }
+    else
+    {
+        item.moving = true;
+        m_moving.push_back(id);
+    }
+}
+
+void
+GridSpatialIndex::Erase(uint32_t id, const Item& item)
+{
+    NS_LOG_FUNCTION(this << id);
+    if (item.moving)
+    {
+        auto it = std::find(m_moving.begin(), m_moving.end(), id);
+        NS_ASSERT(it != m_moving.end());
+        *it = m_moving.back();
+        m_moving.pop_back();
+        return;
+    }
+    auto cellIt = m_cells.find(item.cell);
+    NS_ASSERT(cellIt != m_cells.end());
+    auto& ids = cellIt->second;
+    auto it = std::find(ids.begin(), ids.end(), id);
+    NS_ASSERT(it != ids.end());
+    *it = ids.back();
+    ids.pop_back();
+    if (ids.empty())
+    {
+        m_cells.erase(cellIt);
+    }
+}
+
+void
+GridSpatialIndex::Add(Ptr<MobilityModel> mobility, uint32_t id)
+{
+    NS_LOG_FUNCTION(this << mobility << id);
+    NS_ASSERT_MSG(mobility, "A mobility model is required to index element " << id);
+    auto [it, inserted] = m_items.emplace(id, Item{mobility, false, 0});
+    NS_ABORT_MSG_IF(!inserted, "Element " << id << " is already in the index");
+    Insert(id, it->second);
+
+    auto& ids = m_idsByMobility[PeekPointer(mobility)];
+    if (ids.empty())
+    {
+        mobility->TraceConnectWithoutContext("CourseChange",
+                                             MakeCallback(&GridSpatialIndex::CourseChanged, this));
+    }
+    ids.push_back(id);
+}
+
+void
+GridSpatialIndex::Remove(uint32_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    auto it = m_items.find(id);
+    if (it == m_items.end())
+    {
+        return;
+    }
+    Erase(id, it->second);
+
+    auto mobIt = m_idsByMobility.find(PeekPointer(it->second.mobility));
+    NS_ASSERT(mobIt != m_idsByMobility.end());
+    mobIt->second.erase(std::find(mobIt->second.begin(), mobIt->second.end(), id));
+    if (mobIt->second.empty())
+    {
+        m_idsByMobility.erase(mobIt);
+        it->second.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&GridSpatialIndex::CourseChanged, this));
+    }
+    m_items.erase(it);
+}
+
+bool
+GridSpatialIndex::Contains(uint32_t id) const
+{
+    return m_items.find(id) != m_items.end();
+}
+
+std::size_t
+GridSpatialIndex::GetN() const
+{
+    return m_items.size();
+}
+
+std::size_t
+GridSpatialIndex::GetNMoving() const
+{
+    return m_moving.size();
+}
+
+void
+GridSpatialIndex::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto mobIt = m_idsByMobility.find(PeekPointer(mobility));
+    if (mobIt == m_idsByMobility.end())
+    {
+        return;
+    }
+    for (const auto id : mobIt->second)
+    {
+        auto& item = m_items.at(id);
+        Erase(id, item);
+        Insert(id, item);
+    }
+}
+
+void
+GridSpatialIndex::GetCandidates(const Vector& position,
+                                double range,
+                                std::vector<uint32_t>& ids) const
+{
+    NS_LOG_FUNCTION(this << position << range);
+    NS_ASSERT(range >= 0);
+
+    ids.insert(ids.end(), m_moving.begin(), m_moving.end());
+
+    const int32_t xMin = GetCellCoordinate(position.x - range);
+    const int32_t xMax = GetCellCoordinate(position.x + range);
+    const int32_t yMin = GetCellCoordinate(position.y - range);
+    const int32_t yMax = GetCellCoordinate(position.y + range);
+    const double nCells =
+        (static_cast<double>(xMax) - xMin + 1) * (static_cast<double>(yMax) - yMin + 1);
+
+    if (nCells > m_cells.size())
+    {
+        // cheaper to visit the non-empty cells than to look up every cell in range
+        for (const auto& [key, cellIds] : m_cells)
+        {
+            auto x = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+            auto y = static_cast<int32_t>(static_cast<uint32_t>(key));
+            if (x >= xMin && x <= xMax && y >= yMin && y <= yMax)
+            {
+                ids.insert(ids.end(), cellIds.begin(), cellIds.end());
+            }
+        }
+        return;
+    }
+
+    for (int64_t x = xMin; x <= xMax; ++x)
+    {
+        for (int64_t y = yMin; y <= yMax; ++y)
+        {
+            auto it = m_cells.find(GetCellKey(static_cast<int32_t>(x), static_cast<int32_t>(y)));
+            if (it != m_cells.end())
+            {
+                ids.insert(ids.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+}
+
+} // namespace ns3
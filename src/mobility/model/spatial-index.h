@@ -0,0 +1,191 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "mobility-model.h"
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mobility
+ * \brief Index a set of mobility models by position.
+ *
+ * A spatial index keeps track of a set of elements, each identified by a
+ * caller-defined identifier and located by a MobilityModel, and returns
+ * the identifiers of the elements that may be located within a given
+ * range of a position. The returned set is conservative: it contains
+ * at least every element within range, but may contain elements which
+ * are further away, hence callers are expected to check the actual
+ * distance of each candidate.
+ *
+ * This is typically used by channels to avoid visiting every attached
+ * receiver when only the receivers within a maximum range matter.
+ */
+class SpatialIndex : public Object
+{
+  public:
+    /**
+     * Register this type with the TypeId system.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    SpatialIndex();
+    ~SpatialIndex() override;
+
+    /**
+     * Add an element to the index.
+     *
+     * \param mobility the mobility model locating the element
+     * \param id the identifier of the element, which must not be in the index yet
+     */
+    virtual void Add(Ptr<MobilityModel> mobility, uint32_t id) = 0;
+    /**
+     * Remove an element from the index. Nothing is done if the identifier
+     * is not in the index.
+     *
+     * \param id the identifier of the element
+     */
+    virtual void Remove(uint32_t id) = 0;
+    /**
+     * \param id the identifier of an element
+     * \return true if the element is in the index
+     */
+    virtual bool Contains(uint32_t id) const = 0;
+    /**
+     * \return the number of elements in the index
+     */
+    virtual std::size_t GetN() const = 0;
+    /**
+     * Append to the given vector the identifiers of the elements that may be
+     * located within the given range of the given position. The identifiers
+     * are appended in no particular order.
+     *
+     * \param position the position to look around
+     * \param range the range (m)
+     * \param ids the vector to which the identifiers are appended
+     */
+    virtual void GetCandidates(const Vector& position,
+                               double range,
+                               std::vector<uint32_t>& ids) const = 0;
+};
+
+/**
+ * \ingroup mobility
+ * \brief Spatial index based on a uniform grid over the x-y plane.
+ *
+ * Elements whose mobility model reports a null velocity are stored in the
+ * grid cell containing their current position. Elements which are moving
+ * are kept in a separate list and always returned as candidates, since
+ * their position changes without any notification. The index listens to
+ * the CourseChange trace source of each mobility model to move elements
+ * across cells and between the two sets; mobility models are therefore
+ * expected to notify course changes as soon as they happen (e.g., the
+ * LazyNotify attribute of the WaypointMobilityModel must not be set).
+ *
+ * The best performance is obtained when the cell size is in the order of
+ * the range used for the queries.
+ */
+class GridSpatialIndex : public SpatialIndex
+{
+  public:
+    /**
+     * Register this type with the TypeId system.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    GridSpatialIndex();
+    ~GridSpatialIndex() override;
+
+    void Add(Ptr<MobilityModel> mobility, uint32_t id) override;
+    void Remove(uint32_t id) override;
+    bool Contains(uint32_t id) const override;
+    std::size_t GetN() const override;
+    void GetCandidates(const Vector& position,
+                       double range,
+                       std::vector<uint32_t>& ids) const override;
+
+    /**
+     * \return the number of elements which are currently considered moving
+     */
+    std::size_t GetNMoving() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Key identifying a cell of the grid
+    typedef uint64_t CellKey;
+
+    /// Element of the index
+    struct Item
+    {
+        Ptr<MobilityModel> mobility; //!< the mobility model of the element
+        bool moving;                 //!< whether the element is in the list of moving elements
+        CellKey cell;                //!< the cell containing the element, if not moving
+    };
+
+    /**
+     * \param value a coordinate (m)
+     * \return the index of the cell containing the given coordinate
+     */
+    int32_t GetCellCoordinate(double value) const;
+    /**
+     * \param x the index of the cell along the x axis
+     * \param y the index of the cell along the y axis
+     * \return the key of the cell
+     */
+    static CellKey GetCellKey(int32_t x, int32_t y);
+    /**
+     * Store the given element in the grid or in the list of moving elements,
+     * depending on the current state of its mobility model.
+     *
+     * \param id the identifier of the element
+     * \param item the element
+     */
+    void Insert(uint32_t id, Item& item);
+    /**
+     * Remove the given element from the grid or from the list of moving elements.
+     *
+     * \param id the identifier of the element
+     * \param item the element
+     */
+    void Erase(uint32_t id, const Item& item);
+    /**
+     * Callback connected to the CourseChange trace source of the indexed
+     * mobility models.
+     *
+     * \param mobility the mobility model whose course changed
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    double m_cellSize;                                           //!< size of a cell (m)
+    std::unordered_map<uint32_t, Item> m_items;                  //!< indexed elements
+    std::unordered_map<CellKey, std::vector<uint32_t>> m_cells;  //!< non-empty cells
+    std::vector<uint32_t> m_moving;                              //!< moving elements
+    std::unordered_map<const MobilityModel*, std::vector<uint32_t>>
+        m_idsByMobility; //!< identifiers of the elements located by each mobility model
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_INDEX_H */
@@ -0,0 +1,214 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/spatial-index.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Check that the candidates returned by the GridSpatialIndex include
+ * every element within range, for random positions, cell sizes and ranges.
+ */
+class GridSpatialIndexQueryTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param cellSize the size of the cells of the grid (m)
+     */
+    GridSpatialIndexQueryTestCase(double cellSize);
+
+  private:
+    void DoRun() override;
+
+    double m_cellSize; ///< the size of the cells of the grid (m)
+};
+
+GridSpatialIndexQueryTestCase::GridSpatialIndexQueryTestCase(double cellSize)
+    : TestCase("Check GridSpatialIndex queries with cell size " + std::to_string(cellSize)),
+      m_cellSize(cellSize)
+{
+}
+
+void
+GridSpatialIndexQueryTestCase::DoRun()
+{
+    auto index = CreateObjectWithAttributes<GridSpatialIndex>("CellSize", DoubleValue(m_cellSize));
+    auto coordinate = CreateObject<UniformRandomVariable>();
+    coordinate->SetAttribute("Min", DoubleValue(-1000));
+    coordinate->SetAttribute("Max", DoubleValue(1000));
+    coordinate->SetStream(1);
+
+    std::vector<Ptr<MobilityModel>> mobilities;
+    for (uint32_t id = 0; id < 500; ++id)
+    {
+        auto mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(coordinate->GetValue(), coordinate->GetValue(), 0));
+        mobilities.push_back(mobility);
+        index->Add(mobility, id);
+    }
+    // a second element located by the same mobility model
+    index->Add(mobilities.front(), 500);
+    mobilities.push_back(mobilities.front());
+    NS_TEST_ASSERT_MSG_EQ(index->GetN(), 501, "Unexpected number of indexed elements");
+    NS_TEST_ASSERT_MSG_EQ(index->GetNMoving(), 0, "No element should be moving");
+
+    for (double range : {0.0, 10.0, 150.0, 5000.0})
+    {
+        for (uint32_t query = 0; query < 50; ++query)
+        {
+            Vector position(coordinate->GetValue(), coordinate->GetValue(), 0);
+            std::vector<uint32_t> candidates;
+            index->GetCandidates(position, range, candidates);
+            std::set<uint32_t> unique(candidates.begin(), candidates.end());
+            NS_TEST_ASSERT_MSG_EQ(unique.size(), candidates.size(), "Duplicate candidates");
+            for (uint32_t id = 0; id < mobilities.size(); ++id)
+            {
+                if (CalculateDistance(position, mobilities[id]->GetPosition()) <= range)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(unique.count(id),
+                                          1,
+                                          "Element " << id << " within " << range
+                                                     << "m of " << position << " not returned");
+                }
+            }
+        }
+    }
+
+    index->Remove(500);
+    index->Remove(500);
+    NS_TEST_ASSERT_MSG_EQ(index->Contains(500), false, "Element should have been removed");
+    NS_TEST_ASSERT_MSG_EQ(index->Contains(0), true, "Element should still be indexed");
+    NS_TEST_ASSERT_MSG_EQ(index->GetN(), 500, "Unexpected number of indexed elements");
+    index->Dispose();
+}
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Check that the GridSpatialIndex follows the course changes of
+ * the indexed mobility models.
+ */
+class GridSpatialIndexCourseChangeTestCase : public TestCase
+{
+  public:
+    GridSpatialIndexCourseChangeTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \param index the spatial index
+     * \param position the position to look around
+     * \param range the range (m)
+     * \param id the identifier of an element
+     * \return true if the element is a candidate for the given query
+     */
+    static bool IsCandidate(Ptr<SpatialIndex> index, Vector position, double range, uint32_t id);
+};
+
+GridSpatialIndexCourseChangeTestCase::GridSpatialIndexCourseChangeTestCase()
+    : TestCase("Check GridSpatialIndex course change handling")
+{
+}
+
+bool
+GridSpatialIndexCourseChangeTestCase::IsCandidate(Ptr<SpatialIndex> index,
+                                                  Vector position,
+                                                  double range,
+                                                  uint32_t id)
+{
+    std::vector<uint32_t> candidates;
+    index->GetCandidates(position, range, candidates);
+    return std::find(candidates.begin(), candidates.end(), id) != candidates.end();
+}
+
+void
+GridSpatialIndexCourseChangeTestCase::DoRun()
+{
+    auto index = CreateObjectWithAttributes<GridSpatialIndex>("CellSize", DoubleValue(10.0));
+    auto still = CreateObject<ConstantPositionMobilityModel>();
+    still->SetPosition(Vector(0, 0, 0));
+    auto moving = CreateObject<ConstantVelocityMobilityModel>();
+    moving->SetPosition(Vector(500, 0, 0));
+    index->Add(still, 0);
+    index->Add(moving, 1);
+
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(0, 0, 0), 1, 0), true, "Expected candidate");
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(0, 0, 0), 1, 1), false, "Out of range");
+
+    still->SetPosition(Vector(1000, 1000, 0));
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(0, 0, 0), 1, 0), false, "Out of range");
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(1000, 1000, 0), 1, 0),
+                          true,
+                          "Expected candidate after the position change");
+
+    moving->SetVelocity(Vector(-10, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(index->GetNMoving(), 1, "Element should be moving");
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(0, 0, 0), 1, 1),
+                          true,
+                          "Moving elements are always candidates");
+    Simulator::Schedule(Seconds(50), [&]() { moving->SetVelocity(Vector(0, 0, 0)); });
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(index->GetNMoving(), 0, "Element should have stopped");
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(0, 0, 0), 1, 1),
+                          true,
+                          "Expected candidate at its stop position");
+    NS_TEST_ASSERT_MSG_EQ(IsCandidate(index, Vector(500, 0, 0), 1, 1), false, "Out of range");
+
+    index->Dispose();
+    // the index is not notified anymore
+    moving->SetPosition(Vector(500, 0, 0));
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Spatial Index Test Suite
+ */
+class SpatialIndexTestSuite : public TestSuite
+{
+  public:
+    SpatialIndexTestSuite();
+};
+
+SpatialIndexTestSuite::SpatialIndexTestSuite()
+    : TestSuite("spatial-index", UNIT)
+{
+    for (double cellSize : {1.0, 37.5, 100.0, 10000.0})
+    {
+        AddTestCase(new GridSpatialIndexQueryTestCase(cellSize), TestCase::QUICK);
+    }
+    AddTestCase(new GridSpatialIndexCourseChangeTestCase, TestCase::QUICK);
+}
+
+/**
+ * \ingroup mobility-test
+ * Static variable for test initialization
+ */
+static SpatialIndexTestSuite g_spatialIndexTestSuite;
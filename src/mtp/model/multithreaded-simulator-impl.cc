@@ -0,0 +1,704 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::LogicalProcess* MultithreadedSimulatorImpl::g_currentLp =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The number of threads running the simulation, "
+                          "or 0 to use one thread per hardware thread. "
+                          "It must be set as a default value, before the simulator is created.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Lookahead",
+                          "The minimum delay of the events scheduled by a node on a node "
+                          "executed by another thread, or 0 to compute it from the "
+                          "Delay attribute of the channels.",
+                          TimeValue(Time(0)),
+                          MakeTimeAccessor(&MultithreadedSimulatorImpl::m_userLookahead),
+                          MakeTimeChecker(Time(0)));
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_maxThreads(0),
+      m_lookahead(0),
+      m_windowEnd(0),
+      m_parallel(false),
+      m_stop(false),
+      m_windowCount(0),
+      m_busyWorkers(0),
+      m_exit(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_global.uid = EventId::UID::VALID;
+    m_global.currentUid = EventId::UID::INVALID;
+    m_global.currentTs = 0;
+    m_global.currentContext = Simulator::NO_CONTEXT;
+    m_global.eventCount = 0;
+    m_global.objectUid = 0;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    DeliverRemoteEvents();
+    auto clear = [](LogicalProcess& lp) {
+        while (lp.events && !lp.events->IsEmpty())
+        {
+            Scheduler::Event next = lp.events->RemoveNext();
+            next.impl->Unref();
+        }
+        lp.events = nullptr;
+    };
+    for (auto& lp : m_lps)
+    {
+        clear(lp);
+    }
+    clear(m_global);
+    m_lps.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CreateLogicalProcesses()
+{
+    if (!m_lps.empty())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    uint32_t nThreads = m_maxThreads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    NS_LOG_INFO("Using " << nThreads << " threads");
+    m_lps.resize(nThreads);
+    for (auto& lp : m_lps)
+    {
+        lp.events = m_schedulerFactory.Create<Scheduler>();
+        lp.uid = EventId::UID::VALID;
+        lp.currentUid = EventId::UID::INVALID;
+        lp.currentTs = m_global.currentTs;
+        lp.currentContext = Simulator::NO_CONTEXT;
+        lp.eventCount = 0;
+        lp.objectUid = 0;
+        lp.outbox.resize(nThreads + 1);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    CreateLogicalProcesses();
+
+    auto replace = [&schedulerFactory](LogicalProcess& lp) {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (lp.events)
+        {
+            while (!lp.events->IsEmpty())
+            {
+                scheduler->Insert(lp.events->RemoveNext());
+            }
+        }
+        lp.events = scheduler;
+    };
+    for (auto& lp : m_lps)
+    {
+        replace(lp);
+    }
+    replace(m_global);
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::AllocateUid(uint32_t& counter)
+{
+    // The counter of the serial implementations is shared by the threads,
+    // hence each logical process keeps its own. The global logical process,
+    // which exists before the others are created, uses the identifier 0.
+    LogicalProcess& lp = GetCurrentLogicalProcess();
+    uint64_t lpId = &lp == &m_global ? 0 : &lp - m_lps.data() + 1;
+    return lpId << 32 | lp.objectUid++;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetThreadCount() const
+{
+    return m_lps.size();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return TimeStep(m_lookahead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcessIndex(uint32_t context) const
+{
+    if (context == Simulator::NO_CONTEXT)
+    {
+        return m_lps.size();
+    }
+    return context % m_lps.size();
+}
+
+MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::GetLogicalProcess(uint32_t context)
+{
+    if (context == Simulator::NO_CONTEXT)
+    {
+        return m_global;
+    }
+    return m_lps[context % m_lps.size()];
+}
+
+const MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::GetLogicalProcess(uint32_t context) const
+{
+    if (context == Simulator::NO_CONTEXT)
+    {
+        return m_global;
+    }
+    return m_lps[context % m_lps.size()];
+}
+
+MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::GetCurrentLogicalProcess()
+{
+    return g_currentLp != nullptr ? *g_currentLp : m_global;
+}
+
+const MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::GetCurrentLogicalProcess() const
+{
+    return g_currentLp != nullptr ? *g_currentLp : m_global;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNextTimestamp(const LogicalProcess& lp)
+{
+    if (lp.events->IsEmpty())
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return lp.events->PeekNext().key.m_ts;
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert(LogicalProcess& lp,
+                                   uint64_t timestamp,
+                                   uint32_t context,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = timestamp;
+    ev.key.m_context = context;
+    ev.key.m_uid = lp.uid;
+    lp.uid++;
+    lp.events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(LogicalProcess& lp)
+{
+    Scheduler::Event next = lp.events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= lp.currentTs);
+    lp.eventCount++;
+
+    NS_LOG_LOGIC("handle " << next.key.m_ts);
+    lp.currentTs = next.key.m_ts;
+    lp.currentContext = next.key.m_context;
+    lp.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow(LogicalProcess& lp)
+{
+    // Stop() only takes effect at the end of the window, so that the
+    // final state does not depend on the scheduling of the threads
+    while (!lp.events->IsEmpty() && lp.events->PeekNext().key.m_ts <= m_windowEnd)
+    {
+        ProcessOneEvent(lp);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessGlobalEvents(uint64_t timestamp)
+{
+    while (!m_global.events->IsEmpty() && m_global.events->PeekNext().key.m_ts == timestamp &&
+           !m_stop)
+    {
+        ProcessOneEvent(m_global);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DeliverRemoteEvents()
+{
+    // The events are delivered in the order of their source, then in the
+    // order in which they were scheduled, which does not depend on the
+    // scheduling of the threads.
+    for (uint32_t target = 0; target <= m_lps.size(); ++target)
+    {
+        LogicalProcess& lp = target < m_lps.size() ? m_lps[target] : m_global;
+        for (auto& source : m_lps)
+        {
+            for (const auto& remote : source.outbox[target])
+            {
+                Insert(lp, remote.timestamp, remote.context, remote.event);
+            }
+            source.outbox[target].clear();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookahead()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_userLookahead.IsZero())
+    {
+        m_lookahead = m_userLookahead.GetTimeStep();
+        return;
+    }
+
+    // without channels across logical processes, the windows are only
+    // bounded by the events of the global logical process
+    m_lookahead = GetMaximumSimulationTime().GetTimeStep();
+    for (auto it = ChannelList::Begin(); it != ChannelList::End(); ++it)
+    {
+        Ptr<Channel> channel = *it;
+        std::set<uint32_t> lps;
+        for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> device = channel->GetDevice(i);
+            if (device && device->GetNode())
+            {
+                lps.insert(GetLogicalProcessIndex(device->GetNode()->GetId()));
+            }
+        }
+        if (lps.size() < 2)
+        {
+            continue;
+        }
+        TimeValue delay;
+        if (channel->GetAttributeFailSafe("Delay", delay) && delay.Get().IsStrictlyPositive())
+        {
+            m_lookahead = std::min<uint64_t>(m_lookahead, delay.Get().GetTimeStep());
+        }
+        else
+        {
+            NS_LOG_INFO("Channel " << channel->GetId() << " (" << channel->GetInstanceTypeId()
+                                   << ") yields a null lookahead");
+            m_lookahead = 0;
+            return;
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWorker(uint32_t index)
+{
+    g_currentLp = &m_lps[index];
+    uint64_t windowCount = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock{m_mutex};
+            m_windowStarted.wait(lock, [&]() { return m_exit || m_windowCount != windowCount; });
+            if (m_exit)
+            {
+                break;
+            }
+            windowCount = m_windowCount;
+        }
+        ProcessWindow(m_lps[index]);
+        {
+            std::unique_lock lock{m_mutex};
+            if (--m_busyWorkers == 0)
+            {
+                m_windowCompleted.notify_one();
+            }
+        }
+    }
+    g_currentLp = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(g_currentLp == nullptr, "Simulator::Run called from a simulation thread");
+    CalculateLookahead();
+    NS_LOG_INFO("Lookahead " << TimeStep(m_lookahead).As(Time::S));
+    m_stop = false;
+    m_exit = false;
+    for (uint32_t i = 1; i < m_lps.size(); ++i)
+    {
+        m_threads.emplace_back(&MultithreadedSimulatorImpl::RunWorker, this, i);
+    }
+
+    while (!m_stop)
+    {
+        DeliverRemoteEvents();
+        uint64_t globalTs = GetNextTimestamp(m_global);
+        uint64_t minTs = std::numeric_limits<uint64_t>::max();
+        for (const auto& lp : m_lps)
+        {
+            minTs = std::min(minTs, GetNextTimestamp(lp));
+        }
+        if (globalTs == std::numeric_limits<uint64_t>::max() &&
+            minTs == std::numeric_limits<uint64_t>::max())
+        {
+            break;
+        }
+        if (globalTs <= minTs)
+        {
+            ProcessGlobalEvents(globalTs);
+            continue;
+        }
+
+        // Process the events up to the end of the window, which is bounded
+        // by the next global event. With a null lookahead, only the events
+        // with the smallest timestamp are processed.
+        m_windowEnd = minTs;
+        if (m_lookahead > 0)
+        {
+            uint64_t end = minTs + std::min(m_lookahead, globalTs - minTs);
+            m_windowEnd = end - 1;
+        }
+        m_parallel = true;
+        {
+            std::unique_lock lock{m_mutex};
+            m_windowCount++;
+            m_busyWorkers = m_lps.size() - 1;
+        }
+        m_windowStarted.notify_all();
+        g_currentLp = &m_lps[0];
+        ProcessWindow(m_lps[0]);
+        g_currentLp = nullptr;
+        {
+            std::unique_lock lock{m_mutex};
+            m_windowCompleted.wait(lock, [this]() { return m_busyWorkers == 0; });
+        }
+        m_parallel = false;
+    }
+
+    {
+        std::unique_lock lock{m_mutex};
+        m_exit = true;
+    }
+    m_windowStarted.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+    DeliverRemoteEvents();
+
+    // the current time of the main thread is the time of the last event
+    for (const auto& lp : m_lps)
+    {
+        m_global.currentTs = std::max(m_global.currentTs, lp.currentTs);
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    return std::all_of(m_lps.begin(),
+                       m_lps.end(),
+                       [](const LogicalProcess& lp) {
+                           return lp.events->IsEmpty() &&
+                                  std::all_of(lp.outbox.begin(),
+                                              lp.outbox.end(),
+                                              [](const auto& events) { return events.empty(); });
+                       }) &&
+           m_global.events->IsEmpty();
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+    LogicalProcess& lp = GetCurrentLogicalProcess();
+    Time tAbsolute = delay + TimeStep(lp.currentTs);
+    return Insert(lp, tAbsolute.GetTimeStep(), lp.currentContext, event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+    LogicalProcess& source = GetCurrentLogicalProcess();
+    Time tAbsolute = delay + TimeStep(source.currentTs);
+    LogicalProcess& target = GetLogicalProcess(context);
+    if (!m_parallel || &target == &source)
+    {
+        Insert(target, tAbsolute.GetTimeStep(), context, event);
+        return;
+    }
+    NS_ABORT_MSG_IF(g_currentLp == nullptr,
+                    "Simulator::ScheduleWithContext called from a thread not running the "
+                    "simulation");
+    if (static_cast<uint64_t>(tAbsolute.GetTimeStep()) < m_windowEnd)
+    {
+        NS_FATAL_ERROR("Event scheduled on context "
+                       << context << " with a delay of " << delay.As(Time::S)
+                       << ", smaller than the lookahead of " << TimeStep(m_lookahead).As(Time::S)
+                       << "; set the Lookahead attribute of ns3::MultithreadedSimulatorImpl "
+                          "to a smaller value");
+    }
+    source.outbox[GetLogicalProcessIndex(context)].push_back(
+        {static_cast<uint64_t>(tAbsolute.GetTimeStep()), context, event});
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    std::unique_lock lock{m_destroyMutex};
+    EventId id(Ptr<EventImpl>(event, false), Now().GetTimeStep(), 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrentLogicalProcess().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs()) - Now();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        std::unique_lock lock{m_destroyMutex};
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    LogicalProcess& lp = GetLogicalProcess(id.GetContext());
+    if (m_parallel && &lp != g_currentLp)
+    {
+        // the queue of another thread cannot be modified
+        id.PeekEventImpl()->Cancel();
+        return;
+    }
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    lp.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        std::unique_lock lock{m_destroyMutex};
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    // the identifiers are only comparable with the state of the logical
+    // process which owns the event
+    const LogicalProcess& lp = GetLogicalProcess(id.GetContext());
+    return id.PeekEventImpl() == nullptr || id.GetTs() < lp.currentTs ||
+           (id.GetTs() == lp.currentTs && id.GetUid() <= lp.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrentLogicalProcess().currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t eventCount = m_global.eventCount;
+    for (const auto& lp : m_lps)
+    {
+        eventCount += lp.eventCount;
+    }
+    return eventCount;
+}
+
+} // namespace ns3
@@ -0,0 +1,272 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-impl.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \defgroup mtp Multithreaded Simulation
+ */
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Parallel simulator implementation running on several threads of
+ * a single process.
+ *
+ * The events are partitioned into logical processes (LPs) according to
+ * their execution context: the events of context \c c belong to the LP
+ * <tt>c % N</tt>, where N is the number of threads, and the events without
+ * context (Simulator::NO_CONTEXT) belong to a global LP. Since the context
+ * of the events is the identifier of the node they are executed on, the
+ * nodes are automatically partitioned across the threads.
+ *
+ * The LPs are synchronized with a conservative, window-based algorithm.
+ * At each round, the smallest timestamp \c t of the pending events is
+ * computed and each thread processes the events of its LP up to
+ * <tt>t + lookahead</tt>, where the lookahead is the smallest delay of
+ * the channels connecting nodes of different LPs. Events scheduled on
+ * another LP are buffered and delivered at the end of the round, in an
+ * order which only depends on the simulated events, hence the results do
+ * not depend on the scheduling of the threads. The events of the global
+ * LP are processed serially, while the other threads are idle.
+ *
+ * The lookahead is computed when Simulator::Run is called from the
+ * "Delay" attribute of the channels (e.g., PointToPointChannel and
+ * CsmaChannel). Any other channel connecting different LPs, e.g. a
+ * wireless channel, yields a null lookahead, in which case only the
+ * events sharing the same timestamp are processed in parallel, unless
+ * a minimum delay is provided by the user through the Lookahead attribute.
+ * Scheduling an event on another LP sooner than the end of the current
+ * window is a fatal error.
+ *
+ * The simulation models are expected to only access the state of the
+ * nodes of their own LP, except through events scheduled with
+ * Simulator::ScheduleWithContext. See the module documentation for the
+ * known limitations.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+    uint64_t AllocateUid(uint32_t& counter) override;
+
+    /**
+     * \return the number of threads, which is also the number of
+     * logical processes besides the global one
+     */
+    uint32_t GetThreadCount() const;
+    /**
+     * \return the lookahead used by the last call to Run
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** Event scheduled on another logical process. */
+    struct RemoteEvent
+    {
+        uint64_t timestamp; //!< absolute timestamp of the event
+        uint32_t context;   //!< context of the event
+        EventImpl* event;   //!< the event implementation
+    };
+
+    /** State of a logical process. */
+    struct LogicalProcess
+    {
+        Ptr<Scheduler> events;   //!< the event priority queue
+        uint32_t uid;            //!< next event unique id
+        uint32_t currentUid;     //!< unique id of the current event
+        uint64_t currentTs;      //!< timestamp of the current event
+        uint32_t currentContext; //!< execution context of the current event
+        uint64_t eventCount;     //!< number of events processed
+        uint32_t objectUid;      //!< next unique id of the objects created
+        /** Events scheduled on other logical processes, indexed by target */
+        std::vector<std::vector<RemoteEvent>> outbox;
+    };
+
+    /** Create the logical processes, if not done yet. */
+    void CreateLogicalProcesses();
+    /**
+     * \param context an execution context
+     * \return the logical process which owns the events of the given context
+     */
+    LogicalProcess& GetLogicalProcess(uint32_t context);
+    /**
+     * \copydoc GetLogicalProcess(uint32_t)
+     */
+    const LogicalProcess& GetLogicalProcess(uint32_t context) const;
+    /**
+     * \param context an execution context
+     * \return the index of the logical process which owns the events of the
+     * given context, the global logical process having the last index
+     */
+    uint32_t GetLogicalProcessIndex(uint32_t context) const;
+    /**
+     * \return the logical process whose event is executed by the calling
+     * thread, or the global logical process outside of parallel windows
+     */
+    const LogicalProcess& GetCurrentLogicalProcess() const;
+    /**
+     * \copydoc GetCurrentLogicalProcess() const
+     */
+    LogicalProcess& GetCurrentLogicalProcess();
+    /**
+     * Insert an event in the queue of a logical process.
+     *
+     * \param lp the logical process
+     * \param timestamp the absolute timestamp of the event
+     * \param context the context of the event
+     * \param event the event implementation
+     * \return the identifier of the event
+     */
+    EventId Insert(LogicalProcess& lp, uint64_t timestamp, uint32_t context, EventImpl* event);
+    /**
+     * Process the next event of a logical process.
+     *
+     * \param lp the logical process
+     */
+    void ProcessOneEvent(LogicalProcess& lp);
+    /**
+     * Process the events of a logical process up to the end of the current window.
+     *
+     * \param lp the logical process
+     */
+    void ProcessWindow(LogicalProcess& lp);
+    /**
+     * Process the events of the global logical process with the given timestamp.
+     *
+     * \param timestamp the timestamp of the events
+     */
+    void ProcessGlobalEvents(uint64_t timestamp);
+    /** Move the events scheduled on other logical processes to their queue. */
+    void DeliverRemoteEvents();
+    /**
+     * Process the windows of a logical process until the simulation ends.
+     *
+     * \param index the index of the logical process
+     */
+    void RunWorker(uint32_t index);
+    /** Compute the lookahead from the channels connecting different logical processes. */
+    void CalculateLookahead();
+    /**
+     * \param lp a logical process
+     * \return the timestamp of the next event of the logical process, or
+     * the largest representable timestamp if there is none
+     */
+    static uint64_t GetNextTimestamp(const LogicalProcess& lp);
+
+    /** The logical processes executed in parallel, one per thread. */
+    std::vector<LogicalProcess> m_lps;
+    /** The logical process of the events without context. */
+    LogicalProcess m_global;
+    /** The logical process whose event is executed by the current thread. */
+    static thread_local LogicalProcess* g_currentLp;
+
+    /** Factory of the event priority queues. */
+    ObjectFactory m_schedulerFactory;
+    /** Number of threads requested by the user, or 0 for one per hardware thread. */
+    uint32_t m_maxThreads;
+    /** Lookahead requested by the user, or 0 to compute it from the channels. */
+    Time m_userLookahead;
+    /** Lookahead used by the current run, in time steps. */
+    uint64_t m_lookahead;
+    /** Inclusive end of the current window. */
+    uint64_t m_windowEnd;
+    /** Whether the logical processes are being executed in parallel. */
+    bool m_parallel;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Mutex to control access to the list of destroy events. */
+    mutable std::mutex m_destroyMutex;
+
+    /** Worker threads, processing the logical processes but the first one. */
+    std::vector<std::thread> m_threads;
+    /** Mutex protecting the synchronization of the threads. */
+    std::mutex m_mutex;
+    /** Signals the start of a window, or the end of the simulation, to the workers. */
+    std::condition_variable m_windowStarted;
+    /** Signals the completion of a window by the workers to the main thread. */
+    std::condition_variable m_windowCompleted;
+    /** Number of windows started. */
+    uint64_t m_windowCount;
+    /** Number of workers which have not completed the current window. */
+    uint32_t m_busyWorkers;
+    /** Whether the workers must exit. */
+    bool m_exit;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
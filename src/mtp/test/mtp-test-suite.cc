@@ -0,0 +1,439 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/default-simulator-impl.h"
+#include "ns3/mac48-address.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-test mtp module tests
+ */
+
+/**
+ * \ingroup mtp-test
+ *
+ * \brief Check that the events scheduled across contexts are executed at the
+ * same time as with the DefaultSimulatorImpl, and that the execution is
+ * reproducible.
+ *
+ * Each context relays a number of tokens to other contexts, with delays not
+ * smaller than the lookahead, and schedules local events in between. An
+ * event without context is scheduled from the main thread.
+ */
+class MtpEventOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param threads the number of threads
+     */
+    MtpEventOrderTestCase(uint32_t threads);
+
+  private:
+    void DoRun() override;
+
+    /// Log of the events of a context: (timestamp, token) pairs
+    typedef std::vector<std::pair<int64_t, uint32_t>> Log;
+
+    /**
+     * Run the scenario with the given implementation.
+     * \param impl the simulator implementation
+     * \return the log of each context
+     */
+    std::vector<Log> RunScenario(Ptr<SimulatorImpl> impl);
+    /**
+     * Relay a token to another context.
+     * \param context the current context
+     * \param token the token
+     * \param hops the number of remaining hops
+     */
+    void Relay(uint32_t context, uint32_t token, uint32_t hops);
+    /**
+     * Record a local event.
+     * \param context the current context
+     * \param token the token
+     */
+    void Local(uint32_t context, uint32_t token);
+    /// Record the event without context
+    void Global();
+
+    uint32_t m_threads;                    //!< number of threads
+    std::vector<Log> m_logs;               //!< log of each context
+    std::vector<uint32_t> m_contextErrors; //!< number of events with a wrong context, per context
+    Log m_globalLog;                       //!< log of the events without context
+    static const uint32_t N_CONTEXTS = 10; //!< number of contexts
+};
+
+MtpEventOrderTestCase::MtpEventOrderTestCase(uint32_t threads)
+    : TestCase("Check the execution of the events with " + std::to_string(threads) + " threads"),
+      m_threads(threads)
+{
+}
+
+void
+MtpEventOrderTestCase::Relay(uint32_t context, uint32_t token, uint32_t hops)
+{
+    if (Simulator::GetContext() != context)
+    {
+        m_contextErrors[context]++;
+    }
+    m_logs[context].emplace_back(Simulator::Now().GetTimeStep(), token);
+    Simulator::Schedule(MicroSeconds(300), &MtpEventOrderTestCase::Local, this, context, token);
+    if (hops == 0)
+    {
+        return;
+    }
+    uint32_t next = (context * 3 + token) % N_CONTEXTS;
+    Simulator::ScheduleWithContext(next,
+                                   MilliSeconds(1 + (context + token) % 3),
+                                   &MtpEventOrderTestCase::Relay,
+                                   this,
+                                   next,
+                                   token,
+                                   hops - 1);
+}
+
+void
+MtpEventOrderTestCase::Local(uint32_t context, uint32_t token)
+{
+    if (Simulator::GetContext() != context)
+    {
+        m_contextErrors[context]++;
+    }
+    m_logs[context].emplace_back(Simulator::Now().GetTimeStep(), token + 1000);
+}
+
+void
+MtpEventOrderTestCase::Global()
+{
+    if (Simulator::GetContext() != Simulator::NO_CONTEXT)
+    {
+        m_globalLog.emplace_back(-1, 0);
+    }
+    m_globalLog.emplace_back(Simulator::Now().GetTimeStep(), 0);
+}
+
+std::vector<MtpEventOrderTestCase::Log>
+MtpEventOrderTestCase::RunScenario(Ptr<SimulatorImpl> impl)
+{
+    Simulator::SetImplementation(impl);
+    m_logs.assign(N_CONTEXTS, Log());
+    m_contextErrors.assign(N_CONTEXTS, 0);
+    m_globalLog.clear();
+    for (uint32_t token = 0; token < 2 * N_CONTEXTS; ++token)
+    {
+        uint32_t context = token % N_CONTEXTS;
+        Simulator::ScheduleWithContext(context,
+                                       MicroSeconds(100 * token),
+                                       &MtpEventOrderTestCase::Relay,
+                                       this,
+                                       context,
+                                       token,
+                                       50);
+    }
+    Simulator::Schedule(MilliSeconds(5), &MtpEventOrderTestCase::Global, this);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    for (uint32_t context = 0; context < N_CONTEXTS; ++context)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_contextErrors[context], 0, "Unexpected context");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_globalLog.size(), 1, "Event without context not executed once");
+    return m_logs;
+}
+
+void
+MtpEventOrderTestCase::DoRun()
+{
+    auto reference = RunScenario(CreateObject<DefaultSimulatorImpl>());
+    auto first = RunScenario(
+        CreateObjectWithAttributes<MultithreadedSimulatorImpl>("MaxThreads",
+                                                               UintegerValue(m_threads),
+                                                               "Lookahead",
+                                                               TimeValue(MilliSeconds(1))));
+    auto second = RunScenario(
+        CreateObjectWithAttributes<MultithreadedSimulatorImpl>("MaxThreads",
+                                                               UintegerValue(m_threads),
+                                                               "Lookahead",
+                                                               TimeValue(MilliSeconds(1))));
+
+    for (uint32_t context = 0; context < N_CONTEXTS; ++context)
+    {
+        NS_TEST_EXPECT_MSG_EQ((first[context] == second[context]),
+                              true,
+                              "Execution of context " << context << " is not reproducible");
+        // the order of simultaneous events may differ from the default implementation
+        std::sort(first[context].begin(), first[context].end());
+        std::sort(reference[context].begin(), reference[context].end());
+        NS_TEST_EXPECT_MSG_EQ((first[context] == reference[context]),
+                              true,
+                              "Events of context " << context << " differ from the reference");
+    }
+}
+
+/**
+ * \ingroup mtp-test
+ *
+ * \brief Check the exchange of packets between nodes executed by different
+ * threads, and the lookahead computed from the channel delays.
+ *
+ * The nodes are connected in a ring by SimpleChannels. Each node relays the
+ * packets it receives to the next node of the ring, until the packets have
+ * gone around the ring a given number of times.
+ */
+class MtpPacketRelayTestCase : public TestCase
+{
+  public:
+    MtpPacketRelayTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Receive a packet and relay it to the next node.
+     * \param device the receiving device
+     * \param packet the packet
+     * \param protocol the protocol number
+     * \param from the sender address
+     * \param to the destination address
+     * \param packetType the type of packet
+     */
+    void Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from,
+                 const Address& to,
+                 NetDevice::PacketType packetType);
+
+    std::vector<Ptr<NetDevice>> m_txDevices; //!< device of each node towards the next node
+    std::vector<uint32_t> m_rxPackets;       //!< number of packets received by each node
+    std::vector<uint32_t> m_rxBytes;         //!< number of bytes received by each node
+    static const uint32_t N_NODES = 8;       //!< number of nodes
+    static const uint32_t N_LAPS = 20;       //!< number of laps of each packet
+};
+
+MtpPacketRelayTestCase::MtpPacketRelayTestCase()
+    : TestCase("Check the relay of packets across threads")
+{
+}
+
+void
+MtpPacketRelayTestCase::Receive(Ptr<NetDevice> device,
+                                Ptr<const Packet> packet,
+                                uint16_t protocol,
+                                const Address& from,
+                                const Address& to,
+                                NetDevice::PacketType packetType)
+{
+    uint32_t id = device->GetNode()->GetId();
+    m_rxPackets[id]++;
+    m_rxBytes[id] += packet->GetSize();
+    if (protocol < N_LAPS * N_NODES)
+    {
+        Ptr<Packet> copy = packet->Copy();
+        copy->AddPaddingAtEnd(1);
+        m_txDevices[id]->Send(copy, Mac48Address::GetBroadcast(), protocol + 1);
+    }
+}
+
+void
+MtpPacketRelayTestCase::DoRun()
+{
+    Simulator::SetImplementation(
+        CreateObjectWithAttributes<MultithreadedSimulatorImpl>("MaxThreads", UintegerValue(4)));
+    auto impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+
+    std::vector<Ptr<Node>> nodes;
+    for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+        nodes.push_back(CreateObject<Node>());
+    }
+    m_txDevices.clear();
+    m_rxPackets.assign(N_NODES, 0);
+    m_rxBytes.assign(N_NODES, 0);
+    for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+        uint32_t next = (i + 1) % N_NODES;
+        auto channel = CreateObject<SimpleChannel>();
+        channel->SetAttribute("Delay", TimeValue(MilliSeconds(i == 3 ? 2 : 3)));
+        auto tx = CreateObject<SimpleNetDevice>();
+        auto rx = CreateObject<SimpleNetDevice>();
+        tx->SetAddress(Mac48Address::Allocate());
+        rx->SetAddress(Mac48Address::Allocate());
+        tx->SetChannel(channel);
+        rx->SetChannel(channel);
+        nodes[i]->AddDevice(tx);
+        nodes[next]->AddDevice(rx);
+        nodes[next]->RegisterProtocolHandler(MakeCallback(&MtpPacketRelayTestCase::Receive, this),
+                                             0,
+                                             rx);
+        m_txDevices.push_back(tx);
+    }
+    // nodes 0 and 4 are executed by the same thread: the delay of their
+    // channel does not bound the lookahead
+    auto channel = CreateObject<SimpleChannel>();
+    channel->SetAttribute("Delay", TimeValue(MicroSeconds(1)));
+    for (uint32_t i : {0, 4})
+    {
+        auto device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        device->SetChannel(channel);
+        nodes[i]->AddDevice(device);
+    }
+
+    for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+        Simulator::ScheduleWithContext(i, Seconds(0), [this, i]() {
+            m_txDevices[i]->Send(Create<Packet>(100), Mac48Address::GetBroadcast(), 1);
+        });
+    }
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(impl->GetThreadCount(), 4, "Unexpected number of threads");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), MilliSeconds(2), "Unexpected lookahead");
+    // each node sends N_LAPS * N_NODES packets (one per protocol number),
+    // growing by one byte at each hop
+    uint32_t hops = N_LAPS * N_NODES;
+    for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_rxPackets[i], hops, "Unexpected number of packets");
+        NS_TEST_EXPECT_MSG_EQ(m_rxBytes[i],
+                              100 * hops + hops * (hops - 1) / 2,
+                              "Unexpected number of bytes");
+    }
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mtp-test
+ *
+ * \brief Check that the unique identifiers of the packets created by
+ * different threads are unique and do not depend on the scheduling of the
+ * threads.
+ */
+class MtpPacketUidTestCase : public TestCase
+{
+  public:
+    MtpPacketUidTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run a simulation where each context creates packets.
+     * \return the unique identifiers of the packets created by each
+     * context, the ones created without context coming last
+     */
+    std::vector<std::vector<uint64_t>> CreatePackets();
+
+    static const uint32_t N_CONTEXTS = 8;  //!< number of contexts
+    static const uint32_t N_PACKETS = 100; //!< number of packets per context and timestamp
+};
+
+MtpPacketUidTestCase::MtpPacketUidTestCase()
+    : TestCase("Check the unique identifiers of the packets")
+{
+}
+
+std::vector<std::vector<uint64_t>>
+MtpPacketUidTestCase::CreatePackets()
+{
+    Simulator::SetImplementation(
+        CreateObjectWithAttributes<MultithreadedSimulatorImpl>("MaxThreads", UintegerValue(4)));
+
+    std::vector<std::vector<uint64_t>> uids(N_CONTEXTS + 1);
+    auto create = [&uids](uint32_t index) {
+        for (uint32_t i = 0; i < N_PACKETS; ++i)
+        {
+            uids[index].push_back(Create<Packet>()->GetUid());
+        }
+    };
+    create(N_CONTEXTS);
+    for (uint32_t t = 0; t < 3; ++t)
+    {
+        for (uint32_t c = 0; c < N_CONTEXTS; ++c)
+        {
+            Simulator::ScheduleWithContext(c, MilliSeconds(t), [&create, c]() { create(c); });
+        }
+        Simulator::Schedule(MilliSeconds(t), [&create]() { create(N_CONTEXTS); });
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    return uids;
+}
+
+void
+MtpPacketUidTestCase::DoRun()
+{
+    auto first = CreatePackets();
+    auto second = CreatePackets();
+
+    std::set<uint64_t> all;
+    for (uint32_t c = 0; c <= N_CONTEXTS; ++c)
+    {
+        NS_TEST_EXPECT_MSG_EQ(first[c].size(),
+                              (c == N_CONTEXTS ? 4 : 3) * N_PACKETS,
+                              "Unexpected number of packets");
+        NS_TEST_EXPECT_MSG_EQ((first[c] == second[c]),
+                              true,
+                              "The packet identifiers of context " << c << " are not reproducible");
+        all.insert(first[c].begin(), first[c].end());
+    }
+    NS_TEST_EXPECT_MSG_EQ(all.size(),
+                          (4 + 3 * N_CONTEXTS) * N_PACKETS,
+                          "The packet identifiers are not unique");
+}
+
+/**
+ * \ingroup mtp-test
+ *
+ * \brief The multithreaded simulation TestSuite
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", UNIT)
+{
+    for (uint32_t threads : {1, 2, 4})
+    {
+        AddTestCase(new MtpEventOrderTestCase(threads), TestCase::QUICK);
+    }
+    AddTestCase(new MtpPacketRelayTestCase, TestCase::QUICK);
+    AddTestCase(new MtpPacketUidTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static MtpTestSuite g_mtpTestSuite;
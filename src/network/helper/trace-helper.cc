@@ -19,12 +19,16 @@
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/ptr.h"
+#include "ns3/uinteger.h"
 
 #include <fstream>
 #include <stdint.h>
@@ -35,6 +39,88 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("TraceHelper");
 
+/**
+ * \ingroup network
+ * Whether the trace files are written on background threads.
+ */
+static GlobalValue g_asyncTraceFiles =
+    GlobalValue("AsyncTraceFiles",
+                "Write the pcap and ascii trace files created by the trace helpers through "
+                "write-behind buffers, on background threads; the files are complete once "
+                "their trace sinks are destroyed, e.g., by Simulator::Destroy",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
+/**
+ * \ingroup network
+ * The size of the buffers of the asynchronous trace files.
+ */
+static GlobalValue g_asyncTraceBufferSize =
+    GlobalValue("AsyncTraceBufferSize",
+                "The size of each write-behind buffer of the asynchronous trace files, in bytes",
+                UintegerValue(1 << 16),
+                MakeUintegerChecker<uint32_t>(1));
+
+/**
+ * \ingroup network
+ * The length of the queues of the asynchronous trace files.
+ */
+static GlobalValue g_asyncTraceQueueLength =
+    GlobalValue("AsyncTraceQueueLength",
+                "The maximum number of full buffers of an asynchronous trace file waiting to be "
+                "written; the simulation waits for the writer when the queue is full",
+                UintegerValue(4),
+                MakeUintegerChecker<uint32_t>(1));
+
+/**
+ * \ingroup network
+ * The compression of the asynchronous trace files.
+ */
+static GlobalValue g_asyncTraceCompression =
+    GlobalValue("AsyncTraceCompression",
+                "The compression of the asynchronous trace files; the .gz suffix is appended to "
+                "the names of the gzip files",
+                EnumValue(AsyncFileWriter::NONE),
+                MakeEnumChecker(AsyncFileWriter::NONE, "none", AsyncFileWriter::GZIP, "gzip"));
+
+/**
+ * Get the configuration of the asynchronous trace files.
+ *
+ * \param [out] config The configuration of the writer of a trace file.
+ * \param [in,out] filename The name of the trace file, to which the suffix
+ * of the compression is appended.
+ * \return true if the trace files are written asynchronously.
+ */
+static bool
+GetAsyncTraceConfig(AsyncFileWriter::Config& config, std::string& filename)
+{
+    BooleanValue async;
+    g_asyncTraceFiles.GetValue(async);
+    if (!async.Get())
+    {
+        return false;
+    }
+    UintegerValue bufferSize;
+    g_asyncTraceBufferSize.GetValue(bufferSize);
+    config.bufferSize = bufferSize.Get();
+    UintegerValue queueLength;
+    g_asyncTraceQueueLength.GetValue(queueLength);
+    config.maxQueuedBuffers = queueLength.Get();
+    EnumValue compression;
+    g_asyncTraceCompression.GetValue(compression);
+    config.compression = static_cast<AsyncFileWriter::Compression>(compression.Get());
+    NS_ABORT_MSG_UNLESS(AsyncFileWriter::IsCompressionSupported(config.compression),
+                        "The trace compression is not supported by this build");
+    const std::string suffix = ".gz";
+    if (config.compression == AsyncFileWriter::GZIP &&
+        (filename.size() < suffix.size() ||
+         filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) != 0))
+    {
+        filename += suffix;
+    }
+    return true;
+}
+
 PcapHelper::PcapHelper()
 {
     NS_LOG_FUNCTION_NOARGS();
@@ -55,7 +141,15 @@ PcapHelper::CreateFile(std::string filename,
     NS_LOG_FUNCTION(filename << filemode << dataLinkType << snapLen << tzCorrection);
 
     Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper>();
-    file->Open(filename, filemode);
+    AsyncFileWriter::Config config;
+    if (GetAsyncTraceConfig(config, filename))
+    {
+        file->OpenAsync(filename, filemode, config);
+    }
+    else
+    {
+        file->Open(filename, filemode);
+    }
     NS_ABORT_MSG_IF(file->Fail(), "Unable to Open " << filename << " for mode " << filemode);
 
     file->Init(dataLinkType, snapLen, tzCorrection);
@@ -194,7 +288,16 @@ AsciiTraceHelper::CreateFileStream(std::string filename, std::ios::openmode file
 {
     NS_LOG_FUNCTION(filename << filemode);
 
-    Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper>(filename, filemode);
+    Ptr<OutputStreamWrapper> StreamWrapper;
+    AsyncFileWriter::Config config;
+    if (GetAsyncTraceConfig(config, filename))
+    {
+        StreamWrapper = Create<OutputStreamWrapper>(filename, filemode, config);
+    }
+    else
+    {
+        StreamWrapper = Create<OutputStreamWrapper>(filename, filemode);
+    }
 
     //
     // Note that the ascii trace helper promptly forgets all about the trace file.
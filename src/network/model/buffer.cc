@@ -18,6 +18,8 @@
  */
 #include "buffer.h"
 
+#include "packet-data-allocator.h"
+
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -54,96 +56,12 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
-#ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy
- * constructor orderings.
- */
-#define MAGIC_DESTROYED (~(long)0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED(x) && !IS_DESTROYED(x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList* Buffer::g_freeList = nullptr;
-Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor()
-{
-    NS_LOG_FUNCTION(this);
-    if (IS_INITIALIZED(g_freeList))
-    {
-        for (Buffer::FreeList::iterator i = g_freeList->begin(); i != g_freeList->end(); i++)
-        {
-            Buffer::Deallocate(*i);
-        }
-        delete g_freeList;
-        g_freeList = DESTROYED;
-    }
-}
+#endif
 
-void
-Buffer::Recycle(Buffer::Data* data)
-{
-    NS_LOG_FUNCTION(data);
-    NS_ASSERT(data->m_count == 0);
-    NS_ASSERT(!IS_UNINITIALIZED(g_freeList));
-    g_maxSize = std::max(g_maxSize, data->m_size);
-    /* feed into free list */
-    if (data->m_size < g_maxSize || IS_DESTROYED(g_freeList) || g_freeList->size() > 1000)
-    {
-        Buffer::Deallocate(data);
-    }
-    else
-    {
-        NS_ASSERT(IS_INITIALIZED(g_freeList));
-        g_freeList->push_back(data);
-    }
-}
-
-Buffer::Data*
-Buffer::Create(uint32_t dataSize)
-{
-    NS_LOG_FUNCTION(dataSize);
-    /* try to find a buffer correctly sized. */
-    if (IS_UNINITIALIZED(g_freeList))
-    {
-        g_freeList = new Buffer::FreeList();
-    }
-    else if (IS_INITIALIZED(g_freeList))
-    {
-        while (!g_freeList->empty())
-        {
-            Buffer::Data* data = g_freeList->back();
-            g_freeList->pop_back();
-            if (data->m_size >= dataSize)
-            {
-                data->m_count = 1;
-                return data;
-            }
-            Buffer::Deallocate(data);
-        }
-    }
-    Buffer::Data* data = Buffer::Allocate(dataSize);
-    NS_ASSERT(data->m_count == 1);
-    return data;
-}
-#else  /* BUFFER_FREE_LIST */
 void
 Buffer::Recycle(Buffer::Data* data)
 {
@@ -158,7 +76,6 @@ Buffer::Create(uint32_t size)
     NS_LOG_FUNCTION(size);
     return Allocate(size);
 }
-#endif /* BUFFER_FREE_LIST */
 
 constexpr uint32_t ALLOC_OVER_PROVISION = 100; //!< Additional bytes to over-provision.
 
@@ -173,9 +90,9 @@ Buffer::Allocate(uint32_t reqSize)
     NS_ASSERT(reqSize >= 1);
     reqSize += ALLOC_OVER_PROVISION;
     uint32_t size = reqSize - 1 + sizeof(Buffer::Data);
-    uint8_t* b = new uint8_t[size];
-    Buffer::Data* data = reinterpret_cast<Buffer::Data*>(b);
-    data->m_size = reqSize;
+    auto data = static_cast<Buffer::Data*>(PacketDataAllocator::Allocate(size));
+    // use the whole block
+    data->m_size = reqSize + (PacketDataAllocator::GetBlockSize(size) - size);
     data->m_count = 1;
     return data;
 }
@@ -185,8 +102,7 @@ Buffer::Deallocate(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
-    uint8_t* buf = reinterpret_cast<uint8_t*>(data);
-    delete[] buf;
+    PacketDataAllocator::Deallocate(data, data->m_size - 1 + sizeof(Buffer::Data));
 }
 
 Buffer::Buffer()
@@ -210,6 +126,14 @@ Buffer::Buffer(uint32_t dataSize, bool initialize)
     }
 }
 
+Buffer::Buffer(uint32_t dataSize, Ptr<const BufferContentGenerator> generator, uint64_t offset)
+{
+    NS_LOG_FUNCTION(this << dataSize << generator << offset);
+    Initialize(dataSize);
+    m_generator = generator;
+    m_zeroAreaOffset = offset;
+}
+
 bool
 Buffer::CheckInternalState() const
 {
@@ -249,10 +173,12 @@ Buffer::Initialize(uint32_t zeroSize)
 {
     NS_LOG_FUNCTION(this << zeroSize);
     m_data = Buffer::Create(0);
-    m_start = std::min(m_data->m_size, g_recommendedStart);
+    m_start = std::min<uint32_t>(m_data->m_size, g_recommendedStart);
     m_maxZeroAreaStart = m_start;
     m_zeroAreaStart = m_start;
     m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
+    m_generator = nullptr;
+    m_zeroAreaOffset = 0;
     m_end = m_zeroAreaEnd;
     m_data->m_dirtyStart = m_start;
     m_data->m_dirtyEnd = m_end;
@@ -266,18 +192,19 @@ Buffer::operator=(const Buffer& o)
     if (m_data != o.m_data)
     {
         // not assignment to self.
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Recycle(m_data);
         }
         m_data = o.m_data;
         m_data->m_count++;
     }
-    g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
+    g_recommendedStart = std::max<uint32_t>(g_recommendedStart, m_maxZeroAreaStart);
     m_maxZeroAreaStart = o.m_maxZeroAreaStart;
     m_zeroAreaStart = o.m_zeroAreaStart;
     m_zeroAreaEnd = o.m_zeroAreaEnd;
+    m_generator = o.m_generator;
+    m_zeroAreaOffset = o.m_zeroAreaOffset;
     m_start = o.m_start;
     m_end = o.m_end;
     NS_ASSERT(CheckInternalState());
@@ -288,9 +215,8 @@ Buffer::~Buffer()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
-    g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    g_recommendedStart = std::max<uint32_t>(g_recommendedStart, m_maxZeroAreaStart);
+    if (--m_data->m_count == 0)
     {
         Recycle(m_data);
     }
@@ -315,7 +241,12 @@ Buffer::AddAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
     NS_ASSERT(CheckInternalState());
+#ifdef NS3_MTP
+    // shared data may be read by other threads: never write into it
+    bool isDirty = m_data->m_count > 1;
+#else
     bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
     if (m_start >= start && !isDirty)
     {
         /* enough space in the buffer and not dirty.
@@ -333,8 +264,7 @@ Buffer::AddAtStart(uint32_t start)
         uint32_t newSize = GetInternalSize() + start;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data + start, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -361,7 +291,12 @@ Buffer::AddAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
     NS_ASSERT(CheckInternalState());
+#ifdef NS3_MTP
+    // shared data may be read by other threads: never write into it
+    bool isDirty = m_data->m_count > 1;
+#else
     bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
     if (GetInternalEnd() + end <= m_data->m_size && !isDirty)
     {
         /* enough space in buffer and not dirty
@@ -379,8 +314,7 @@ Buffer::AddAtEnd(uint32_t end)
         uint32_t newSize = GetInternalSize() + end;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -402,23 +336,77 @@ Buffer::AddAtEnd(uint32_t end)
     NS_ASSERT(CheckInternalState());
 }
 
+void
+Buffer::Unshare()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_data->m_count == 1)
+    {
+        return;
+    }
+    // keep the usual room for the headers in front of the real bytes
+    uint32_t start = g_recommendedStart;
+    uint32_t size = GetInternalSize();
+    Buffer::Data* newData = Buffer::Create(start + size);
+    memcpy(newData->m_data + start, m_data->m_data + m_start, size);
+    if (--m_data->m_count == 0)
+    {
+        Buffer::Recycle(m_data);
+    }
+    m_data = newData;
+
+    int32_t delta = start - m_start;
+    m_start += delta;
+    m_zeroAreaStart += delta;
+    m_zeroAreaEnd += delta;
+    m_end += delta;
+
+    // update dirty area
+    m_data->m_dirtyStart = m_start;
+    m_data->m_dirtyEnd = m_end;
+    m_maxZeroAreaStart = std::max(m_maxZeroAreaStart, m_zeroAreaStart);
+    NS_ASSERT(CheckInternalState());
+}
+
 void
 Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
 
-    if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-        m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
-        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    if (&o == this)
+    {
+        Buffer copy = o;
+        AddAtEnd(copy);
+        return;
+    }
+    if (GetSize() == 0)
+    {
+        *this = o;
+        return;
+    }
+
+    uint32_t ourZeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+    if ((m_end == m_zeroAreaEnd || ourZeroSize == 0) && o.m_start == o.m_zeroAreaStart &&
+        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0 &&
+        (ourZeroSize == 0 ||
+         (m_generator == o.m_generator &&
+          (!m_generator || m_zeroAreaOffset + ourZeroSize == o.m_zeroAreaOffset))))
     {
         /**
          * This is an optimization which kicks in when
          * we attempt to aggregate two buffers which contain
-         * adjacent zero areas.
+         * adjacent zero areas, holding zeroes or consecutive
+         * parts of the same generated content. If our real
+         * bytes are shared, e.g., with the packet this buffer
+         * is a fragment of, they are copied first, so that the
+         * zero areas are merged instead of being written.
          */
-        if (m_zeroAreaStart == m_zeroAreaEnd)
+        Unshare();
+        if (ourZeroSize == 0)
         {
             m_zeroAreaStart = m_end;
+            m_generator = o.m_generator;
+            m_zeroAreaOffset = o.m_zeroAreaOffset;
         }
         uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
         m_zeroAreaEnd = m_end + zeroSize;
@@ -435,7 +423,25 @@ Buffer::AddAtEnd(const Buffer& o)
         return;
     }
 
-    *this = CreateFullCopy();
+    if (ourZeroSize == 0 && o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    {
+        /**
+         * We have no zero area: prepend our bytes to the
+         * other buffer, whose zero area is kept.
+         */
+        Buffer tmp = o;
+        tmp.AddAtStart(GetSize());
+        tmp.Begin().Write(Begin(), End());
+        *this = tmp;
+        NS_ASSERT(CheckInternalState());
+        return;
+    }
+
+    // only the zero area of the other buffer, if any, is written
+    if (m_data == o.m_data)
+    {
+        Unshare();
+    }
     AddAtEnd(o.GetSize());
     Buffer::Iterator destStart = End();
     destStart.Prev(o.GetSize());
@@ -462,6 +468,7 @@ Buffer::RemoveAtStart(uint32_t start)
         uint32_t delta = newStart - m_zeroAreaStart;
         m_start = m_zeroAreaStart;
         m_zeroAreaEnd -= delta;
+        m_zeroAreaOffset += delta;
         m_end -= delta;
     }
     else if (newStart <= m_end)
@@ -546,7 +553,16 @@ Buffer::CreateFullCopy() const
     {
         Buffer tmp;
         tmp.AddAtStart(m_zeroAreaEnd - m_zeroAreaStart);
-        tmp.Begin().WriteU8(0, m_zeroAreaEnd - m_zeroAreaStart);
+        if (m_generator)
+        {
+            m_generator->Generate(tmp.m_data->m_data + tmp.m_start,
+                                  m_zeroAreaEnd - m_zeroAreaStart,
+                                  m_zeroAreaOffset);
+        }
+        else
+        {
+            tmp.Begin().WriteU8(0, m_zeroAreaEnd - m_zeroAreaStart);
+        }
         uint32_t dataStart = m_zeroAreaStart - m_start;
         tmp.AddAtStart(dataStart);
         tmp.Begin().Write(m_data->m_data + m_start, dataStart);
@@ -566,6 +582,11 @@ uint32_t
 Buffer::GetSerializedSize() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_generator && m_zeroAreaEnd != m_zeroAreaStart)
+    {
+        // the generated content is serialized as real bytes
+        return CreateFullCopy().GetSerializedSize();
+    }
     uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
     uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -582,6 +603,10 @@ uint32_t
 Buffer::Serialize(uint8_t* buffer, uint32_t maxSize) const
 {
     NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (m_generator && m_zeroAreaEnd != m_zeroAreaStart)
+    {
+        return CreateFullCopy().Serialize(buffer, maxSize);
+    }
     uint32_t* p = reinterpret_cast<uint32_t*>(buffer);
     uint32_t size = 0;
 
@@ -728,10 +753,21 @@ Buffer::CopyData(std::ostream* os, uint32_t size) const
             size -= m_zeroAreaStart - m_start;
             tmpsize = std::min(m_zeroAreaEnd - m_zeroAreaStart, size);
             uint32_t left = tmpsize;
+            char generated[sizeof(g_zeroes.buffer)];
             while (left > 0)
             {
                 uint32_t toWrite = std::min(left, g_zeroes.size);
-                os->write(g_zeroes.buffer, toWrite);
+                if (m_generator)
+                {
+                    m_generator->Generate(reinterpret_cast<uint8_t*>(generated),
+                                          toWrite,
+                                          m_zeroAreaOffset + (tmpsize - left));
+                    os->write(generated, toWrite);
+                }
+                else
+                {
+                    os->write(g_zeroes.buffer, toWrite);
+                }
                 left -= toWrite;
             }
             if (size > tmpsize)
@@ -758,13 +794,21 @@ Buffer::CopyData(uint8_t* buffer, uint32_t size) const
         if (size > 0)
         {
             tmpsize = std::min(m_zeroAreaEnd - m_zeroAreaStart, size);
-            uint32_t left = tmpsize;
-            while (left > 0)
+            if (m_generator)
             {
-                uint32_t toWrite = std::min(left, g_zeroes.size);
-                memcpy(buffer, g_zeroes.buffer, toWrite);
-                left -= toWrite;
-                buffer += toWrite;
+                m_generator->Generate(buffer, tmpsize, m_zeroAreaOffset);
+                buffer += tmpsize;
+            }
+            else
+            {
+                uint32_t left = tmpsize;
+                while (left > 0)
+                {
+                    uint32_t toWrite = std::min(left, g_zeroes.size);
+                    memcpy(buffer, g_zeroes.buffer, toWrite);
+                    left -= toWrite;
+                    buffer += toWrite;
+                }
             }
             size -= tmpsize;
             if (size > 0)
@@ -838,27 +882,37 @@ Buffer::Iterator::Write(Iterator start, Iterator end)
     NS_ASSERT(m_data != start.m_data);
     uint32_t size = end.m_current - start.m_current;
     NS_ASSERT_MSG(CheckNoZero(m_current, m_current + size), GetWriteErrorMessage());
+    // the written bytes are either all before or all after our zero area
+    uint8_t* to = &m_data[m_current < m_zeroEnd ? m_current : m_current - (m_zeroEnd - m_zeroStart)];
+    m_current += size;
     if (start.m_current <= start.m_zeroStart)
     {
         uint32_t toCopy = std::min(size, start.m_zeroStart - start.m_current);
-        memcpy(&m_data[m_current], &start.m_data[start.m_current], toCopy);
+        memcpy(to, &start.m_data[start.m_current], toCopy);
         start.m_current += toCopy;
-        m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     if (start.m_current <= start.m_zeroEnd)
     {
         uint32_t toCopy = std::min(size, start.m_zeroEnd - start.m_current);
-        memset(&m_data[m_current], 0, toCopy);
+        if (start.m_generator != nullptr && toCopy > 0)
+        {
+            start.m_generator->Generate(to,
+                                        toCopy,
+                                        start.m_zeroOffset + (start.m_current - start.m_zeroStart));
+        }
+        else
+        {
+            memset(to, 0, toCopy);
+        }
         start.m_current += toCopy;
-        m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     uint32_t toCopy = std::min(size, start.m_dataEnd - start.m_current);
     uint8_t* from = &start.m_data[start.m_current - (start.m_zeroEnd - start.m_zeroStart)];
-    uint8_t* to = &m_data[m_current];
     memcpy(to, from, toCopy);
-    m_current += toCopy;
 }
 
 void
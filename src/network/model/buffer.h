@@ -20,16 +20,49 @@
 #define BUFFER_H
 
 #include "ns3/assert.h"
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
 
 #include <ostream>
 #include <stdint.h>
 #include <vector>
 
-#define BUFFER_FREE_LIST 1
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 namespace ns3
 {
 
+/**
+ * \ingroup packet
+ *
+ * \brief Generator of the content of the virtual zero area of a Buffer
+ *
+ * The virtual zero area of a Buffer created with a generator holds the
+ * content generated from an offset, instead of zeroes. The bytes of this
+ * content are only written when they are read, e.g., by Buffer::CopyData,
+ * or when the zero area is made real, e.g., by Buffer::PeekData: they must
+ * only depend on their offset in the content. Fragments of a Buffer, and
+ * Buffers holding consecutive parts of the same content, are appended to
+ * each other without writing their content.
+ */
+class BufferContentGenerator : public SimpleRefCount<BufferContentGenerator>
+{
+  public:
+    virtual ~BufferContentGenerator() = default;
+
+    /**
+     * Write bytes of the content.
+     *
+     * \param buffer the bytes to write
+     * \param size the number of bytes to write
+     * \param offset the offset of the first byte to write in the content
+     */
+    virtual void Generate(uint8_t* buffer, uint32_t size, uint64_t offset) const = 0;
+};
+
 /**
  * \ingroup packet
  *
@@ -38,10 +71,11 @@ namespace ns3
  * This represents a buffer of bytes. Its size is
  * automatically adjusted to hold any data prepended
  * or appended by the user. Its implementation is optimized
- * to ensure that the number of buffer resizes is minimized,
- * by creating new Buffers of the maximum size ever used.
- * The correct maximum size is learned at runtime during use by
- * recording the maximum size of each packet.
+ * to ensure that the number of buffer resizes is minimized:
+ * the storage is allocated by the PacketDataAllocator, whose
+ * blocks are recycled and used in full, and new Buffers keep
+ * room in front of their data for the largest headers ever
+ * prepended, which is learned at runtime during use.
  *
  * \internal
  * The implementation of the Buffer class uses a COW (Copy On Write)
@@ -66,10 +100,15 @@ namespace ns3
  * contains real data bytes in its BufferData instance but it also
  * contains "virtual zero data" which typically is used to represent
  * application-level payload. No memory is allocated to store the
- * zero bytes of application-level payload unless the user fragments
- * a Buffer: this application-level payload is kept track of with
- * a pair of integers which describe where in the buffer content
- * the "virtual zero area" starts and ends.
+ * zero bytes of application-level payload unless the user peeks at
+ * the content of the Buffer (PeekData) or appends Buffers whose zero
+ * areas cannot be merged, i.e., which are separated by real bytes:
+ * this application-level payload is kept track of with a pair of
+ * integers which describe where in the buffer content the "virtual
+ * zero area" starts and ends. Fragments of a Buffer can be appended
+ * to each other without allocating their zero bytes. The virtual
+ * zero area can also hold non-zero synthetic payload, produced by a
+ * BufferContentGenerator when it is read.
  *
  * \verbatim
  * ***: unused bytes
@@ -483,6 +522,15 @@ class Buffer
          * to this pointer.
          */
         uint8_t* m_data;
+        /**
+         * the generator of the content of the "virtual zero area", if any
+         */
+        const BufferContentGenerator* m_generator;
+        /**
+         * offset in the content generated of the first byte of the
+         * "virtual zero area".
+         */
+        uint64_t m_zeroOffset;
     };
 
     /**
@@ -525,7 +573,11 @@ class Buffer
     /**
      * \param o the buffer to append to the end of this buffer.
      *
-     * Add bytes at the end of the Buffer.
+     * Add bytes at the end of the Buffer. The virtual zero
+     * areas of the buffers are merged when they are adjacent,
+     * and the virtual zero area of a buffer is kept when the
+     * other buffer has none, so that the zero bytes of
+     * fragments appended to each other are not allocated.
      * Any call to this method invalidates any Iterator
      * pointing to this Buffer.
      */
@@ -642,6 +694,18 @@ class Buffer
      * \param initialize initialize the buffer with zeroes.
      */
     Buffer(uint32_t dataSize, bool initialize);
+    /**
+     * \brief Constructor
+     *
+     * The buffer will be initialized with the content generated
+     * from the given offset up to its size. This content is only
+     * written when it is read.
+     *
+     * \param dataSize the buffer size
+     * \param generator the generator of the content of the buffer
+     * \param offset the offset in the content of the first byte of the buffer
+     */
+    Buffer(uint32_t dataSize, Ptr<const BufferContentGenerator> generator, uint64_t offset = 0);
     ~Buffer();
 
   private:
@@ -665,7 +729,11 @@ class Buffer
          * The reference count of an instance of this data structure.
          * Each buffer which references an instance holds a count.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /**
          * the size of the m_data field below.
          */
@@ -695,6 +763,12 @@ class Buffer
      */
     Buffer CreateFullCopy() const;
 
+    /**
+     * \brief Copy the real bytes of the buffer to a BufferData which is
+     * not shared with other buffers, keeping its zero area virtual.
+     */
+    void Unshare();
+
     /**
      * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
      */
@@ -769,7 +843,11 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -781,6 +859,16 @@ class Buffer
      * of m_data->m_data
      */
     uint32_t m_zeroAreaEnd;
+    /**
+     * the generator of the content of the virtual zero area, which
+     * holds zeroes if there is none
+     */
+    Ptr<const BufferContentGenerator> m_generator;
+    /**
+     * offset in the content generated of the first byte of the
+     * virtual zero area
+     */
+    uint64_t m_zeroAreaOffset;
     /**
      * offset to the start of the data referenced by this Buffer
      * instance from the start of m_data->m_data
@@ -791,21 +879,6 @@ class Buffer
      * instance from the start of m_data->m_data
      */
     uint32_t m_end;
-
-#ifdef BUFFER_FREE_LIST
-    /// Container for buffer data
-    typedef std::vector<Buffer::Data*> FreeList;
-
-    /// Local static destructor structure
-    struct LocalStaticDestructor
-    {
-        ~LocalStaticDestructor();
-    };
-
-    static uint32_t g_maxSize;                            //!< Max observed data size
-    static FreeList* g_freeList;                          //!< Buffer data container
-    static LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
 };
 
 } // namespace ns3
@@ -823,7 +896,9 @@ Buffer::Iterator::Iterator()
       m_dataStart(0),
       m_dataEnd(0),
       m_current(0),
-      m_data(nullptr)
+      m_data(nullptr),
+      m_generator(nullptr),
+      m_zeroOffset(0)
 {
 }
 
@@ -847,6 +922,8 @@ Buffer::Iterator::Construct(const Buffer* buffer)
     m_dataStart = buffer->m_start;
     m_dataEnd = buffer->m_end;
     m_data = buffer->m_data->m_data;
+    m_generator = PeekPointer(buffer->m_generator);
+    m_zeroOffset = buffer->m_zeroAreaOffset;
 }
 
 void
@@ -1014,7 +1091,12 @@ Buffer::Iterator::PeekU8()
     }
     else if (m_current < m_zeroEnd)
     {
-        return 0;
+        uint8_t data = 0;
+        if (m_generator != nullptr)
+        {
+            m_generator->Generate(&data, 1, m_zeroOffset + (m_current - m_zeroStart));
+        }
+        return data;
     }
     else
     {
@@ -1057,6 +1139,8 @@ Buffer::Buffer(const Buffer& o)
       m_maxZeroAreaStart(o.m_zeroAreaStart),
       m_zeroAreaStart(o.m_zeroAreaStart),
       m_zeroAreaEnd(o.m_zeroAreaEnd),
+      m_generator(o.m_generator),
+      m_zeroAreaOffset(o.m_zeroAreaOffset),
       m_start(o.m_start),
       m_end(o.m_end)
 {
@@ -40,4 +40,17 @@ NetDevice::~NetDevice()
     NS_LOG_FUNCTION(this);
 }
 
+bool
+NetDevice::SendMore(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << dest << protocolNumber);
+    return Send(packet, dest, protocolNumber);
+}
+
+void
+NetDevice::EndBurst()
+{
+    NS_LOG_FUNCTION(this);
+}
+
 } // namespace ns3
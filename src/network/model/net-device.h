@@ -264,6 +264,27 @@ class NetDevice : public Object
                           const Address& source,
                           const Address& dest,
                           uint16_t protocolNumber) = 0;
+    /**
+     * \param packet packet sent from above down to Network Device
+     * \param dest mac address of the destination (already resolved)
+     * \param protocolNumber identifies the type of payload contained in
+     *        this packet. Used to call the right L3Protocol when the packet
+     *        is received.
+     *
+     *  Called from higher layer to send a packet which is followed by
+     *  other packets of the same burst, like the xmit_more hint of Linux:
+     *  the Network Device may defer the start of the transmission until
+     *  EndBurst is called, so as to process the packets of the burst at
+     *  once. The default implementation calls Send.
+     *
+     * \return whether the Send operation succeeded
+     */
+    virtual bool SendMore(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+    /**
+     *  Called from higher layer after the last packet of a burst sent
+     *  with SendMore. The default implementation does nothing.
+     */
+    virtual void EndBurst();
     /**
      * \returns the node base class which contains this network
      *          interface.
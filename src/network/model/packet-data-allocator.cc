@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "packet-data-allocator.h"
+
+#include "ns3/log.h"
+
+#include <new>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PacketDataAllocator");
+
+namespace
+{
+
+/** Size of the blocks of the first size class, in bytes. */
+constexpr std::size_t MIN_BLOCK_SIZE = 64;
+/** Number of size classes: larger blocks use the system allocator. */
+constexpr std::size_t SIZE_CLASS_COUNT = 11;
+/** Maximum number of bytes of the blocks kept in a free list. */
+constexpr std::size_t FREE_LIST_MAX_BYTES = 4 << 20;
+
+/** A free block of a free list. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< Next free block of the list
+};
+
+/*
+ * The free lists are plain thread-local data, which remain usable after
+ * the thread-local destructors have run, e.g. when packets are released by
+ * the destructors of static objects.
+ */
+/** The free lists of the calling thread, by size class. */
+thread_local FreeBlock* g_freeLists[SIZE_CLASS_COUNT];
+/** The number of blocks in the free lists of the calling thread. */
+thread_local std::size_t g_freeListSizes[SIZE_CLASS_COUNT];
+/** Whether the free lists of the calling thread are enabled. */
+thread_local bool g_freeListsEnabled = true;
+/** The statistics of the calling thread. */
+thread_local PacketDataAllocator::Stats g_stats;
+
+/** Empty the free lists of the calling thread. */
+void
+ReleaseFreeLists()
+{
+    for (std::size_t i = 0; i < SIZE_CLASS_COUNT; i++)
+    {
+        while (g_freeLists[i] != nullptr)
+        {
+            FreeBlock* block = g_freeLists[i];
+            g_freeLists[i] = block->next;
+            ::operator delete(block);
+        }
+        g_freeListSizes[i] = 0;
+    }
+    g_stats.cachedBlocks = 0;
+    g_stats.cachedBytes = 0;
+}
+
+/** Release the free lists of a thread when it exits. */
+struct FreeListsReleaser
+{
+    /** Destructor. */
+    ~FreeListsReleaser()
+    {
+        g_freeListsEnabled = false;
+        ReleaseFreeLists();
+    }
+};
+
+/**
+ * \param size A requested size, in bytes.
+ * \return The size class of the requested size, or SIZE_CLASS_COUNT if the
+ * size is larger than the largest size class.
+ */
+inline std::size_t
+GetSizeClass(std::size_t size)
+{
+    std::size_t sizeClass = 0;
+    while (sizeClass < SIZE_CLASS_COUNT && (MIN_BLOCK_SIZE << sizeClass) < size)
+    {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+} // unnamed namespace
+
+std::size_t
+PacketDataAllocator::GetBlockSize(std::size_t size)
+{
+    std::size_t sizeClass = GetSizeClass(size);
+    return sizeClass < SIZE_CLASS_COUNT ? MIN_BLOCK_SIZE << sizeClass : size;
+}
+
+void*
+PacketDataAllocator::Allocate(std::size_t size)
+{
+    NS_LOG_FUNCTION(size);
+    g_stats.allocations++;
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass == SIZE_CLASS_COUNT)
+    {
+        return ::operator new(size);
+    }
+    FreeBlock* block = g_freeLists[sizeClass];
+    if (block != nullptr)
+    {
+        g_freeLists[sizeClass] = block->next;
+        g_freeListSizes[sizeClass]--;
+        g_stats.reuses++;
+        g_stats.cachedBlocks--;
+        g_stats.cachedBytes -= MIN_BLOCK_SIZE << sizeClass;
+        return block;
+    }
+    return ::operator new(MIN_BLOCK_SIZE << sizeClass);
+}
+
+void
+PacketDataAllocator::Deallocate(void* block, std::size_t size)
+{
+    NS_LOG_FUNCTION(block << size);
+    g_stats.releases++;
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass == SIZE_CLASS_COUNT || !g_freeListsEnabled ||
+        (g_freeListSizes[sizeClass] + 1) * (MIN_BLOCK_SIZE << sizeClass) > FREE_LIST_MAX_BYTES)
+    {
+        ::operator delete(block);
+        return;
+    }
+    // register the release of the free lists at the exit of the thread
+    static thread_local FreeListsReleaser releaser;
+    auto freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = g_freeLists[sizeClass];
+    g_freeLists[sizeClass] = freeBlock;
+    g_freeListSizes[sizeClass]++;
+    g_stats.cachedBlocks++;
+    g_stats.cachedBytes += MIN_BLOCK_SIZE << sizeClass;
+}
+
+PacketDataAllocator::Stats
+PacketDataAllocator::GetStats()
+{
+    return g_stats;
+}
+
+void
+PacketDataAllocator::EnableFreeLists(bool enable)
+{
+    NS_LOG_FUNCTION(enable);
+    g_freeListsEnabled = enable;
+    if (!enable)
+    {
+        ReleaseFreeLists();
+    }
+}
+
+} // namespace ns3
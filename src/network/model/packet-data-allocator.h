@@ -0,0 +1,95 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PACKET_DATA_ALLOCATOR_H
+#define PACKET_DATA_ALLOCATOR_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup packet
+ *
+ * \brief Allocator of the variable-sized storage of the packets.
+ *
+ * The storage of the Buffer, PacketMetadata and ByteTagList instances is
+ * allocated in blocks whose size is a power of two, from 64 bytes to
+ * 64 KiB, and the released blocks are kept in one free list per block
+ * size, to be reused by the next allocations of the same size class.
+ * Larger blocks are directly handed to the system allocator.
+ *
+ * The free lists and the statistics are per thread, hence the allocator
+ * needs no locking: a block allocated by a thread can be released by
+ * another thread, e.g., in a multithreaded simulation, and is then
+ * reused by the latter. The free lists of a thread are released when it
+ * exits.
+ */
+class PacketDataAllocator
+{
+  public:
+    /** Statistics of the allocations of the calling thread. */
+    struct Stats
+    {
+        uint64_t allocations;  //!< Number of blocks allocated
+        uint64_t reuses;       //!< Number of blocks allocated from a free list
+        uint64_t releases;     //!< Number of blocks released
+        uint64_t cachedBlocks; //!< Number of blocks in the free lists
+        uint64_t cachedBytes;  //!< Number of bytes of the blocks in the free lists
+    };
+
+    /**
+     * \param size A requested size, in bytes.
+     * \return The size of the block allocated for the requested size, in
+     * bytes, which can be used in full by the caller.
+     */
+    static std::size_t GetBlockSize(std::size_t size);
+
+    /**
+     * Allocate a block, from the free list of its size class if possible.
+     *
+     * \param size The requested size, in bytes.
+     * \return The block, of GetBlockSize(size) bytes.
+     */
+    static void* Allocate(std::size_t size);
+
+    /**
+     * Release a block to the free list of its size class.
+     *
+     * \param block The block.
+     * \param size The requested size the block was allocated for, or its
+     * block size.
+     */
+    static void Deallocate(void* block, std::size_t size);
+
+    /**
+     * \return The statistics of the allocations of the calling thread.
+     */
+    static Stats GetStats();
+
+    /**
+     * Enable or disable the free lists of the calling thread; they are
+     * enabled by default. When they are disabled, the free lists are
+     * emptied and the released blocks are returned to the system allocator.
+     *
+     * \param enable Whether the free lists are enabled.
+     */
+    static void EnableFreeLists(bool enable);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_DATA_ALLOCATOR_H */
@@ -20,6 +20,7 @@
 
 #include "buffer.h"
 #include "header.h"
+#include "packet-data-allocator.h"
 #include "trailer.h"
 
 #include "ns3/assert.h"
@@ -37,19 +38,16 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
+bool PacketMetadata::m_sampling = false;
+uint32_t PacketMetadata::m_samplingPeriod = 1;
+PacketMetadata::SamplingFilter PacketMetadata::m_samplingFilter;
+#ifdef NS3_MTP
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
+#else
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList()
-{
-    NS_LOG_FUNCTION(this);
-    for (iterator i = begin(); i != end(); i++)
-    {
-        PacketMetadata::Deallocate(*i);
-    }
-    PacketMetadata::m_enable = false;
-}
+#endif
 
 void
 PacketMetadata::Enable()
@@ -73,6 +71,33 @@ PacketMetadata::EnableChecking()
     m_enableChecking = true;
 }
 
+void
+PacketMetadata::EnableSampling(uint32_t period, SamplingFilter filter)
+{
+    NS_LOG_FUNCTION(period);
+    NS_ASSERT_MSG(period > 0, "The sampling period must be at least one packet");
+    Enable();
+    m_samplingPeriod = period;
+    m_samplingFilter = filter;
+    m_sampling = period > 1 || !filter.IsNull();
+}
+
+bool
+PacketMetadata::Sample(uint64_t uid)
+{
+    if (uid % m_samplingPeriod != 0)
+    {
+        return false;
+    }
+    return m_samplingFilter.IsNull() || m_samplingFilter(uid);
+}
+
+bool
+PacketMetadata::IsSampled() const
+{
+    return m_enable && m_sampled;
+}
+
 void
 PacketMetadata::ReserveCopy(uint32_t size)
 {
@@ -80,8 +105,7 @@ PacketMetadata::ReserveCopy(uint32_t size)
     PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
     memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -104,8 +128,13 @@ PacketMetadata::Reserve(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     NS_ASSERT(m_data != nullptr);
+#ifdef NS3_MTP
+    // shared data may be read by other threads: never write into it
+    if (m_data->m_size >= m_used + size && m_data->m_count == 1)
+#else
     if (m_data->m_size >= m_used + size &&
         (m_head == 0xffff || m_data->m_count == 1 || m_data->m_dirtyEnd == m_used))
+#endif
     {
         /* enough room, not dirty. */
     }
@@ -384,8 +413,12 @@ PacketMetadata::AddSmall(const PacketMetadata::SmallItem* item)
     uint32_t typeUidSize = GetUleb128Size(item->typeUid);
     uint32_t sizeSize = GetUleb128Size(item->size);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2;
+#ifdef NS3_MTP
+    if (m_used + n > m_data->m_size || m_data->m_count != 1)
+#else
     if (m_used + n > m_data->m_size ||
         (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+#endif
     {
         ReserveCopy(n);
     }
@@ -421,8 +454,12 @@ PacketMetadata::AddBig(uint32_t next,
     uint32_t fragEndSize = GetUleb128Size(extraItem->fragmentEnd);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
+#ifdef NS3_MTP
+    if (m_used + n > m_data->m_size || m_data->m_count != 1)
+#else
     if (m_used + n > m_data->m_size ||
         (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+#endif
     {
         ReserveCopy(n);
     }
@@ -572,19 +609,6 @@ PacketMetadata::Create(uint32_t size)
     {
         m_maxSize = size;
     }
-    while (!m_freeList.empty())
-    {
-        PacketMetadata::Data* data = m_freeList.back();
-        m_freeList.pop_back();
-        if (data->m_size >= size)
-        {
-            NS_LOG_LOGIC("create found size=" << data->m_size);
-            data->m_count = 1;
-            return data;
-        }
-        NS_LOG_LOGIC("create dealloc size=" << data->m_size);
-        PacketMetadata::Deallocate(data);
-    }
     NS_LOG_LOGIC("create alloc size=" << m_maxSize);
     return PacketMetadata::Allocate(m_maxSize);
 }
@@ -593,21 +617,8 @@ void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    if (!m_enable)
-    {
-        PacketMetadata::Deallocate(data);
-        return;
-    }
-    NS_LOG_LOGIC("recycle size=" << data->m_size << ", list=" << m_freeList.size());
     NS_ASSERT(data->m_count == 0);
-    if (m_freeList.size() > 1000 || data->m_size < m_maxSize)
-    {
-        PacketMetadata::Deallocate(data);
-    }
-    else
-    {
-        m_freeList.push_back(data);
-    }
+    PacketMetadata::Deallocate(data);
 }
 
 PacketMetadata::Data*
@@ -620,9 +631,9 @@ PacketMetadata::Allocate(uint32_t n)
         n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
     size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-    uint8_t* buf = new uint8_t[size];
-    PacketMetadata::Data* data = (PacketMetadata::Data*)buf;
-    data->m_size = n;
+    auto data = static_cast<PacketMetadata::Data*>(PacketDataAllocator::Allocate(size));
+    // use the whole block
+    data->m_size = n + (PacketDataAllocator::GetBlockSize(size) - size);
     data->m_count = 1;
     data->m_dirtyEnd = 0;
     return data;
@@ -632,8 +643,8 @@ void
 PacketMetadata::Deallocate(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    uint8_t* buf = (uint8_t*)data;
-    delete[] buf;
+    PacketDataAllocator::Deallocate(data,
+                                    sizeof(Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE);
 }
 
 PacketMetadata
@@ -659,9 +670,8 @@ void
 PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
 {
     NS_LOG_FUNCTION(this << uid << size);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
 
@@ -681,9 +691,8 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
 {
     uint32_t uid = header.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &header << size);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
     PacketMetadata::SmallItem item;
@@ -726,9 +735,8 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
     PacketMetadata::SmallItem item;
@@ -748,9 +756,8 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
     PacketMetadata::SmallItem item;
@@ -792,9 +799,19 @@ void
 PacketMetadata::AddAtEnd(const PacketMetadata& o)
 {
     NS_LOG_FUNCTION(this << &o);
-    if (!m_enable)
+    if (!IsRecording())
+    {
+        return;
+    }
+    if (!o.m_sampled)
     {
-        m_metadataSkipped = true;
+        // The items of o were not recorded, so that the items of this
+        // packet would not describe the bytes appended: stop recording.
+        NS_LOG_LOGIC("appending an unsampled packet");
+        m_head = 0xffff;
+        m_tail = 0xffff;
+        m_used = 0;
+        m_sampled = false;
         return;
     }
     if (m_tail == 0xffff)
@@ -868,9 +885,8 @@ void
 PacketMetadata::AddPaddingAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
 }
@@ -879,9 +895,8 @@ void
 PacketMetadata::RemoveAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
     NS_ASSERT(m_data != nullptr);
@@ -940,9 +955,8 @@ void
 PacketMetadata::RemoveAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
     NS_ASSERT(m_data != nullptr);
@@ -1320,6 +1334,8 @@ PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
         uint32_t tmp = AddBig(0xffff, m_tail, &item, &extraItem);
         UpdateTail(tmp);
     }
+    // the sender of a packet without metadata did not sample it
+    m_sampled = !m_sampling || m_head != 0xffff;
     NS_ASSERT(desSize == 0);
     return (desSize != 0) ? 0 : 1;
 }
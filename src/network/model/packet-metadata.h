@@ -23,12 +23,17 @@
 
 #include "ns3/assert.h"
 #include "ns3/callback.h"
+#include "ns3/core-config.h"
 #include "ns3/type-id.h"
 
 #include <limits>
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -76,10 +81,23 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * Maintaining this list on every operation of every packet is
+ * expensive, so the metadata can be recorded for a sample of the
+ * packets only (see EnableSampling). Whether a packet is sampled is
+ * decided once, when it is created, and is inherited by its copies and
+ * fragments: the other packets skip all the bookkeeping, as if the
+ * metadata were disabled, and have an empty list of items.
  */
 class PacketMetadata
 {
   public:
+    /**
+     * Callback deciding whether the metadata of a new packet is recorded:
+     * its argument is the uid of the packet.
+     */
+    typedef Callback<bool, uint64_t> SamplingFilter;
+
     /**
      * \brief structure describing a packet metadata item
      */
@@ -169,6 +187,24 @@ class PacketMetadata
      * \brief Enable the packet metadata checking
      */
     static void EnableChecking();
+    /**
+     * \brief Enable the packet metadata for a sample of the packets
+     *
+     * The metadata of a packet is recorded if its uid is a multiple of
+     * the period and, if the filter is not null, if the filter returns
+     * true for the packet: the filter can select, for example, the
+     * packets created by some nodes with Simulator::GetContext. A period
+     * of 1 and a null filter record the metadata of all the packets, as
+     * Enable. The sampling can be changed during the simulation: it
+     * applies to the packets created afterwards.
+     *
+     * In a distributed simulation, a packet received from another process
+     * is sampled if it carries metadata.
+     *
+     * \param period the sampling period, in packets
+     * \param filter the filter of the packets, or a null callback
+     */
+    static void EnableSampling(uint32_t period, SamplingFilter filter = SamplingFilter());
 
     /**
      * \brief Constructor
@@ -251,6 +287,12 @@ class PacketMetadata
      */
     void RemoveAtEnd(uint32_t end);
 
+    /**
+     * \brief Check if the metadata of the packet is recorded
+     * \returns true if the metadata is enabled and the packet is sampled
+     */
+    bool IsSampled() const;
+
     /**
      * \brief Get the packet Uid
      * \return the packet Uid
@@ -426,7 +468,11 @@ class PacketMetadata
     struct Data
     {
         /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /** size (in bytes) of m_data buffer below */
         uint16_t m_size;
         /** max of the m_used field over all objects which reference this struct Data instance */
@@ -509,16 +555,6 @@ class PacketMetadata
         uint64_t packetUid;
     };
 
-    /**
-     * \brief Class to hold all the metadata
-     */
-    class DataFreeList : public std::vector<Data*>
-    {
-      public:
-        ~DataFreeList();
-    };
-
-    friend DataFreeList::~DataFreeList();
     /// Friend class
     friend class ItemIterator;
 
@@ -634,6 +670,20 @@ class PacketMetadata
      * \param size header serialized size
      */
     void DoAddHeader(uint32_t uid, uint32_t size);
+    /**
+     * \brief Check if the operations on the metadata are recorded
+     *
+     * Also notes that an operation is skipped when the metadata is disabled.
+     *
+     * \returns true if the metadata is enabled and the packet is sampled
+     */
+    inline bool IsRecording() const;
+    /**
+     * \brief Decide whether the metadata of a new packet is recorded
+     * \param uid the uid of the packet
+     * \returns true if the packet is sampled
+     */
+    static bool Sample(uint64_t uid);
     /**
      * \brief Check if the metadata state is ok
      * \returns true if the internal state is ok
@@ -675,7 +725,6 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
     static bool m_enable;           //!< Enable the packet metadata
     static bool m_enableChecking;   //!< Enable the packet metadata checking
 
@@ -686,8 +735,17 @@ class PacketMetadata
      */
     static bool m_metadataSkipped;
 
+    static bool m_sampling;                 //!< Record the metadata of a sample of the packets
+    static uint32_t m_samplingPeriod;       //!< Sampling period, in packets
+    static SamplingFilter m_samplingFilter; //!< Filter of the sampled packets
+
+#ifdef NS3_MTP
+    static thread_local uint32_t m_maxSize;  //!< maximum metadata size
+    static thread_local uint16_t m_chunkUid; //!< Chunk Uid
+#else
     static uint32_t m_maxSize;  //!< maximum metadata size
     static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
     Data* m_data; //!< Metadata storage
     /*
@@ -699,6 +757,7 @@ class PacketMetadata
     uint16_t m_tail;      //!< list tail
     uint16_t m_used;      //!< used portion
     uint64_t m_packetUid; //!< packet Uid
+    bool m_sampled;       //!< true if the metadata of this packet is recorded
 };
 
 } // namespace ns3
@@ -711,7 +770,8 @@ PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
       m_head(0xffff),
       m_tail(0xffff),
       m_used(0),
-      m_packetUid(uid)
+      m_packetUid(uid),
+      m_sampled(!m_sampling || Sample(uid))
 {
     memset(m_data->m_data, 0xff, 4);
     if (size > 0)
@@ -725,7 +785,8 @@ PacketMetadata::PacketMetadata(const PacketMetadata& o)
       m_head(o.m_head),
       m_tail(o.m_tail),
       m_used(o.m_used),
-      m_packetUid(o.m_packetUid)
+      m_packetUid(o.m_packetUid),
+      m_sampled(o.m_sampled)
 {
     NS_ASSERT(m_data != nullptr);
     NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
@@ -739,8 +800,7 @@ PacketMetadata::operator=(const PacketMetadata& o)
     {
         // not self assignment
         NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             PacketMetadata::Recycle(m_data);
         }
@@ -752,14 +812,25 @@ PacketMetadata::operator=(const PacketMetadata& o)
     m_tail = o.m_tail;
     m_used = o.m_used;
     m_packetUid = o.m_packetUid;
+    m_sampled = o.m_sampled;
     return *this;
 }
 
+bool
+PacketMetadata::IsRecording() const
+{
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return false;
+    }
+    return m_sampled;
+}
+
 PacketMetadata::~PacketMetadata()
 {
     NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -52,6 +52,26 @@ PacketTagList::CreateTagData(size_t dataSize)
     return tag;
 }
 
+#ifdef NS3_MTP
+PacketTagList::TagData*
+PacketTagList::DeepCopy(const TagData* list)
+{
+    TagData* head = nullptr;
+    TagData** prevNext = &head;
+    for (const TagData* cur = list; cur != nullptr; cur = cur->next)
+    {
+        TagData* copy = CreateTagData(cur->size);
+        copy->tid = cur->tid;
+        copy->count = 1;
+        copy->next = nullptr;
+        memcpy(copy->data, cur->data, copy->size);
+        *prevNext = copy;
+        prevNext = &copy->next;
+    }
+    return head;
+}
+#endif
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -24,6 +24,7 @@
 \brief  Defines a linked list of Packet tags, including copy-on-write semantics.
 */
 
+#include "ns3/core-config.h"
 #include "ns3/type-id.h"
 
 #include <ostream>
@@ -253,6 +254,18 @@ class PacketTagList
      */
     static TagData* CreateTagData(size_t dataSize);
 
+#ifdef NS3_MTP
+    /**
+     * Copy a list of tags. In multithreaded builds, lists are copied
+     * rather than shared, since the copy-on-write bookkeeping of the
+     * shared tails is not thread-safe.
+     *
+     * \param [in] list The first TagData of the list to copy.
+     * \returns The first TagData of the copy.
+     */
+    static TagData* DeepCopy(const TagData* list);
+#endif
+
     /**
      * Typedef of method function pointer for copy-on-write operations
      *
@@ -324,10 +337,14 @@ PacketTagList::PacketTagList()
 PacketTagList::PacketTagList(const PacketTagList& o)
     : m_next(o.m_next)
 {
+#ifdef NS3_MTP
+    m_next = DeepCopy(m_next);
+#else
     if (m_next != nullptr)
     {
         m_next->count++;
     }
+#endif
 }
 
 PacketTagList&
@@ -339,11 +356,15 @@ PacketTagList::operator=(const PacketTagList& o)
         return *this;
     }
     RemoveAll();
+#ifdef NS3_MTP
+    m_next = DeepCopy(o.m_next);
+#else
     m_next = o.m_next;
     if (m_next != nullptr)
     {
         m_next->count++;
     }
+#endif
     return *this;
 }
 
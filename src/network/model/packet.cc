@@ -141,15 +141,15 @@ Packet::Packet()
       m_byteTagList(),
       m_packetTagList(),
       /* The upper 32 bits of the packet id in
-       * metadata is for the system id. For non-
-       * distributed simulations, this is simply
-       * zero.  The lower 32 bits are for the
-       * global UID
+       * metadata is for the system id, or the
+       * logical process in multithreaded
+       * simulations. For serial simulations,
+       * this is simply zero.  The lower 32 bits
+       * are for the global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(Simulator::AllocateUid(m_globalUid), 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -181,15 +181,24 @@ Packet::Packet(uint32_t size)
       m_byteTagList(),
       m_packetTagList(),
       /* The upper 32 bits of the packet id in
-       * metadata is for the system id. For non-
-       * distributed simulations, this is simply
-       * zero.  The lower 32 bits are for the
-       * global UID
+       * metadata is for the system id, or the
+       * logical process in multithreaded
+       * simulations. For serial simulations,
+       * this is simply zero.  The lower 32 bits
+       * are for the global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(Simulator::AllocateUid(m_globalUid), size),
+      m_nixVector(nullptr)
+{
+}
+
+Packet::Packet(uint32_t size, Ptr<const BufferContentGenerator> generator, uint64_t offset)
+    : m_buffer(size, generator, offset),
+      m_byteTagList(),
+      m_packetTagList(),
+      m_metadata(Simulator::AllocateUid(m_globalUid), size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -208,15 +217,15 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
       m_byteTagList(),
       m_packetTagList(),
       /* The upper 32 bits of the packet id in
-       * metadata is for the system id. For non-
-       * distributed simulations, this is simply
-       * zero.  The lower 32 bits are for the
-       * global UID
+       * metadata is for the system id, or the
+       * logical process in multithreaded
+       * simulations. For serial simulations,
+       * this is simply zero.  The lower 32 bits
+       * are for the global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(Simulator::AllocateUid(m_globalUid), size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -606,6 +615,13 @@ Packet::EnableChecking()
     PacketMetadata::EnableChecking();
 }
 
+void
+Packet::EnableSampledPrinting(uint32_t period, PacketMetadata::SamplingFilter filter)
+{
+    NS_LOG_FUNCTION(period);
+    PacketMetadata::EnableSampling(period, filter);
+}
+
 uint32_t
 Packet::GetSerializedSize() const
 {
@@ -207,6 +207,9 @@ class PacketTagIterator
  * checking of metadata, and do not need any printing capability, you can
  * call Packet::EnableChecking: its runtime cost is lower than
  * Packet::EnablePrinting.
+ * Packet::EnableSampledPrinting records the metadata of a sample of the
+ * packets only, so that large simulations can print some packets at a
+ * fraction of the cost.
  *
  * - The set of tags contain simulation-specific information which cannot
  * be stored in the packet byte buffer because the protocol headers or trailers
@@ -266,6 +269,22 @@ class Packet : public SimpleRefCount<Packet>
      * \param size the size of the zero-filled payload
      */
     Packet(uint32_t size);
+    /**
+     * \brief Create a packet with a generated payload.
+     *
+     * The payload holds the content generated from the given
+     * offset. As for a zero-filled payload, its memory is not
+     * allocated, and the content is only generated when the
+     * payload is read, e.g., by CopyData. The fragments of
+     * packets holding consecutive parts of the same content
+     * are appended to each other without generating it. The
+     * packet is allocated with a new uid.
+     *
+     * \param size the size of the payload
+     * \param generator the generator of the content of the payload
+     * \param offset the offset in the content of the first byte of the payload
+     */
+    Packet(uint32_t size, Ptr<const BufferContentGenerator> generator, uint64_t offset = 0);
     /**
      * \brief Create a new packet from the serialized buffer.
      *
@@ -536,6 +555,22 @@ class Packet : public SimpleRefCount<Packet>
      * errors will be detected and will abort the program.
      */
     static void EnableChecking();
+    /**
+     * \brief Enable printing the metadata of a sample of the packets.
+     *
+     * Only the packets sampled when they are created keep around the
+     * metadata needed by the Print methods: the other packets print as
+     * if the metadata were disabled, and are processed faster.
+     *
+     * \param period the sampling period: one packet in period is sampled
+     * \param filter if not null, a callback which must also return true
+     * for the uid of a packet for the packet to be sampled
+     *
+     * \sa PacketMetadata::EnableSampling
+     */
+    static void EnableSampledPrinting(uint32_t period,
+                                      PacketMetadata::SamplingFilter filter =
+                                          PacketMetadata::SamplingFilter());
 
     /**
      * \brief Returns number of bytes required for packet
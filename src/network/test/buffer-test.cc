@@ -19,9 +19,15 @@
 
 #include "ns3/buffer.h"
 #include "ns3/double.h"
+#include "ns3/packet.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -393,6 +399,222 @@ BufferTest::DoRun()
     val2 <<= 8;
     val2 |= i.ReadU8();
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
+
+    // appending fragments of zero-filled buffers keeps their zero areas virtual:
+    // only the 3 lengths and the real bytes are serialized
+    Buffer zeroes(1000);
+    Buffer fragment = zeroes.CreateFragment(0, 300);
+    fragment.AddAtEnd(zeroes.CreateFragment(300, 700));
+    NS_TEST_ASSERT_MSG_EQ(fragment.GetSize(), 1000, "Bad size of the merged fragments");
+    NS_TEST_ASSERT_MSG_EQ(fragment.GetSerializedSize(), 12, "The zero areas were written");
+
+    Buffer withHeader(1000);
+    withHeader.AddAtStart(4);
+    withHeader.Begin().WriteHtonU32(0x01020304);
+    Buffer zeroTail = withHeader.CreateFragment(0, 504);
+    zeroTail.AddAtEnd(withHeader.CreateFragment(504, 500));
+    NS_TEST_ASSERT_MSG_EQ(zeroTail.GetSerializedSize(), 16, "The zero areas were written");
+
+    Buffer header;
+    header.AddAtStart(4);
+    header.Begin().WriteHtonU32(0x05060708);
+    header.AddAtEnd(withHeader);
+    NS_TEST_ASSERT_MSG_EQ(header.GetSize(), 1008, "Bad size of the appended buffer");
+    NS_TEST_ASSERT_MSG_EQ(header.GetSerializedSize(), 20, "The zero area was written");
+    std::vector<uint8_t> content(header.GetSize(), 0xff);
+    header.CopyData(content.data(), content.size());
+    std::vector<uint8_t> expected(header.GetSize(), 0);
+    for (uint8_t j = 0; j < 8; j++)
+    {
+        expected[j] = (j < 4 ? 5 : 1) + j % 4;
+    }
+    NS_TEST_ASSERT_MSG_EQ((content == expected), true, "Bad content of the appended buffer");
+
+    // the real bytes appended after a zero area and some real bytes are
+    // written after the latter
+    Buffer trailer(100);
+    trailer.AddAtEnd(4);
+    Buffer::Iterator end = trailer.End();
+    end.Prev(4);
+    end.WriteHtonU32(0x090a0b0c);
+    trailer.AddAtEnd(header.CreateFragment(0, 8));
+    NS_TEST_ASSERT_MSG_EQ(trailer.GetSize(), 112, "Bad size of the appended buffer");
+    content.assign(trailer.GetSize(), 0xff);
+    trailer.CopyData(content.data(), content.size());
+    expected.assign(trailer.GetSize(), 0);
+    for (uint8_t j = 0; j < 12; j++)
+    {
+        expected[100 + j] = (j < 4 ? 9 : (j < 8 ? 5 : 1)) + j % 4;
+    }
+    NS_TEST_ASSERT_MSG_EQ((content == expected), true, "Bad content of the appended buffer");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Generator of a content whose byte at offset k is k modulo 251, which
+ * counts the bytes generated.
+ */
+class CountingContentGenerator : public BufferContentGenerator
+{
+  public:
+    void Generate(uint8_t* buffer, uint32_t size, uint64_t offset) const override
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            buffer[i] = (offset + i) % 251;
+        }
+        m_generated += size;
+    }
+
+    mutable uint32_t m_generated{0}; //!< Number of bytes generated
+};
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer content generator unit tests.
+ */
+class BufferContentGeneratorTest : public TestCase
+{
+  private:
+    /**
+     * Checks the content of a buffer
+     * \param b The buffer to check
+     * \param expected The expected content
+     * \param name The name of the buffer
+     */
+    void CheckContent(const Buffer& b, const std::vector<uint8_t>& expected, std::string name);
+
+  public:
+    void DoRun() override;
+    BufferContentGeneratorTest();
+};
+
+BufferContentGeneratorTest::BufferContentGeneratorTest()
+    : TestCase("Buffer content generator")
+{
+}
+
+void
+BufferContentGeneratorTest::CheckContent(const Buffer& b,
+                                         const std::vector<uint8_t>& expected,
+                                         std::string name)
+{
+    NS_TEST_ASSERT_MSG_EQ(b.GetSize(), expected.size(), "Bad size of the " << name);
+    std::vector<uint8_t> content(b.GetSize(), 0xff);
+    b.CopyData(content.data(), content.size());
+    NS_TEST_EXPECT_MSG_EQ((content == expected), true, "Bad content of the " << name);
+    std::ostringstream os;
+    b.CopyData(&os, b.GetSize());
+    NS_TEST_EXPECT_MSG_EQ((os.str() == std::string(expected.begin(), expected.end())),
+                          true,
+                          "Bad content of the " << name << " written to a stream");
+    Buffer::Iterator i = b.Begin();
+    for (uint32_t j = 0; j < expected.size(); j++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(uint32_t(i.ReadU8()),
+                              uint32_t(expected[j]),
+                              "Bad byte " << j << " of the " << name << " read");
+    }
+}
+
+void
+BufferContentGeneratorTest::DoRun()
+{
+    Ptr<CountingContentGenerator> generator = Create<CountingContentGenerator>();
+    auto expectedContent = [](uint64_t offset, uint32_t size) {
+        std::vector<uint8_t> content;
+        for (uint32_t j = 0; j < size; j++)
+        {
+            content.push_back((offset + j) % 251);
+        }
+        return content;
+    };
+
+    // the content is generated when it is read
+    Buffer generated(1000, generator, 100);
+    NS_TEST_ASSERT_MSG_EQ(generator->m_generated, 0, "The content was generated");
+    CheckContent(generated, expectedContent(100, 1000), "generated buffer");
+    NS_TEST_ASSERT_MSG_GT(generator->m_generated, 0, "The content was not generated");
+
+    // consecutive fragments are appended without generating their content
+    generator->m_generated = 0;
+    Buffer merged = generated.CreateFragment(0, 300);
+    merged.AddAtEnd(generated.CreateFragment(300, 700));
+    NS_TEST_ASSERT_MSG_EQ(generator->m_generated, 0, "The merged fragments were generated");
+    CheckContent(merged, expectedContent(100, 1000), "merged fragments");
+
+    // with headers and trailers around the generated content
+    generator->m_generated = 0;
+    Buffer segment = generated.CreateFragment(200, 400);
+    segment.AddAtStart(2);
+    segment.Begin().WriteU16(0x0201);
+    Buffer trailer = generated.CreateFragment(600, 100);
+    segment.AddAtEnd(trailer);
+    segment.AddAtEnd(1);
+    Buffer::Iterator end = segment.End();
+    end.Prev();
+    end.WriteU8(3);
+    NS_TEST_ASSERT_MSG_EQ(generator->m_generated, 0, "The segment was generated");
+    std::vector<uint8_t> expected{1, 2};
+    std::vector<uint8_t> payload = expectedContent(300, 500);
+    expected.insert(expected.end(), payload.begin(), payload.end());
+    expected.push_back(3);
+    CheckContent(segment, expected, "segment");
+
+    // the fragments which are not consecutive are written
+    Buffer gap = generated.CreateFragment(0, 100);
+    gap.AddAtEnd(generated.CreateFragment(500, 100));
+    expected = expectedContent(100, 100);
+    payload = expectedContent(600, 100);
+    expected.insert(expected.end(), payload.begin(), payload.end());
+    CheckContent(gap, expected, "fragments with a gap");
+
+    // the zero-filled and generated contents are not merged
+    Buffer zeroes(50);
+    zeroes.AddAtEnd(generated.CreateFragment(0, 50));
+    expected.assign(50, 0);
+    payload = expectedContent(100, 50);
+    expected.insert(expected.end(), payload.begin(), payload.end());
+    CheckContent(zeroes, expected, "zeroes followed by generated content");
+
+    // the content is kept by PeekData
+    expected = {1, 2};
+    payload = expectedContent(300, 500);
+    expected.insert(expected.end(), payload.begin(), payload.end());
+    expected.push_back(3);
+    const uint8_t* data = segment.PeekData();
+    NS_TEST_EXPECT_MSG_EQ(std::memcmp(data, expected.data(), expected.size()),
+                          0,
+                          "Bad content of the real buffer");
+    generator->m_generated = 0;
+    CheckContent(segment, expected, "real buffer");
+    NS_TEST_EXPECT_MSG_EQ(generator->m_generated, 0, "The real buffer was generated");
+
+    // packets
+    Ptr<Packet> packet = Create<Packet>(1000, generator, 100);
+    Ptr<Packet> reassembled = packet->CreateFragment(0, 400);
+    reassembled->AddAtEnd(packet->CreateFragment(400, 600));
+    std::vector<uint8_t> content(reassembled->GetSize());
+    reassembled->CopyData(content.data(), content.size());
+    NS_TEST_EXPECT_MSG_EQ((content == expectedContent(100, 1000)),
+                          true,
+                          "Bad content of the reassembled packet");
+
+    // the serialized packet holds the generated content
+    std::vector<uint8_t> serialized(reassembled->GetSerializedSize());
+    NS_TEST_ASSERT_MSG_EQ(reassembled->Serialize(serialized.data(), serialized.size()),
+                          1,
+                          "Serialization failed");
+    Ptr<Packet> deserialized = Create<Packet>(serialized.data(), serialized.size(), true);
+    content.assign(deserialized->GetSize(), 0);
+    deserialized->CopyData(content.data(), content.size());
+    NS_TEST_EXPECT_MSG_EQ((content == expectedContent(100, 1000)),
+                          true,
+                          "Bad content of the deserialized packet");
 }
 
 /**
@@ -411,6 +633,7 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", UNIT)
 {
     AddTestCase(new BufferTest, TestCase::QUICK);
+    AddTestCase(new BufferContentGeneratorTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/packet-data-allocator.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PacketDataAllocator size classes and free lists Test
+ */
+class PacketDataAllocatorTest : public TestCase
+{
+  public:
+    PacketDataAllocatorTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketDataAllocatorTest::PacketDataAllocatorTest()
+    : TestCase("Check the size classes and the reuse of the packet data blocks")
+{
+}
+
+void
+PacketDataAllocatorTest::DoRun()
+{
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetBlockSize(1), 64, "Wrong smallest block");
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetBlockSize(64), 64, "Wrong block of 64 bytes");
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetBlockSize(65), 128, "Wrong block of 65 bytes");
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetBlockSize(1500),
+                          2048,
+                          "Wrong block of 1500 bytes");
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetBlockSize(65536),
+                          65536,
+                          "Wrong largest block");
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetBlockSize(65537),
+                          65537,
+                          "Blocks larger than the largest class should not be rounded");
+
+    // a released block is reused by the next allocation of its size class
+    void* block = PacketDataAllocator::Allocate(1000);
+    PacketDataAllocator::Deallocate(block, 1000);
+    PacketDataAllocator::Stats stats = PacketDataAllocator::GetStats();
+    NS_TEST_EXPECT_MSG_GT(stats.cachedBlocks, 0, "The released block should be cached");
+    void* reused = PacketDataAllocator::Allocate(600);
+    NS_TEST_EXPECT_MSG_EQ(reused, block, "The released block should be reused");
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetStats().reuses,
+                          stats.reuses + 1,
+                          "The reuse should be counted");
+    PacketDataAllocator::Deallocate(reused, 600);
+
+    // the packets are allocated from the free lists
+    {
+        Ptr<Packet> p = Create<Packet>(1500);
+    }
+    stats = PacketDataAllocator::GetStats();
+    {
+        Ptr<Packet> p = Create<Packet>(1500);
+    }
+    NS_TEST_EXPECT_MSG_GT(PacketDataAllocator::GetStats().reuses,
+                          stats.reuses,
+                          "The storage of a packet should be reused");
+
+    // without free lists, the blocks are released to the system allocator
+    PacketDataAllocator::EnableFreeLists(false);
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetStats().cachedBytes,
+                          0,
+                          "The free lists should be emptied");
+    {
+        Ptr<Packet> p = Create<Packet>(1500);
+    }
+    NS_TEST_EXPECT_MSG_EQ(PacketDataAllocator::GetStats().cachedBytes,
+                          0,
+                          "No block should be cached without free lists");
+    PacketDataAllocator::EnableFreeLists(true);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PacketDataAllocator TestSuite
+ */
+class PacketDataAllocatorTestSuite : public TestSuite
+{
+  public:
+    PacketDataAllocatorTestSuite();
+};
+
+PacketDataAllocatorTestSuite::PacketDataAllocatorTestSuite()
+    : TestSuite("packet-data-allocator", UNIT)
+{
+    AddTestCase(new PacketDataAllocatorTest, TestCase::QUICK);
+}
+
+static PacketDataAllocatorTestSuite
+    g_packetDataAllocatorTestSuite; //!< Static variable for test initialization
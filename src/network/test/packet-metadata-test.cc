@@ -881,6 +881,88 @@ PacketMetadataTest::DoRun()
                           "Could not find original data in received packet");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet Metadata sampling unit tests.
+ */
+class PacketMetadataSamplingTest : public TestCase
+{
+  public:
+    PacketMetadataSamplingTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * \param p The packet
+     * \return The number of metadata items of the packet
+     */
+    static uint32_t CountItems(Ptr<const Packet> p);
+};
+
+PacketMetadataSamplingTest::PacketMetadataSamplingTest()
+    : TestCase("Packet metadata sampling")
+{
+}
+
+uint32_t
+PacketMetadataSamplingTest::CountItems(Ptr<const Packet> p)
+{
+    uint32_t n = 0;
+    PacketMetadata::ItemIterator k = p->BeginItem();
+    while (k.HasNext())
+    {
+        k.Next();
+        n++;
+    }
+    return n;
+}
+
+void
+PacketMetadataSamplingTest::DoRun()
+{
+    PacketMetadata::EnableSampling(2);
+    Ptr<Packet> sampled;
+    Ptr<Packet> unsampled;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(10);
+        ADD_HEADER(p, 2);
+        ((p->GetUid() % 2 == 0) ? sampled : unsampled) = p;
+        NS_TEST_EXPECT_MSG_EQ(CountItems(p),
+                              ((p->GetUid() % 2 == 0) ? 2 : 0),
+                              "Only one packet in two should have metadata");
+    }
+
+    // copies and fragments are sampled as their packet
+    NS_TEST_EXPECT_MSG_EQ(CountItems(sampled->Copy()), 2, "A copy lost its metadata");
+    NS_TEST_EXPECT_MSG_EQ(CountItems(sampled->CreateFragment(0, 5)), 2, "Wrong fragment items");
+    Ptr<Packet> fragment = unsampled->CreateFragment(0, 5);
+    ADD_HEADER(fragment, 3);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(fragment), 0, "An unsampled fragment has metadata");
+
+    // appending an unsampled packet stops the recording of the metadata
+    Ptr<Packet> p = sampled->Copy();
+    p->AddAtEnd(unsampled);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(p), 0, "The metadata should be dropped");
+    ADD_HEADER(p, 4);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(p), 0, "The metadata should not be recorded anymore");
+    p = sampled->Copy();
+    p->AddAtEnd(sampled);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(p), 4, "Wrong number of items of sampled packets");
+
+    // the filter selects the packets among the sampled ones
+    bool select = false;
+    PacketMetadata::EnableSampling(1, [&select](uint64_t) { return select; });
+    NS_TEST_EXPECT_MSG_EQ(CountItems(Create<Packet>(10)), 0, "The filter was ignored");
+    select = true;
+    NS_TEST_EXPECT_MSG_EQ(CountItems(Create<Packet>(10)), 1, "The filter was ignored");
+
+    PacketMetadata::EnableSampling(1);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(Create<Packet>(10)), 1, "Sampling was not disabled");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -897,6 +979,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite()
     : TestSuite("packet-metadata", UNIT)
 {
     AddTestCase(new PacketMetadataTest, TestCase::QUICK);
+    AddTestCase(new PacketMetadataSamplingTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
@@ -16,14 +16,18 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/output-stream-wrapper.h"
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -1375,6 +1379,149 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the files written through an
+ * AsyncFileWriter are identical to the files written directly.
+ */
+class AsyncWriteTestCase : public TestCase
+{
+  public:
+    AsyncWriteTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write the known packets several times to a pcap file.
+     *
+     * \param f The pcap file, opened in write mode.
+     */
+    void WritePackets(PcapFile& f);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase()
+    : TestCase("Check that the asynchronous pcap and ascii files are written in full")
+{
+}
+
+void
+AsyncWriteTestCase::WritePackets(PcapFile& f)
+{
+    f.Init(1, N_PACKET_BYTES / 2);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Init must not fail");
+    for (uint32_t j = 0; j < 50; ++j)
+    {
+        for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+            const PacketEntry& p = knownPackets[i];
+            f.Write(p.tsSec + j * 10, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+            NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Write must not fail");
+        }
+    }
+    f.Close();
+    NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Close must not fail");
+}
+
+void
+AsyncWriteTestCase::DoRun()
+{
+    // small buffers and a short queue, so that the writer thread is woken
+    // up and the stream waits for it many times
+    AsyncFileWriter::Config config;
+    config.bufferSize = 100;
+    config.maxQueuedBuffers = 2;
+
+    std::string syncFilename = CreateTempDirFilename("sync.pcap");
+    std::string asyncFilename = CreateTempDirFilename("async.pcap");
+    PcapFile syncFile;
+    syncFile.Open(syncFilename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(syncFile.Fail(), false, "Open (" << syncFilename << ") returns error");
+    WritePackets(syncFile);
+    PcapFile asyncFile;
+    asyncFile.OpenAsync(asyncFilename, std::ios::out, config);
+    NS_TEST_ASSERT_MSG_EQ(asyncFile.Fail(),
+                          false,
+                          "OpenAsync (" << asyncFilename << ") returns error");
+    WritePackets(asyncFile);
+
+    uint32_t sec(0);
+    uint32_t usec(0);
+    uint32_t packets(0);
+    bool diff = PcapFile::Diff(syncFilename, asyncFilename, sec, usec, packets, N_PACKET_BYTES);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "The asynchronous pcap file differs");
+    // 24 bytes of file header, 16 bytes of record header and 8 bytes of data per packet
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(asyncFilename, 24 + 50 * N_KNOWN_PACKETS * (16 + 8)),
+                          true,
+                          "The asynchronous pcap file has an unexpected length");
+
+    std::string asciiFilename = CreateTempDirFilename("async.tr");
+    std::ostringstream expected;
+    {
+        OutputStreamWrapper stream(asciiFilename, std::ios::out, config);
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            *stream.GetStream() << "+ " << i << " packet" << std::endl;
+            expected << "+ " << i << " packet" << std::endl;
+        }
+    }
+    std::ifstream ascii(asciiFilename);
+    std::ostringstream content;
+    content << ascii.rdbuf();
+    NS_TEST_EXPECT_MSG_EQ(content.str(), expected.str(), "The asynchronous ascii file differs");
+
+    // several files written at the same time share the writer thread
+    const uint32_t nFiles = 5;
+    std::vector<std::string> filenames;
+    std::vector<std::ostringstream> expectedFiles(nFiles);
+    {
+        std::vector<std::unique_ptr<OutputStreamWrapper>> streams;
+        for (uint32_t f = 0; f < nFiles; ++f)
+        {
+            filenames.push_back(CreateTempDirFilename("async-" + std::to_string(f) + ".tr"));
+            streams.push_back(
+                std::make_unique<OutputStreamWrapper>(filenames.back(), std::ios::out, config));
+        }
+        for (uint32_t i = 0; i < 200; ++i)
+        {
+            for (uint32_t f = 0; f < nFiles; ++f)
+            {
+                *streams[f]->GetStream() << "r " << i << " file " << f << std::endl;
+                expectedFiles[f] << "r " << i << " file " << f << std::endl;
+            }
+        }
+        // the files are closed in a different order than they were opened
+        streams[2].reset();
+    }
+    for (uint32_t f = 0; f < nFiles; ++f)
+    {
+        std::ifstream file(filenames[f]);
+        std::ostringstream fileContent;
+        fileContent << file.rdbuf();
+        NS_TEST_EXPECT_MSG_EQ(fileContent.str(),
+                              expectedFiles[f].str(),
+                              "The asynchronous ascii file " << f << " differs");
+    }
+
+    if (AsyncFileWriter::IsCompressionSupported(AsyncFileWriter::GZIP))
+    {
+        config.compression = AsyncFileWriter::GZIP;
+        std::string gzipFilename = CreateTempDirFilename("async.pcap.gz");
+        PcapFile gzipFile;
+        gzipFile.OpenAsync(gzipFilename, std::ios::out, config);
+        NS_TEST_ASSERT_MSG_EQ(gzipFile.Fail(), false, "OpenAsync (" << gzipFilename << ") fails");
+        WritePackets(gzipFile);
+        std::ifstream gzip(gzipFilename, std::ios::binary);
+        unsigned char magic[2] = {0, 0};
+        gzip.read(reinterpret_cast<char*>(magic), 2);
+        NS_TEST_EXPECT_MSG_EQ((magic[0] == 0x1f && magic[1] == 0x8b),
+                              true,
+                              "The compressed file is not a gzip file");
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1545,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,267 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncFileWriter");
+
+AsyncFileWriter::AsyncFileWriter(const std::string& filename,
+                                 std::ios::openmode mode,
+                                 const Config& config)
+    : m_config(config)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    NS_ASSERT_MSG(m_config.bufferSize > 0 && m_config.maxQueuedBuffers > 0,
+                  "Invalid buffer configuration");
+    bool append = (mode & std::ios::app) != 0;
+    switch (m_config.compression)
+    {
+    case NONE:
+        m_file.open(filename,
+                    std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+        m_open = m_file.is_open();
+        break;
+    case GZIP:
+#ifdef HAVE_ZLIB
+        m_gzFile = gzopen(filename.c_str(), append ? "ab" : "wb");
+        m_open = m_gzFile != nullptr;
+#else
+        NS_LOG_WARN("gzip compression is not supported by this build");
+#endif
+        break;
+    }
+    if (!m_open)
+    {
+        return;
+    }
+    m_current.data = std::make_unique<char[]>(m_config.bufferSize);
+    setp(m_current.data.get(), m_current.data.get() + m_config.bufferSize);
+    GetWriterThread();
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+AsyncFileWriter::IsOpen() const
+{
+    return m_open;
+}
+
+bool
+AsyncFileWriter::IsCompressionSupported(Compression compression)
+{
+#ifdef HAVE_ZLIB
+    return compression == NONE || compression == GZIP;
+#else
+    return compression == NONE;
+#endif
+}
+
+bool
+AsyncFileWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_open)
+    {
+        return !m_error;
+    }
+    Submit();
+    {
+        WriterThread& writerThread = GetWriterThread();
+        std::unique_lock<std::mutex> lock(writerThread.mutex);
+        m_written.wait(lock, [this]() { return m_nQueued == 0; });
+    }
+    m_open = false;
+    setp(nullptr, nullptr);
+    if (m_file.is_open())
+    {
+        m_file.close();
+        m_error = m_error || m_file.fail();
+    }
+#ifdef HAVE_ZLIB
+    if (m_gzFile != nullptr)
+    {
+        m_error = (gzclose(m_gzFile) != Z_OK) || m_error;
+        m_gzFile = nullptr;
+    }
+#endif
+    return !m_error;
+}
+
+void
+AsyncFileWriter::Submit()
+{
+    NS_LOG_FUNCTION(this);
+    m_current.size = pptr() - pbase();
+    if (m_current.size == 0)
+    {
+        return;
+    }
+    m_submitted += m_current.size;
+    Chunk next;
+    WriterThread& writerThread = GetWriterThread();
+    {
+        std::unique_lock<std::mutex> lock(writerThread.mutex);
+        m_written.wait(lock, [this]() { return m_nQueued < m_config.maxQueuedBuffers; });
+        writerThread.queue.emplace_back(this, std::move(m_current));
+        m_nQueued++;
+        if (!m_free.empty())
+        {
+            next = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    writerThread.queued.notify_one();
+    if (!next.data)
+    {
+        next.data = std::make_unique<char[]>(m_config.bufferSize);
+    }
+    m_current = std::move(next);
+    setp(m_current.data.get(), m_current.data.get() + m_config.bufferSize);
+}
+
+bool
+AsyncFileWriter::WriteChunk(const Chunk& chunk)
+{
+#ifdef HAVE_ZLIB
+    if (m_gzFile != nullptr)
+    {
+        return gzwrite(m_gzFile, chunk.data.get(), chunk.size) == static_cast<int>(chunk.size);
+    }
+#endif
+    m_file.write(chunk.data.get(), chunk.size);
+    return m_file.good();
+}
+
+AsyncFileWriter::WriterThread&
+AsyncFileWriter::GetWriterThread()
+{
+    // The writer thread runs until the end of the program: it is detached,
+    // and its state is never destroyed, so that it does not have to be
+    // stopped before the static objects are destroyed.
+    static WriterThread* writerThread = []() {
+        auto thread = new WriterThread;
+        std::thread(&WriterThread::Run, thread).detach();
+        return thread;
+    }();
+    return *writerThread;
+}
+
+void
+AsyncFileWriter::WriterThread::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        queued.wait(lock, [this]() { return !queue.empty(); });
+        auto [writer, chunk] = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        if (!writer->m_error && !writer->WriteChunk(chunk))
+        {
+            writer->m_error = true;
+        }
+        lock.lock();
+        writer->m_free.push_back(std::move(chunk));
+        writer->m_nQueued--;
+        // notified with the lock held, since the writer may be destroyed
+        // as soon as it is released
+        writer->m_written.notify_one();
+    }
+}
+
+AsyncFileWriter::int_type
+AsyncFileWriter::overflow(int_type c)
+{
+    if (!m_open || m_error)
+    {
+        return traits_type::eof();
+    }
+    Submit();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+AsyncFileWriter::xsputn(const char_type* s, std::streamsize n)
+{
+    if (!m_open || m_error)
+    {
+        return 0;
+    }
+    std::streamsize written = 0;
+    while (written < n)
+    {
+        if (pptr() == epptr())
+        {
+            Submit();
+        }
+        std::streamsize count = std::min<std::streamsize>(n - written, epptr() - pptr());
+        std::memcpy(pptr(), s + written, count);
+        // pbump takes an int: the buffers are smaller than 4 GiB
+        pbump(static_cast<int>(count));
+        written += count;
+    }
+    return written;
+}
+
+int
+AsyncFileWriter::sync()
+{
+    // write-behind: the data are written when the buffers are full
+    return m_error ? -1 : 0;
+}
+
+AsyncFileWriter::pos_type
+AsyncFileWriter::seekoff(off_type off, std::ios::seekdir dir, std::ios::openmode which)
+{
+    // only the current position can be queried
+    auto current = static_cast<off_type>(m_submitted + (pptr() - pbase()));
+    if ((which & std::ios::out) == 0 || (dir == std::ios::cur && off != 0) ||
+        (dir == std::ios::beg && off != current) || dir == std::ios::end)
+    {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(current);
+}
+
+AsyncFileWriter::pos_type
+AsyncFileWriter::seekpos(pos_type pos, std::ios::openmode which)
+{
+    return seekoff(off_type(pos), std::ios::beg, which);
+}
+
+} // namespace ns3
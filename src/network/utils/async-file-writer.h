@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// zlib file handle
+struct gzFile_s;
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief A write-behind stream buffer, which writes a file on a background
+ * thread.
+ *
+ * The data written to the stream are accumulated in buffers. Each full
+ * buffer is queued to a writer thread, which writes it to the file,
+ * optionally compressed, while the stream fills the next buffer. A single
+ * writer thread, started by the first stream buffer, serves all the files
+ * in the order their buffers were queued. The number of buffers queued by
+ * each file is bounded: the stream waits for the writer thread when its
+ * queue is full, which bounds the memory used by a slow disk.
+ *
+ * Flushing the stream does not write its data, so that the trace sinks
+ * which end each line with std::endl keep the benefit of the buffers:
+ * the file is complete once the stream buffer is closed or destroyed.
+ * The stream is write-only, and can only seek to its current position.
+ */
+class AsyncFileWriter : public std::streambuf
+{
+  public:
+    /// Compression of the file
+    enum Compression
+    {
+        NONE, //!< Uncompressed file
+        GZIP, //!< gzip file, written with zlib
+    };
+
+    /// Configuration of the writer
+    struct Config
+    {
+        uint32_t bufferSize{1 << 16};  //!< Size of each buffer, in bytes
+        uint32_t maxQueuedBuffers{4};  //!< Maximum number of buffers queued
+        Compression compression{NONE}; //!< Compression of the file
+    };
+
+    /**
+     * Open a file, and start the writer thread if not done yet.
+     *
+     * \param filename The name of the file.
+     * \param mode The access mode for the file: std::ios::app appends to
+     * an existing file, which is truncated otherwise.
+     * \param config The configuration of the writer.
+     */
+    AsyncFileWriter(const std::string& filename, std::ios::openmode mode, const Config& config);
+
+    /** Close the file. */
+    ~AsyncFileWriter() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * \return true if the file is open.
+     */
+    bool IsOpen() const;
+
+    /**
+     * Write the buffered data, wait for the writer thread to write them and
+     * close the file.
+     *
+     * \return true if all the data were written successfully.
+     */
+    bool Close();
+
+    /**
+     * \param compression A compression.
+     * \return true if the compression is available in this build.
+     */
+    static bool IsCompressionSupported(Compression compression);
+
+  protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char_type* s, std::streamsize n) override;
+    int sync() override;
+    pos_type seekoff(off_type off, std::ios::seekdir dir, std::ios::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios::openmode which) override;
+
+  private:
+    /// A buffer of data
+    struct Chunk
+    {
+        std::unique_ptr<char[]> data; //!< The data
+        std::size_t size{0};          //!< The number of bytes of data
+    };
+
+    /// The writer thread shared by all the files
+    struct WriterThread
+    {
+        std::mutex mutex;                //!< Protects the queue and the state of the writers
+        std::condition_variable queued;  //!< Signaled when a buffer is queued
+        std::deque<std::pair<AsyncFileWriter*, Chunk>> queue; //!< The buffers to write
+
+        /** Write the queued buffers, forever. */
+        void Run();
+    };
+
+    /**
+     * \return the writer thread, which is started by the first call
+     */
+    static WriterThread& GetWriterThread();
+
+    /**
+     * Queue the current buffer to the writer thread, waiting for room in
+     * the queue, and start a new buffer.
+     */
+    void Submit();
+
+    /**
+     * \param chunk A buffer to write.
+     * \return true if the buffer was written successfully.
+     */
+    bool WriteChunk(const Chunk& chunk);
+
+    Config m_config;                   //!< The configuration
+    std::ofstream m_file;              //!< The uncompressed file
+    gzFile_s* m_gzFile{nullptr};       //!< The compressed file
+    bool m_open{false};                //!< Whether the file is open
+    Chunk m_current;                   //!< The buffer being filled
+    uint64_t m_submitted{0};           //!< Number of bytes queued to the writer thread
+    uint32_t m_nQueued{0};             //!< Number of buffers queued to the writer thread
+    std::vector<Chunk> m_free;         //!< The buffers written, to be reused
+    std::atomic<bool> m_error{false};  //!< Whether a write failed
+    std::condition_variable m_written; //!< Signaled when a buffer of this file is written
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
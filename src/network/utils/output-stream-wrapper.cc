@@ -41,6 +41,20 @@ OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmod
                             << "Unable to Open " << filename << " for mode " << filemode);
 }
 
+OutputStreamWrapper::OutputStreamWrapper(std::string filename,
+                                         std::ios::openmode filemode,
+                                         const AsyncFileWriter::Config& config)
+    : m_destroyable(true),
+      m_asyncBuf(std::make_unique<AsyncFileWriter>(filename, filemode, config))
+{
+    NS_LOG_FUNCTION(this << filename << filemode);
+    m_ostream = new std::ostream(m_asyncBuf.get());
+    FatalImpl::RegisterStream(m_ostream);
+    NS_ABORT_MSG_UNLESS(m_asyncBuf->IsOpen(),
+                        "AsciiTraceHelper::CreateFileStream():  "
+                            << "Unable to Open " << filename << " for mode " << filemode);
+}
+
 OutputStreamWrapper::OutputStreamWrapper(std::ostream* os)
     : m_ostream(os),
       m_destroyable(false)
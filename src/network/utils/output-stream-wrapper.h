@@ -18,11 +18,14 @@
 #ifndef OUTPUT_STREAM_WRAPPER_H
 #define OUTPUT_STREAM_WRAPPER_H
 
+#include "async-file-writer.h"
+
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 
 #include <fstream>
+#include <memory>
 
 namespace ns3
 {
@@ -77,6 +80,18 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
      * \param filemode std::ios::openmode flags
      */
     OutputStreamWrapper(std::string filename, std::ios::openmode filemode);
+    /**
+     * Constructor of a stream written on a background thread through large
+     * write-behind buffers: the file is complete once the wrapper is
+     * destroyed.
+     *
+     * \param filename file name
+     * \param filemode std::ios::openmode flags
+     * \param config the configuration of the writer
+     */
+    OutputStreamWrapper(std::string filename,
+                        std::ios::openmode filemode,
+                        const AsyncFileWriter::Config& config);
     /**
      * Constructor
      * \param os output stream
@@ -94,8 +109,9 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
     std::ostream* GetStream();
 
   private:
-    std::ostream* m_ostream; //!< The output stream
-    bool m_destroyable;      //!< Can be destroyed
+    std::ostream* m_ostream;                     //!< The output stream
+    bool m_destroyable;                          //!< Can be destroyed
+    std::unique_ptr<AsyncFileWriter> m_asyncBuf; //!< The write-behind buffer of the stream, if any
 };
 
 } // namespace ns3
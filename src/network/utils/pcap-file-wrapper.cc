@@ -98,6 +98,15 @@ PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
     m_file.Open(filename, mode);
 }
 
+void
+PcapFileWrapper::OpenAsync(const std::string& filename,
+                           std::ios::openmode mode,
+                           const AsyncFileWriter::Config& config)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    m_file.OpenAsync(filename, mode, config);
+}
+
 void
 PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -78,6 +78,22 @@ class PcapFileWrapper : public Object
      */
     void Open(const std::string& filename, std::ios::openmode mode);
 
+    /**
+     * Create a new pcap file, written on a background thread through large
+     * write-behind buffers.
+     *
+     * \param filename String containing the name of the file.
+     *
+     * \param mode String containing the access mode for the file.
+     *
+     * \param config The configuration of the writer.
+     *
+     * \see PcapFile::OpenAsync
+     */
+    void OpenAsync(const std::string& filename,
+                   std::ios::openmode mode,
+                   const AsyncFileWriter::Config& config);
+
     /**
      * Close the underlying pcap file.
      */
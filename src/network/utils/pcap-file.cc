@@ -52,7 +52,8 @@ const uint16_t VERSION_MAJOR = 2; /**< Major version of supported pcap file form
 const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file format */
 
 PcapFile::PcapFile()
-    : m_file(),
+    : m_fileBuf(),
+      m_file(&m_fileBuf),
       m_swapMode(false),
       m_nanosecMode(false)
 {
@@ -92,7 +93,23 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
-    m_file.close();
+    if (m_asyncBuf)
+    {
+        bool written = m_asyncBuf->Close();
+        std::ios::iostate state = m_file.rdstate();
+        m_file.rdbuf(&m_fileBuf);
+        m_file.setstate(state);
+        m_asyncBuf.reset();
+        if (!written)
+        {
+            m_file.setstate(std::ios::failbit);
+        }
+        return;
+    }
+    if (!m_fileBuf.close())
+    {
+        m_file.setstate(std::ios::failbit);
+    }
 }
 
 uint32_t
@@ -323,7 +340,7 @@ PcapFile::ReadAndVerifyFileHeader()
 
     if (m_file.fail())
     {
-        m_file.close();
+        m_fileBuf.close();
     }
 }
 
@@ -339,7 +356,14 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     mode |= std::ios::binary;
 
     m_filename = filename;
-    m_file.open(filename, mode);
+    if (m_fileBuf.open(filename, mode))
+    {
+        m_file.clear();
+    }
+    else
+    {
+        m_file.setstate(std::ios::failbit);
+    }
     if (mode & std::ios::in)
     {
         // will set the fail bit if file header is invalid.
@@ -347,6 +371,27 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::OpenAsync(const std::string& filename,
+                    std::ios::openmode mode,
+                    const AsyncFileWriter::Config& config)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    NS_ASSERT((mode & (std::ios::in | std::ios::app)) == 0);
+    NS_ASSERT(!m_file.fail());
+
+    m_filename = filename;
+    auto buf = std::make_unique<AsyncFileWriter>(filename, mode, config);
+    if (!buf->IsOpen())
+    {
+        m_file.setstate(std::ios::failbit);
+        return;
+    }
+    m_asyncBuf = std::move(buf);
+    // also clears the state of the stream
+    m_file.rdbuf(m_asyncBuf.get());
+}
+
 void
 PcapFile::Init(uint32_t dataLinkType,
                uint32_t snapLen,
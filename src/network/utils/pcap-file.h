@@ -20,9 +20,13 @@
 #ifndef PCAP_FILE_H
 #define PCAP_FILE_H
 
+#include "async-file-writer.h"
+
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <iostream>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -81,6 +85,21 @@ class PcapFile
      */
     void Open(const std::string& filename, std::ios::openmode mode);
 
+    /**
+     * Create a new pcap file, written on a background thread through large
+     * write-behind buffers (see AsyncFileWriter). The file is complete once
+     * it is closed.
+     *
+     * \param filename String containing the name of the file.
+     *
+     * \param mode the access mode for the file, which must be a write mode.
+     *
+     * \param config The configuration of the writer.
+     */
+    void OpenAsync(const std::string& filename,
+                   std::ios::openmode mode,
+                   const AsyncFileWriter::Config& config);
+
     /**
      * Close the underlying file.
      */
@@ -373,11 +392,13 @@ class PcapFile
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    std::string m_filename;                      //!< file name
+    std::filebuf m_fileBuf;                      //!< file buffer
+    std::unique_ptr<AsyncFileWriter> m_asyncBuf; //!< write-behind buffer, if opened with OpenAsync
+    std::iostream m_file;                        //!< file stream, on one of the buffers
+    PcapFileHeader m_fileHeader;                 //!< file header
+    bool m_swapMode;                             //!< swap mode
+    bool m_nanosecMode;                          //!< nanosecond timestamp mode
 };
 
 } // namespace ns3
@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "segmentation-offload-tag.h"
+
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <algorithm>
+
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SegmentationOffloadTag");
+
+NS_OBJECT_ENSURE_REGISTERED(SegmentationOffloadTag);
+
+/**
+ * Whether a super-segment was tagged: until then, the packets are not
+ * searched for the tag, so that the simulations which do not offload the
+ * segmentation do not pay for it.
+ */
+#ifdef NS3_MTP
+static std::atomic<bool> g_segmentationOffloadUsed{false};
+#else
+static bool g_segmentationOffloadUsed = false;
+#endif
+
+TypeId
+SegmentationOffloadTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SegmentationOffloadTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<SegmentationOffloadTag>();
+    return tid;
+}
+
+TypeId
+SegmentationOffloadTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SegmentationOffloadTag::GetSerializedSize() const
+{
+    return 8;
+}
+
+void
+SegmentationOffloadTag::Serialize(TagBuffer buf) const
+{
+    buf.WriteU32(m_payloadSize);
+    buf.WriteU32(m_segmentSize);
+}
+
+void
+SegmentationOffloadTag::Deserialize(TagBuffer buf)
+{
+    m_payloadSize = buf.ReadU32();
+    m_segmentSize = buf.ReadU32();
+}
+
+void
+SegmentationOffloadTag::Print(std::ostream& os) const
+{
+    os << "PayloadSize=" << m_payloadSize << " SegmentSize=" << m_segmentSize;
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag()
+    : Tag(),
+      m_payloadSize(0),
+      m_segmentSize(1)
+{
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag(uint32_t payloadSize, uint32_t segmentSize)
+    : Tag(),
+      m_payloadSize(payloadSize),
+      m_segmentSize(segmentSize)
+{
+    NS_LOG_FUNCTION(this << payloadSize << segmentSize);
+    NS_ASSERT_MSG(segmentSize > 0, "The segments cannot be empty");
+    g_segmentationOffloadUsed = true;
+}
+
+uint32_t
+SegmentationOffloadTag::GetPayloadSize() const
+{
+    return m_payloadSize;
+}
+
+uint32_t
+SegmentationOffloadTag::GetSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+uint32_t
+SegmentationOffloadTag::GetSegments() const
+{
+    return std::max<uint32_t>((m_payloadSize + m_segmentSize - 1) / m_segmentSize, 1);
+}
+
+uint32_t
+SegmentationOffloadTag::GetSegments(Ptr<const Packet> packet)
+{
+    SegmentationOffloadTag tag;
+    if (!g_segmentationOffloadUsed || !packet->PeekPacketTag(tag))
+    {
+        return 1;
+    }
+    return tag.GetSegments();
+}
+
+uint32_t
+SegmentationOffloadTag::GetMaxSegmentSize(Ptr<const Packet> packet)
+{
+    SegmentationOffloadTag tag;
+    if (!g_segmentationOffloadUsed || !packet->PeekPacketTag(tag) ||
+        tag.m_payloadSize > packet->GetSize())
+    {
+        return packet->GetSize();
+    }
+    uint32_t headerSize = packet->GetSize() - tag.m_payloadSize;
+    return headerSize + std::min(tag.m_payloadSize, tag.m_segmentSize);
+}
+
+uint32_t
+SegmentationOffloadTag::GetWireSize(Ptr<const Packet> packet)
+{
+    SegmentationOffloadTag tag;
+    if (!g_segmentationOffloadUsed || !packet->PeekPacketTag(tag) ||
+        tag.m_payloadSize > packet->GetSize())
+    {
+        return packet->GetSize();
+    }
+    uint32_t headerSize = packet->GetSize() - tag.m_payloadSize;
+    return packet->GetSize() + (tag.GetSegments() - 1) * headerSize;
+}
+
+} // namespace ns3
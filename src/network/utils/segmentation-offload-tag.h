@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENTATION_OFFLOAD_TAG_H
+#define SEGMENTATION_OFFLOAD_TAG_H
+
+#include "ns3/ptr.h"
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief Packet tag of the super-segments of a segmentation offload.
+ *
+ * A transport protocol which offloads its segmentation sends the payload of
+ * several segments in a single packet, with a single set of headers, tagged
+ * with the size of the payload and the size of the segments it stands for.
+ * The packet is forwarded as a whole, and the devices which model the
+ * offload transmit it in the time of the individual segments: each segment
+ * carries a copy of the headers that the packet holds when it is
+ * transmitted, hence the static methods of this class which return the size
+ * of the individual segments and their total size on the wire. These methods
+ * only search the packets for the tag once a super-segment was tagged, so
+ * that the simulations which do not offload the segmentation do not pay for
+ * it.
+ *
+ * A super-segment is a single packet for the queues and the queue discs: a
+ * queue limited in packets holds as many super-segments as its limit, hence
+ * more data than it would hold in segments, while a queue limited in bytes
+ * counts the whole payload of the super-segments.
+ */
+class SegmentationOffloadTag : public Tag
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer buf) const override;
+    void Deserialize(TagBuffer buf) override;
+    void Print(std::ostream& os) const override;
+    SegmentationOffloadTag();
+
+    /**
+     * Constructs a SegmentationOffloadTag
+     *
+     * \param payloadSize the size of the payload of the segments
+     * \param segmentSize the maximum size of the payload of a segment
+     */
+    SegmentationOffloadTag(uint32_t payloadSize, uint32_t segmentSize);
+
+    /**
+     * \returns the size of the payload of the segments
+     */
+    uint32_t GetPayloadSize() const;
+    /**
+     * \returns the maximum size of the payload of a segment
+     */
+    uint32_t GetSegmentSize() const;
+    /**
+     * \returns the number of segments
+     */
+    uint32_t GetSegments() const;
+
+    /**
+     * \param packet a packet
+     * \returns the number of segments of the packet, or 1 if it is not tagged
+     */
+    static uint32_t GetSegments(Ptr<const Packet> packet);
+    /**
+     * \param packet a packet
+     * \returns the size of the largest segment of the packet, headers
+     * included, or the size of the packet if it is not tagged
+     */
+    static uint32_t GetMaxSegmentSize(Ptr<const Packet> packet);
+    /**
+     * \param packet a packet
+     * \returns the total size of the segments of the packet, each with its
+     * headers, or the size of the packet if it is not tagged
+     */
+    static uint32_t GetWireSize(Ptr<const Packet> packet);
+
+  private:
+    uint32_t m_payloadSize; //!< Size of the payload of the segments
+    uint32_t m_segmentSize; //!< Maximum size of the payload of a segment
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_TAG_H */
@@ -18,6 +18,7 @@
  */
 #include "simple-net-device.h"
 
+#include "segmentation-offload-tag.h"
 #include "simple-channel.h"
 
 #include "ns3/boolean.h"
@@ -433,7 +434,8 @@ SimpleNetDevice::SendFrom(Ptr<Packet> p,
                           uint16_t protocolNumber)
 {
     NS_LOG_FUNCTION(this << p << source << dest << protocolNumber);
-    if (p->GetSize() > GetMtu())
+    // The super-segments of a segmentation offload are sent whole
+    if (SegmentationOffloadTag::GetMaxSegmentSize(p) > GetMtu())
     {
         return false;
     }
@@ -485,7 +487,7 @@ SimpleNetDevice::StartTransmission()
     Time txTime = Time(0);
     if (m_bps > DataRate(0))
     {
-        txTime = m_bps.CalculateBytesTxTime(packet->GetSize());
+        txTime = m_bps.CalculateBytesTxTime(SegmentationOffloadTag::GetWireSize(packet));
     }
     FinishTransmissionEvent =
         Simulator::Schedule(txTime, &SimpleNetDevice::FinishTransmission, this, packet);
@@ -25,13 +25,19 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <queue>
+#include <thread>
 
 namespace ns3
 {
@@ -41,6 +47,29 @@ NS_LOG_COMPONENT_DEFINE("NixVectorRouting");
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(NixVectorRouting, Ipv4RoutingProtocol);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(NixVectorRouting, Ipv6RoutingProtocol);
 
+/**
+ * \ingroup nix-vector-routing
+ * The number of threads building the nix-vectors of several nodes at once.
+ */
+static GlobalValue g_nixVectorRoutingThreads =
+    GlobalValue("NixVectorRoutingThreads",
+                "The number of threads building the nix-vectors of the nodes in "
+                "PrecomputeNixVectors and in the incremental update of the caches "
+                "(0 for one thread per hardware thread)",
+                UintegerValue(1),
+                MakeUintegerChecker<uint32_t>());
+
+/**
+ * \ingroup nix-vector-routing
+ * Whether the nix-vector caches are updated, rather than flushed, on topology changes.
+ */
+static GlobalValue g_nixVectorRoutingIncremental =
+    GlobalValue("NixVectorRoutingIncremental",
+                "Rebuild the cached nix-vectors whose destination is still reachable "
+                "when the topology changes, instead of flushing all the caches",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
 template <typename T>
 bool NixVectorRouting<T>::g_isCacheDirty = false;
 
@@ -55,6 +84,9 @@ template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap
     NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+typename NixVectorRouting<T>::Topology NixVectorRouting<T>::g_topology;
+
 template <typename T>
 TypeId
 NixVectorRouting<T>::GetTypeId()
@@ -169,6 +201,284 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
+    // Same for the snapshot of the topology.
+    g_topology = Topology();
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::UpdateGlobalNixRoutingCache() const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    g_ipAddressToNodeMap.clear();
+    BuildIpAddressToNodeMap();
+    BuildTopology();
+
+    std::vector<NixVectorRequest> requests;
+    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<NixVectorRouting<T>> rp = (*i)->GetObject<NixVectorRouting>();
+        if (!rp)
+        {
+            continue;
+        }
+        rp->FlushIpRouteCache();
+        rp->m_totalNeighbors = 0;
+        if (rp->m_nixCache.empty())
+        {
+            continue;
+        }
+
+        NixVectorRequest request;
+        request.routing = PeekPointer(rp);
+        request.source = (*i)->GetId();
+        for (const auto& entry : rp->m_nixCache)
+        {
+            auto iter = g_ipAddressToNodeMap.find(entry.first);
+            if (iter != g_ipAddressToNodeMap.end())
+            {
+                request.dests.emplace_back(entry.first, iter->second->GetId());
+            }
+        }
+        requests.push_back(std::move(request));
+    }
+    NS_LOG_LOGIC("Updating the Nix caches of " << requests.size() << " nodes.");
+    BuildNixVectors(requests);
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::PrecomputeNixVectors() const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    CheckCacheStateAndFlush();
+    if (g_ipAddressToNodeMap.empty())
+    {
+        BuildIpAddressToNodeMap();
+    }
+    if (g_topology.bfsOffsets.size() != NodeList::GetNNodes() + 1)
+    {
+        BuildTopology();
+    }
+
+    // Sort the addresses, so that the result does not depend on the hash map order.
+    std::vector<std::pair<IpAddress, uint32_t>> dests;
+    for (const auto& entry : g_ipAddressToNodeMap)
+    {
+        dests.emplace_back(entry.first, entry.second->GetId());
+    }
+    std::sort(dests.begin(), dests.end());
+
+    std::vector<NixVectorRequest> requests;
+    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<NixVectorRouting<T>> rp = (*i)->GetObject<NixVectorRouting>();
+        if (rp)
+        {
+            requests.push_back({PeekPointer(rp), (*i)->GetId(), dests, {}});
+        }
+    }
+    BuildNixVectors(requests);
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildNixVectors(std::vector<NixVectorRequest>& requests)
+{
+    NS_LOG_FUNCTION(requests.size());
+
+    UintegerValue threadsValue;
+    g_nixVectorRoutingThreads.GetValue(threadsValue);
+    uint32_t nThreads = threadsValue.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<std::size_t>(nThreads, requests.size());
+
+    //
+    // The threads only read the snapshot of the topology and the link state
+    // of the devices, and create new nix-vectors, which are private to their
+    // request: the reference counts may not be thread-safe, hence the caches
+    // are filled by this thread.
+    //
+    std::atomic<std::size_t> next(0);
+    auto run = [&requests, &next]() {
+        std::vector<uint32_t> parentVector;
+        std::vector<Ptr<NixVector>> nixVectors(g_topology.bfsOffsets.size());
+        for (std::size_t i = next++; i < requests.size(); i = next++)
+        {
+            NixVectorRequest& request = requests[i];
+            TopologyBFS(request.source, UINT32_MAX, parentVector);
+            for (const auto& dest : request.dests)
+            {
+                // The addresses of a node share its nix-vector.
+                Ptr<NixVector>& nixVector = nixVectors[dest.second];
+                if (!nixVector && dest.second != request.source)
+                {
+                    nixVector = BuildTopologyNixVector(parentVector, request.source, dest.second);
+                }
+                if (nixVector)
+                {
+                    request.nixVectors.emplace_back(dest.first, nixVector);
+                }
+            }
+            for (const auto& dest : request.dests)
+            {
+                nixVectors[dest.second] = nullptr;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(run);
+    }
+    run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto& request : requests)
+    {
+        NixMap_t& cache = request.routing->m_nixCache;
+        cache.clear();
+        cache.insert(request.nixVectors.begin(), request.nixVectors.end());
+        request.nixVectors.clear();
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildTopology() const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    uint32_t numberOfNodes = NodeList::GetNNodes();
+    g_topology = Topology();
+    g_topology.bfsOffsets.reserve(numberOfNodes + 1);
+    g_topology.nixOffsets.reserve(numberOfNodes + 1);
+
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        Ptr<Node> node = NodeList::GetNode(id);
+        Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol>();
+        g_topology.bfsOffsets.push_back(g_topology.bfsNeighbors.size());
+        g_topology.nixOffsets.push_back(g_topology.nixNeighbors.size());
+
+        for (uint32_t i = 0; i < node->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            NetDeviceContainer netDeviceContainer;
+            GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+
+            // The neighbor indexes of BuildNixVector skip the bridges
+            if (!localNetDevice->IsBridge())
+            {
+                for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End();
+                     iter++)
+                {
+                    g_topology.nixNeighbors.push_back((*iter)->GetNode()->GetId());
+                }
+            }
+
+            // The BFS only goes through the up interfaces, and checks the
+            // links when it runs, since they do not notify their changes
+            if (ip)
+            {
+                int32_t interfaceIndex = ip->GetInterfaceForDevice(localNetDevice);
+                if (interfaceIndex == -1 || !ip->IsUp(interfaceIndex))
+                {
+                    continue;
+                }
+            }
+            for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+            {
+                Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
+                if (remoteIpInterface && remoteIpInterface->IsUp())
+                {
+                    g_topology.bfsNeighbors.push_back((*iter)->GetNode()->GetId());
+                    g_topology.bfsDevices.push_back(localNetDevice);
+                }
+            }
+        }
+    }
+    g_topology.bfsOffsets.push_back(g_topology.bfsNeighbors.size());
+    g_topology.nixOffsets.push_back(g_topology.nixNeighbors.size());
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::TopologyBFS(uint32_t source,
+                                 uint32_t dest,
+                                 std::vector<uint32_t>& parentVector)
+{
+    // The snapshot has one more offset than the number of nodes
+    parentVector.assign(g_topology.bfsOffsets.size() - 1, UINT32_MAX);
+    std::queue<uint32_t> greyNodeList;
+    greyNodeList.push(source);
+    parentVector[source] = source;
+
+    while (!greyNodeList.empty())
+    {
+        uint32_t currNode = greyNodeList.front();
+        greyNodeList.pop();
+        if (currNode == dest)
+        {
+            return true;
+        }
+        for (uint32_t i = g_topology.bfsOffsets[currNode]; i < g_topology.bfsOffsets[currNode + 1];
+             i++)
+        {
+            uint32_t remoteNode = g_topology.bfsNeighbors[i];
+            if (parentVector[remoteNode] == UINT32_MAX && g_topology.bfsDevices[i]->IsLinkUp())
+            {
+                parentVector[remoteNode] = currNode;
+                greyNodeList.push(remoteNode);
+            }
+        }
+    }
+    return dest == UINT32_MAX;
+}
+
+template <typename T>
+Ptr<NixVector>
+NixVectorRouting<T>::BuildTopologyNixVector(const std::vector<uint32_t>& parentVector,
+                                            uint32_t source,
+                                            uint32_t dest)
+{
+    if (parentVector[dest] == UINT32_MAX)
+    {
+        return nullptr;
+    }
+
+    Ptr<NixVector> nixVector = Create<NixVector>();
+    nixVector->SetEpoch(g_epoch);
+    // add the neighbor indexes from the destination back to the source, as BuildNixVector
+    for (uint32_t node = dest; node != source; node = parentVector[node])
+    {
+        uint32_t parentNode = parentVector[node];
+        uint32_t begin = g_topology.nixOffsets[parentNode];
+        uint32_t end = g_topology.nixOffsets[parentNode + 1];
+        uint32_t destId = 0;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            if (g_topology.nixNeighbors[i] == node)
+            {
+                destId = i - begin;
+            }
+        }
+        nixVector->AddNeighborIndex(destId, nixVector->BitCount(end - begin));
+    }
+    return nixVector;
 }
 
 template <typename T>
@@ -218,6 +528,22 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
     {
         // otherwise proceed as normal
         // and build the nix vector
+        if (!oif)
+        {
+            // use the snapshot of the topology
+            if (g_topology.bfsOffsets.size() != NodeList::GetNNodes() + 1)
+            {
+                BuildTopology();
+            }
+            std::vector<uint32_t> parentVector;
+            if (TopologyBFS(source->GetId(), destNode->GetId(), parentVector))
+            {
+                return BuildTopologyNixVector(parentVector, source->GetId(), destNode->GetId());
+            }
+            NS_LOG_ERROR("No routing path exists");
+            return nullptr;
+        }
+
         std::vector<Ptr<Node>> parentVector;
 
         if (BFS(NodeList::GetNNodes(), source, destNode, parentVector, oif))
@@ -1432,9 +1758,18 @@ NixVectorRouting<T>::CheckCacheStateAndFlush() const
 {
     if (g_isCacheDirty)
     {
-        FlushGlobalNixRoutingCache();
-        g_epoch++;
         g_isCacheDirty = false;
+        g_epoch++;
+        BooleanValue incremental;
+        g_nixVectorRoutingIncremental.GetValue(incremental);
+        if (incremental.Get())
+        {
+            UpdateGlobalNixRoutingCache();
+        }
+        else
+        {
+            FlushGlobalNixRoutingCache();
+        }
     }
 }
 
@@ -1443,6 +1778,8 @@ template void NixVectorRouting<Ipv4RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv6RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv4RoutingProtocol>::FlushGlobalNixRoutingCache() const;
 template void NixVectorRouting<Ipv6RoutingProtocol>::FlushGlobalNixRoutingCache() const;
+template void NixVectorRouting<Ipv4RoutingProtocol>::PrecomputeNixVectors() const;
+template void NixVectorRouting<Ipv6RoutingProtocol>::PrecomputeNixVectors() const;
 template void NixVectorRouting<Ipv4RoutingProtocol>::PrintRoutingPath(
     Ptr<Node> source,
     IpAddress dest,
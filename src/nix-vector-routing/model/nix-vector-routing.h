@@ -43,6 +43,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 // NOLINTBEGIN(modernize-use-override)
 
@@ -127,6 +128,19 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void FlushGlobalNixRoutingCache() const;
 
+    /**
+     * @brief Build the nix-vectors from every node to all the addresses
+     * of the other reachable nodes, and store them in the caches
+     *
+     * The shortest path trees of the nodes are computed in parallel over
+     * a snapshot of the topology, with the number of threads set by the
+     * "NixVectorRoutingThreads" global value.  Since a nix-vector is stored
+     * for every pair of nodes, the memory grows with the square of the
+     * number of nodes.  Unless the "NixVectorRoutingIncremental" global
+     * value is set, the nix-vectors are dropped at the next topology change.
+     */
+    void PrecomputeNixVectors() const;
+
     /**
      * @brief Print the Routing Path according to Nix Routing
      * \param source Source node
@@ -475,6 +489,62 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void CheckCacheStateAndFlush() const;
 
+    /**
+     * Rebuild the snapshot of the topology and the nix-vectors of the
+     * caches after a topology change, dropping the ones whose destination
+     * is no longer reachable, and flush the IP route caches.
+     */
+    void UpdateGlobalNixRoutingCache() const;
+
+    /**
+     * Build the snapshot of the topology from the node list.
+     */
+    void BuildTopology() const;
+
+    /**
+     * Breadth-first search over the snapshot of the topology.  The
+     * neighbors are explored in the same order as in BFS().
+     *
+     * \param source Source node id
+     * \param dest Destination node id, or UINT32_MAX to explore all the nodes
+     * \param parentVector Parent of each node id on the shortest path tree,
+     *        UINT32_MAX for the nodes not reached
+     * \returns true if the destination has been reached
+     */
+    static bool TopologyBFS(uint32_t source, uint32_t dest, std::vector<uint32_t>& parentVector);
+
+    /**
+     * Build a nix-vector from a shortest path tree of the snapshot of the
+     * topology, with the same neighbor indexes as BuildNixVector().
+     *
+     * \param parentVector Parent vector returned by TopologyBFS()
+     * \param source Source node id
+     * \param dest Destination node id
+     * \returns The nix-vector, or nullptr if the destination is not reachable
+     */
+    static Ptr<NixVector> BuildTopologyNixVector(const std::vector<uint32_t>& parentVector,
+                                                 uint32_t source,
+                                                 uint32_t dest);
+
+    /// The nix-vectors to build from a source node.
+    struct NixVectorRequest
+    {
+        const NixVectorRouting* routing; //!< Routing protocol of the source node
+        uint32_t source;                 //!< Source node id
+        /// Destination addresses and node ids
+        std::vector<std::pair<IpAddress, uint32_t>> dests;
+        /// Nix-vectors of the reachable destination addresses
+        std::vector<std::pair<IpAddress, Ptr<NixVector>>> nixVectors;
+    };
+
+    /**
+     * Build the nix-vectors of several source nodes in parallel, then
+     * replace the nix-vector caches of the sources with them.
+     *
+     * \param requests The nix-vectors to build, one request per source
+     */
+    static void BuildNixVectors(std::vector<NixVectorRequest>& requests);
+
     /**
      * Build map from IP Address to Node for faster lookup.
      */
@@ -517,6 +587,27 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     typedef std::unordered_map<Ptr<NetDevice>, Ptr<IpInterface>> NetDeviceToIpInterfaceMap;
     static NetDeviceToIpInterfaceMap
         g_netdeviceToIpInterfaceMap; //!< NetDevice pointer to IpInterface pointer map
+
+    /**
+     * Snapshot of the adjacency of the nodes, indexed by node id, in
+     * compressed sparse row format: the neighbors of node \c i are the
+     * entries \c offsets[i] to \c offsets[i+1] of the neighbor vectors.
+     */
+    struct Topology
+    {
+        /// Offsets of the neighbors explored by the BFS
+        std::vector<uint32_t> bfsOffsets;
+        /// Neighbors reachable through the up interfaces, in BFS order
+        std::vector<uint32_t> bfsNeighbors;
+        /// Local device of each neighbor explored by the BFS, whose link has to be up
+        std::vector<Ptr<NetDevice>> bfsDevices;
+        /// Offsets of the neighbors in nix-vector index order
+        std::vector<uint32_t> nixOffsets;
+        /// Neighbors in nix-vector index order
+        std::vector<uint32_t> nixNeighbors;
+    };
+
+    static Topology g_topology; //!< Snapshot of the topology, rebuilt on topology changes
 };
 
 /**
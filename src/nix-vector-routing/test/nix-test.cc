@@ -17,6 +17,8 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -25,6 +27,7 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -32,6 +35,9 @@
 #include "ns3/test.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
 
 using namespace ns3;
 
@@ -393,6 +399,140 @@ NixVectorRoutingTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is a 4x4 grid of point-to-point links.
+ *
+ * Following are the tests in this test case:
+ * - Test that the nix-vectors precomputed by several threads give the
+ *   same routing paths as the ones built on demand.
+ * (Set down the interface of n5 on the n5-n6 channel, and isolate n15.)
+ * - Test that the nix-vectors updated incrementally give the same routing
+ *   paths as the ones built on demand after flushing the caches.
+ *
+ * \brief IPv4 Nix-Vector Routing Precomputation Test
+ */
+class NixVectorRoutingPrecomputeTest : public TestCase
+{
+  public:
+    NixVectorRoutingPrecomputeTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Print the routing paths between all the nodes.
+     * \param nodes The nodes.
+     * \return The routing paths.
+     */
+    static std::string PrintRoutingPaths(const NodeContainer& nodes);
+};
+
+NixVectorRoutingPrecomputeTest::NixVectorRoutingPrecomputeTest()
+    : TestCase("precomputed and incrementally updated nix-vectors test")
+{
+}
+
+std::string
+NixVectorRoutingPrecomputeTest::PrintRoutingPaths(const NodeContainer& nodes)
+{
+    std::ostringstream oss;
+    Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper>(&oss);
+    for (auto source = nodes.Begin(); source != nodes.End(); source++)
+    {
+        Ptr<Ipv4NixVectorRouting> routing = (*source)->GetObject<Ipv4NixVectorRouting>();
+        for (auto dest = nodes.Begin(); dest != nodes.End(); dest++)
+        {
+            Ptr<Ipv4> ipv4 = (*dest)->GetObject<Ipv4>();
+            // the interface 0 is the loopback
+            for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+            {
+                routing->PrintRoutingPath(*source,
+                                          ipv4->GetAddress(i, 0).GetLocal(),
+                                          stream,
+                                          Time::S);
+            }
+        }
+    }
+    return oss.str();
+}
+
+void
+NixVectorRoutingPrecomputeTest::DoRun()
+{
+    const uint32_t size = 4;
+    NodeContainer nodes;
+    nodes.Create(size * size);
+
+    Ipv4NixVectorHelper ipv4NixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(ipv4NixRouting);
+    stack.SetIpv6StackInstall(false);
+    stack.Install(nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address;
+    address.SetBase("10.0.0.0", "255.255.255.0");
+    NetDeviceContainer d5d6;
+    for (uint32_t i = 0; i < size * size; i++)
+    {
+        if (i % size < size - 1)
+        {
+            NetDeviceContainer devices =
+                devHelper.Install(NodeContainer(nodes.Get(i), nodes.Get(i + 1)));
+            address.Assign(devices);
+            address.NewNetwork();
+            if (i == 5)
+            {
+                d5d6 = devices;
+            }
+        }
+        if (i + size < size * size)
+        {
+            address.Assign(devHelper.Install(NodeContainer(nodes.Get(i), nodes.Get(i + size))));
+            address.NewNetwork();
+        }
+    }
+
+    std::string onDemand = PrintRoutingPaths(nodes);
+
+    GlobalValue::Bind("NixVectorRoutingThreads", UintegerValue(4));
+    Ptr<Ipv4NixVectorRouting> routing = nodes.Get(0)->GetObject<Ipv4NixVectorRouting>();
+    routing->PrecomputeNixVectors();
+    std::ostringstream cache;
+    Ptr<Ipv4RoutingProtocol> protocol = routing;
+    protocol->PrintRoutingTable(Create<OutputStreamWrapper>(&cache));
+    NS_TEST_EXPECT_MSG_NE(cache.str().find("10.0.23.2"),
+                          std::string::npos,
+                          "The nix-vector to node 15 should have been precomputed.");
+    NS_TEST_EXPECT_MSG_EQ(PrintRoutingPaths(nodes),
+                          onDemand,
+                          "The precomputed nix-vectors should give the same routing paths.");
+
+    GlobalValue::Bind("NixVectorRoutingIncremental", BooleanValue(true));
+    Ptr<Ipv4> ipv4 = nodes.Get(5)->GetObject<Ipv4>();
+    ipv4->SetDown(ipv4->GetInterfaceForDevice(d5d6.Get(0)));
+    ipv4 = nodes.Get(size * size - 1)->GetObject<Ipv4>();
+    for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+    {
+        ipv4->SetDown(i);
+    }
+    std::string incremental = PrintRoutingPaths(nodes);
+
+    routing->FlushGlobalNixRoutingCache();
+    onDemand = PrintRoutingPaths(nodes);
+    NS_TEST_EXPECT_MSG_EQ(incremental,
+                          onDemand,
+                          "The updated nix-vectors should give the same routing paths.");
+
+    GlobalValue::Bind("NixVectorRoutingThreads", UintegerValue(1));
+    GlobalValue::Bind("NixVectorRoutingIncremental", BooleanValue(false));
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -406,6 +546,7 @@ class NixVectorRoutingTestSuite : public TestSuite
         : TestSuite("nix-vector-routing", UNIT)
     {
         AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingPrecomputeTest(), TestCase::QUICK);
     }
 };
 
@@ -26,10 +26,14 @@
 #include "ns3/mac48-address.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <utility>
+#include <vector>
+
 namespace ns3
 {
 
@@ -71,6 +75,16 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("MaxBurstSize",
+                          "The maximum number of packets of the transmit queue whose "
+                          "transmission is started at once, back to back, with a single "
+                          "transmission complete event. Bursts are only used when the "
+                          "PhyTxBegin, PhyTxEnd, Sniffer and PromiscSniffer trace sources "
+                          "are not connected, since these report the start and end of the "
+                          "transmission of each packet.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&PointToPointNetDevice::m_maxBurstSize),
+                          MakeUintegerChecker<uint32_t>(1))
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -249,9 +263,28 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
 
-    Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
+    Time txTime = GetTxTime(p);
     Time txCompleteTime = txTime + m_tInterframeGap;
 
+    //
+    // If nothing traces the start and end of the transmission of each packet,
+    // the next packets of the queue are transmitted back to back in the same
+    // burst: we only need the time at which each of them is completely
+    // transmitted, and a single event at the end of the burst.
+    //
+    std::vector<std::pair<Ptr<Packet>, Time>> burst;
+    if (m_maxBurstSize > 1 && m_phyTxBeginTrace.IsEmpty() && m_phyTxEndTrace.IsEmpty() &&
+        m_snifferTrace.IsEmpty() && m_promiscSnifferTrace.IsEmpty())
+    {
+        Ptr<Packet> next;
+        while (burst.size() + 1 < m_maxBurstSize && (next = m_queue->Dequeue()))
+        {
+            Time txEndTime = txCompleteTime + GetTxTime(next);
+            burst.emplace_back(next, txEndTime);
+            txCompleteTime = txEndTime + m_tInterframeGap;
+        }
+    }
+
     NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
     Simulator::Schedule(txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
 
@@ -260,9 +293,28 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     {
         m_phyTxDropTrace(p);
     }
+    for (const auto& [packet, txEndTime] : burst)
+    {
+        NS_LOG_LOGIC("UID " << packet->GetUid() << " in the burst");
+        m_currentPkt = packet;
+        if (!m_channel->TransmitStart(packet, this, txEndTime))
+        {
+            m_phyTxDropTrace(packet);
+        }
+    }
     return result;
 }
 
+Time
+PointToPointNetDevice::GetTxTime(Ptr<const Packet> p) const
+{
+    // The segments of a super-segment are transmitted back to back, each
+    // with its own headers
+    uint32_t segments = SegmentationOffloadTag::GetSegments(p);
+    return m_bps.CalculateBytesTxTime(SegmentationOffloadTag::GetWireSize(p)) +
+           m_tInterframeGap * (segments - 1);
+}
+
 void
 PointToPointNetDevice::TransmitComplete()
 {
@@ -516,6 +568,62 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     NS_LOG_LOGIC("p=" << packet << ", dest=" << &dest);
     NS_LOG_LOGIC("UID is " << packet->GetUid());
 
+    if (!Enqueue(packet, protocolNumber))
+    {
+        return false;
+    }
+
+    //
+    // If the channel is ready for transition we send the packet right now
+    //
+    if (m_txMachineState == READY)
+    {
+        packet = m_queue->Dequeue();
+        m_snifferTrace(packet);
+        m_promiscSnifferTrace(packet);
+        bool ret = TransmitStart(packet);
+        return ret;
+    }
+    return true;
+}
+
+bool
+PointToPointNetDevice::SendMore(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << dest << protocolNumber);
+
+    //
+    // Without bursts, there is no point in waiting for the next packets
+    //
+    if (m_maxBurstSize <= 1)
+    {
+        return Send(packet, dest, protocolNumber);
+    }
+    return Enqueue(packet, protocolNumber);
+}
+
+void
+PointToPointNetDevice::EndBurst()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_txMachineState == READY)
+    {
+        Ptr<Packet> packet = m_queue->Dequeue();
+        if (packet)
+        {
+            m_snifferTrace(packet);
+            m_promiscSnifferTrace(packet);
+            TransmitStart(packet);
+        }
+    }
+}
+
+bool
+PointToPointNetDevice::Enqueue(Ptr<Packet> packet, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << protocolNumber);
+
     //
     // If IsLinkUp() is false it means there is no channel to send any packet
     // over so we just hit the drop trace on the packet and return an error.
@@ -539,17 +647,6 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     //
     if (m_queue->Enqueue(packet))
     {
-        //
-        // If the channel is ready for transition we send the packet right now
-        //
-        if (m_txMachineState == READY)
-        {
-            packet = m_queue->Dequeue();
-            m_snifferTrace(packet);
-            m_promiscSnifferTrace(packet);
-            bool ret = TransmitStart(packet);
-            return ret;
-        }
         return true;
     }
 
@@ -185,6 +185,8 @@ class PointToPointNetDevice : public NetDevice
                   const Address& source,
                   const Address& dest,
                   uint16_t protocolNumber) override;
+    bool SendMore(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) override;
+    void EndBurst() override;
 
     Ptr<Node> GetNode() const override;
     void SetNode(Ptr<Node> node) override;
@@ -236,6 +238,15 @@ class PointToPointNetDevice : public NetDevice
      */
     bool ProcessHeader(Ptr<Packet> p, uint16_t& param);
 
+    /**
+     * Add the headers to a packet and enqueue it in the transmit queue,
+     * hitting the drop trace if the link is down or the queue is full.
+     * \param packet the packet
+     * \param protocolNumber protocol number
+     * \return true if the packet was enqueued
+     */
+    bool Enqueue(Ptr<Packet> packet, uint16_t protocolNumber);
+
     /**
      * Start Sending a Packet Down the Wire.
      *
@@ -246,6 +257,11 @@ class PointToPointNetDevice : public NetDevice
      * started sending signals.  An event is scheduled for the time at which
      * the bits have been completely transmitted.
      *
+     * If the MaxBurstSize attribute allows it and no trace source needs the
+     * start and end of the transmission of each packet, the next packets of
+     * the queue are sent in the same burst, back to back, and the event is
+     * scheduled for the end of the burst.
+     *
      * \see PointToPointChannel::TransmitStart ()
      * \see TransmitComplete()
      * \param p a reference to the packet to send
@@ -253,6 +269,13 @@ class PointToPointNetDevice : public NetDevice
      */
     bool TransmitStart(Ptr<Packet> p);
 
+    /**
+     * \param p a packet
+     * \returns the time to transmit the packet, or all the segments of the
+     * packet if it is a super-segment of a segmentation offload
+     */
+    Time GetTxTime(Ptr<const Packet> p) const;
+
     /**
      * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
      *
@@ -294,6 +317,11 @@ class PointToPointNetDevice : public NetDevice
      */
     Time m_tInterframeGap;
 
+    /**
+     * The maximum number of packets whose transmission is started at once
+     */
+    uint32_t m_maxBurstSize;
+
     /**
      * The PointToPointChannel to which this PointToPointNetDevice has been
      * attached.
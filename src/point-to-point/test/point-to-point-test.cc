@@ -21,10 +21,13 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +142,185 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test of the bursts of PointToPointNetDevice
+ *
+ * It sends packets in a burst with and without the MaxBurstSize attribute,
+ * and checks that the packets are received at the same times with fewer
+ * events.
+ */
+class PointToPointBurstTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointBurstTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send packets between two devices
+     *
+     * \param maxBurstSize The MaxBurstSize attribute of the sender.
+     * \param [out] events The number of events of the simulation.
+     * \return The receive times of the packets.
+     */
+    std::vector<Time> SendPackets(uint32_t maxBurstSize, uint64_t& events);
+};
+
+PointToPointBurstTest::PointToPointBurstTest()
+    : TestCase("PointToPoint bursts")
+{
+}
+
+std::vector<Time>
+PointToPointBurstTest::SendPackets(uint32_t maxBurstSize, uint64_t& events)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(1)));
+    devA->SetAttribute("DataRate", DataRateValue(DataRate("1Mbps")));
+    devA->SetAttribute("InterframeGap", TimeValue(MicroSeconds(10)));
+    devA->SetAttribute("MaxBurstSize", UintegerValue(maxBurstSize));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    std::vector<Time> rxTimes;
+    devB->SetReceiveCallback(
+        [&rxTimes](Ptr<NetDevice>, Ptr<const Packet>, uint16_t, const Address&) {
+            rxTimes.push_back(Simulator::Now());
+            return true;
+        });
+    Simulator::Schedule(Seconds(1.0), [devA]() {
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            devA->SendMore(Create<Packet>(100 * (i + 1)), devA->GetBroadcast(), 0x800);
+        }
+        devA->EndBurst();
+    });
+    // a packet sent while the burst is being transmitted is queued
+    Simulator::Schedule(Seconds(1.001), [devA]() {
+        devA->Send(Create<Packet>(100), devA->GetBroadcast(), 0x800);
+    });
+
+    Simulator::Run();
+    events = Simulator::GetEventCount();
+    Simulator::Destroy();
+    return rxTimes;
+}
+
+void
+PointToPointBurstTest::DoRun()
+{
+    uint64_t events;
+    std::vector<Time> expected = SendPackets(1, events);
+    NS_TEST_ASSERT_MSG_EQ(expected.size(), 6, "Wrong number of packets received");
+    Time txEnd = Seconds(1.0);
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        // the PPP header adds 2 bytes
+        txEnd += DataRate("1Mbps").CalculateBytesTxTime(100 * (i + 1) + 2);
+        NS_TEST_EXPECT_MSG_EQ(expected[i], txEnd + MilliSeconds(1), "Wrong receive time");
+        txEnd += MicroSeconds(10);
+    }
+
+    for (uint32_t maxBurstSize : {2, 4, 10})
+    {
+        uint64_t burstEvents;
+        std::vector<Time> rxTimes = SendPackets(maxBurstSize, burstEvents);
+        NS_TEST_ASSERT_MSG_EQ(rxTimes.size(), expected.size(), "Wrong number of packets received");
+        for (std::size_t i = 0; i < rxTimes.size(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(rxTimes[i], expected[i], "Bursts changed the receive times");
+        }
+        NS_TEST_EXPECT_MSG_LT(burstEvents, events, "Bursts should need fewer events");
+    }
+}
+
+/**
+ * \brief Test of the segmentation offload of PointToPointNetDevice
+ *
+ * It sends a super-segment, and checks that it is received whole after the
+ * transmission time of its individual segments.
+ */
+class PointToPointOffloadTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointOffloadTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+};
+
+PointToPointOffloadTest::PointToPointOffloadTest()
+    : TestCase("PointToPoint segmentation offload")
+{
+}
+
+void
+PointToPointOffloadTest::DoRun()
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    devA->SetAttribute("DataRate", DataRateValue(DataRate("1Mbps")));
+    devA->SetAttribute("InterframeGap", TimeValue(MicroSeconds(10)));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    std::vector<std::pair<Time, uint32_t>> received;
+    devB->SetReceiveCallback(
+        [&received](Ptr<NetDevice>, Ptr<const Packet> p, uint16_t, const Address&) {
+            received.emplace_back(Simulator::Now(), p->GetSize());
+            return true;
+        });
+    // 40 bytes of headers and the payload of three segments, the last one short
+    Ptr<Packet> p = Create<Packet>(40 + 2500);
+    p->AddPacketTag(SegmentationOffloadTag(2500, 1000));
+    devA->Send(p, devA->GetBroadcast(), 0x800);
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(received.size(), 1, "The super-segment should be received whole");
+    NS_TEST_EXPECT_MSG_EQ(received[0].second, 40 + 2500, "Wrong size of the super-segment");
+    // each segment carries the 40 bytes of headers and the 2 bytes of the PPP
+    // header, and the segments are separated by the interframe gap
+    Time txTime = DataRate("1Mbps").CalculateBytesTxTime(3 * 42 + 2500) + MicroSeconds(20);
+    NS_TEST_EXPECT_MSG_EQ(received[0].first, txTime, "Wrong transmission time of the segments");
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +337,8 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::QUICK);
+    AddTestCase(new PointToPointBurstTest, TestCase::QUICK);
+    AddTestCase(new PointToPointOffloadTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
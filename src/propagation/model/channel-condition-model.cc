@@ -25,6 +25,7 @@
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 #include <cmath>
 
@@ -330,7 +331,15 @@ ThreeGppChannelConditionModel::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(
                               &ThreeGppChannelConditionModel::m_linkO2iConditionToAntennaHeight),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("MaxCacheBytes",
+                          "The memory limit, in bytes, of the cache of the channel conditions, "
+                          "beyond which the least recently used ones are evicted and computed "
+                          "again when needed (0 for no limit)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelConditionModel::SetMaxCacheBytes,
+                                               &ThreeGppChannelConditionModel::GetMaxCacheBytes),
+                          MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -352,10 +361,28 @@ ThreeGppChannelConditionModel::~ThreeGppChannelConditionModel()
 void
 ThreeGppChannelConditionModel::DoDispose()
 {
-    m_channelConditionMap.clear();
+    m_channelConditionCache.Clear();
     m_updatePeriod = Seconds(0.0);
 }
 
+void
+ThreeGppChannelConditionModel::SetMaxCacheBytes(uint64_t maxBytes)
+{
+    m_channelConditionCache.SetMaxBytes(maxBytes);
+}
+
+uint64_t
+ThreeGppChannelConditionModel::GetMaxCacheBytes() const
+{
+    return m_channelConditionCache.GetMaxBytes();
+}
+
+LruCacheStats
+ThreeGppChannelConditionModel::GetCacheStats() const
+{
+    return m_channelConditionCache.GetStats();
+}
+
 Ptr<ChannelCondition>
 ThreeGppChannelConditionModel::GetChannelCondition(Ptr<const MobilityModel> a,
                                                    Ptr<const MobilityModel> b) const
@@ -368,16 +395,16 @@ ThreeGppChannelConditionModel::GetChannelCondition(Ptr<const MobilityModel> a,
     bool notFound = false; // indicates if the channel condition is not present in the map
     bool update = false;   // indicates if the channel condition has to be updated
 
-    // look for the channel condition in m_channelConditionMap
-    auto mapItem = m_channelConditionMap.find(key);
-    if (mapItem != m_channelConditionMap.end())
+    // look for the channel condition in m_channelConditionCache
+    const Item* cacheItem = m_channelConditionCache.Find(key);
+    if (cacheItem != nullptr)
     {
-        NS_LOG_DEBUG("found the channel condition in the map");
-        cond = mapItem->second.m_condition;
+        NS_LOG_DEBUG("found the channel condition in the cache");
+        cond = cacheItem->m_condition;
 
         // check if it has to be updated
         if (!m_updatePeriod.IsZero() &&
-            Simulator::Now() - mapItem->second.m_generatedTime > m_updatePeriod)
+            Simulator::Now() - cacheItem->m_generatedTime > m_updatePeriod)
         {
             NS_LOG_DEBUG("it has to be updated");
             update = true;
@@ -394,12 +421,11 @@ ThreeGppChannelConditionModel::GetChannelCondition(Ptr<const MobilityModel> a,
     if (notFound || update)
     {
         cond = ComputeChannelCondition(a, b);
-        // store the channel condition in m_channelConditionMap, used as cache.
-        // For this reason you see a const_cast.
-        Item mapItem;
-        mapItem.m_condition = cond;
-        mapItem.m_generatedTime = Simulator::Now();
-        const_cast<ThreeGppChannelConditionModel*>(this)->m_channelConditionMap[key] = mapItem;
+        // store the channel condition in m_channelConditionCache
+        Item cacheItem;
+        cacheItem.m_condition = cond;
+        cacheItem.m_generatedTime = Simulator::Now();
+        m_channelConditionCache.Insert(key, cacheItem, sizeof(ChannelCondition));
     }
 
     return cond;
@@ -19,13 +19,12 @@
 #ifndef CHANNEL_CONDITION_MODEL_H
 #define CHANNEL_CONDITION_MODEL_H
 
+#include "ns3/lru-cache.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/vector.h"
 
-#include <unordered_map>
-
 namespace ns3
 {
 
@@ -483,6 +482,11 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
      */
     int64_t AssignStreams(int64_t stream) override;
 
+    /**
+     * \return the statistics of the cache of the channel conditions
+     */
+    LruCacheStats GetCacheStats() const;
+
   protected:
     void DoDispose() override;
 
@@ -556,7 +560,7 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
     static uint32_t GetKey(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
 
     /**
-     * Struct to store the channel condition in the m_channelConditionMap
+     * Struct to store the channel condition in the m_channelConditionCache
      */
     struct Item
     {
@@ -564,9 +568,19 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
         Time m_generatedTime;              //!< the time when the condition was generated
     };
 
-    std::unordered_map<uint32_t, Item>
-        m_channelConditionMap; //!< map to store the channel conditions
-    Time m_updatePeriod;       //!< the update period for the channel condition
+    /**
+     * Set the memory limit of the cache of the channel conditions
+     * \param maxBytes the memory limit, in bytes, or 0 for no limit
+     */
+    void SetMaxCacheBytes(uint64_t maxBytes);
+
+    /**
+     * \return the memory limit of the cache of the channel conditions, in bytes
+     */
+    uint64_t GetMaxCacheBytes() const;
+
+    mutable LruCache<uint32_t, Item> m_channelConditionCache; //!< cache of the channel conditions
+    Time m_updatePeriod; //!< the update period for the channel condition
 
     double m_o2iThreshold{
         0}; //!< the threshold for determining what is the ratio of channels with O2I
@@ -189,4 +189,10 @@ Cost231PropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+Cost231PropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 } // namespace ns3
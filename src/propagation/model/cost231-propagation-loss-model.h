@@ -132,6 +132,7 @@ class Cost231PropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     double m_BSAntennaHeight; //!< BS Antenna Height [m]
     double m_SSAntennaHeight; //!< SS Antenna Height [m]
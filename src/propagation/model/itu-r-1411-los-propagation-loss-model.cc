@@ -109,4 +109,10 @@ ItuR1411LosPropagationLossModel::DoAssignStreams(int64_t stream)
 {
     return 0;
 }
+
+bool
+ItuR1411LosPropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
 } // namespace ns3
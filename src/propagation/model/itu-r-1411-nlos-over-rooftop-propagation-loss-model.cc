@@ -240,4 +240,10 @@ ItuR1411NlosOverRooftopPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+ItuR1411NlosOverRooftopPropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 } // namespace ns3
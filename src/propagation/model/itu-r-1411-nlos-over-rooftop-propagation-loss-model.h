@@ -80,6 +80,7 @@ class ItuR1411NlosOverRooftopPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     double m_frequency;            //!< frequency in MHz
     double m_lambda;               //!< wavelength
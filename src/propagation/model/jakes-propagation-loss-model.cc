@@ -21,6 +21,7 @@
 
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -46,7 +47,16 @@ JakesPropagationLossModel::GetTypeId()
     static TypeId tid = TypeId("ns3::JakesPropagationLossModel")
                             .SetParent<PropagationLossModel>()
                             .SetGroupName("Propagation")
-                            .AddConstructor<JakesPropagationLossModel>();
+                            .AddConstructor<JakesPropagationLossModel>()
+                            .AddAttribute("MaxCacheBytes",
+                                          "The memory limit, in bytes, of the cache of the Jakes "
+                                          "processes of the links, beyond which the least "
+                                          "recently used ones are evicted (0 for no limit)",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &JakesPropagationLossModel::SetMaxCacheBytes,
+                                              &JakesPropagationLossModel::GetMaxCacheBytes),
+                                          MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -79,6 +89,24 @@ JakesPropagationLossModel::DoCalcRxPower(double txPowerDbm,
     return txPowerDbm + pathData->GetChannelGainDb();
 }
 
+void
+JakesPropagationLossModel::SetMaxCacheBytes(uint64_t maxBytes)
+{
+    m_propagationCache.SetMaxBytes(maxBytes);
+}
+
+uint64_t
+JakesPropagationLossModel::GetMaxCacheBytes() const
+{
+    return m_propagationCache.GetMaxBytes();
+}
+
+LruCacheStats
+JakesPropagationLossModel::GetCacheStats() const
+{
+    return m_propagationCache.GetStats();
+}
+
 Ptr<UniformRandomVariable>
 JakesPropagationLossModel::GetUniformRandomVariable() const
 {
@@ -47,6 +47,11 @@ class JakesPropagationLossModel : public PropagationLossModel
     JakesPropagationLossModel(const JakesPropagationLossModel&) = delete;
     JakesPropagationLossModel& operator=(const JakesPropagationLossModel&) = delete;
 
+    /**
+     * \return the statistics of the cache of the Jakes processes
+     */
+    LruCacheStats GetCacheStats() const;
+
   protected:
     void DoDispose() override;
 
@@ -65,6 +70,17 @@ class JakesPropagationLossModel : public PropagationLossModel
      */
     Ptr<UniformRandomVariable> GetUniformRandomVariable() const;
 
+    /**
+     * Set the memory limit of the cache of the Jakes processes
+     * \param maxBytes the memory limit, in bytes, or 0 for no limit
+     */
+    void SetMaxCacheBytes(uint64_t maxBytes);
+
+    /**
+     * \return the memory limit of the cache of the Jakes processes, in bytes
+     */
+    uint64_t GetMaxCacheBytes() const;
+
     Ptr<UniformRandomVariable> m_uniformVariable;              //!< random stream
     mutable PropagationCache<JakesProcess> m_propagationCache; //!< Propagation cache
 };
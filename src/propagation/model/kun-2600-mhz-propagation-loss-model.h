@@ -68,6 +68,7 @@ class Kun2600MhzPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 };
 
 } // namespace ns3
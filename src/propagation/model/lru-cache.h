@@ -0,0 +1,264 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include "ns3/callback.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * \ingroup propagation
+ * \brief The statistics of an LruCache
+ */
+struct LruCacheStats
+{
+    uint64_t hits{0};       //!< Number of lookups which found their entry
+    uint64_t misses{0};     //!< Number of lookups which did not find their entry
+    uint64_t evictions{0};  //!< Number of entries evicted to honor the memory limit
+    std::size_t entries{0}; //!< Number of entries in the cache
+    std::size_t bytes{0};   //!< Estimated memory used by the entries, in bytes
+
+    /**
+     * Add the statistics of another cache
+     * \param other the statistics of the other cache
+     * \return a reference to these statistics
+     */
+    LruCacheStats& operator+=(const LruCacheStats& other)
+    {
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        entries += other.entries;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+/**
+ * \ingroup propagation
+ * \brief A hash map whose memory use is bounded by evicting the least
+ * recently used entries
+ *
+ * The propagation and channel models keep a cache entry per pair of nodes,
+ * or of antennas, ever seen. The memory of these caches can be bounded with
+ * SetMaxBytes: each entry accounts for the memory its value owns, as
+ * estimated by the caller of Insert, plus the overhead of the cache, and the
+ * least recently looked up or inserted entries are evicted once the limit
+ * is exceeded. The most recently inserted entry is never evicted. An evicted
+ * entry is simply computed again, as a new realization, the next time it is
+ * needed.
+ *
+ * \tparam Key the key type
+ * \tparam Value the value type
+ * \tparam Hash the hash function of the keys
+ */
+template <class Key, class Value, class Hash = std::hash<Key>>
+class LruCache
+{
+  public:
+    /// An entry of the cache
+    struct Entry
+    {
+        Key key;           //!< The key
+        Value value;       //!< The value
+        std::size_t bytes; //!< The memory accounted for the entry, in bytes
+    };
+
+    /// Iterator over the entries, from the most to the least recently used
+    typedef typename std::list<Entry>::const_iterator Iterator;
+
+    /**
+     * Set the memory limit of the cache, evicting entries if needed
+     * \param maxBytes the memory limit, in bytes, or 0 for no limit
+     */
+    void SetMaxBytes(std::size_t maxBytes)
+    {
+        m_maxBytes = maxBytes;
+        Evict();
+    }
+
+    /**
+     * \return the memory limit of the cache, in bytes, or 0 for no limit
+     */
+    std::size_t GetMaxBytes() const
+    {
+        return m_maxBytes;
+    }
+
+    /**
+     * Set the callback invoked with the value of each evicted entry, e.g.,
+     * to dispose of it
+     * \param evicted the callback
+     */
+    void SetEvictionCallback(Callback<void, Value> evicted)
+    {
+        m_evicted = evicted;
+    }
+
+    /**
+     * Look up an entry, which becomes the most recently used one
+     * \param key the key
+     * \return a pointer to the value, or nullptr if there is no such entry
+     */
+    Value* Find(const Key& key)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end())
+        {
+            m_misses++;
+            return nullptr;
+        }
+        m_hits++;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return &it->second->value;
+    }
+
+    /**
+     * Look up an entry, without changing the order of the entries or the
+     * statistics
+     * \param key the key
+     * \return a pointer to the value, or nullptr if there is no such entry
+     */
+    const Value* Peek(const Key& key) const
+    {
+        auto it = m_index.find(key);
+        return it == m_index.end() ? nullptr : &it->second->value;
+    }
+
+    /**
+     * Insert or replace an entry, which becomes the most recently used one,
+     * and evict the least recently used entries if the memory limit is
+     * exceeded
+     * \param key the key
+     * \param value the value
+     * \param bytes the memory owned by the value, in bytes
+     */
+    void Insert(const Key& key, Value value, std::size_t bytes)
+    {
+        bytes += ENTRY_OVERHEAD;
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            m_bytes -= it->second->bytes;
+            it->second->value = std::move(value);
+            it->second->bytes = bytes;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+        }
+        else
+        {
+            m_entries.push_front({key, std::move(value), bytes});
+            m_index.emplace(key, m_entries.begin());
+        }
+        m_bytes += bytes;
+        Evict();
+    }
+
+    /**
+     * Remove all the entries, without invoking the eviction callback
+     */
+    void Clear()
+    {
+        m_entries.clear();
+        m_index.clear();
+        m_bytes = 0;
+    }
+
+    /**
+     * \return the number of entries
+     */
+    std::size_t GetSize() const
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * \return the statistics of the cache
+     */
+    LruCacheStats GetStats() const
+    {
+        LruCacheStats stats;
+        stats.hits = m_hits;
+        stats.misses = m_misses;
+        stats.evictions = m_evictions;
+        stats.entries = m_entries.size();
+        stats.bytes = m_bytes;
+        return stats;
+    }
+
+    /**
+     * \return an iterator to the most recently used entry
+     */
+    Iterator Begin() const
+    {
+        return m_entries.begin();
+    }
+
+    /**
+     * \return an iterator past the least recently used entry
+     */
+    Iterator End() const
+    {
+        return m_entries.end();
+    }
+
+  private:
+    /// Index of the entries by key
+    typedef std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> Index;
+
+    /// Estimated memory used by the cache for each entry, in bytes
+    static constexpr std::size_t ENTRY_OVERHEAD =
+        sizeof(Entry) + sizeof(typename Index::value_type) + 4 * sizeof(void*);
+
+    /**
+     * Evict the least recently used entries, but the most recently used one,
+     * until the memory limit is honored
+     */
+    void Evict()
+    {
+        while (m_maxBytes != 0 && m_bytes > m_maxBytes && m_entries.size() > 1)
+        {
+            Entry& entry = m_entries.back();
+            m_index.erase(entry.key);
+            m_bytes -= entry.bytes;
+            m_evictions++;
+            Value value = std::move(entry.value);
+            m_entries.pop_back();
+            if (!m_evicted.IsNull())
+            {
+                m_evicted(value);
+            }
+        }
+    }
+
+    std::list<Entry> m_entries;      //!< The entries, from the most to the least recently used
+    Index m_index;                   //!< The entries by key
+    std::size_t m_maxBytes{0};       //!< The memory limit, in bytes, or 0 for no limit
+    std::size_t m_bytes{0};          //!< The memory accounted for the entries, in bytes
+    uint64_t m_hits{0};              //!< Number of lookups which found their entry
+    uint64_t m_misses{0};            //!< Number of lookups which did not find their entry
+    uint64_t m_evictions{0};         //!< Number of evicted entries
+    Callback<void, Value> m_evicted; //!< Callback invoked with the evicted values
+};
+
+} // namespace ns3
+
+#endif /* LRU_CACHE_H */
@@ -168,4 +168,10 @@ OkumuraHataPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+OkumuraHataPropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 } // namespace ns3
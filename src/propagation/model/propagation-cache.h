@@ -19,10 +19,9 @@
 #ifndef PROPAGATION_CACHE_H_
 #define PROPAGATION_CACHE_H_
 
+#include "ns3/lru-cache.h"
 #include "ns3/mobility-model.h"
 
-#include <map>
-
 namespace ns3
 {
 /**
@@ -30,12 +29,19 @@ namespace ns3
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation
  * path loss calculations. Propagation path a-->b and b-->a is the same thing. Propagation path is
  * identified by a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are hashed, and the memory of the cache can be bounded with SetMaxBytes, in which
+ * case the objects of the least recently used paths are disposed of and evicted.
  */
 template <class T>
 class PropagationCache
 {
   public:
-    PropagationCache(){};
+    PropagationCache()
+    {
+        m_pathCache.SetEvictionCallback(MakeCallback(&PropagationCache::DisposePathData));
+    };
+
     ~PropagationCache(){};
 
     /**
@@ -48,12 +54,12 @@ class PropagationCache
     Ptr<T> GetPathData(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
     {
         PropagationPathIdentifier key = PropagationPathIdentifier(a, b, modelUid);
-        typename PathCache::iterator it = m_pathCache.find(key);
-        if (it == m_pathCache.end())
+        Ptr<T>* data = m_pathCache.Find(key);
+        if (data == nullptr)
         {
             return nullptr;
         }
-        return it->second;
+        return *data;
     };
 
     /**
@@ -62,15 +68,17 @@ class PropagationCache
      * \param a 1st node mobility model
      * \param b 2nd node mobility model
      * \param modelUid model UID
+     * \param bytes the memory owned by the model, in bytes
      */
     void AddPathData(Ptr<T> data,
                      Ptr<const MobilityModel> a,
                      Ptr<const MobilityModel> b,
-                     uint32_t modelUid)
+                     uint32_t modelUid,
+                     std::size_t bytes = sizeof(T))
     {
         PropagationPathIdentifier key = PropagationPathIdentifier(a, b, modelUid);
-        NS_ASSERT(m_pathCache.find(key) == m_pathCache.end());
-        m_pathCache.insert(std::make_pair(key, data));
+        NS_ASSERT(m_pathCache.Peek(key) == nullptr);
+        m_pathCache.Insert(key, data, bytes);
     };
 
     /**
@@ -78,11 +86,36 @@ class PropagationCache
      */
     void Cleanup()
     {
-        for (auto i : m_pathCache)
+        for (auto i = m_pathCache.Begin(); i != m_pathCache.End(); i++)
         {
-            i.second->Dispose();
+            i->value->Dispose();
         }
-        m_pathCache.clear();
+        m_pathCache.Clear();
+    }
+
+    /**
+     * Set the memory limit of the cache
+     * \param maxBytes the memory limit, in bytes, or 0 for no limit
+     */
+    void SetMaxBytes(std::size_t maxBytes)
+    {
+        m_pathCache.SetMaxBytes(maxBytes);
+    }
+
+    /**
+     * \return the memory limit of the cache, in bytes, or 0 for no limit
+     */
+    std::size_t GetMaxBytes() const
+    {
+        return m_pathCache.GetMaxBytes();
+    }
+
+    /**
+     * \return the statistics of the cache
+     */
+    LruCacheStats GetStats() const
+    {
+        return m_pathCache.GetStats();
     }
 
   private:
@@ -106,42 +139,50 @@ class PropagationCache
         uint32_t m_spectrumModelUid;            //!< model UID
 
         /**
-         * Less-than operator.
-         *
-         * The goal of this operator is just to provide a stable comparison
-         * to be used in containers requiring a order (of any kind).
+         * Equality operator.
          *
-         * If the models are different, the comparison is based on their Uid.
-         * Otherwise, the comparison is based on the pointers of the Mobility models.
+         * Links are supposed to be symmetrical, hence the paths a-->b and b-->a are equal.
          *
          * \param other Right value of the operator.
-         * \returns True if the Left value is less than the Right value.
+         * \returns True if the paths are equal.
          */
-        bool operator<(const PropagationPathIdentifier& other) const
+        bool operator==(const PropagationPathIdentifier& other) const
         {
-            if (m_spectrumModelUid != other.m_spectrumModelUid)
-            {
-                return m_spectrumModelUid < other.m_spectrumModelUid;
-            }
-            /// Links are supposed to be symmetrical!
-            if (std::min(m_dstMobility, m_srcMobility) !=
-                std::min(other.m_dstMobility, other.m_srcMobility))
-            {
-                return std::min(m_dstMobility, m_srcMobility) <
-                       std::min(other.m_dstMobility, other.m_srcMobility);
-            }
-            if (std::max(m_dstMobility, m_srcMobility) !=
-                std::max(other.m_dstMobility, other.m_srcMobility))
-            {
-                return std::max(m_dstMobility, m_srcMobility) <
+            return m_spectrumModelUid == other.m_spectrumModelUid &&
+                   std::min(m_dstMobility, m_srcMobility) ==
+                       std::min(other.m_dstMobility, other.m_srcMobility) &&
+                   std::max(m_dstMobility, m_srcMobility) ==
                        std::max(other.m_dstMobility, other.m_srcMobility);
-            }
-            return false;
         }
     };
 
+    /// Symmetrical hash function of the paths
+    struct PropagationPathIdentifierHash
+    {
+        /**
+         * \param path the path
+         * \return the hash of the path
+         */
+        std::size_t operator()(const PropagationPathIdentifier& path) const
+        {
+            std::hash<const MobilityModel*> hasher;
+            std::size_t hash = hasher(PeekPointer(path.m_srcMobility)) ^
+                               hasher(PeekPointer(path.m_dstMobility));
+            return hash ^ (path.m_spectrumModelUid + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+        }
+    };
+
+    /**
+     * Dispose of the model of an evicted path
+     * \param data the model
+     */
+    static void DisposePathData(Ptr<T> data)
+    {
+        data->Dispose();
+    }
+
     /// Typedef: PropagationPathIdentifier, Ptr<T>
-    typedef std::map<PropagationPathIdentifier, Ptr<T>> PathCache;
+    typedef LruCache<PropagationPathIdentifier, Ptr<T>, PropagationPathIdentifierHash> PathCache;
 
   private:
     PathCache m_pathCache; //!< Path cache
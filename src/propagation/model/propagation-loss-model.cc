@@ -23,13 +23,17 @@
 #include "propagation-loss-model.h"
 
 #include "ns3/boolean.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
+#include <atomic>
 #include <cmath>
+#include <thread>
 
 namespace ns3
 {
@@ -94,6 +98,18 @@ PropagationLossModel::AssignStreams(int64_t stream)
     return (currentStream - stream);
 }
 
+bool
+PropagationLossModel::IsPositionOnly() const
+{
+    return DoIsPositionOnly() && (!m_next || m_next->IsPositionOnly());
+}
+
+bool
+PropagationLossModel::DoIsPositionOnly() const
+{
+    return false;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(RandomPropagationLossModel);
@@ -287,6 +303,12 @@ FriisPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+FriisPropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 // -- Two-Ray Ground Model ported from NS-2 -- tomhewer@mac.com -- Nov09 //
 
@@ -468,6 +490,12 @@ TwoRayGroundPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+TwoRayGroundPropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(LogDistancePropagationLossModel);
@@ -560,6 +588,12 @@ LogDistancePropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+LogDistancePropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(ThreeLogDistancePropagationLossModel);
@@ -659,6 +693,12 @@ ThreeLogDistancePropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+ThreeLogDistancePropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(NakagamiPropagationLossModel);
@@ -824,6 +864,12 @@ FixedRssLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+FixedRssLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(MatrixPropagationLossModel);
@@ -954,6 +1000,258 @@ RangePropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+bool
+RangePropagationLossModel::DoIsPositionOnly() const
+{
+    return true;
+}
+
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CachedPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<CachedPropagationLossModel>()
+            .AddAttribute("Model",
+                          "The propagation loss model, or the first model of the chain of "
+                          "models, whose losses are recorded.",
+                          PointerValue(),
+                          MakePointerAccessor(&CachedPropagationLossModel::SetModel,
+                                              &CachedPropagationLossModel::GetModel),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("Threads",
+                          "The number of threads evaluating the losses in Precompute (0 for one "
+                          "thread per hardware thread).",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&CachedPropagationLossModel::m_threads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel()
+    : PropagationLossModel(),
+      m_threads(1)
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel()
+{
+}
+
+void
+CachedPropagationLossModel::DoDispose()
+{
+    for (const auto& [key, mobility] : m_mobilityModels)
+    {
+        mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&CachedPropagationLossModel::CourseChanged, this));
+    }
+    m_mobilityModels.clear();
+    m_losses.clear();
+    m_model = nullptr;
+    PropagationLossModel::DoDispose();
+}
+
+void
+CachedPropagationLossModel::SetModel(Ptr<PropagationLossModel> model)
+{
+    m_model = model;
+    m_losses.clear();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel() const
+{
+    return m_model;
+}
+
+std::size_t
+CachedPropagationLossModel::GetNLosses() const
+{
+    std::size_t n = 0;
+    for (const auto& [a, losses] : m_losses)
+    {
+        n += losses.size();
+    }
+    return n;
+}
+
+void
+CachedPropagationLossModel::Precompute(const std::vector<Ptr<MobilityModel>>& mobilityModels)
+{
+    NS_LOG_FUNCTION(this << mobilityModels.size());
+    NS_ASSERT_MSG(m_model, "Set the model first");
+
+    std::size_t n = mobilityModels.size();
+    uint32_t nThreads = m_threads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<std::size_t>(nThreads, n);
+    if (nThreads > 1 && !m_model->IsPositionOnly())
+    {
+        // the copies of the mobility models are not aggregated to the nodes,
+        // nor to their building information
+        NS_LOG_WARN("The model does not only depend on the positions, the losses are "
+                    "precomputed on a single thread");
+        nThreads = 1;
+    }
+    if (nThreads <= 1)
+    {
+        for (const auto& a : mobilityModels)
+        {
+            for (const auto& b : mobilityModels)
+            {
+                if (a != b)
+                {
+                    GetLoss(a, b);
+                }
+            }
+        }
+        return;
+    }
+
+    //
+    // The reference counts of the objects may not be thread-safe, hence the
+    // threads only use the model through a raw pointer, and evaluate the
+    // losses with their own copies of the mobility models.
+    //
+    std::vector<std::vector<Ptr<MobilityModel>>> copies(nThreads);
+    for (auto& threadCopies : copies)
+    {
+        for (const auto& mobility : mobilityModels)
+        {
+            Ptr<MobilityModel> copy = CreateObject<ConstantPositionMobilityModel>();
+            copy->SetPosition(mobility->GetPosition());
+            threadCopies.push_back(copy);
+        }
+    }
+
+    std::vector<std::vector<double>> losses(n, std::vector<double>(n, 0));
+    PropagationLossModel* model = PeekPointer(m_model);
+    std::atomic<std::size_t> next(0);
+    auto run = [&](std::vector<Ptr<MobilityModel>>* threadCopies) {
+        for (std::size_t i = next++; i < n; i = next++)
+        {
+            for (std::size_t j = 0; j < n; j++)
+            {
+                if (i != j)
+                {
+                    losses[i][j] = -model->CalcRxPower(0, (*threadCopies)[i], (*threadCopies)[j]);
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(run, &copies[i]);
+    }
+    run(&copies[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (IsMoving(mobilityModels[i]))
+        {
+            continue;
+        }
+        Track(mobilityModels[i]);
+        Losses& aLosses = m_losses[PeekPointer(mobilityModels[i])];
+        for (std::size_t j = 0; j < n; j++)
+        {
+            if (i != j && !IsMoving(mobilityModels[j]))
+            {
+                aLosses[PeekPointer(mobilityModels[j])] = losses[i][j];
+            }
+        }
+    }
+}
+
+double
+CachedPropagationLossModel::GetLoss(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+    Losses& aLosses = m_losses[PeekPointer(a)];
+    auto it = aLosses.find(PeekPointer(b));
+    if (it != aLosses.end())
+    {
+        return it->second;
+    }
+    double loss = -m_model->CalcRxPower(0, a, b);
+    if (IsMoving(a) || IsMoving(b))
+    {
+        // the nodes may move without notifying a course change
+        return loss;
+    }
+    Track(a);
+    Track(b);
+    NS_LOG_DEBUG("recording the loss " << loss << " dB from " << a << " to " << b);
+    aLosses[PeekPointer(b)] = loss;
+    return loss;
+}
+
+bool
+CachedPropagationLossModel::IsMoving(Ptr<MobilityModel> mobility)
+{
+    Vector velocity = mobility->GetVelocity();
+    return velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+}
+
+void
+CachedPropagationLossModel::Track(Ptr<MobilityModel> mobility) const
+{
+    if (m_mobilityModels.emplace(PeekPointer(mobility), mobility).second)
+    {
+        mobility->TraceConnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&CachedPropagationLossModel::CourseChanged, this));
+    }
+}
+
+void
+CachedPropagationLossModel::CourseChanged(Ptr<const MobilityModel> mobility) const
+{
+    NS_LOG_FUNCTION(this << mobility);
+    m_losses.erase(PeekPointer(mobility));
+    for (auto& [a, losses] : m_losses)
+    {
+        losses.erase(PeekPointer(mobility));
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                          Ptr<MobilityModel> a,
+                                          Ptr<MobilityModel> b) const
+{
+    if (!m_model)
+    {
+        return txPowerDbm;
+    }
+    return txPowerDbm - GetLoss(a, b);
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    if (!m_model)
+    {
+        return 0;
+    }
+    return m_model->AssignStreams(stream);
+}
+
 // ------------------------------------------------------------------------- //
 
 } // namespace ns3
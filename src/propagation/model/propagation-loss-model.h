@@ -28,6 +28,8 @@
 #include "ns3/random-variable-stream.h"
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -114,6 +116,16 @@ class PropagationLossModel : public Object
      */
     int64_t AssignStreams(int64_t stream);
 
+    /**
+     * Whether the loss computed by this model, and by the models chained to
+     * it, is a deterministic function of the positions of the mobility
+     * models. Such losses can be evaluated concurrently by several threads,
+     * each with its own mobility models placed at the positions of interest.
+     *
+     * \return true if the losses only depend on the positions
+     */
+    bool IsPositionOnly() const;
+
   protected:
     /**
      * Assign a fixed random variable stream number to the random variables used by this model.
@@ -126,6 +138,15 @@ class PropagationLossModel : public Object
      */
     virtual int64_t DoAssignStreams(int64_t stream) = 0;
 
+    /**
+     * Subclasses whose loss neither depends on random variables, on a state
+     * updated by DoCalcRxPower, nor on the identity of the mobility models or
+     * on the objects aggregated to them, return true.
+     *
+     * \return whether the loss of this model only depends on the positions
+     */
+    virtual bool DoIsPositionOnly() const;
+
   private:
     /**
      * PropagationLossModel.
@@ -304,6 +325,7 @@ class FriisPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     /**
      * Transforms a Dbm value to Watt
@@ -414,6 +436,7 @@ class TwoRayGroundPropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     /**
      * Transforms a Dbm value to Watt
@@ -493,6 +516,7 @@ class LogDistancePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     /**
      *  Creates a default reference loss model
@@ -569,6 +593,7 @@ class ThreeLogDistancePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     double m_distance0; //!< Beginning of the first (near) distance field
     double m_distance1; //!< Beginning of the second (middle) distance field.
@@ -686,6 +711,7 @@ class FixedRssLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     double m_rss; //!< the received signal strength
 };
@@ -778,10 +804,126 @@ class RangePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> b) const override;
 
     int64_t DoAssignStreams(int64_t stream) override;
+    bool DoIsPositionOnly() const override;
 
     double m_range; //!< Maximum Transmission Range (meters)
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Records the loss of another propagation loss model for each pair of nodes
+ *
+ * For static nodes, the deterministic losses, e.g., of the
+ * LogDistancePropagationLossModel or of the BuildingsPropagationLossModel, are
+ * the same for every transmission. This model evaluates the loss of the model,
+ * or of the chain of models, set by its Model attribute once per ordered pair
+ * of mobility models, and returns the recorded loss afterwards. The stochastic
+ * models, e.g., the NakagamiPropagationLossModel, should be chained to this
+ * model with SetNext, so that they are still evaluated for every transmission.
+ *
+ * Only the losses between static nodes are recorded: the losses of a node
+ * with a non-null velocity are evaluated for every transmission, since the
+ * mobility models do not notify a course change while a node moves, e.g.
+ * along a straight line. The recorded losses of a node are discarded when its
+ * mobility model notifies a course change, which is the case when it starts
+ * moving. The losses are assumed not to depend on the transmission power,
+ * which holds for all the models but the FixedRssLossModel and the
+ * RangePropagationLossModel.
+ *
+ * Precompute evaluates the losses between a set of nodes beforehand, on the
+ * number of threads set by the Threads attribute. Since the losses are then
+ * evaluated concurrently, for copies of the mobility models which are not
+ * aggregated to the nodes, several threads are only used if the model only
+ * depends on the positions of the nodes (see
+ * PropagationLossModel::IsPositionOnly), and one thread otherwise.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CachedPropagationLossModel();
+    ~CachedPropagationLossModel() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    CachedPropagationLossModel(const CachedPropagationLossModel&) = delete;
+    CachedPropagationLossModel& operator=(const CachedPropagationLossModel&) = delete;
+
+    /**
+     * Set the model whose losses are recorded, discarding the recorded losses
+     * \param model the propagation loss model
+     */
+    void SetModel(Ptr<PropagationLossModel> model);
+
+    /**
+     * \return the model whose losses are recorded
+     */
+    Ptr<PropagationLossModel> GetModel() const;
+
+    /**
+     * Evaluate and record the losses between each ordered pair of the
+     * mobility models
+     * \param mobilityModels the mobility models of the nodes
+     */
+    void Precompute(const std::vector<Ptr<MobilityModel>>& mobilityModels);
+
+    /**
+     * \return the number of recorded losses
+     */
+    std::size_t GetNLosses() const;
+
+  private:
+    void DoDispose() override;
+
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    /**
+     * Get the recorded loss between two nodes, evaluating and recording it if
+     * needed
+     * \param a the mobility model of the source
+     * \param b the mobility model of the destination
+     * \return the loss, positive in dB
+     */
+    double GetLoss(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+    /**
+     * \param mobility a mobility model
+     * \return true if the velocity of the mobility model is not null
+     */
+    static bool IsMoving(Ptr<MobilityModel> mobility);
+
+    /**
+     * Get notified of the course changes of a mobility model, if not already
+     * \param mobility the mobility model
+     */
+    void Track(Ptr<MobilityModel> mobility) const;
+
+    /**
+     * Discard the recorded losses of a node whose course changed
+     * \param mobility the mobility model of the node
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility) const;
+
+    /// The recorded losses, in dB, by mobility model of the destination
+    typedef std::unordered_map<const MobilityModel*, double> Losses;
+
+    Ptr<PropagationLossModel> m_model; //!< The model whose losses are recorded
+    uint32_t m_threads;                //!< The number of threads of Precompute
+    /// The recorded losses, by mobility model of the source
+    mutable std::unordered_map<const MobilityModel*, Losses> m_losses;
+    /// The mobility models whose course changes are tracked
+    mutable std::unordered_map<const MobilityModel*, Ptr<MobilityModel>> m_mobilityModels;
+};
+
 } // namespace ns3
 
 #endif /* PROPAGATION_LOSS_MODEL_H */
@@ -22,9 +22,11 @@
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/lru-cache.h"
 #include "ns3/node-container.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -277,6 +279,105 @@ ThreeGppChannelConditionModelTestCase::DoRun()
     }
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * Test case for the memory limit of the caches of the channel condition
+ * models. It checks the order in which LruCache evicts its entries, and that
+ * ThreeGppChannelConditionModel keeps a single channel condition when its
+ * memory limit is tiny, determining a new one once it has been evicted.
+ */
+class ChannelConditionCacheTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ChannelConditionCacheTestCase();
+
+  private:
+    /**
+     * Builds the simulation scenario and perform the tests
+     */
+    void DoRun() override;
+};
+
+ChannelConditionCacheTestCase::ChannelConditionCacheTestCase()
+    : TestCase("Test case for the memory limit of the channel condition caches")
+{
+}
+
+void
+ChannelConditionCacheTestCase::DoRun()
+{
+    // the entries account for much more memory than the overhead of the cache,
+    // hence two of them fit in the limit, but not three
+    LruCache<uint32_t, uint32_t> cache;
+    cache.SetMaxBytes(25000);
+    cache.Insert(1, 10, 10000);
+    cache.Insert(2, 20, 10000);
+    NS_TEST_ASSERT_MSG_NE(cache.Find(1), nullptr, "Entry 1 should be in the cache");
+    NS_TEST_ASSERT_MSG_EQ(*cache.Find(1), 10, "Unexpected value of entry 1");
+    cache.Insert(3, 30, 10000);
+    NS_TEST_ASSERT_MSG_EQ(cache.GetSize(), 2, "Unexpected number of entries");
+    NS_TEST_ASSERT_MSG_EQ(cache.Peek(2), nullptr, "The least recently used entry was not evicted");
+    NS_TEST_ASSERT_MSG_NE(cache.Peek(1), nullptr, "Entry 1 should be in the cache");
+    NS_TEST_ASSERT_MSG_NE(cache.Peek(3), nullptr, "Entry 3 should be in the cache");
+    NS_TEST_ASSERT_MSG_EQ(cache.Find(2), nullptr, "Entry 2 should not be in the cache");
+    LruCacheStats stats = cache.GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.hits, 2, "Unexpected number of hits");
+    NS_TEST_ASSERT_MSG_EQ(stats.misses, 1, "Unexpected number of misses");
+    NS_TEST_ASSERT_MSG_EQ(stats.evictions, 1, "Unexpected number of evictions");
+    NS_TEST_ASSERT_MSG_EQ(stats.entries, 2, "Unexpected number of entries");
+    NS_TEST_ASSERT_MSG_GT(stats.bytes, 20000, "The memory of the entries was not accounted");
+
+    // the most recently used entry is kept, even if it exceeds the limit
+    cache.SetMaxBytes(1);
+    NS_TEST_ASSERT_MSG_EQ(cache.GetSize(), 1, "Unexpected number of entries");
+    NS_TEST_ASSERT_MSG_NE(cache.Peek(3), nullptr, "Entry 3 should be in the cache");
+
+    NodeContainer nodes;
+    nodes.Create(3);
+    std::vector<Ptr<MobilityModel>> mobs;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(Vector(100.0 * i, 0, 1.5));
+        nodes.Get(i)->AggregateObject(mob);
+        mobs.push_back(mob);
+    }
+
+    // without a limit, the channel conditions of both links are kept
+    Ptr<ThreeGppChannelConditionModel> condModel =
+        CreateObject<ThreeGppUmaChannelConditionModel>();
+    condModel->GetChannelCondition(mobs[0], mobs[1]);
+    condModel->GetChannelCondition(mobs[0], mobs[2]);
+    Ptr<ChannelCondition> cond = condModel->GetChannelCondition(mobs[0], mobs[1]);
+    NS_TEST_ASSERT_MSG_EQ(condModel->GetChannelCondition(mobs[1], mobs[0]),
+                          cond,
+                          "The channel condition is not reciprocal");
+    stats = condModel->GetCacheStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.entries, 2, "Unexpected number of channel conditions");
+    NS_TEST_ASSERT_MSG_EQ(stats.evictions, 0, "No channel condition should be evicted");
+
+    // with a tiny limit, only the last channel condition is kept
+    condModel->SetAttribute("MaxCacheBytes", UintegerValue(1));
+    stats = condModel->GetCacheStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.entries, 1, "Unexpected number of channel conditions");
+    NS_TEST_ASSERT_MSG_EQ(condModel->GetChannelCondition(mobs[1], mobs[0]),
+                          cond,
+                          "The last channel condition should be kept");
+    condModel->GetChannelCondition(mobs[0], mobs[2]);
+    NS_TEST_ASSERT_MSG_NE(condModel->GetChannelCondition(mobs[0], mobs[1]),
+                          cond,
+                          "The evicted channel condition should be determined again");
+    stats = condModel->GetCacheStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.entries, 1, "Unexpected number of channel conditions");
+    NS_TEST_ASSERT_MSG_EQ(stats.evictions, 3, "Unexpected number of evictions");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -292,6 +393,7 @@ ChannelConditionModelsTestSuite::ChannelConditionModelsTestSuite()
     : TestSuite("propagation-channel-condition-model", UNIT)
 {
     AddTestCase(new ThreeGppChannelConditionModelTestCase, TestCase::QUICK);
+    AddTestCase(new ChannelConditionCacheTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
@@ -18,11 +18,15 @@
 #include "ns3/abort.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -489,6 +493,173 @@ RangePropagationLossModelTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief PropagationLossModel::IsPositionOnly Test
+ */
+class PositionOnlyPropagationLossModelTestCase : public TestCase
+{
+  public:
+    PositionOnlyPropagationLossModelTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PositionOnlyPropagationLossModelTestCase::PositionOnlyPropagationLossModelTestCase()
+    : TestCase("Test PropagationLossModel::IsPositionOnly")
+{
+}
+
+void
+PositionOnlyPropagationLossModelTestCase::DoRun()
+{
+    Ptr<PropagationLossModel> friis = CreateObject<FriisPropagationLossModel>();
+    Ptr<PropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel>();
+    Ptr<PropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel>();
+    NS_TEST_EXPECT_MSG_EQ(friis->IsPositionOnly(), true, "Friis only depends on the positions");
+    NS_TEST_EXPECT_MSG_EQ(nakagami->IsPositionOnly(), false, "Nakagami is random");
+    NS_TEST_EXPECT_MSG_EQ(CreateObject<MatrixPropagationLossModel>()->IsPositionOnly(),
+                          false,
+                          "The matrix depends on the mobility models");
+
+    // the models chained to a model
+    friis->SetNext(logDistance);
+    NS_TEST_EXPECT_MSG_EQ(friis->IsPositionOnly(), true, "Unexpected chain of models");
+    logDistance->SetNext(nakagami);
+    NS_TEST_EXPECT_MSG_EQ(friis->IsPositionOnly(), false, "Unexpected chain of random models");
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief CachedPropagationLossModel Test
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+  public:
+    CachedPropagationLossModelTestCase();
+    ~CachedPropagationLossModelTestCase() override;
+
+  private:
+    void DoRun() override;
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase()
+    : TestCase("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun()
+{
+    std::vector<Ptr<MobilityModel>> m;
+    for (int i = 0; i < 4; ++i)
+    {
+        m.push_back(CreateObject<ConstantPositionMobilityModel>());
+        m[i]->SetPosition(Vector(10.0 * (i + 1), 5.0 * i, 0));
+    }
+
+    // the losses of a random model are recorded, hence they do not change
+    Ptr<RandomPropagationLossModel> random = CreateObject<RandomPropagationLossModel>();
+    random->SetAttribute("Variable", StringValue("ns3::UniformRandomVariable[Min=0|Max=100]"));
+    Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel>();
+    cached->SetAttribute("Model", PointerValue(random));
+    double loss01 = cached->CalcRxPower(0, m[0], m[1]);
+    NS_TEST_ASSERT_MSG_EQ(cached->CalcRxPower(0, m[0], m[1]), loss01, "Loss 0 -> 1 changed");
+    NS_TEST_ASSERT_MSG_EQ(cached->CalcRxPower(10, m[0], m[1]),
+                          loss01 + 10,
+                          "Loss 0 -> 1 depends on the tx power");
+    cached->CalcRxPower(0, m[1], m[0]);
+    NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 2, "Unexpected number of recorded losses");
+
+    // the losses of the models chained to the cached model are not recorded
+    Ptr<RandomPropagationLossModel> fading = CreateObject<RandomPropagationLossModel>();
+    fading->SetAttribute("Variable", StringValue("ns3::UniformRandomVariable[Min=0|Max=100]"));
+    cached->SetNext(fading);
+    double fading01 = cached->CalcRxPower(0, m[0], m[1]);
+    NS_TEST_ASSERT_MSG_NE(cached->CalcRxPower(0, m[0], m[1]),
+                          fading01,
+                          "The chained model should be evaluated again");
+    cached->SetNext(nullptr);
+
+    // the losses of a node are evaluated again after its course changed
+    m[1]->SetPosition(Vector(100, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 0, "The losses of node 1 were not discarded");
+    NS_TEST_ASSERT_MSG_NE(cached->CalcRxPower(0, m[0], m[1]),
+                          loss01,
+                          "Loss 0 -> 1 was not evaluated again");
+
+    // the precomputed losses, on one or more threads, are the ones of the model
+    Ptr<LogDistancePropagationLossModel> logDistance =
+        CreateObject<LogDistancePropagationLossModel>();
+    for (uint32_t threads : {1, 3})
+    {
+        cached = CreateObject<CachedPropagationLossModel>();
+        cached->SetAttribute("Model", PointerValue(logDistance));
+        cached->SetAttribute("Threads", UintegerValue(threads));
+        cached->Precompute(m);
+        NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 12, "Unexpected number of recorded losses");
+        for (const auto& a : m)
+        {
+            for (const auto& b : m)
+            {
+                if (a != b)
+                {
+                    NS_TEST_ASSERT_MSG_EQ_TOL(cached->CalcRxPower(0, a, b),
+                                              logDistance->CalcRxPower(0, a, b),
+                                              1e-9,
+                                              "Unexpected precomputed loss");
+                }
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 12, "Unexpected number of recorded losses");
+        cached->Dispose();
+    }
+
+    // a model which does not only depend on the positions is precomputed on a
+    // single thread
+    cached = CreateObject<CachedPropagationLossModel>();
+    cached->SetAttribute("Model", PointerValue(random));
+    cached->SetAttribute("Threads", UintegerValue(3));
+    cached->Precompute(m);
+    NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 12, "Unexpected number of recorded losses");
+    cached->Dispose();
+
+    // the losses of a moving node are not recorded, since it does not notify
+    // its course changes
+    Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel>();
+    moving->SetPosition(Vector(0, 0, 0));
+    moving->SetVelocity(Vector(10, 0, 0));
+    m.push_back(moving);
+    cached = CreateObject<CachedPropagationLossModel>();
+    cached->SetAttribute("Model", PointerValue(logDistance));
+    cached->SetAttribute("Threads", UintegerValue(3));
+    cached->Precompute(m);
+    NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 12, "The losses of the moving node were recorded");
+    NS_TEST_ASSERT_MSG_EQ_TOL(cached->CalcRxPower(0, m[0], moving),
+                              logDistance->CalcRxPower(0, m[0], moving),
+                              1e-9,
+                              "Unexpected loss to the moving node");
+    NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 12, "The losses of the moving node were recorded");
+    double loss = cached->CalcRxPower(0, moving, m[0]);
+    Simulator::Schedule(Seconds(1), [&]() {
+        NS_TEST_EXPECT_MSG_NE(cached->CalcRxPower(0, moving, m[0]),
+                              loss,
+                              "The loss from the moving node was not evaluated again");
+    });
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(cached->GetNLosses(), 12, "The losses of the moving node were recorded");
+    cached->Dispose();
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -500,6 +671,7 @@ RangePropagationLossModelTestCase::DoRun()
  *   - LogDistancePropagationLossModel
  *   - MatrixPropagationLossModel
  *   - RangePropagationLossModel
+ *   - CachedPropagationLossModel
  */
 class PropagationLossModelsTestSuite : public TestSuite
 {
@@ -515,6 +687,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite()
     AddTestCase(new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
     AddTestCase(new MatrixPropagationLossModelTestCase, TestCase::QUICK);
     AddTestCase(new RangePropagationLossModelTestCase, TestCase::QUICK);
+    AddTestCase(new PositionOnlyPropagationLossModelTestCase, TestCase::QUICK);
+    AddTestCase(new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
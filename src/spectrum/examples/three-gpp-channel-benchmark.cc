@@ -0,0 +1,199 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This example measures the time the ThreeGppChannelModel takes to generate
+ * the channel matrices of the links between a base station and a set of user
+ * terminals, in the 3GPP UMa and UMi-StreetCanyon scenarios.
+ * The base station and the user terminals have uniform planar arrays of
+ * 8x8 = 64 elements by default. The channel matrices are regenerated every
+ * update period, for a number of periods, either one link at a time with
+ * GetChannel, or in a batch with GetChannels, on the given number of threads.
+ * Both modes use the same random streams, hence they generate the same
+ * matrices, which the example checks.
+ */
+
+#include "ns3/channel-condition-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/core-module.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/node-container.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <chrono>
+#include <iomanip>
+
+NS_LOG_COMPONENT_DEFINE("ThreeGppChannelBenchmark");
+
+using namespace ns3;
+
+/**
+ * Create a channel model for the scenario
+ * \param scenario the 3GPP scenario
+ * \param updatePeriod the channel update period
+ * \param threads the number of threads of GetChannels
+ * \return the channel model
+ */
+static Ptr<ThreeGppChannelModel>
+CreateChannelModel(std::string scenario, Time updatePeriod, uint32_t threads)
+{
+    Ptr<ChannelConditionModel> channelConditionModel;
+    if (scenario == "UMa")
+    {
+        channelConditionModel = CreateObject<ThreeGppUmaChannelConditionModel>();
+    }
+    else
+    {
+        channelConditionModel = CreateObject<ThreeGppUmiStreetCanyonChannelConditionModel>();
+    }
+    channelConditionModel->AssignStreams(1);
+
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28.0e9));
+    channelModel->SetAttribute("Scenario", StringValue(scenario));
+    channelModel->SetAttribute("ChannelConditionModel", PointerValue(channelConditionModel));
+    channelModel->SetAttribute("UpdatePeriod", TimeValue(updatePeriod));
+    channelModel->SetAttribute("Threads", UintegerValue(threads));
+    channelModel->AssignStreams(10);
+    return channelModel;
+}
+
+/**
+ * Generate the channel matrices of the links in both modes, and add the
+ * time it took to the total times
+ * \param single the channel model used one link at a time
+ * \param batch the channel model used in batches
+ * \param links the links
+ * \param singleTime the total time of the single mode
+ * \param batchTime the total time of the batch mode
+ */
+static void
+GenerateChannels(Ptr<ThreeGppChannelModel> single,
+                 Ptr<ThreeGppChannelModel> batch,
+                 const std::vector<ThreeGppChannelModel::ChannelLink>* links,
+                 double* singleTime,
+                 double* batchTime)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> expected;
+    for (const auto& link : *links)
+    {
+        expected.push_back(single->GetChannel(link.aMob, link.bMob, link.aAntenna, link.bAntenna));
+    }
+    auto middle = std::chrono::steady_clock::now();
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> channels =
+        batch->GetChannels(*links);
+    auto end = std::chrono::steady_clock::now();
+
+    *singleTime += std::chrono::duration<double>(middle - start).count();
+    *batchTime += std::chrono::duration<double>(end - middle).count();
+    for (std::size_t i = 0; i < links->size(); i++)
+    {
+        NS_ABORT_MSG_UNLESS(channels[i]->m_channel == expected[i]->m_channel,
+                            "The batch generated a different channel matrix");
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numUts = 20;    // number of user terminals
+    uint32_t arraySide = 8;  // number of rows and columns of the arrays
+    uint32_t numPeriods = 5; // number of update periods
+    uint32_t threads = 0;    // number of threads of GetChannels
+    double radius = 200;     // radius of the cell, in m
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numUts", "The number of user terminals", numUts);
+    cmd.AddValue("arraySide", "The number of rows and columns of the arrays", arraySide);
+    cmd.AddValue("numPeriods", "The number of update periods", numPeriods);
+    cmd.AddValue("threads",
+                 "The number of threads of the batches (0 for one per hardware thread)",
+                 threads);
+    cmd.AddValue("radius", "The radius of the cell, in m", radius);
+    cmd.Parse(argc, argv);
+
+    Time updatePeriod = MilliSeconds(10);
+    Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable>();
+    position->SetAttribute("Min", DoubleValue(-radius));
+    position->SetAttribute("Max", DoubleValue(radius));
+    position->SetStream(1);
+
+    std::cout << "scenario           elements  links  single (ms/link)  batch (ms/link)"
+              << std::endl;
+    for (std::string scenario : {"UMa", "UMi-StreetCanyon"})
+    {
+        NodeContainer nodes;
+        nodes.Create(numUts + 1);
+        std::vector<ThreeGppChannelModel::ChannelLink> links;
+        Ptr<MobilityModel> bsMob;
+        Ptr<PhasedArrayModel> bsAntenna;
+        for (uint32_t i = 0; i < nodes.GetN(); i++)
+        {
+            Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+            if (i == 0)
+            {
+                mob->SetPosition(Vector(0.0, 0.0, scenario == "UMa" ? 25.0 : 10.0));
+            }
+            else
+            {
+                mob->SetPosition(Vector(position->GetValue(), position->GetValue(), 1.5));
+            }
+            nodes.Get(i)->AggregateObject(mob);
+            Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+                "NumColumns",
+                UintegerValue(arraySide),
+                "NumRows",
+                UintegerValue(arraySide),
+                "AntennaElement",
+                PointerValue(CreateObject<IsotropicAntennaModel>()));
+            if (i == 0)
+            {
+                bsMob = mob;
+                bsAntenna = antenna;
+            }
+            else
+            {
+                links.push_back({bsMob, mob, bsAntenna, antenna});
+            }
+        }
+
+        Ptr<ThreeGppChannelModel> single = CreateChannelModel(scenario, updatePeriod, 1);
+        Ptr<ThreeGppChannelModel> batch = CreateChannelModel(scenario, updatePeriod, threads);
+        double singleTime = 0;
+        double batchTime = 0;
+        for (uint32_t period = 0; period < numPeriods; period++)
+        {
+            Simulator::Schedule(updatePeriod * period + MilliSeconds(1),
+                                &GenerateChannels,
+                                single,
+                                batch,
+                                &links,
+                                &singleTime,
+                                &batchTime);
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+
+        double numChannels = static_cast<double>(links.size()) * numPeriods;
+        std::cout << std::left << std::setw(19) << scenario << std::setw(10)
+                  << arraySide * arraySide << std::setw(7) << links.size() << std::setw(18)
+                  << 1e3 * singleTime / numChannels << 1e3 * batchTime / numChannels
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -29,9 +29,11 @@
 #include <ns3/object.h>
 #include <ns3/packet-burst.h>
 #include <ns3/packet.h>
+#include <ns3/pointer.h>
 #include <ns3/propagation-delay-model.h>
 #include <ns3/propagation-loss-model.h>
 #include <ns3/simulator.h>
+#include <ns3/spatial-index.h>
 #include <ns3/spectrum-converter.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-propagation-loss-model.h>
@@ -91,18 +93,40 @@ MultiModelSpectrumChannel::DoDispose()
     NS_LOG_FUNCTION(this);
     m_txSpectrumModelInfoMap.clear();
     m_rxSpectrumModelInfoMap.clear();
+    m_rxPhyIds.clear();
+    m_rxPhysById.clear();
+    m_rxPhysToIndex.clear();
+    if (m_spatialIndex)
+    {
+        m_spatialIndex->Dispose();
+        m_spatialIndex = nullptr;
+    }
     SpectrumChannel::DoDispose();
 }
 
 TypeId
 MultiModelSpectrumChannel::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::MultiModelSpectrumChannel")
-                            .SetParent<SpectrumChannel>()
-                            .SetGroupName("Spectrum")
-                            .AddConstructor<MultiModelSpectrumChannel>()
-
-        ;
+    static TypeId tid =
+        TypeId("ns3::MultiModelSpectrumChannel")
+            .SetParent<SpectrumChannel>()
+            .SetGroupName("Spectrum")
+            .AddConstructor<MultiModelSpectrumChannel>()
+            .AddAttribute("MaxRange",
+                          "If strictly positive, signals are not propagated to the receivers "
+                          "located further than this distance (m) from the transmitter, "
+                          "and no path loss is computed for them.",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&MultiModelSpectrumChannel::m_maxRange),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SpatialIndex",
+                          "If set and MaxRange is strictly positive, the spatial index used to "
+                          "find the receivers located within MaxRange of the transmitter, "
+                          "instead of visiting every receiver. It must not be shared with "
+                          "other channels.",
+                          PointerValue(),
+                          MakePointerAccessor(&MultiModelSpectrumChannel::m_spatialIndex),
+                          MakePointerChecker<SpatialIndex>());
     return tid;
 }
 
@@ -129,6 +153,17 @@ MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
             break; // there should be at most one entry
         }
     }
+
+    if (auto idIt = m_rxPhyIds.find(phy); idIt != m_rxPhyIds.end())
+    {
+        m_rxPhysToIndex.erase(
+            std::remove(m_rxPhysToIndex.begin(), m_rxPhysToIndex.end(), idIt->second),
+            m_rxPhysToIndex.end());
+        if (m_spatialIndex)
+        {
+            m_spatialIndex->Remove(idIt->second);
+        }
+    }
 }
 
 void
@@ -155,6 +190,15 @@ MultiModelSpectrumChannel::AddRx(Ptr<SpectrumPhy> phy)
     // prevented insertion. In both cases, add the phy to the element pointed to by rxInfoIterator
     rxInfoIterator->second.m_rxPhys.push_back(phy);
 
+    // the phy is added to the spatial index upon the next transmission, since its
+    // mobility model may not be available yet
+    auto [idIt, newPhy] = m_rxPhyIds.emplace(phy, m_rxPhysById.size());
+    if (newPhy)
+    {
+        m_rxPhysById.push_back(phy);
+    }
+    m_rxPhysToIndex.push_back(idIt->second);
+
     if (inserted)
     {
         // create the necessary converters for all the TX spectrum models that we know of
@@ -256,142 +300,229 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
     NS_LOG_LOGIC("converter map first element: "
                  << txInfoIteratorerator->second.m_spectrumConverterMap.begin()->first);
 
+    if (m_maxRange > 0 && m_spatialIndex && txMobility)
+    {
+        // only visit the RX phys that may be within range, grouped by RX SpectrumModel
+        std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy>>> rxPhysInRange;
+        for (const auto& rxPhy : GetRxPhysInRange(txMobility))
+        {
+            rxPhysInRange[rxPhy->GetRxSpectrumModel()->GetUid()].push_back(rxPhy);
+        }
+        for (const auto& [rxSpectrumModelUid, rxPhys] : rxPhysInRange)
+        {
+            auto rxInfoIterator = m_rxSpectrumModelInfoMap.find(rxSpectrumModelUid);
+            NS_ASSERT_MSG(rxInfoIterator != m_rxSpectrumModelInfoMap.end(),
+                          "SpectrumModel change was not notified to MultiModelSpectrumChannel "
+                          "(i.e., AddRx should be called again after model is changed)");
+            StartTxToRxPhys(txParams,
+                            txMobility,
+                            txInfoIteratorerator->second,
+                            rxInfoIterator->second,
+                            rxPhys);
+        }
+        return;
+    }
+
     for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
          rxInfoIterator != m_rxSpectrumModelInfoMap.end();
          ++rxInfoIterator)
     {
-        SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid();
-        NS_LOG_LOGIC("rxSpectrumModelUids " << rxSpectrumModelUid);
+        StartTxToRxPhys(txParams,
+                        txMobility,
+                        txInfoIteratorerator->second,
+                        rxInfoIterator->second,
+                        rxInfoIterator->second.m_rxPhys);
+    }
+}
 
-        Ptr<SpectrumValue> convertedTxPowerSpectrum;
-        if (txSpectrumModelUid == rxSpectrumModelUid)
-        {
-            NS_LOG_LOGIC("no spectrum conversion needed");
-            convertedTxPowerSpectrum = txParams->psd;
-        }
-        else
+void
+MultiModelSpectrumChannel::StartTxToRxPhys(Ptr<SpectrumSignalParameters> txParams,
+                                           Ptr<MobilityModel> txMobility,
+                                           const TxSpectrumModelInfo& txInfo,
+                                           const RxSpectrumModelInfo& rxInfo,
+                                           const std::vector<Ptr<SpectrumPhy>>& rxPhys)
+{
+    SpectrumModelUid_t txSpectrumModelUid = txInfo.m_txSpectrumModel->GetUid();
+    SpectrumModelUid_t rxSpectrumModelUid = rxInfo.m_rxSpectrumModel->GetUid();
+    NS_LOG_LOGIC("rxSpectrumModelUids " << rxSpectrumModelUid);
+
+    const SpectrumConverter* converter = nullptr;
+    if (txSpectrumModelUid != rxSpectrumModelUid)
+    {
+        auto rxConverterIterator = txInfo.m_spectrumConverterMap.find(rxSpectrumModelUid);
+        if (rxConverterIterator == txInfo.m_spectrumConverterMap.end())
         {
-            NS_LOG_LOGIC("converting txPowerSpectrum SpectrumModelUids "
-                         << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
-            SpectrumConverterMap_t::const_iterator rxConverterIterator =
-                txInfoIteratorerator->second.m_spectrumConverterMap.find(rxSpectrumModelUid);
-            if (rxConverterIterator == txInfoIteratorerator->second.m_spectrumConverterMap.end())
-            {
-                // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
-                continue;
-            }
-            convertedTxPowerSpectrum = rxConverterIterator->second.Convert(txParams->psd);
+            // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
+            return;
         }
+        converter = &rxConverterIterator->second;
+    }
+    // the TX power spectrum is converted when the first receiver within range is found
+    Ptr<SpectrumValue> convertedTxPowerSpectrum;
 
-        for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin();
-             rxPhyIterator != rxInfoIterator->second.m_rxPhys.end();
-             ++rxPhyIterator)
+    for (auto rxPhyIterator = rxPhys.begin(); rxPhyIterator != rxPhys.end(); ++rxPhyIterator)
+    {
+        NS_ASSERT_MSG((*rxPhyIterator)->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
+                      "SpectrumModel change was not notified to MultiModelSpectrumChannel "
+                      "(i.e., AddRx should be called again after model is changed)");
+
+        if ((*rxPhyIterator) != txParams->txPhy)
         {
-            NS_ASSERT_MSG((*rxPhyIterator)->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
-                          "SpectrumModel change was not notified to MultiModelSpectrumChannel "
-                          "(i.e., AddRx should be called again after model is changed)");
+            Ptr<NetDevice> rxNetDevice = (*rxPhyIterator)->GetDevice();
+            Ptr<NetDevice> txNetDevice = txParams->txPhy->GetDevice();
 
-            if ((*rxPhyIterator) != txParams->txPhy)
+            if (rxNetDevice && txNetDevice)
             {
-                Ptr<NetDevice> rxNetDevice = (*rxPhyIterator)->GetDevice();
-                Ptr<NetDevice> txNetDevice = txParams->txPhy->GetDevice();
-
-                if (rxNetDevice && txNetDevice)
+                // we assume that devices are attached to a node
+                if (rxNetDevice->GetNode()->GetId() == txNetDevice->GetNode()->GetId())
                 {
-                    // we assume that devices are attached to a node
-                    if (rxNetDevice->GetNode()->GetId() == txNetDevice->GetNode()->GetId())
-                    {
-                        NS_LOG_DEBUG(
-                            "Skipping the pathloss calculation among different antennas of the "
-                            "same node, not supported yet by any pathloss model in ns-3.");
-                        continue;
-                    }
+                    NS_LOG_DEBUG(
+                        "Skipping the pathloss calculation among different antennas of the "
+                        "same node, not supported yet by any pathloss model in ns-3.");
+                    continue;
                 }
+            }
+
+            Time delay = MicroSeconds(0);
+            double pathGainLinear = 1;
 
-                NS_LOG_LOGIC("copying signal parameters " << txParams);
-                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
-                rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
-                Time delay = MicroSeconds(0);
+            Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
 
-                Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
+            if (txMobility && receiverMobility)
+            {
+                if (m_maxRange > 0 && txMobility->GetDistanceFrom(receiverMobility) > m_maxRange)
+                {
+                    NS_LOG_LOGIC("receiver " << *rxPhyIterator << " beyond MaxRange");
+                    continue;
+                }
+                double txAntennaGain = 0;
+                double rxAntennaGain = 0;
+                double propagationGainDb = 0;
+                double pathLossDb = 0;
+                if (txParams->txAntenna)
+                {
+                    Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
+                    txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
+                    NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
+                    pathLossDb -= txAntennaGain;
+                }
+                Ptr<AntennaModel> rxAntenna =
+                    DynamicCast<AntennaModel>((*rxPhyIterator)->GetAntenna());
+                if (rxAntenna)
+                {
+                    Angles rxAngles(txMobility->GetPosition(), receiverMobility->GetPosition());
+                    rxAntennaGain = rxAntenna->GetGainDb(rxAngles);
+                    NS_LOG_LOGIC("rxAntennaGain = " << rxAntennaGain << " dB");
+                    pathLossDb -= rxAntennaGain;
+                }
+                if (m_propagationLoss)
+                {
+                    propagationGainDb =
+                        m_propagationLoss->CalcRxPower(0, txMobility, receiverMobility);
+                    NS_LOG_LOGIC("propagationGainDb = " << propagationGainDb << " dB");
+                    pathLossDb -= propagationGainDb;
+                }
+                NS_LOG_LOGIC("total pathLoss = " << pathLossDb << " dB");
+                // Gain trace
+                m_gainTrace(txMobility,
+                            receiverMobility,
+                            txAntennaGain,
+                            rxAntennaGain,
+                            propagationGainDb,
+                            pathLossDb);
+                // Pathloss trace
+                m_pathLossTrace(txParams->txPhy, *rxPhyIterator, pathLossDb);
+                if (pathLossDb > m_maxLossDb)
+                {
+                    // beyond range, checked before copying the signal parameters
+                    continue;
+                }
+                pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
 
-                if (txMobility && receiverMobility)
+                if (m_propagationDelay)
                 {
-                    double txAntennaGain = 0;
-                    double rxAntennaGain = 0;
-                    double propagationGainDb = 0;
-                    double pathLossDb = 0;
-                    if (rxParams->txAntenna)
-                    {
-                        Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
-                        txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
-                        NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
-                        pathLossDb -= txAntennaGain;
-                    }
-                    Ptr<AntennaModel> rxAntenna =
-                        DynamicCast<AntennaModel>((*rxPhyIterator)->GetAntenna());
-                    if (rxAntenna)
-                    {
-                        Angles rxAngles(txMobility->GetPosition(), receiverMobility->GetPosition());
-                        rxAntennaGain = rxAntenna->GetGainDb(rxAngles);
-                        NS_LOG_LOGIC("rxAntennaGain = " << rxAntennaGain << " dB");
-                        pathLossDb -= rxAntennaGain;
-                    }
-                    if (m_propagationLoss)
-                    {
-                        propagationGainDb =
-                            m_propagationLoss->CalcRxPower(0, txMobility, receiverMobility);
-                        NS_LOG_LOGIC("propagationGainDb = " << propagationGainDb << " dB");
-                        pathLossDb -= propagationGainDb;
-                    }
-                    NS_LOG_LOGIC("total pathLoss = " << pathLossDb << " dB");
-                    // Gain trace
-                    m_gainTrace(txMobility,
-                                receiverMobility,
-                                txAntennaGain,
-                                rxAntennaGain,
-                                propagationGainDb,
-                                pathLossDb);
-                    // Pathloss trace
-                    m_pathLossTrace(txParams->txPhy, *rxPhyIterator, pathLossDb);
-                    if (pathLossDb > m_maxLossDb)
-                    {
-                        // beyond range
-                        continue;
-                    }
-                    double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                    *(rxParams->psd) *= pathGainLinear;
-
-                    if (m_propagationDelay)
-                    {
-                        delay = m_propagationDelay->GetDelay(txMobility, receiverMobility);
-                    }
+                    delay = m_propagationDelay->GetDelay(txMobility, receiverMobility);
                 }
+            }
 
-                if (rxNetDevice)
+            if (!convertedTxPowerSpectrum)
+            {
+                if (converter)
                 {
-                    // the receiver has a NetDevice, so we expect that it is attached to a Node
-                    uint32_t dstNode = rxNetDevice->GetNode()->GetId();
-                    Simulator::ScheduleWithContext(dstNode,
-                                                   delay,
-                                                   &MultiModelSpectrumChannel::StartRx,
-                                                   this,
-                                                   rxParams,
-                                                   *rxPhyIterator);
+                    NS_LOG_LOGIC("converting txPowerSpectrum SpectrumModelUids "
+                                 << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
+                    convertedTxPowerSpectrum = converter->Convert(txParams->psd);
                 }
                 else
                 {
-                    // the receiver is not attached to a NetDevice, so we cannot assume that it is
-                    // attached to a node
-                    Simulator::Schedule(delay,
-                                        &MultiModelSpectrumChannel::StartRx,
-                                        this,
-                                        rxParams,
-                                        *rxPhyIterator);
+                    NS_LOG_LOGIC("no spectrum conversion needed");
+                    convertedTxPowerSpectrum = txParams->psd;
                 }
             }
+
+            NS_LOG_LOGIC("copying signal parameters " << txParams);
+            Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+            rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
+            if (txMobility && receiverMobility)
+            {
+                *(rxParams->psd) *= pathGainLinear;
+            }
+
+            if (rxNetDevice)
+            {
+                // the receiver has a NetDevice, so we expect that it is attached to a Node
+                uint32_t dstNode = rxNetDevice->GetNode()->GetId();
+                Simulator::ScheduleWithContext(dstNode,
+                                               delay,
+                                               &MultiModelSpectrumChannel::StartRx,
+                                               this,
+                                               rxParams,
+                                               *rxPhyIterator);
+            }
+            else
+            {
+                // the receiver is not attached to a NetDevice, so we cannot assume that it is
+                // attached to a node
+                Simulator::Schedule(delay,
+                                    &MultiModelSpectrumChannel::StartRx,
+                                    this,
+                                    rxParams,
+                                    *rxPhyIterator);
+            }
+        }
+    }
+}
+
+std::vector<Ptr<SpectrumPhy>>
+MultiModelSpectrumChannel::GetRxPhysInRange(Ptr<MobilityModel> txMobility)
+{
+    NS_LOG_FUNCTION(this << txMobility);
+    std::vector<uint32_t> ids;
+    // RX phys are indexed once they have a mobility model; those that have none yet
+    // are always visited, as they would be without spatial index
+    for (auto it = m_rxPhysToIndex.begin(); it != m_rxPhysToIndex.end();)
+    {
+        if (auto mobility = m_rxPhysById[*it]->GetMobility())
+        {
+            m_spatialIndex->Add(mobility, *it);
+            it = m_rxPhysToIndex.erase(it);
         }
+        else
+        {
+            ids.push_back(*it++);
+        }
+    }
+    m_spatialIndex->GetCandidates(txMobility->GetPosition(), m_maxRange, ids);
+    // visit the RX phys in a deterministic order
+    std::sort(ids.begin(), ids.end());
+
+    std::vector<Ptr<SpectrumPhy>> rxPhys;
+    rxPhys.reserve(ids.size());
+    for (const auto id : ids)
+    {
+        rxPhys.push_back(m_rxPhysById[id]);
     }
+    return rxPhys;
 }
 
 void
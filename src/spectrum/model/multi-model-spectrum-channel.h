@@ -32,6 +32,8 @@
 namespace ns3
 {
 
+class SpatialIndex;
+
 /**
  * \ingroup spectrum
  * Container: SpectrumModelUid_t, SpectrumConverter
@@ -98,6 +100,11 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * If the MaxRange attribute is set, signals are not propagated to the
+ * receivers located further than MaxRange from the transmitter. In such
+ * a case, a SpatialIndex can be set to only visit the receivers which
+ * may be within range.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -144,6 +151,31 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      */
     virtual void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+    /**
+     * Used internally by StartTx to propagate a signal to the given receivers,
+     * which all use the given RX SpectrumModel.
+     *
+     * \param txParams The signal parameters.
+     * \param txMobility The mobility model of the transmitter.
+     * \param txInfo The information about the TX SpectrumModel.
+     * \param rxInfo The information about the RX SpectrumModel.
+     * \param rxPhys The receivers.
+     */
+    void StartTxToRxPhys(Ptr<SpectrumSignalParameters> txParams,
+                         Ptr<MobilityModel> txMobility,
+                         const TxSpectrumModelInfo& txInfo,
+                         const RxSpectrumModelInfo& rxInfo,
+                         const std::vector<Ptr<SpectrumPhy>>& rxPhys);
+
+    /**
+     * Look up the receivers that may be located within MaxRange of the transmitter
+     * in the spatial index. Receivers without mobility model are always returned.
+     *
+     * \param txMobility The mobility model of the transmitter.
+     * \return the receivers that may be within range, sorted by identifier
+     */
+    std::vector<Ptr<SpectrumPhy>> GetRxPhysInRange(Ptr<MobilityModel> txMobility);
+
     /**
      * Data structure holding, for each TX SpectrumModel,  all the
      * converters to any RX SpectrumModel, and all the corresponding
@@ -162,6 +194,12 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * Number of devices connected to the channel.
      */
     std::size_t m_numDevices;
+
+    double m_maxRange;                               //!< max distance to a receiver (m), 0 if none
+    Ptr<SpatialIndex> m_spatialIndex;                //!< spatial index of the RX phys, if any
+    std::map<Ptr<SpectrumPhy>, uint32_t> m_rxPhyIds; //!< identifiers of the RX phys
+    std::vector<Ptr<SpectrumPhy>> m_rxPhysById;      //!< RX phys by identifier
+    std::vector<uint32_t> m_rxPhysToIndex;           //!< RX phys not in the spatial index yet
 };
 
 } // namespace ns3
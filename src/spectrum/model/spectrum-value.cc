@@ -22,6 +22,10 @@
 #include <ns3/math.h>
 #include <ns3/spectrum-value.h>
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 namespace ns3
 {
 
@@ -97,50 +101,66 @@ SpectrumValue::ConstBandsEnd() const
     return m_spectrumModel->End();
 }
 
+/**
+ * Apply an operation to each value of a SpectrumValue and the matching value
+ * of another one. The values are contiguous and the loop has no dependency
+ * between iterations, hence it is vectorized by the compiler for the target
+ * instruction set.
+ *
+ * \param x the values, replaced by the result of the operation
+ * \param y the other operand
+ * \param op the operation, called with a value of \p x and a value of \p y
+ */
+template <typename Op>
+static void
+Transform(Values& x, const Values& y, Op op)
+{
+    NS_ASSERT(x.size() == y.size());
+    double* xv = x.data();
+    const double* yv = y.data();
+    const std::size_t n = x.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        xv[i] = op(xv[i], yv[i]);
+    }
+}
+
+/**
+ * Apply an operation to each value of a SpectrumValue.
+ *
+ * \param x the values, replaced by the result of the operation
+ * \param op the operation, called with a value of \p x
+ */
+template <typename Op>
+static void
+Transform(Values& x, Op op)
+{
+    double* xv = x.data();
+    const std::size_t n = x.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        xv[i] = op(xv[i]);
+    }
+}
+
 void
 SpectrumValue::Add(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
-    NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 += *it2;
-        ++it1;
-        ++it2;
-    }
+    Transform(m_values, x.m_values, [](double a, double b) { return a + b; });
 }
 
 void
 SpectrumValue::Add(double s)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 += s;
-        ++it1;
-    }
+    Transform(m_values, [s](double a) { return a + s; });
 }
 
 void
 SpectrumValue::Subtract(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
-    NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 -= *it2;
-        ++it1;
-        ++it2;
-    }
+    Transform(m_values, x.m_values, [](double a, double b) { return a - b; });
 }
 
 void
@@ -152,72 +172,49 @@ SpectrumValue::Subtract(double s)
 void
 SpectrumValue::Multiply(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
-    NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 *= *it2;
-        ++it1;
-        ++it2;
-    }
+    Transform(m_values, x.m_values, [](double a, double b) { return a * b; });
 }
 
 void
 SpectrumValue::Multiply(double s)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 *= s;
-        ++it1;
-    }
+    Transform(m_values, [s](double a) { return a * s; });
 }
 
 void
 SpectrumValue::Divide(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
-    NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 /= *it2;
-        ++it1;
-        ++it2;
-    }
+    Transform(m_values, x.m_values, [](double a, double b) { return a / b; });
 }
 
 void
 SpectrumValue::Divide(double s)
 {
     NS_LOG_FUNCTION(this << s);
-    Values::iterator it1 = m_values.begin();
+    Transform(m_values, [s](double a) { return a / s; });
+}
 
-    while (it1 != m_values.end())
-    {
-        *it1 /= s;
-        ++it1;
-    }
+void
+SpectrumValue::DivideInto(const SpectrumValue& x)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    Transform(m_values, x.m_values, [](double a, double b) { return b / a; });
 }
 
 void
 SpectrumValue::ChangeSign()
 {
-    Values::iterator it1 = m_values.begin();
+    Transform(m_values, [](double a) { return -a; });
+}
 
-    while (it1 != m_values.end())
-    {
-        *it1 = -(*it1);
-        ++it1;
-    }
+SpectrumValue&
+SpectrumValue::AddScaled(const SpectrumValue& x, double s)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    Transform(m_values, x.m_values, [s](double a, double b) { return a + b * s; });
+    return *this;
 }
 
 void
@@ -256,65 +253,35 @@ void
 SpectrumValue::Pow(double exp)
 {
     NS_LOG_FUNCTION(this << exp);
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = std::pow(*it1, exp);
-        ++it1;
-    }
+    Transform(m_values, [exp](double a) { return std::pow(a, exp); });
 }
 
 void
 SpectrumValue::Exp(double base)
 {
     NS_LOG_FUNCTION(this << base);
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = std::pow(base, *it1);
-        ++it1;
-    }
+    Transform(m_values, [base](double a) { return std::pow(base, a); });
 }
 
 void
 SpectrumValue::Log10()
 {
     NS_LOG_FUNCTION(this);
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = std::log10(*it1);
-        ++it1;
-    }
+    Transform(m_values, [](double a) { return std::log10(a); });
 }
 
 void
 SpectrumValue::Log2()
 {
     NS_LOG_FUNCTION(this);
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = log2(*it1);
-        ++it1;
-    }
+    Transform(m_values, [](double a) { return std::log2(a); });
 }
 
 void
 SpectrumValue::Log()
 {
     NS_LOG_FUNCTION(this);
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = std::log(*it1);
-        ++it1;
-    }
+    Transform(m_values, [](double a) { return std::log(a); });
 }
 
 double
@@ -403,154 +370,164 @@ operator<<(std::ostream& os, const SpectrumValue& pvf)
 }
 
 SpectrumValue
-operator+(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator+(SpectrumValue lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Add(rhs);
-    return res;
+    lhs.Add(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator+(const SpectrumValue& lhs, double rhs)
+operator+(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Add(rhs);
-    return res;
+    rhs.Add(lhs);
+    return std::move(rhs);
 }
 
 SpectrumValue
-operator+(double lhs, const SpectrumValue& rhs)
+operator+(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = rhs;
-    res.Add(lhs);
-    return res;
+    lhs.Add(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator-(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator+(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.ChangeSign();
-    res.Add(lhs);
-    return res;
+    rhs.Add(lhs);
+    return rhs;
 }
 
 SpectrumValue
-operator-(const SpectrumValue& lhs, double rhs)
+operator-(SpectrumValue lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Subtract(rhs);
-    return res;
+    lhs.Subtract(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator-(double lhs, const SpectrumValue& rhs)
+operator-(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
-    SpectrumValue res = rhs;
-    res.Subtract(lhs);
-    return res;
+    rhs.ChangeSign();
+    rhs.Add(lhs);
+    return std::move(rhs);
 }
 
 SpectrumValue
-operator*(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator-(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = lhs;
-    res.Multiply(rhs);
-    return res;
+    lhs.Subtract(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator*(const SpectrumValue& lhs, double rhs)
+operator-(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = lhs;
-    res.Multiply(rhs);
-    return res;
+    rhs.Subtract(lhs);
+    return rhs;
 }
 
 SpectrumValue
-operator*(double lhs, const SpectrumValue& rhs)
+operator*(SpectrumValue lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = rhs;
-    res.Multiply(lhs);
-    return res;
+    lhs.Multiply(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator/(const SpectrumValue& lhs, const SpectrumValue& rhs)
+operator*(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
-    SpectrumValue res = lhs;
-    res.Divide(rhs);
-    return res;
+    rhs.Multiply(lhs);
+    return std::move(rhs);
 }
 
 SpectrumValue
-operator/(const SpectrumValue& lhs, double rhs)
+operator*(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = lhs;
-    res.Divide(rhs);
-    return res;
+    lhs.Multiply(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator/(double lhs, const SpectrumValue& rhs)
+operator*(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.Divide(lhs);
-    return res;
+    rhs.Multiply(lhs);
+    return rhs;
+}
+
+SpectrumValue
+operator/(SpectrumValue lhs, const SpectrumValue& rhs)
+{
+    lhs.Divide(rhs);
+    return lhs;
 }
 
 SpectrumValue
-operator+(const SpectrumValue& rhs)
+operator/(const SpectrumValue& lhs, SpectrumValue&& rhs)
 {
+    rhs.DivideInto(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator/(SpectrumValue lhs, double rhs)
+{
+    lhs.Divide(rhs);
+    return lhs;
+}
+
+SpectrumValue
+operator/(double lhs, SpectrumValue rhs)
+{
+    rhs.Divide(lhs);
     return rhs;
 }
 
 SpectrumValue
-operator-(const SpectrumValue& rhs)
+operator+(SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.ChangeSign();
-    return res;
+    return rhs;
 }
 
 SpectrumValue
-Pow(double lhs, const SpectrumValue& rhs)
+operator-(SpectrumValue rhs)
 {
-    SpectrumValue res = rhs;
-    res.Exp(lhs);
-    return res;
+    rhs.ChangeSign();
+    return rhs;
 }
 
 SpectrumValue
-Pow(const SpectrumValue& lhs, double rhs)
+Pow(double lhs, SpectrumValue rhs)
 {
-    SpectrumValue res = lhs;
-    res.Pow(rhs);
-    return res;
+    rhs.Exp(lhs);
+    return rhs;
 }
 
 SpectrumValue
-Log10(const SpectrumValue& arg)
+Pow(SpectrumValue lhs, double rhs)
 {
-    SpectrumValue res = arg;
-    res.Log10();
-    return res;
+    lhs.Pow(rhs);
+    return lhs;
 }
 
 SpectrumValue
-Log2(const SpectrumValue& arg)
+Log10(SpectrumValue arg)
 {
-    SpectrumValue res = arg;
-    res.Log2();
-    return res;
+    arg.Log10();
+    return arg;
 }
 
 SpectrumValue
-Log(const SpectrumValue& arg)
+Log2(SpectrumValue arg)
 {
-    SpectrumValue res = arg;
-    res.Log();
-    return res;
+    arg.Log2();
+    return arg;
+}
+
+SpectrumValue
+Log(SpectrumValue arg)
+{
+    arg.Log();
+    return arg;
 }
 
 SpectrumValue&
@@ -612,13 +589,7 @@ SpectrumValue::operator/=(double rhs)
 SpectrumValue&
 SpectrumValue::operator=(double rhs)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 = rhs;
-        ++it1;
-    }
+    std::fill(m_values.begin(), m_values.end(), rhs);
     return *this;
 }
 
@@ -55,6 +55,11 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * The operators and functions returning a new SpectrumValue store their
+ * result in the operands which are temporaries, e.g., the intermediate
+ * results of an expression such as <tt>a / (b - c + d)</tt>, rather than
+ * allocating a new SpectrumValue for each operation.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
@@ -173,7 +178,18 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs + rhs
      */
-    friend SpectrumValue operator+(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator+(SpectrumValue lhs, const SpectrumValue& rhs);
+
+    /**
+     * addition operator, storing the result in the temporary Right Hand Side
+     * instead of allocating a new SpectrumValue
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs + rhs
+     */
+    friend SpectrumValue operator+(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      *  addition operator
@@ -183,7 +199,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs + rhs
      */
-    friend SpectrumValue operator+(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator+(SpectrumValue lhs, double rhs);
 
     /**
      *  addition operator
@@ -193,7 +209,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs + rhs
      */
-    friend SpectrumValue operator+(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator+(double lhs, SpectrumValue rhs);
 
     /**
      *  subtraction operator
@@ -203,7 +219,18 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs - rhs
      */
-    friend SpectrumValue operator-(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator-(SpectrumValue lhs, const SpectrumValue& rhs);
+
+    /**
+     * subtraction operator, storing the result in the temporary Right Hand Side
+     * instead of allocating a new SpectrumValue
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs - rhs
+     */
+    friend SpectrumValue operator-(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      *  subtraction operator
@@ -213,7 +240,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs - rhs
      */
-    friend SpectrumValue operator-(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator-(SpectrumValue lhs, double rhs);
 
     /**
      *  subtraction operator
@@ -223,7 +250,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs - rhs
      */
-    friend SpectrumValue operator-(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator-(double lhs, SpectrumValue rhs);
 
     /**
      *  multiplication component-by-component (Schur product)
@@ -233,7 +260,19 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs * rhs
      */
-    friend SpectrumValue operator*(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator*(SpectrumValue lhs, const SpectrumValue& rhs);
+
+    /**
+     * multiplication component-by-component (Schur product), storing the
+     * result in the temporary Right Hand Side instead of allocating a new
+     * SpectrumValue
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs * rhs
+     */
+    friend SpectrumValue operator*(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      *  multiplication by a scalar
@@ -243,7 +282,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs * rhs
      */
-    friend SpectrumValue operator*(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator*(SpectrumValue lhs, double rhs);
 
     /**
      *  multiplication of a scalar
@@ -253,7 +292,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs * rhs
      */
-    friend SpectrumValue operator*(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator*(double lhs, SpectrumValue rhs);
 
     /**
      *  division component-by-component
@@ -263,7 +302,18 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of lhs / rhs
      */
-    friend SpectrumValue operator/(const SpectrumValue& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator/(SpectrumValue lhs, const SpectrumValue& rhs);
+
+    /**
+     * division component-by-component, storing the result in the temporary
+     * Right Hand Side instead of allocating a new SpectrumValue
+     *
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     *
+     * @return the value of lhs / rhs
+     */
+    friend SpectrumValue operator/(const SpectrumValue& lhs, SpectrumValue&& rhs);
 
     /**
      * division by a scalar
@@ -273,7 +323,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of *this / rhs
      */
-    friend SpectrumValue operator/(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue operator/(SpectrumValue lhs, double rhs);
 
     /**
      * division of a scalar
@@ -283,7 +333,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value of *this / rhs
      */
-    friend SpectrumValue operator/(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator/(double lhs, SpectrumValue rhs);
 
     /**
      * unary plus operator
@@ -291,7 +341,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * @param rhs Right Hand Side of the operator
      * @return the value of *this
      */
-    friend SpectrumValue operator+(const SpectrumValue& rhs);
+    friend SpectrumValue operator+(SpectrumValue rhs);
 
     /**
      * unary minus operator
@@ -299,7 +349,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * @param rhs Right Hand Side of the operator
      * @return the value of - *this
      */
-    friend SpectrumValue operator-(const SpectrumValue& rhs);
+    friend SpectrumValue operator-(SpectrumValue rhs);
 
     /**
      * left shift operator
@@ -409,6 +459,18 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     SpectrumValue& operator=(double rhs);
 
+    /**
+     * Add the product of a SpectrumValue and a scalar to *this, component
+     * by component, without allocating a temporary SpectrumValue for the
+     * product
+     *
+     * @param x the SpectrumValue
+     * @param s the scalar
+     *
+     * @return a reference to *this
+     */
+    SpectrumValue& AddScaled(const SpectrumValue& x, double s);
+
     /**
      *
      * @param x the operand
@@ -443,7 +505,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return each value in base raised to the exponent
      */
-    friend SpectrumValue Pow(const SpectrumValue& lhs, double rhs);
+    friend SpectrumValue Pow(SpectrumValue lhs, double rhs);
 
     /**
      *
@@ -452,7 +514,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the value in base raised to each value in the exponent
      */
-    friend SpectrumValue Pow(double lhs, const SpectrumValue& rhs);
+    friend SpectrumValue Pow(double lhs, SpectrumValue rhs);
 
     /**
      *
@@ -461,7 +523,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the logarithm in base 10 of all values in the argument
      */
-    friend SpectrumValue Log10(const SpectrumValue& arg);
+    friend SpectrumValue Log10(SpectrumValue arg);
 
     /**
      *
@@ -470,7 +532,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the logarithm in base 2 of all values in the argument
      */
-    friend SpectrumValue Log2(const SpectrumValue& arg);
+    friend SpectrumValue Log2(SpectrumValue arg);
 
     /**
      *
@@ -479,7 +541,7 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      * @return the logarithm in base e of all values in the argument
      */
-    friend SpectrumValue Log(const SpectrumValue& arg);
+    friend SpectrumValue Log(SpectrumValue arg);
 
     /**
      *
@@ -547,6 +609,12 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * \param s flat value
      */
     void Divide(double s);
+    /**
+     * Divides a SpectrumValue by the current elements (element by element
+     * division), storing the result in the current elements
+     * \param x SpectrumValue
+     */
+    void DivideInto(const SpectrumValue& x);
     /**
      * Change the values sign
      */
@@ -604,11 +672,11 @@ std::ostream& operator<<(std::ostream& os, const SpectrumValue& pvf);
 double Norm(const SpectrumValue& x);
 double Sum(const SpectrumValue& x);
 double Prod(const SpectrumValue& x);
-SpectrumValue Pow(const SpectrumValue& lhs, double rhs);
-SpectrumValue Pow(double lhs, const SpectrumValue& rhs);
-SpectrumValue Log10(const SpectrumValue& arg);
-SpectrumValue Log2(const SpectrumValue& arg);
-SpectrumValue Log(const SpectrumValue& arg);
+SpectrumValue Pow(SpectrumValue lhs, double rhs);
+SpectrumValue Pow(double lhs, SpectrumValue rhs);
+SpectrumValue Log10(SpectrumValue arg);
+SpectrumValue Log2(SpectrumValue arg);
+SpectrumValue Log(SpectrumValue arg);
 double Integral(const SpectrumValue& arg);
 
 } // namespace ns3
@@ -29,10 +29,13 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
+#include <atomic>
 #include <random>
+#include <thread>
 
 namespace ns3
 {
@@ -269,8 +272,8 @@ ThreeGppChannelModel::DoDispose()
     {
         m_channelConditionModel->Dispose();
     }
-    m_channelMatrixMap.clear();
-    m_channelParamsMap.clear();
+    m_channelMatrixCache.Clear();
+    m_channelParamsCache.Clear();
     m_channelConditionModel = nullptr;
 }
 
@@ -306,6 +309,21 @@ ThreeGppChannelModel::GetTypeId()
                           TimeValue(MilliSeconds(0)),
                           MakeTimeAccessor(&ThreeGppChannelModel::m_updatePeriod),
                           MakeTimeChecker())
+            .AddAttribute("Threads",
+                          "The number of threads generating the channel matrices of a batch of "
+                          "links, see GetChannels (0 for one thread per hardware thread)",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::m_threads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxCacheBytes",
+                          "The memory limit, in bytes, of each of the caches of the channel "
+                          "params and of the channel matrices, beyond which the least recently "
+                          "used ones are evicted, and generated again when needed (0 for no "
+                          "limit)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::SetMaxCacheBytes,
+                                               &ThreeGppChannelModel::GetMaxCacheBytes),
+                          MakeUintegerChecker<uint64_t>())
             // attributes for the blockage model
             .AddAttribute("Blockage",
                           "Enable blockage model A (sec 7.6.4.1)",
@@ -1086,6 +1104,66 @@ ThreeGppChannelModel::ChannelMatrixNeedsUpdate(Ptr<const ThreeGppChannelParams>
     return channelParams->m_generatedTime > channelMatrix->m_generatedTime;
 }
 
+void
+ThreeGppChannelModel::SetMaxCacheBytes(uint64_t maxBytes)
+{
+    NS_LOG_FUNCTION(this << maxBytes);
+    m_channelMatrixCache.SetMaxBytes(maxBytes);
+    m_channelParamsCache.SetMaxBytes(maxBytes);
+}
+
+uint64_t
+ThreeGppChannelModel::GetMaxCacheBytes() const
+{
+    return m_channelMatrixCache.GetMaxBytes();
+}
+
+LruCacheStats
+ThreeGppChannelModel::GetCacheStats() const
+{
+    LruCacheStats stats = m_channelMatrixCache.GetStats();
+    stats += m_channelParamsCache.GetStats();
+    return stats;
+}
+
+/**
+ * \param v a vector
+ * \return the memory owned by the vector, in bytes
+ */
+template <class T>
+static std::size_t
+GetVectorBytes(const std::vector<T>& v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+/**
+ * \param v a vector of vectors
+ * \return the memory owned by the vector and by its elements, in bytes
+ */
+template <class T>
+static std::size_t
+GetVectorBytes(const std::vector<std::vector<T>>& v)
+{
+    std::size_t bytes = v.capacity() * sizeof(std::vector<T>);
+    for (const auto& i : v)
+    {
+        bytes += GetVectorBytes(i);
+    }
+    return bytes;
+}
+
+/**
+ * \param channelMatrix a channel matrix
+ * \return the memory owned by the channel matrix, in bytes
+ */
+static std::size_t
+GetChannelMatrixBytes(Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix)
+{
+    return sizeof(MatrixBasedChannelModel::ChannelMatrix) +
+           channelMatrix->m_channel.GetSize() * sizeof(std::complex<double>);
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelMatrix>
 ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
                                  Ptr<const MobilityModel> bMob,
@@ -1094,6 +1172,148 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
 {
     NS_LOG_FUNCTION(this);
 
+    Ptr<const ThreeGppChannelParams> channelParams;
+    Ptr<const ParamsTable> table3gpp;
+    Ptr<ChannelMatrix> channelMatrix =
+        LookupChannel(aMob, bMob, aAntenna, bAntenna, channelParams, table3gpp);
+
+    // If the channel is not present in the map or if it has to be updated
+    // generate a new realization
+    if (!channelMatrix)
+    {
+        // channel matrix not found or has to be updated, generate a new one
+        channelMatrix = GetNewChannel(channelParams, table3gpp, aMob, bMob, aAntenna, bAntenna);
+        channelMatrix->m_antennaPair =
+            std::make_pair(aAntenna->GetId(),
+                           bAntenna->GetId()); // save antenna pair, with the exact order of s and u
+                                               // antennas at the moment of the channel generation
+
+        // store or replace the channel matrix in the channel cache
+        m_channelMatrixCache.Insert(GetKey(aAntenna->GetId(), bAntenna->GetId()),
+                                    channelMatrix,
+                                    GetChannelMatrixBytes(channelMatrix));
+    }
+
+    return channelMatrix;
+}
+
+std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>>
+ThreeGppChannelModel::GetChannels(const std::vector<ChannelLink>& links)
+{
+    NS_LOG_FUNCTION(this << links.size());
+
+    NS_ASSERT_MSG(m_frequency > 0.0, "Set the operating frequency first!");
+
+    // a channel matrix whose coefficients are still to be computed
+    struct NewChannel
+    {
+        Ptr<ChannelMatrix> channelMatrix;               //!< the new channel matrix
+        Ptr<const ThreeGppChannelParams> channelParams; //!< the channel params
+        Ptr<const ParamsTable> table3gpp;               //!< the 3gpp parameters table
+        Vector sPos;                                    //!< the position of node s
+        Vector uPos;                                    //!< the position of node u
+        Ptr<const PhasedArrayModel> sAntenna;           //!< the antenna array of node s
+        Ptr<const PhasedArrayModel> uAntenna;           //!< the antenna array of node u
+    };
+
+    // Look for the channels in the order of the links, as the successive calls
+    // to GetChannel would, and store the new matrices in the cache right away,
+    // so that the links which share them find them there
+    std::vector<Ptr<const ChannelMatrix>> channels;
+    std::vector<NewChannel> newChannels;
+    for (const auto& link : links)
+    {
+        Ptr<const ThreeGppChannelParams> channelParams;
+        Ptr<const ParamsTable> table3gpp;
+        Ptr<ChannelMatrix> channelMatrix = LookupChannel(link.aMob,
+                                                         link.bMob,
+                                                         link.aAntenna,
+                                                         link.bAntenna,
+                                                         channelParams,
+                                                         table3gpp);
+        if (!channelMatrix)
+        {
+            channelMatrix = Create<ChannelMatrix>();
+            channelMatrix->m_generatedTime = Simulator::Now();
+            channelMatrix->m_nodeIds = std::make_pair(link.aMob->GetObject<Node>()->GetId(),
+                                                      link.bMob->GetObject<Node>()->GetId());
+            channelMatrix->m_antennaPair =
+                std::make_pair(link.aAntenna->GetId(), link.bAntenna->GetId());
+            m_channelMatrixCache.Insert(GetKey(link.aAntenna->GetId(), link.bAntenna->GetId()),
+                                        channelMatrix,
+                                        0);
+            newChannels.push_back({channelMatrix,
+                                   channelParams,
+                                   table3gpp,
+                                   link.aMob->GetPosition(),
+                                   link.bMob->GetPosition(),
+                                   link.aAntenna,
+                                   link.bAntenna});
+        }
+        channels.push_back(channelMatrix);
+    }
+
+    uint32_t nThreads = m_threads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<std::size_t>(nThreads, newChannels.size());
+    NS_LOG_DEBUG("Generating " << newChannels.size() << " channel matrices on " << nThreads
+                               << " threads");
+
+    // The reference counts of the objects may not be thread-safe, hence the
+    // threads only use the objects through raw pointers
+    std::atomic<std::size_t> next(0);
+    auto run = [&]() {
+        for (std::size_t i = next++; i < newChannels.size(); i = next++)
+        {
+            const NewChannel& newChannel = newChannels[i];
+            ChannelMatrix* channelMatrix = PeekPointer(newChannel.channelMatrix);
+            const ThreeGppChannelParams* channelParams = PeekPointer(newChannel.channelParams);
+            channelMatrix->m_channel =
+                GenerateChannelCoefficients(*channelParams,
+                                            *PeekPointer(newChannel.table3gpp),
+                                            channelParams->m_nodeIds == channelMatrix->m_nodeIds,
+                                            newChannel.sPos,
+                                            newChannel.uPos,
+                                            *PeekPointer(newChannel.sAntenna),
+                                            *PeekPointer(newChannel.uAntenna));
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(run);
+    }
+    run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // account for the memory of the coefficients of the new matrices
+    for (const auto& newChannel : newChannels)
+    {
+        const auto& antennaPair = newChannel.channelMatrix->m_antennaPair;
+        m_channelMatrixCache.Insert(GetKey(antennaPair.first, antennaPair.second),
+                                    newChannel.channelMatrix,
+                                    GetChannelMatrixBytes(newChannel.channelMatrix));
+    }
+
+    return channels;
+}
+
+Ptr<MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModel::LookupChannel(Ptr<const MobilityModel> aMob,
+                                    Ptr<const MobilityModel> bMob,
+                                    Ptr<const PhasedArrayModel> aAntenna,
+                                    Ptr<const PhasedArrayModel> bAntenna,
+                                    Ptr<const ThreeGppChannelParams>& channelParams,
+                                    Ptr<const ParamsTable>& table3gpp)
+{
+    NS_LOG_FUNCTION(this);
+
     // Compute the channel params key. The key is reciprocal, i.e., key (a, b) = key (b, a)
     uint64_t channelParamsKey =
         GetKey(aMob->GetObject<Node>()->GetId(), bMob->GetObject<Node>()->GetId());
@@ -1107,15 +1327,12 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     // Check if the channel is present in the map and return it, otherwise
     // generate a new channel
     bool updateParams = false;
-    bool updateMatrix = false;
     bool notFoundParams = false;
-    bool notFoundMatrix = false;
-    Ptr<ChannelMatrix> channelMatrix;
-    Ptr<ThreeGppChannelParams> channelParams;
 
-    if (m_channelParamsMap.find(channelParamsKey) != m_channelParamsMap.end())
+    Ptr<ThreeGppChannelParams>* cachedParams = m_channelParamsCache.Find(channelParamsKey);
+    if (cachedParams != nullptr)
     {
-        channelParams = m_channelParamsMap[channelParamsKey];
+        channelParams = *cachedParams;
         // check if it has to be updated
         updateParams = ChannelParamsNeedsUpdate(channelParams, condition);
     }
@@ -1135,7 +1352,7 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     double hBs = std::max(aMob->GetPosition().z, bMob->GetPosition().z);
 
     // get the 3GPP parameters
-    Ptr<const ParamsTable> table3gpp = GetThreeGppTable(condition, hBs, hUt, distance2D);
+    table3gpp = GetThreeGppTable(condition, hBs, hUt, distance2D);
 
     if (notFoundParams || updateParams)
     {
@@ -1147,40 +1364,36 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         // shuffle all the arrays to perform random coupling
         // Step 9: Generate the cross polarization power ratios
         // Step 10: Draw initial phases
-        channelParams = GenerateChannelParameters(condition, table3gpp, aMob, bMob);
-        // store or replace the channel parameters
-        m_channelParamsMap[channelParamsKey] = channelParams;
+        Ptr<ThreeGppChannelParams> newParams =
+            GenerateChannelParameters(condition, table3gpp, aMob, bMob);
+        // store or replace the channel parameters, whose memory is mostly the
+        // one of their vectors
+        std::size_t paramsBytes =
+            sizeof(ThreeGppChannelParams) + GetVectorBytes(newParams->m_delay) +
+            GetVectorBytes(newParams->m_angle) + GetVectorBytes(newParams->m_alpha) +
+            GetVectorBytes(newParams->m_D) + GetVectorBytes(newParams->m_nonSelfBlocking) +
+            GetVectorBytes(newParams->m_norRvAngles) + GetVectorBytes(newParams->m_rayAodRadian) +
+            GetVectorBytes(newParams->m_rayAoaRadian) + GetVectorBytes(newParams->m_rayZodRadian) +
+            GetVectorBytes(newParams->m_rayZoaRadian) + GetVectorBytes(newParams->m_clusterPhase) +
+            GetVectorBytes(newParams->m_crossPolarizationPowerRatios) +
+            GetVectorBytes(newParams->m_clusterPower) + GetVectorBytes(newParams->m_attenuation_dB);
+        m_channelParamsCache.Insert(channelParamsKey, newParams, paramsBytes);
+        channelParams = newParams;
     }
 
-    if (m_channelMatrixMap.find(channelMatrixKey) != m_channelMatrixMap.end())
-    {
-        // channel matrix present in the map
-        NS_LOG_DEBUG("channel matrix present in the map");
-        channelMatrix = m_channelMatrixMap[channelMatrixKey];
-        updateMatrix = ChannelMatrixNeedsUpdate(channelParams, channelMatrix);
-    }
-    else
+    Ptr<ChannelMatrix>* channelMatrix = m_channelMatrixCache.Find(channelMatrixKey);
+    if (channelMatrix == nullptr)
     {
         NS_LOG_DEBUG("channel matrix not found");
-        notFoundMatrix = true;
+        return nullptr;
     }
-
-    // If the channel is not present in the map or if it has to be updated
-    // generate a new realization
-    if (notFoundMatrix || updateMatrix)
+    // channel matrix present in the cache
+    NS_LOG_DEBUG("channel matrix present in the cache");
+    if (ChannelMatrixNeedsUpdate(channelParams, *channelMatrix))
     {
-        // channel matrix not found or has to be updated, generate a new one
-        channelMatrix = GetNewChannel(channelParams, table3gpp, aMob, bMob, aAntenna, bAntenna);
-        channelMatrix->m_antennaPair =
-            std::make_pair(aAntenna->GetId(),
-                           bAntenna->GetId()); // save antenna pair, with the exact order of s and u
-                                               // antennas at the moment of the channel generation
-
-        // store or replace the channel matrix in the channel map
-        m_channelMatrixMap[channelMatrixKey] = channelMatrix;
+        return nullptr;
     }
-
-    return channelMatrix;
+    return *channelMatrix;
 }
 
 Ptr<const MatrixBasedChannelModel::ChannelParams>
@@ -1192,9 +1405,10 @@ ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const Mobilit
     uint64_t channelParamsKey =
         GetKey(aMob->GetObject<Node>()->GetId(), bMob->GetObject<Node>()->GetId());
 
-    if (m_channelParamsMap.find(channelParamsKey) != m_channelParamsMap.end())
+    const Ptr<ThreeGppChannelParams>* channelParams = m_channelParamsCache.Peek(channelParamsKey);
+    if (channelParams != nullptr)
     {
-        return m_channelParamsMap.find(channelParamsKey)->second;
+        return *channelParams;
     }
     else
     {
@@ -1842,117 +2056,161 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::Double2DVector rayAodRadian;
-    MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-    MatrixBasedChannelModel::Double2DVector rayZodRadian;
-    MatrixBasedChannelModel::Double2DVector rayZoaRadian;
+    // Step 11 and 12: Generate channel coefficients for each cluster n and each receiver
+    // and transmitter element pair u,s, and apply the LOS ray.
+    Complex3DVector hUsn = GenerateChannelCoefficients(*channelParams,
+                                                       *table3gpp,
+                                                       isSameDirection,
+                                                       sMob->GetPosition(),
+                                                       uMob->GetPosition(),
+                                                       *sAntenna,
+                                                       *uAntenna);
+
+    NS_LOG_DEBUG("Husn (sAntenna, uAntenna):" << sAntenna->GetId() << ", " << uAntenna->GetId());
+    for (size_t cIndex = 0; cIndex < hUsn.GetNumPages(); cIndex++)
+    {
+        for (size_t rowIdx = 0; rowIdx < hUsn.GetNumRows(); rowIdx++)
+        {
+            for (size_t colIdx = 0; colIdx < hUsn.GetNumCols(); colIdx++)
+            {
+                NS_LOG_DEBUG(" " << hUsn(rowIdx, colIdx, cIndex) << ",");
+            }
+        }
+    }
+
+    NS_LOG_INFO("size of coefficient matrix (rows, columns, clusters) = ("
+                << hUsn.GetNumRows() << ", " << hUsn.GetNumCols() << ", " << hUsn.GetNumPages()
+                << ")");
+    channelMatrix->m_channel = hUsn;
+    return channelMatrix;
+}
+
+MatrixBasedChannelModel::Complex3DVector
+ThreeGppChannelModel::GenerateChannelCoefficients(const ThreeGppChannelParams& channelParams,
+                                                  const ParamsTable& table3gpp,
+                                                  bool isSameDirection,
+                                                  const Vector& sPos,
+                                                  const Vector& uPos,
+                                                  const PhasedArrayModel& sAntenna,
+                                                  const PhasedArrayModel& uAntenna) const
+{
+    // NOTE: this method is called by several threads at once by GetChannels,
+    // hence it must not log, draw random numbers or change the model
 
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        rayAodRadian = channelParams->m_rayAodRadian;
-        rayAoaRadian = channelParams->m_rayAoaRadian;
-        rayZodRadian = channelParams->m_rayZodRadian;
-        rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-    else
-    {
-        rayAodRadian = channelParams->m_rayAoaRadian;
-        rayAoaRadian = channelParams->m_rayAodRadian;
-        rayZodRadian = channelParams->m_rayZoaRadian;
-        rayZoaRadian = channelParams->m_rayZodRadian;
-    }
+    const Double2DVector& rayAodRadian =
+        isSameDirection ? channelParams.m_rayAodRadian : channelParams.m_rayAoaRadian;
+    const Double2DVector& rayAoaRadian =
+        isSameDirection ? channelParams.m_rayAoaRadian : channelParams.m_rayAodRadian;
+    const Double2DVector& rayZodRadian =
+        isSameDirection ? channelParams.m_rayZodRadian : channelParams.m_rayZoaRadian;
+    const Double2DVector& rayZoaRadian =
+        isSameDirection ? channelParams.m_rayZoaRadian : channelParams.m_rayZodRadian;
 
     // Step 11: Generate channel coefficients for each cluster n and each receiver
     //  and transmitter element pair u,s.
     // where n is cluster index, u and s are receive and transmit antenna element.
-    size_t uSize = uAntenna->GetNumberOfElements();
-    size_t sSize = sAntenna->GetNumberOfElements();
+    size_t uSize = uAntenna.GetNumberOfElements();
+    size_t sSize = sAntenna.GetNumberOfElements();
+    uint8_t numReducedCluster = channelParams.m_reducedClusterNumber;
+    uint8_t raysPerCluster = table3gpp.m_raysPerCluster;
 
     // NOTE: Since each of the strongest 2 clusters are divided into 3 sub-clusters,
     // the total cluster will generally be numReducedCLuster + 4.
     // However, it might be that m_cluster1st = m_cluster2nd. In this case the
     // total number of clusters will be numReducedCLuster + 2.
-    uint16_t numOverallCluster = (channelParams->m_cluster1st != channelParams->m_cluster2nd)
-                                     ? channelParams->m_reducedClusterNumber + 4
-                                     : channelParams->m_reducedClusterNumber + 2;
+    uint16_t numOverallCluster = (channelParams.m_cluster1st != channelParams.m_cluster2nd)
+                                     ? numReducedCluster + 4
+                                     : numReducedCluster + 2;
     Complex3DVector hUsn(uSize, sSize, numOverallCluster); // channel coefficient hUsn (u, s, n);
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <=
-              channelParams->m_crossPolarizationPowerRatios.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayZoaRadian.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayZodRadian.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayAoaRadian.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayAodRadian.size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <=
-              channelParams->m_crossPolarizationPowerRatios[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayZoaRadian[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayZodRadian[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayAoaRadian[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayAodRadian[0].size());
-
-    double x = sMob->GetPosition().x - uMob->GetPosition().x;
-    double y = sMob->GetPosition().y - uMob->GetPosition().y;
+    NS_ASSERT(numReducedCluster <= channelParams.m_clusterPhase.size());
+    NS_ASSERT(numReducedCluster <= channelParams.m_clusterPower.size());
+    NS_ASSERT(numReducedCluster <= channelParams.m_crossPolarizationPowerRatios.size());
+    NS_ASSERT(numReducedCluster <= rayZoaRadian.size());
+    NS_ASSERT(numReducedCluster <= rayZodRadian.size());
+    NS_ASSERT(numReducedCluster <= rayAoaRadian.size());
+    NS_ASSERT(numReducedCluster <= rayAodRadian.size());
+    NS_ASSERT(raysPerCluster <= channelParams.m_clusterPhase[0].size());
+    NS_ASSERT(raysPerCluster <= channelParams.m_crossPolarizationPowerRatios[0].size());
+    NS_ASSERT(raysPerCluster <= rayZoaRadian[0].size());
+    NS_ASSERT(raysPerCluster <= rayZodRadian[0].size());
+    NS_ASSERT(raysPerCluster <= rayAoaRadian[0].size());
+    NS_ASSERT(raysPerCluster <= rayAodRadian[0].size());
+
+    double x = sPos.x - uPos.x;
+    double y = sPos.y - uPos.y;
     double distance2D = sqrt(x * x + y * y);
     // NOTE we assume hUT = min (height(a), height(b)) and
     // hBS = max (height (a), height (b))
-    double hUt = std::min(sMob->GetPosition().z, uMob->GetPosition().z);
-    double hBs = std::max(sMob->GetPosition().z, uMob->GetPosition().z);
+    double hUt = std::min(sPos.z, uPos.z);
+    double hBs = std::max(sPos.z, uPos.z);
     // compute the 3D distance using eq. 7.4-1
     double distance3D = std::sqrt(distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
 
-    Angles sAngle(uMob->GetPosition(), sMob->GetPosition());
-    Angles uAngle(sMob->GetPosition(), uMob->GetPosition());
-
-    Complex2DVector raysPreComp(channelParams->m_reducedClusterNumber,
-                                table3gpp->m_raysPerCluster); // stores part of the ray expression,
-    // cached as independent from the u- and s-indexes
-    Double2DVector sinCosA; // cached multiplications of sin and cos of the ZoA and AoA angles
-    Double2DVector sinSinA; // cached multiplications of sines of the ZoA and AoA angles
-    Double2DVector cosZoA;  // cached cos of the ZoA angle
-    Double2DVector sinCosD; // cached multiplications of sin and cos of the ZoD and AoD angles
-    Double2DVector sinSinD; // cached multiplications of the cosines of the ZoA and AoA angles
-    Double2DVector cosZoD;  // cached cos of the ZoD angle
-
-    // resize to appropriate dimensions
-    sinCosA.resize(channelParams->m_reducedClusterNumber);
-    sinSinA.resize(channelParams->m_reducedClusterNumber);
-    cosZoA.resize(channelParams->m_reducedClusterNumber);
-    sinCosD.resize(channelParams->m_reducedClusterNumber);
-    sinSinD.resize(channelParams->m_reducedClusterNumber);
-    cosZoD.resize(channelParams->m_reducedClusterNumber);
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
-    {
-        sinCosA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinA[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinCosD[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinD[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoD[nIndex].resize(table3gpp->m_raysPerCluster);
-    }
-    // pre-compute the terms which are independent from uIndex and sIndex
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
-    {
-        for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+    Angles sAngle(uPos, sPos);
+    Angles uAngle(sPos, uPos);
+
+    // The locations of the elements, as structures of arrays
+    std::vector<double> uLocX(uSize);
+    std::vector<double> uLocY(uSize);
+    std::vector<double> uLocZ(uSize);
+    for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+        Vector uLoc = uAntenna.GetElementLocation(uIndex);
+        uLocX[uIndex] = uLoc.x;
+        uLocY[uIndex] = uLoc.y;
+        uLocZ[uIndex] = uLoc.z;
+    }
+    std::vector<double> sLocX(sSize);
+    std::vector<double> sLocY(sSize);
+    std::vector<double> sLocZ(sSize);
+    for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+        Vector sLoc = sAntenna.GetElementLocation(sIndex);
+        sLocX[sIndex] = sLoc.x;
+        sLocY[sIndex] = sLoc.y;
+        sLocZ[sIndex] = sLoc.z;
+    }
+
+    // The rays of a cluster m contribute
+    //   raysPreComp(n, m) * exp(j * rxPhaseDiff(n, m, u)) * exp(j * txPhaseDiff(n, m, s))
+    // to the coefficient (u, s, n). The phasors of the receiving elements,
+    // multiplied by raysPreComp, and those of the transmitting elements are
+    // stored with the real and imaginary parts apart, indexed by
+    // mIndex * size + element, so that the coefficients of all the receiving
+    // elements are accumulated at once for each transmitting element.
+    std::vector<double> rxRe(raysPerCluster * uSize);
+    std::vector<double> rxIm(raysPerCluster * uSize);
+    std::vector<double> txRe(raysPerCluster * sSize);
+    std::vector<double> txIm(raysPerCluster * sSize);
+    // accumulators of the coefficients of the 3 sub-clusters
+    std::vector<double> accRe(3 * uSize);
+    std::vector<double> accIm(3 * uSize);
+    std::vector<uint8_t> subCluster(raysPerCluster, 0);
+
+    // The following for loops computes the channel coefficients
+    // Keeps track of how many sub-clusters have been added up to now
+    uint8_t numSubClustersAdded = 0;
+    for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
+    {
+        for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
         {
-            DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+            DoubleVector initialPhase = channelParams.m_clusterPhase[nIndex][mIndex];
             NS_ASSERT(4 <= initialPhase.size());
-            double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+            double k = channelParams.m_crossPolarizationPowerRatios[nIndex][mIndex];
 
-            // cache the component of the "rays" terms which depend on the random angle of arrivals
+            // the component of the "rays" terms which depend on the random angle of arrivals
             // and departures and initial phases only
-            auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                Angles(channelParams->m_rayAoaRadian[nIndex][mIndex],
-                       channelParams->m_rayZoaRadian[nIndex][mIndex]));
-            auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                Angles(channelParams->m_rayAodRadian[nIndex][mIndex],
-                       channelParams->m_rayZodRadian[nIndex][mIndex]));
-            raysPreComp(nIndex, mIndex) =
+            auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna.GetElementFieldPattern(
+                Angles(channelParams.m_rayAoaRadian[nIndex][mIndex],
+                       channelParams.m_rayZoaRadian[nIndex][mIndex]));
+            auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna.GetElementFieldPattern(
+                Angles(channelParams.m_rayAodRadian[nIndex][mIndex],
+                       channelParams.m_rayZodRadian[nIndex][mIndex]));
+            std::complex<double> raysPreComp =
                 std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
                     rxFieldPatternTheta * txFieldPatternTheta +
                 std::complex<double>(cos(initialPhase[1]), sin(initialPhase[1])) *
@@ -1962,136 +2220,128 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
                 std::complex<double>(cos(initialPhase[3]), sin(initialPhase[3])) *
                     rxFieldPatternPhi * txFieldPatternPhi;
 
-            // cache the component of the "rxPhaseDiff" terms which depend on the random angle of
+            // the component of the "rxPhaseDiff" terms which depend on the random angle of
             // arrivals only
             double sinRayZoa = sin(rayZoaRadian[nIndex][mIndex]);
             double sinRayAoa = cos(rayAoaRadian[nIndex][mIndex]);
             double cosRayAoa = cos(rayAoaRadian[nIndex][mIndex]);
-            sinCosA[nIndex][mIndex] = sinRayZoa * cosRayAoa;
-            sinSinA[nIndex][mIndex] = sinRayZoa * sinRayAoa;
-            cosZoA[nIndex][mIndex] = cos(rayZoaRadian[nIndex][mIndex]);
+            double sinCosA = sinRayZoa * cosRayAoa;
+            double sinSinA = sinRayZoa * sinRayAoa;
+            double cosZoA = cos(rayZoaRadian[nIndex][mIndex]);
 
-            // cache the component of the "txPhaseDiff" terms which depend on the random angle of
+            // the component of the "txPhaseDiff" terms which depend on the random angle of
             // departure only
             double sinRayZod = sin(rayZodRadian[nIndex][mIndex]);
             double sinRayAod = cos(rayAodRadian[nIndex][mIndex]);
             double cosRayAod = cos(rayAodRadian[nIndex][mIndex]);
-            sinCosD[nIndex][mIndex] = sinRayZod * cosRayAod;
-            sinSinD[nIndex][mIndex] = sinRayZod * sinRayAod;
-            cosZoD[nIndex][mIndex] = cos(rayZodRadian[nIndex][mIndex]);
+            double sinCosD = sinRayZod * cosRayAod;
+            double sinSinD = sinRayZod * sinRayAod;
+            double cosZoD = cos(rayZodRadian[nIndex][mIndex]);
+
+            // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+            for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+            {
+                double rxPhaseDiff =
+                    2 * M_PI *
+                    (sinCosA * uLocX[uIndex] + sinSinA * uLocY[uIndex] + cosZoA * uLocZ[uIndex]);
+                std::complex<double> rx =
+                    raysPreComp * std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
+                rxRe[mIndex * uSize + uIndex] = rx.real();
+                rxIm[mIndex * uSize + uIndex] = rx.imag();
+            }
+            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+            {
+                double txPhaseDiff =
+                    2 * M_PI *
+                    (sinCosD * sLocX[sIndex] + sinSinD * sLocY[sIndex] + cosZoD * sLocZ[sIndex]);
+                txRe[mIndex * sSize + sIndex] = cos(txPhaseDiff);
+                txIm[mIndex * sSize + sIndex] = sin(txPhaseDiff);
+            }
         }
-    }
 
-    // The following for loops computes the channel coefficients
-    // Keeps track of how many sub-clusters have been added up to now
-    uint8_t numSubClustersAdded = 0;
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
-    {
-        for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+        // Compute the N-2 weakest cluster, assuming 0 slant angle and a
+        // polarization slant angle configured in the array (7.5-22), or the
+        // 3 sub-clusters of the 2 strongest clusters (7.5-28)
+        bool isStrongest =
+            (nIndex == channelParams.m_cluster1st || nIndex == channelParams.m_cluster2nd);
+        if (isStrongest)
+        {
+            // ZML:Just remind me that the angle offsets for the 3 subclusters were not
+            // generated correctly.
+            for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+            {
+                switch (mIndex)
+                {
+                case 9:
+                case 10:
+                case 11:
+                case 12:
+                case 17:
+                case 18:
+                    subCluster[mIndex] = 1;
+                    break;
+                case 13:
+                case 14:
+                case 15:
+                case 16:
+                    subCluster[mIndex] = 2;
+                    break;
+                default: // case 1,2,3,4,5,6,7,8,19,20
+                    subCluster[mIndex] = 0;
+                    break;
+                }
+            }
+        }
+        else
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            std::fill(subCluster.begin(), subCluster.end(), 0);
+        }
+        uint8_t numSubClusters = isStrongest ? 3 : 1;
+        double clusterAmplitude =
+            sqrt(channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
 
-            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            std::fill(accRe.begin(), accRe.end(), 0);
+            std::fill(accIm.begin(), accIm.end(), 0);
+            for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                // Compute the N-2 weakest cluster, assuming 0 slant angle and a
-                // polarization slant angle configured in the array (7.5-22)
-                if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+                // NOTE Doppler is computed in the CalcBeamformingGain function and is
+                // simplified to only account for the center angle of each cluster.
+                const double tRe = txRe[mIndex * sSize + sIndex];
+                const double tIm = txIm[mIndex * sSize + sIndex];
+                const double* rRe = &rxRe[mIndex * uSize];
+                const double* rIm = &rxIm[mIndex * uSize];
+                double* aRe = &accRe[subCluster[mIndex] * uSize];
+                double* aIm = &accIm[subCluster[mIndex] * uSize];
+                for (size_t uIndex = 0; uIndex < uSize; uIndex++)
                 {
-                    std::complex<double> rays(0, 0);
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        // NOTE Doppler is computed in the CalcBeamformingGain function and is
-                        // simplified to only account for the center angle of each cluster.
-                        rays += raysPreComp(nIndex, mIndex) *
-                                std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                                std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-                    }
-                    rays *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = rays;
+                    aRe[uIndex] += rRe[uIndex] * tRe - rIm[uIndex] * tIm;
+                    aIm[uIndex] += rRe[uIndex] * tIm + rIm[uIndex] * tRe;
                 }
-                else //(7.5-28)
+            }
+            for (uint8_t sub = 0; sub < numSubClusters; sub++)
+            {
+                // the first sub-cluster replaces the cluster, the other two are
+                // appended after the reduced clusters
+                size_t page =
+                    (sub == 0) ? nIndex : numReducedCluster + numSubClustersAdded + sub - 1;
+                for (size_t uIndex = 0; uIndex < uSize; uIndex++)
                 {
-                    std::complex<double> raysSub1(0, 0);
-                    std::complex<double> raysSub2(0, 0);
-                    std::complex<double> raysSub3(0, 0);
-
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                        // ZML:Just remind me that the angle offsets for the 3 subclusters were not
-                        // generated correctly.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        std::complex<double> raySub =
-                            raysPreComp(nIndex, mIndex) *
-                            std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                            std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                        switch (mIndex)
-                        {
-                        case 9:
-                        case 10:
-                        case 11:
-                        case 12:
-                        case 17:
-                        case 18:
-                            raysSub2 += raySub;
-                            break;
-                        case 13:
-                        case 14:
-                        case 15:
-                        case 16:
-                            raysSub3 += raySub;
-                            break;
-                        default: // case 1,2,3,4,5,6,7,8,19,20
-                            raysSub1 += raySub;
-                            break;
-                        }
-                    }
-                    raysSub1 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub2 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub3 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = raysSub1;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded) = raysSub2;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded + 1) =
-                        raysSub3;
+                    hUsn(uIndex, sIndex, page) =
+                        std::complex<double>(accRe[sub * uSize + uIndex],
+                                             accIm[sub * uSize + uIndex]) *
+                        clusterAmplitude;
                 }
             }
         }
-        if (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd)
+        if (isStrongest)
         {
             numSubClustersAdded += 2;
         }
     }
 
-    if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+    if (channelParams.m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
     {
         double lambda = 3.0e8 / m_frequency; // the wavelength of the carrier frequency
         std::complex<double> phaseDiffDueToDistance(cos(-2 * M_PI * distance3D / lambda),
@@ -2106,66 +2356,57 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
         const double sinSAngleAz = sin(sAngle.GetAzimuth());
         const double cosSAngleAz = cos(sAngle.GetAzimuth());
 
+        auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna.GetElementFieldPattern(
+            Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
+        auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna.GetElementFieldPattern(
+            Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
+        std::complex<double> losPreComp =
+            (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi) *
+            phaseDiffDueToDistance;
+
+        // the LOS ray at the receiving elements, as the rays of the clusters
+        std::vector<std::complex<double>> losRx(uSize);
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
             double rxPhaseDiff = 2 * M_PI *
-                                 (sinUAngleIncl * cosUAngleAz * uLoc.x +
-                                  sinUAngleIncl * sinUAngleAz * uLoc.y + cosUAngleIncl * uLoc.z);
+                                 (sinUAngleIncl * cosUAngleAz * uLocX[uIndex] +
+                                  sinUAngleIncl * sinUAngleAz * uLocY[uIndex] +
+                                  cosUAngleIncl * uLocZ[uIndex]);
+            losRx[uIndex] = losPreComp * std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
+        }
 
-            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        double kLinear = pow(10, channelParams.m_K_factor / 10.0);
+        // the LOS path should be attenuated if blockage is enabled.
+        double attenuation = pow(10, channelParams.m_attenuation_dB[0] / 10.0);
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            double txPhaseDiff = 2 * M_PI *
+                                 (sinSAngleIncl * cosSAngleAz * sLocX[sIndex] +
+                                  sinSAngleIncl * sinSAngleAz * sLocY[sIndex] +
+                                  cosSAngleIncl * sLocZ[sIndex]);
+            std::complex<double> tx(cos(txPhaseDiff), sin(txPhaseDiff));
+            for (size_t uIndex = 0; uIndex < uSize; uIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                std::complex<double> ray(0, 0);
-                double txPhaseDiff =
-                    2 * M_PI *
-                    (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
-                     cosSAngleIncl * sLoc.z);
-
-                auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                    Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
-                auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                    Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
-
-                ray = (rxFieldPatternTheta * txFieldPatternTheta -
-                       rxFieldPatternPhi * txFieldPatternPhi) *
-                      phaseDiffDueToDistance *
-                      std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                      std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                double kLinear = pow(10, channelParams->m_K_factor / 10.0);
-                // the LOS path should be attenuated if blockage is enabled.
+                std::complex<double> ray = losRx[uIndex] * tx;
                 hUsn(uIndex, sIndex, 0) =
                     sqrt(1.0 / (kLinear + 1)) * hUsn(uIndex, sIndex, 0) +
-                    sqrt(kLinear / (1 + kLinear)) * ray /
-                        pow(10,
-                            channelParams->m_attenuation_dB[0] / 10.0); //(7.5-30) for tau = tau1
-                for (size_t nIndex = 1; nIndex < hUsn.GetNumPages(); nIndex++)
-                {
-                    hUsn(uIndex, sIndex, nIndex) *=
-                        sqrt(1.0 / (kLinear + 1)); //(7.5-30) for tau = tau2...tauN
-                }
+                    sqrt(kLinear / (1 + kLinear)) * ray / attenuation; //(7.5-30) for tau = tau1
             }
         }
-    }
-
-    NS_LOG_DEBUG("Husn (sAntenna, uAntenna):" << sAntenna->GetId() << ", " << uAntenna->GetId());
-    for (size_t cIndex = 0; cIndex < hUsn.GetNumPages(); cIndex++)
-    {
-        for (size_t rowIdx = 0; rowIdx < hUsn.GetNumRows(); rowIdx++)
+        for (size_t nIndex = 1; nIndex < hUsn.GetNumPages(); nIndex++)
         {
-            for (size_t colIdx = 0; colIdx < hUsn.GetNumCols(); colIdx++)
+            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                NS_LOG_DEBUG(" " << hUsn(rowIdx, colIdx, cIndex) << ",");
+                for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+                {
+                    hUsn(uIndex, sIndex, nIndex) *=
+                        sqrt(1.0 / (kLinear + 1)); //(7.5-30) for tau = tau2...tauN
+                }
             }
         }
     }
 
-    NS_LOG_INFO("size of coefficient matrix (rows, columns, clusters) = ("
-                << hUsn.GetNumRows() << ", " << hUsn.GetNumCols() << ", " << hUsn.GetNumPages()
-                << ")");
-    channelMatrix->m_channel = hUsn;
-    return channelMatrix;
+    return hUsn;
 }
 
 std::pair<double, double>
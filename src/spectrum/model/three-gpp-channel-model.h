@@ -24,10 +24,10 @@
 #include "ns3/angles.h"
 #include <ns3/boolean.h>
 #include <ns3/channel-condition-model.h>
+#include <ns3/lru-cache.h>
 #include <ns3/matrix-based-channel-model.h>
 
 #include <complex.h>
-#include <unordered_map>
 
 namespace ns3
 {
@@ -101,10 +101,10 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     std::string GetScenario() const;
 
     /**
-     * Looks for the channel matrix associated to the aMob and bMob pair in m_channelMatrixMap.
+     * Looks for the channel matrix associated to the aMob and bMob pair in m_channelMatrixCache.
      * If found, it checks if it has to be updated. If not found or if it has to
      * be updated, it generates a new uncorrelated channel matrix using the
-     * method GetNewChannel and updates m_channelMap.
+     * method GetNewChannel and updates m_channelMatrixCache.
      *
      * \param aMob mobility model of the a device
      * \param bMob mobility model of the b device
@@ -117,9 +117,36 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                                         Ptr<const PhasedArrayModel> aAntenna,
                                         Ptr<const PhasedArrayModel> bAntenna) override;
 
+    /**
+     * The devices of a link, see GetChannels
+     */
+    struct ChannelLink
+    {
+        Ptr<const MobilityModel> aMob;        //!< mobility model of the a device
+        Ptr<const MobilityModel> bMob;        //!< mobility model of the b device
+        Ptr<const PhasedArrayModel> aAntenna; //!< antenna of the a device
+        Ptr<const PhasedArrayModel> bAntenna; //!< antenna of the b device
+    };
+
+    /**
+     * Returns the channel matrices of a batch of links, as GetChannel would
+     * for each link in turn.
+     *
+     * The channel parameters are drawn in the order of the links, hence the
+     * random numbers and the matrices are those of the successive calls to
+     * GetChannel, but the coefficients of the new matrices are then computed
+     * on the number of threads given by the Threads attribute. The
+     * coefficients are computed by GenerateChannelCoefficients, which
+     * GetNewChannel calls for a single link.
+     *
+     * \param links the links
+     * \return the channel matrices of the links, in the same order
+     */
+    std::vector<Ptr<const ChannelMatrix>> GetChannels(const std::vector<ChannelLink>& links);
+
     /**
      * Looks for the channel params associated to the aMob and bMob pair in
-     * m_channelParamsMap. If not found it will return a nullptr.
+     * m_channelParamsCache. If not found it will return a nullptr.
      *
      * \param aMob mobility model of the a device
      * \param bMob mobility model of the b device
@@ -136,6 +163,12 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      */
     int64_t AssignStreams(int64_t stream);
 
+    /**
+     * \return the statistics of the caches of the channel params and of the
+     * channel matrices, added together
+     */
+    LruCacheStats GetCacheStats() const;
+
   protected:
     /**
      * Wrap an (azimuth, inclination) angle pair in a valid range.
@@ -303,6 +336,57 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                                              const Ptr<const MobilityModel> uMob,
                                              Ptr<const PhasedArrayModel> sAntenna,
                                              Ptr<const PhasedArrayModel> uAntenna) const;
+
+    /**
+     * Compute the channel coefficients hUsn of the clusters and of the LOS
+     * ray (steps 11 and 12 of 3GPP TR 38.901) between the antenna arrays
+     * sAntenna and uAntenna.
+     *
+     * The phase of a ray at an element is the sum of a term of the receiving
+     * element and of a term of the transmitting element, hence the phasors
+     * of the rays are computed for each element of each array, in arrays
+     * indexed by ray and element, and the coefficients are then accumulated
+     * over contiguous elements without any trigonometric function. The
+     * method draws no random number and does not change the model, hence it
+     * can be called on several threads at once.
+     *
+     * \param channelParams the channel parameters of the pair of nodes
+     * \param table3gpp the 3gpp parameters table
+     * \param isSameDirection whether the channel parameters were generated
+     *        from node s to node u
+     * \param sPos the position of node s
+     * \param uPos the position of node u
+     * \param sAntenna the antenna array of node s
+     * \param uAntenna the antenna array of node u
+     * \return the channel coefficients hUsn (u, s, n)
+     */
+    Complex3DVector GenerateChannelCoefficients(const ThreeGppChannelParams& channelParams,
+                                                const ParamsTable& table3gpp,
+                                                bool isSameDirection,
+                                                const Vector& sPos,
+                                                const Vector& uPos,
+                                                const PhasedArrayModel& sAntenna,
+                                                const PhasedArrayModel& uAntenna) const;
+
+    /**
+     * Looks for an up-to-date channel matrix of the antenna arrays aAntenna and
+     * bAntenna in m_channelMatrixCache, generating or updating the channel
+     * params of the nodes in m_channelParamsCache first.
+     *
+     * \param aMob mobility model of the a device
+     * \param bMob mobility model of the b device
+     * \param aAntenna antenna of the a device
+     * \param bAntenna antenna of the b device
+     * \param [out] channelParams the channel params of the nodes
+     * \param [out] table3gpp the 3gpp parameters table of the link
+     * \return the channel matrix, or nullptr if a new one has to be generated
+     */
+    Ptr<ChannelMatrix> LookupChannel(Ptr<const MobilityModel> aMob,
+                                     Ptr<const MobilityModel> bMob,
+                                     Ptr<const PhasedArrayModel> aAntenna,
+                                     Ptr<const PhasedArrayModel> bAntenna,
+                                     Ptr<const ThreeGppChannelParams>& channelParams,
+                                     Ptr<const ParamsTable>& table3gpp);
     /**
      * Applies the blockage model A described in 3GPP TR 38.901
      * \param channelParams the channel parameters structure
@@ -334,15 +418,29 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     bool ChannelMatrixNeedsUpdate(Ptr<const ThreeGppChannelParams> channelParams,
                                   Ptr<const ChannelMatrix> channelMatrix);
 
-    std::unordered_map<uint64_t, Ptr<ChannelMatrix>>
-        m_channelMatrixMap; //!< map containing the channel realizations per pair of
-                            //!< PhasedAntennaArray instances, the key of this map is reciprocal
-                            //!< uniquely identifies a pair of PhasedAntennaArrays
-    std::unordered_map<uint64_t, Ptr<ThreeGppChannelParams>>
-        m_channelParamsMap; //!< map containing the common channel parameters per pair of nodes, the
-                            //!< key of this map is reciprocal and uniquely identifies a pair of
-                            //!< nodes
+    /**
+     * Set the memory limit of each of the caches of the channel params and of
+     * the channel matrices
+     * \param maxBytes the memory limit, in bytes, or 0 for no limit
+     */
+    void SetMaxCacheBytes(uint64_t maxBytes);
+
+    /**
+     * \return the memory limit of each of the caches of the channel params and
+     * of the channel matrices, in bytes
+     */
+    uint64_t GetMaxCacheBytes() const;
+
+    LruCache<uint64_t, Ptr<ChannelMatrix>>
+        m_channelMatrixCache; //!< cache containing the channel realizations per pair of
+                              //!< PhasedAntennaArray instances, the key of this cache is
+                              //!< reciprocal and uniquely identifies a pair of PhasedAntennaArrays
+    LruCache<uint64_t, Ptr<ThreeGppChannelParams>>
+        m_channelParamsCache; //!< cache containing the common channel parameters per pair of
+                              //!< nodes, the key of this cache is reciprocal and uniquely
+                              //!< identifies a pair of nodes
     Time m_updatePeriod;    //!< the channel update period
+    uint32_t m_threads;     //!< the number of threads of GetChannels
     double m_frequency;     //!< the operating frequency
     std::string m_scenario; //!< the 3GPP scenario
     Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
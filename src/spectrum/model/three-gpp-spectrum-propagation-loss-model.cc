@@ -31,6 +31,7 @@
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 #include <map>
 
@@ -54,7 +55,7 @@ ThreeGppSpectrumPropagationLossModel::~ThreeGppSpectrumPropagationLossModel()
 void
 ThreeGppSpectrumPropagationLossModel::DoDispose()
 {
-    m_longTermMap.clear();
+    m_longTermCache.Clear();
     m_channelModel->Dispose();
     m_channelModel = nullptr;
 }
@@ -73,7 +74,16 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId()
                 StringValue("ns3::ThreeGppChannelModel"),
                 MakePointerAccessor(&ThreeGppSpectrumPropagationLossModel::SetChannelModel,
                                     &ThreeGppSpectrumPropagationLossModel::GetChannelModel),
-                MakePointerChecker<MatrixBasedChannelModel>());
+                MakePointerChecker<MatrixBasedChannelModel>())
+            .AddAttribute("MaxCacheBytes",
+                          "The memory limit, in bytes, of the cache of the long term components, "
+                          "beyond which the least recently used ones are evicted and computed "
+                          "again when needed (0 for no limit)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(
+                              &ThreeGppSpectrumPropagationLossModel::SetMaxCacheBytes,
+                              &ThreeGppSpectrumPropagationLossModel::GetMaxCacheBytes),
+                          MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -89,6 +99,24 @@ ThreeGppSpectrumPropagationLossModel::GetChannelModel() const
     return m_channelModel;
 }
 
+void
+ThreeGppSpectrumPropagationLossModel::SetMaxCacheBytes(uint64_t maxBytes)
+{
+    m_longTermCache.SetMaxBytes(maxBytes);
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetMaxCacheBytes() const
+{
+    return m_longTermCache.GetMaxBytes();
+}
+
+LruCacheStats
+ThreeGppSpectrumPropagationLossModel::GetCacheStats() const
+{
+    return m_longTermCache.GetStats();
+}
+
 double
 ThreeGppSpectrumPropagationLossModel::GetFrequency() const
 {
@@ -282,18 +310,18 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm(
     uint64_t longTermId =
         MatrixBasedChannelModel::GetKey(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
 
-    // look for the long term in the map and check if it is valid
-    if (m_longTermMap.find(longTermId) != m_longTermMap.end())
+    // look for the long term in the cache and check if it is valid
+    const Ptr<const LongTerm>* cacheItem = m_longTermCache.Find(longTermId);
+    if (cacheItem != nullptr)
     {
-        NS_LOG_DEBUG("found the long term component in the map");
-        longTerm = m_longTermMap[longTermId]->m_longTerm;
+        NS_LOG_DEBUG("found the long term component in the cache");
+        longTerm = (*cacheItem)->m_longTerm;
 
         // check if the channel matrix has been updated
         // or the s beam has been changed
         // or the u beam has been changed
-        update = (m_longTermMap[longTermId]->m_channel->m_generatedTime !=
-                      channelMatrix->m_generatedTime ||
-                  m_longTermMap[longTermId]->m_sW != sW || m_longTermMap[longTermId]->m_uW != uW);
+        update = ((*cacheItem)->m_channel->m_generatedTime != channelMatrix->m_generatedTime ||
+                  (*cacheItem)->m_sW != sW || (*cacheItem)->m_uW != uW);
     }
     else
     {
@@ -314,7 +342,10 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm(
         longTermItem->m_sW = sW;
         longTermItem->m_uW = uW;
 
-        m_longTermMap[longTermId] = longTermItem;
+        std::size_t longTermBytes =
+            sizeof(LongTerm) +
+            (longTerm.GetSize() + sW.GetSize() + uW.GetSize()) * sizeof(std::complex<double>);
+        m_longTermCache.Insert(longTermId, longTermItem, longTermBytes);
     }
 
     return longTerm;
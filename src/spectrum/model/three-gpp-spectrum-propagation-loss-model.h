@@ -21,13 +21,13 @@
 #ifndef THREE_GPP_SPECTRUM_PROPAGATION_LOSS_H
 #define THREE_GPP_SPECTRUM_PROPAGATION_LOSS_H
 
+#include "ns3/lru-cache.h"
 #include "ns3/matrix-based-channel-model.h"
 #include "ns3/phased-array-spectrum-propagation-loss-model.h"
 #include "ns3/random-variable-stream.h"
 
 #include <complex.h>
 #include <map>
-#include <unordered_map>
 
 namespace ns3
 {
@@ -97,6 +97,11 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      */
     void GetChannelModelAttribute(const std::string& name, AttributeValue& value) const;
 
+    /**
+     * \return the statistics of the cache of the long term components
+     */
+    LruCacheStats GetCacheStats() const;
+
     /**
      * \brief Computes the received PSD.
      *
@@ -148,7 +153,18 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     double GetFrequency() const;
 
     /**
-     * Looks for the long term component in m_longTermMap. If found, checks
+     * Set the memory limit of the cache of the long term components
+     * \param maxBytes the memory limit, in bytes, or 0 for no limit
+     */
+    void SetMaxCacheBytes(uint64_t maxBytes);
+
+    /**
+     * \return the memory limit of the cache of the long term components, in bytes
+     */
+    uint64_t GetMaxCacheBytes() const;
+
+    /**
+     * Looks for the long term component in m_longTermCache. If found, checks
      * whether it has to be updated. If not found or if it has to be updated,
      * calls the method CalcLongTerm to compute it.
      * \param channelMatrix the channel matrix
@@ -190,8 +206,8 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         const Vector& sSpeed,
         const Vector& uSpeed) const;
 
-    mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
-        m_longTermMap;                           //!< map containing the long term components
+    mutable LruCache<uint64_t, Ptr<const LongTerm>>
+        m_longTermCache;                         //!< cache of the long term components
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
@@ -0,0 +1,223 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/net-device.h>
+#include <ns3/pointer.h>
+#include <ns3/simulator.h>
+#include <ns3/spatial-index.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/test.h>
+
+#include <optional>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Minimal SpectrumPhy counting the signals it starts receiving
+ */
+class RangeTestSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * \param rxSpectrumModel the RX spectrum model
+     */
+    RangeTestSpectrumPhy(Ptr<const SpectrumModel> rxSpectrumModel)
+        : m_rxSpectrumModel(rxSpectrumModel),
+          m_rxCount(0)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice> d) override
+    {
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return nullptr;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> c) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxSpectrumModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return nullptr;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        m_rxCount++;
+    }
+
+    /**
+     * \return the number of signals this PHY started receiving
+     */
+    uint32_t GetRxCount() const
+    {
+        return m_rxCount;
+    }
+
+  private:
+    Ptr<const SpectrumModel> m_rxSpectrumModel; //!< RX spectrum model
+    Ptr<MobilityModel> m_mobility;              //!< mobility model
+    uint32_t m_rxCount;                         //!< number of received signals
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that the MultiModelSpectrumChannel does not propagate signals to
+ * the receivers located further than MaxRange, with and without spatial index.
+ *
+ * Receivers using the same SpectrumModel as the transmitter are placed at 10 m
+ * and 100 m, a receiver using an overlapping SpectrumModel at 20 m and a receiver
+ * without mobility model is also attached. With MaxRange set to 50 m, all but the
+ * receiver at 100 m must receive the signal. The latter is then moved within range
+ * and must receive the next signal.
+ */
+class SpectrumChannelMaxRangeTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param useSpatialIndex whether a spatial index is set on the channel
+     */
+    SpectrumChannelMaxRangeTestCase(bool useSpatialIndex);
+
+  private:
+    void DoRun() override;
+
+    bool m_useSpatialIndex; //!< whether a spatial index is set on the channel
+};
+
+SpectrumChannelMaxRangeTestCase::SpectrumChannelMaxRangeTestCase(bool useSpatialIndex)
+    : TestCase(std::string("Check MultiModelSpectrumChannel MaxRange ") +
+               (useSpatialIndex ? "with" : "without") + " spatial index"),
+      m_useSpatialIndex(useSpatialIndex)
+{
+}
+
+void
+SpectrumChannelMaxRangeTestCase::DoRun()
+{
+    auto channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->SetAttribute("MaxRange", DoubleValue(50));
+    if (m_useSpatialIndex)
+    {
+        channel->SetAttribute(
+            "SpatialIndex",
+            PointerValue(
+                CreateObjectWithAttributes<GridSpatialIndex>("CellSize", DoubleValue(25))));
+    }
+
+    auto txModel = Create<SpectrumModel>(std::vector<double>{1.0e9, 1.1e9, 1.2e9});
+    auto otherModel = Create<SpectrumModel>(std::vector<double>{1.05e9, 1.15e9});
+
+    auto createPhy = [&](Ptr<const SpectrumModel> model, std::optional<Vector> position) {
+        auto phy = CreateObject<RangeTestSpectrumPhy>(model);
+        if (position)
+        {
+            auto mobility = CreateObject<ConstantPositionMobilityModel>();
+            mobility->SetPosition(*position);
+            phy->SetMobility(mobility);
+        }
+        return phy;
+    };
+
+    auto txPhy = createPhy(txModel, Vector(0, 0, 0));
+    auto nearPhy = createPhy(txModel, Vector(10, 0, 0));
+    auto farPhy = createPhy(txModel, Vector(100, 0, 0));
+    auto otherModelPhy = createPhy(otherModel, Vector(0, 20, 0));
+    auto unlocatedPhy = createPhy(txModel, std::nullopt);
+    for (const auto& phy : {txPhy, nearPhy, farPhy, otherModelPhy, unlocatedPhy})
+    {
+        channel->AddRx(phy);
+    }
+
+    auto transmit = [&]() {
+        auto params = Create<SpectrumSignalParameters>();
+        params->psd = Create<SpectrumValue>(txModel);
+        *params->psd = 1.0;
+        params->duration = MicroSeconds(100);
+        params->txPhy = txPhy;
+        channel->StartTx(params);
+    };
+
+    Simulator::Schedule(Seconds(1), transmit);
+    Simulator::Schedule(Seconds(2), [&]() {
+        farPhy->GetMobility()->SetPosition(Vector(0, -40, 0));
+    });
+    Simulator::Schedule(Seconds(3), transmit);
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(txPhy->GetRxCount(), 0, "The transmitter must not receive");
+    NS_TEST_EXPECT_MSG_EQ(nearPhy->GetRxCount(), 2, "Receiver in range must receive");
+    NS_TEST_EXPECT_MSG_EQ(otherModelPhy->GetRxCount(),
+                          2,
+                          "Receiver in range with another SpectrumModel must receive");
+    NS_TEST_EXPECT_MSG_EQ(unlocatedPhy->GetRxCount(),
+                          2,
+                          "Receiver without mobility model must receive");
+    NS_TEST_EXPECT_MSG_EQ(farPhy->GetRxCount(),
+                          1,
+                          "Receiver must only receive once moved within range");
+
+    channel->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Spectrum channel range TestSuite
+ */
+class SpectrumChannelRangeTestSuite : public TestSuite
+{
+  public:
+    SpectrumChannelRangeTestSuite();
+};
+
+SpectrumChannelRangeTestSuite::SpectrumChannelRangeTestSuite()
+    : TestSuite("spectrum-channel-range", UNIT)
+{
+    AddTestCase(new SpectrumChannelMaxRangeTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpectrumChannelMaxRangeTestCase(true), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelRangeTestSuite g_spectrumChannelRangeTestSuite;
@@ -268,6 +268,21 @@ SpectrumValueTestSuite::SpectrumValueTestSuite()
     v1rs3[4] = v1[1];
     tv1rs3 = v1 >> 3;
     AddTestCase(new SpectrumValueTestCase(tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
+
+    // the results are stored in the temporary right hand sides
+    SpectrumValue tv3c = v1 + (v2 * 1.0);
+    SpectrumValue tv4c = v1 - (v2 * 1.0);
+    SpectrumValue tv5c = v1 * (v2 * 1.0);
+    SpectrumValue tv6c = v1 / (v2 * 1.0);
+    AddTestCase(new SpectrumValueTestCase(tv3c, v3, "tv3c = v1 + (v2 * 1)"), TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv4c, v4, "tv4c = v1 - (v2 * 1)"), TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv5c, v5, "tv5c = v1 * (v2 * 1)"), TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv6c, v6, "tv6c = v1 div (v2 * 1)"), TestCase::QUICK);
+
+    SpectrumValue tv3d = v1;
+    tv3d.AddScaled(v2 * 2, 0.5);
+    AddTestCase(new SpectrumValueTestCase(tv3d, v3, "tv3d = v1 + (v2 * 2) * 0.5"),
+                TestCase::QUICK);
 }
 
 /**
@@ -682,6 +682,151 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the GetChannels method of the ThreeGppChannelModel class.
+ * It checks that a batch of links gets the channel matrices of successive
+ * calls to GetChannel, regardless of the number of threads, and that the
+ * links which share a pair of antenna arrays share their matrix.
+ */
+class ThreeGppChannelBatchTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param threads the number of threads generating the batch
+     */
+    ThreeGppChannelBatchTest(uint32_t threads);
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Create a ThreeGppChannelModel
+     * \param los whether the links are in LOS, or in NLOS
+     * \return the channel model
+     */
+    Ptr<ThreeGppChannelModel> CreateChannelModel(bool los) const;
+
+    uint32_t m_threads; //!< the number of threads generating the batch
+};
+
+ThreeGppChannelBatchTest::ThreeGppChannelBatchTest(uint32_t threads)
+    : TestCase("Check the channel matrices of a batch of links generated with Threads = " +
+               std::to_string(threads)),
+      m_threads(threads)
+{
+}
+
+Ptr<ThreeGppChannelModel>
+ThreeGppChannelBatchTest::CreateChannelModel(bool los) const
+{
+    Ptr<ChannelConditionModel> channelConditionModel;
+    if (los)
+    {
+        channelConditionModel = CreateObject<AlwaysLosChannelConditionModel>();
+    }
+    else
+    {
+        channelConditionModel = CreateObject<NeverLosChannelConditionModel>();
+    }
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28.0e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+    channelModel->SetAttribute("ChannelConditionModel", PointerValue(channelConditionModel));
+    channelModel->AssignStreams(1);
+    return channelModel;
+}
+
+void
+ThreeGppChannelBatchTest::DoRun()
+{
+    // a base station with a 4x4 array and 3 user terminals with 2x2 arrays
+    NodeContainer nodes;
+    nodes.Create(4);
+    std::vector<Ptr<MobilityModel>> mobs;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(i == 0 ? Vector(0.0, 0.0, 10.0) : Vector(20.0 * i, 10.0 - 5.0 * i, 1.5));
+        nodes.Get(i)->AggregateObject(mob);
+        mobs.push_back(mob);
+        uint32_t side = (i == 0) ? 4 : 2;
+        Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(side),
+            "NumRows",
+            UintegerValue(side),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>()));
+        antennas.push_back(antenna);
+    }
+
+    // the downlinks and the uplinks, and a link between two user terminals
+    // which is then requested again in the reverse direction
+    std::vector<ThreeGppChannelModel::ChannelLink> links;
+    for (uint32_t i = 1; i < nodes.GetN(); i++)
+    {
+        links.push_back({mobs[0], mobs[i], antennas[0], antennas[i]});
+        links.push_back({mobs[i], mobs[0], antennas[i], antennas[0]});
+    }
+    links.push_back({mobs[1], mobs[2], antennas[1], antennas[2]});
+    links.push_back({mobs[2], mobs[1], antennas[2], antennas[1]});
+
+    for (bool los : {true, false})
+    {
+        Ptr<ThreeGppChannelModel> channelModel = CreateChannelModel(los);
+        std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> expected;
+        for (const auto& link : links)
+        {
+            expected.push_back(
+                channelModel->GetChannel(link.aMob, link.bMob, link.aAntenna, link.bAntenna));
+        }
+
+        Ptr<ThreeGppChannelModel> batchModel = CreateChannelModel(los);
+        batchModel->SetAttribute("Threads", UintegerValue(m_threads));
+        std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> channels =
+            batchModel->GetChannels(links);
+
+        NS_TEST_ASSERT_MSG_EQ(channels.size(), links.size(), "Wrong number of channel matrices");
+        for (std::size_t i = 0; i < links.size(); i++)
+        {
+            const auto& channel = channels[i]->m_channel;
+            const auto& expectedChannel = expected[i]->m_channel;
+            NS_TEST_ASSERT_MSG_EQ(channel.GetNumRows(),
+                                  expectedChannel.GetNumRows(),
+                                  "Wrong number of receiving elements");
+            NS_TEST_ASSERT_MSG_EQ(channel.GetNumCols(),
+                                  expectedChannel.GetNumCols(),
+                                  "Wrong number of transmitting elements");
+            NS_TEST_ASSERT_MSG_EQ(channel.GetNumPages(),
+                                  expectedChannel.GetNumPages(),
+                                  "Wrong number of clusters");
+            NS_TEST_ASSERT_MSG_EQ((channel == expectedChannel),
+                                  true,
+                                  "The coefficients of link " << i << " differ");
+            NS_TEST_ASSERT_MSG_EQ((channels[i]->m_nodeIds == expected[i]->m_nodeIds),
+                                  true,
+                                  "Wrong node pair for link " << i);
+            NS_TEST_ASSERT_MSG_EQ((channels[i]->m_antennaPair == expected[i]->m_antennaPair),
+                                  true,
+                                  "Wrong antenna pair for link " << i);
+        }
+        for (std::size_t i = 0; i < links.size(); i += 2)
+        {
+            NS_TEST_ASSERT_MSG_EQ(channels[i],
+                                  channels[i + 1],
+                                  "The reverse link does not share the channel matrix");
+        }
+        Simulator::Destroy();
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -702,6 +847,8 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+    AddTestCase(new ThreeGppChannelBatchTest(1), TestCase::QUICK);
+    AddTestCase(new ThreeGppChannelBatchTest(3), TestCase::QUICK);
 }
 
 /// Static variable for test initialization
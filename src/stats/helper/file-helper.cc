@@ -312,7 +312,8 @@ FileHelper::GetAggregatorSingle()
     if (!m_aggregator)
     {
         // Create the aggregator.
-        std::string outputFileName = m_outputFileNameWithoutExtension + ".txt";
+        std::string outputFileName = m_outputFileNameWithoutExtension +
+                                     (m_fileType == FileAggregator::COLUMNAR ? ".col" : ".txt");
         m_aggregator = CreateObject<FileAggregator>(outputFileName, m_fileType);
 
         // Set all of the format strings for the aggregator.
@@ -555,7 +556,8 @@ FileHelper::ConnectProbeToAggregator(const std::string& typeId,
 
     // Add the aggregator to the map of aggregators, which will keep the
     // aggregator in memory after this function ends.
-    std::string outputFileName = outputFileNameWithoutExtension + ".txt";
+    std::string outputFileName =
+        outputFileNameWithoutExtension + (m_fileType == FileAggregator::COLUMNAR ? ".col" : ".txt");
     AddAggregator(probeContext, outputFileName, onlyOneAggregator);
 
     // Connect the adaptor to the aggregator.
@@ -54,6 +54,7 @@ class FileHelper
      * outputFileNameWithoutExtension plus possible extra information
      * from wildcard matches plus ".txt" with values printed as
      * specified by fileType.  The default file type is space-separated.
+     * The COLUMNAR files get the ".col" extension instead of ".txt".
      */
     FileHelper(const std::string& outputFileNameWithoutExtension,
                FileAggregator::FileType fileType = FileAggregator::SPACE_SEPARATED);
@@ -70,6 +71,7 @@ class FileHelper
      * possible extra information from wildcard matches plus ".txt" with
      * values printed as specified by fileType.  The default file type
      * is space-separated.
+     * The COLUMNAR files get the ".col" extension instead of ".txt".
      */
     void ConfigureFile(const std::string& outputFileNameWithoutExtension,
                        FileAggregator::FileType fileType = FileAggregator::SPACE_SEPARATED);
@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "columnar-file-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ColumnarFileWriter");
+
+namespace
+{
+
+/** The magic number and version which start the files. */
+const char COLUMNAR_FILE_MAGIC[8] = {'N', 'S', '3', 'C', 'O', 'L', 'S', 1};
+/** Type of the blocks which define a table. */
+const uint8_t TABLE_BLOCK = 1;
+/** Type of the blocks which hold rows. */
+const uint8_t BATCH_BLOCK = 2;
+
+/**
+ * Append an integer to a buffer, in little-endian order.
+ * \param buffer the buffer
+ * \param value the integer
+ * \param size the number of bytes of the integer
+ */
+void
+AppendLittleEndian(std::string& buffer, uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++)
+    {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+/**
+ * Append a string to a buffer, preceded by its length.
+ * \param buffer the buffer
+ * \param value the string
+ */
+void
+AppendString(std::string& buffer, const std::string& value)
+{
+    AppendLittleEndian(buffer, value.size(), 4);
+    buffer.append(value);
+}
+
+} // unnamed namespace
+
+ColumnarFileWriter::Table::Table(ColumnarFileWriter* writer,
+                                 uint32_t id,
+                                 const std::string& name,
+                                 const std::vector<ColumnDefinition>& columns)
+    : m_writer(writer),
+      m_id(id),
+      m_name(name),
+      m_nextColumn(0),
+      m_bufferedRows(0),
+      m_rows(0)
+{
+    for (const auto& column : columns)
+    {
+        m_columns.push_back({column.second, column.first, {}, {}, {}});
+    }
+}
+
+ColumnarFileWriter::Table::Column&
+ColumnarFileWriter::Table::NextColumn(ColumnType type)
+{
+    NS_ASSERT_MSG(m_nextColumn < m_columns.size(), "Too many values in a row of " << m_name);
+    Column& column = m_columns[m_nextColumn++];
+    NS_ASSERT_MSG(column.type == type,
+                  "Wrong type of value for the column " << column.name << " of " << m_name);
+    return column;
+}
+
+ColumnarFileWriter::Table&
+ColumnarFileWriter::Table::AddUint(uint64_t value)
+{
+    NextColumn(UINT64).values.push_back(value);
+    return *this;
+}
+
+ColumnarFileWriter::Table&
+ColumnarFileWriter::Table::AddInt(int64_t value)
+{
+    NextColumn(INT64).values.push_back(static_cast<uint64_t>(value));
+    return *this;
+}
+
+ColumnarFileWriter::Table&
+ColumnarFileWriter::Table::AddDouble(double value)
+{
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "double is not 64 bits wide");
+    std::memcpy(&bits, &value, sizeof(bits));
+    NextColumn(DOUBLE).values.push_back(bits);
+    return *this;
+}
+
+ColumnarFileWriter::Table&
+ColumnarFileWriter::Table::AddString(const std::string& value)
+{
+    Column& column = NextColumn(STRING);
+    column.chars.append(value);
+    column.offsets.push_back(column.chars.size());
+    return *this;
+}
+
+void
+ColumnarFileWriter::Table::EndRow()
+{
+    NS_ASSERT_MSG(m_nextColumn == m_columns.size(), "Missing values in a row of " << m_name);
+    m_nextColumn = 0;
+    m_rows++;
+    if (++m_bufferedRows >= m_writer->m_batchRows)
+    {
+        Flush();
+    }
+}
+
+void
+ColumnarFileWriter::Table::Flush()
+{
+    NS_LOG_FUNCTION(this << m_name << m_bufferedRows);
+    if (m_bufferedRows == 0)
+    {
+        return;
+    }
+    std::string payload;
+    AppendLittleEndian(payload, m_id, 4);
+    AppendLittleEndian(payload, m_bufferedRows, 4);
+    for (auto& column : m_columns)
+    {
+        if (column.type == STRING)
+        {
+            AppendLittleEndian(payload, 4 * (column.offsets.size() + 1) + column.chars.size(), 4);
+            AppendLittleEndian(payload, 0, 4);
+            for (uint32_t offset : column.offsets)
+            {
+                AppendLittleEndian(payload, offset, 4);
+            }
+            payload.append(column.chars);
+            column.offsets.clear();
+            column.chars.clear();
+        }
+        else
+        {
+            AppendLittleEndian(payload, 8 * column.values.size(), 4);
+            for (uint64_t value : column.values)
+            {
+                AppendLittleEndian(payload, value, 8);
+            }
+            column.values.clear();
+        }
+    }
+    m_bufferedRows = 0;
+    m_writer->WriteBlock(BATCH_BLOCK, payload);
+}
+
+uint64_t
+ColumnarFileWriter::Table::GetRows() const
+{
+    return m_rows;
+}
+
+ColumnarFileWriter::ColumnarFileWriter(const std::string& filename,
+                                       uint32_t batchRows,
+                                       bool append)
+    : m_batchRows(batchRows)
+{
+    NS_LOG_FUNCTION(this << filename << batchRows << append);
+    NS_ASSERT_MSG(batchRows > 0, "The batches need at least one row");
+    m_file.open(filename,
+                std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (!m_file.is_open())
+    {
+        NS_LOG_WARN("Could not open " << filename);
+        return;
+    }
+    // start a new file with the magic number, or continue an existing one
+    m_file.seekp(0, std::ios::end);
+    if (m_file.tellp() == 0)
+    {
+        m_file.write(COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC));
+    }
+}
+
+ColumnarFileWriter::~ColumnarFileWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+ColumnarFileWriter::IsOk() const
+{
+    return m_file.is_open() && m_file.good();
+}
+
+ColumnarFileWriter::Table&
+ColumnarFileWriter::AddTable(const std::string& name, const std::vector<ColumnDefinition>& columns)
+{
+    NS_LOG_FUNCTION(this << name);
+    NS_ASSERT_MSG(!columns.empty() && columns.size() <= UINT16_MAX,
+                  "Invalid number of columns in " << name);
+    uint32_t id = m_tables.size();
+    std::string payload;
+    AppendLittleEndian(payload, id, 4);
+    AppendString(payload, name);
+    AppendLittleEndian(payload, columns.size(), 2);
+    for (const auto& column : columns)
+    {
+        AppendLittleEndian(payload, column.second, 1);
+        AppendString(payload, column.first);
+    }
+    WriteBlock(TABLE_BLOCK, payload);
+    m_tables.push_back(Table(this, id, name, columns));
+    return m_tables.back();
+}
+
+void
+ColumnarFileWriter::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& table : m_tables)
+    {
+        table.Flush();
+    }
+    if (m_file.is_open())
+    {
+        m_file.flush();
+    }
+}
+
+void
+ColumnarFileWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+void
+ColumnarFileWriter::WriteBlock(uint8_t type, const std::string& payload)
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    std::string header;
+    AppendLittleEndian(header, type, 1);
+    AppendLittleEndian(header, payload.size(), 4);
+    m_file.write(header.data(), header.size());
+    m_file.write(payload.data(), payload.size());
+}
+
+} // namespace ns3
@@ -0,0 +1,212 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COLUMNAR_FILE_WRITER_H
+#define COLUMNAR_FILE_WRITER_H
+
+#include "ns3/simple-ref-count.h"
+
+#include <deque>
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup stats
+ *
+ * \brief Writes tables of values to a binary file, column by column.
+ *
+ * The rows added to a table are buffered, and written to the file in
+ * batches of a fixed number of rows, so that the file grows during the
+ * simulation and a reader can process it batch by batch. Each batch stores
+ * the values of each column contiguously, which is much smaller and faster
+ * to load than text. The file is self-describing: the names and types of
+ * the columns of a table are written before its first batch.
+ *
+ * The file starts with the 8 bytes "NS3COLS" followed by the format
+ * version (1), followed by blocks. All integers are little-endian, the
+ * strings are a uint32_t length followed by the bytes of the string, and
+ * each block is a uint8_t block type followed by a uint32_t payload length
+ * and the payload:
+ *
+ * - a TABLE block (type 1) defines a table for the blocks which follow it:
+ *   uint32_t table id, string table name, uint16_t number of columns and,
+ *   for each column, uint8_t column type and string column name;
+ * - a BATCH block (type 2) holds rows of a table: uint32_t table id,
+ *   uint32_t number of rows and, for each column, a uint32_t length in bytes
+ *   followed by the values. The UINT64, INT64 and DOUBLE values take 8
+ *   bytes each; the STRING values are stored as (rows + 1) uint32_t offsets
+ *   into the bytes of the strings, which follow the offsets.
+ *
+ * A file can be appended to by another writer: its TABLE blocks redefine
+ * the table ids for the batches which follow them. A file truncated by an
+ * interrupted simulation can be read up to its last complete block.
+ */
+class ColumnarFileWriter : public SimpleRefCount<ColumnarFileWriter>
+{
+  public:
+    /// Type of the values of a column
+    enum ColumnType : uint8_t
+    {
+        UINT64 = 1, //!< Unsigned 64-bit integers
+        INT64 = 2,  //!< Signed 64-bit integers
+        DOUBLE = 3, //!< IEEE 754 double precision numbers
+        STRING = 4, //!< Character strings
+    };
+
+    /// A column of a table: name and type
+    typedef std::pair<std::string, ColumnType> ColumnDefinition;
+
+    /**
+     * \brief A table of a ColumnarFileWriter.
+     *
+     * The values of a row are added column by column, in the order of the
+     * columns, and the row is completed with EndRow().
+     */
+    class Table
+    {
+      public:
+        /**
+         * \param value the value of the next column of the row, of type UINT64
+         * \return this table
+         */
+        Table& AddUint(uint64_t value);
+        /**
+         * \param value the value of the next column of the row, of type INT64
+         * \return this table
+         */
+        Table& AddInt(int64_t value);
+        /**
+         * \param value the value of the next column of the row, of type DOUBLE
+         * \return this table
+         */
+        Table& AddDouble(double value);
+        /**
+         * \param value the value of the next column of the row, of type STRING
+         * \return this table
+         */
+        Table& AddString(const std::string& value);
+
+        /**
+         * Complete the row: all its columns must have been added. The
+         * buffered rows are written when they fill a batch.
+         */
+        void EndRow();
+
+        /** Write the buffered rows, if any, in a batch. */
+        void Flush();
+
+        /**
+         * \return the number of complete rows added to the table
+         */
+        uint64_t GetRows() const;
+
+      private:
+        friend class ColumnarFileWriter;
+
+        /// The values of a column, not yet written
+        struct Column
+        {
+            ColumnType type;               //!< Type of the values
+            std::string name;              //!< Name of the column
+            std::vector<uint64_t> values;  //!< Numeric values, as their bit patterns
+            std::vector<uint32_t> offsets; //!< End offsets of the string values
+            std::string chars;             //!< Characters of the string values
+        };
+
+        /**
+         * \param writer the writer of the table
+         * \param id the id of the table in the file
+         * \param name the name of the table
+         * \param columns the columns of the table
+         */
+        Table(ColumnarFileWriter* writer,
+              uint32_t id,
+              const std::string& name,
+              const std::vector<ColumnDefinition>& columns);
+
+        /**
+         * \param type the type of a value being added
+         * \return the column of the value
+         */
+        Column& NextColumn(ColumnType type);
+
+        ColumnarFileWriter* m_writer;  //!< The writer of the table
+        uint32_t m_id;                 //!< The id of the table in the file
+        std::string m_name;            //!< The name of the table
+        std::vector<Column> m_columns; //!< The columns
+        std::size_t m_nextColumn;      //!< Column of the next value added
+        uint32_t m_bufferedRows;       //!< Number of rows not yet written
+        uint64_t m_rows;               //!< Number of rows added
+    };
+
+    /**
+     * Open a file.
+     *
+     * \param filename the name of the file
+     * \param batchRows the number of rows of the batches
+     * \param append if true, append to the file if it exists, instead of
+     * truncating it
+     */
+    ColumnarFileWriter(const std::string& filename, uint32_t batchRows = 4096, bool append = false);
+
+    /** Write the buffered rows and close the file. */
+    ~ColumnarFileWriter();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    ColumnarFileWriter(const ColumnarFileWriter&) = delete;
+    ColumnarFileWriter& operator=(const ColumnarFileWriter&) = delete;
+
+    /**
+     * \return true if the file is open and no write failed.
+     */
+    bool IsOk() const;
+
+    /**
+     * Add a table, and write its definition to the file.
+     *
+     * \param name the name of the table
+     * \param columns the names and types of the columns of the table
+     * \return the table, valid as long as the writer
+     */
+    Table& AddTable(const std::string& name, const std::vector<ColumnDefinition>& columns);
+
+    /** Write the buffered rows of all the tables, and flush the file. */
+    void Flush();
+
+    /** Write the buffered rows of all the tables, and close the file. */
+    void Close();
+
+  private:
+    /**
+     * Write a block to the file.
+     * \param type the type of the block
+     * \param payload the payload of the block
+     */
+    void WriteBlock(uint8_t type, const std::string& payload);
+
+    std::ofstream m_file;       //!< The file
+    uint32_t m_batchRows;       //!< Number of rows of the batches
+    std::deque<Table> m_tables; //!< The tables
+};
+
+} // namespace ns3
+
+#endif /* COLUMNAR_FILE_WRITER_H */
@@ -55,7 +55,9 @@ FileAggregator::FileAggregator(const std::string& outputFileName, FileType fileT
       m_7dFormat("%e %e %e %e %e %e %e"),
       m_8dFormat("%e %e %e %e %e %e %e %e"),
       m_9dFormat("%e %e %e %e %e %e %e %e %e"),
-      m_10dFormat("%e %e %e %e %e %e %e %e %e %e")
+      m_10dFormat("%e %e %e %e %e %e %e %e %e %e"),
+      m_columnarTables(10, nullptr),
+      m_contextTable(nullptr)
 {
     NS_LOG_FUNCTION(this << outputFileName << fileType);
 
@@ -74,13 +76,24 @@ FileAggregator::FileAggregator(const std::string& outputFileName, FileType fileT
         break;
     }
 
-    m_file.open(m_outputFileName);
+    if (m_fileType == COLUMNAR)
+    {
+        OpenColumnarFile();
+    }
+    else
+    {
+        m_file.open(m_outputFileName);
+    }
 }
 
 FileAggregator::~FileAggregator()
 {
     NS_LOG_FUNCTION(this);
     m_file.close();
+    if (m_columnarFile)
+    {
+        m_columnarFile->Close();
+    }
 }
 
 void
@@ -88,6 +101,59 @@ FileAggregator::SetFileType(FileType fileType)
 {
     NS_LOG_FUNCTION(this << fileType);
     m_fileType = fileType;
+    if (m_fileType == COLUMNAR && !m_columnarFile)
+    {
+        // the text file has not been written yet: replace it
+        m_file.close();
+        OpenColumnarFile();
+    }
+}
+
+void
+FileAggregator::OpenColumnarFile()
+{
+    NS_LOG_FUNCTION(this);
+    m_columnarFile = Create<ColumnarFileWriter>(m_outputFileName);
+    m_contextTable = &m_columnarFile->AddTable(
+        "contexts",
+        {{"id", ColumnarFileWriter::UINT64}, {"context", ColumnarFileWriter::STRING}});
+    if (m_hasHeadingBeenSet)
+    {
+        m_columnarFile->AddTable("heading", {{"heading", ColumnarFileWriter::STRING}})
+            .AddString(m_heading)
+            .EndRow();
+    }
+}
+
+void
+FileAggregator::WriteColumnar(const std::string& context, std::initializer_list<double> values)
+{
+    auto contextId = m_contextIds.find(context);
+    if (contextId == m_contextIds.end())
+    {
+        // the contexts are written before the values which refer to them
+        contextId = m_contextIds.emplace(context, m_contextIds.size()).first;
+        m_contextTable->AddUint(contextId->second).AddString(context).EndRow();
+        m_contextTable->Flush();
+    }
+
+    ColumnarFileWriter::Table*& table = m_columnarTables[values.size() - 1];
+    if (table == nullptr)
+    {
+        std::vector<ColumnarFileWriter::ColumnDefinition> columns = {
+            {"context", ColumnarFileWriter::UINT64}};
+        for (std::size_t i = 1; i <= values.size(); i++)
+        {
+            columns.emplace_back("v" + std::to_string(i), ColumnarFileWriter::DOUBLE);
+        }
+        table = &m_columnarFile->AddTable("values" + std::to_string(values.size()) + "d", columns);
+    }
+    table->AddUint(contextId->second);
+    for (double value : values)
+    {
+        table->AddDouble(value);
+    }
+    table->EndRow();
 }
 
 void
@@ -100,7 +166,16 @@ FileAggregator::SetHeading(const std::string& heading)
         m_hasHeadingBeenSet = true;
 
         // Print the heading to the file.
-        m_file << m_heading << std::endl;
+        if (m_columnarFile)
+        {
+            m_columnarFile->AddTable("heading", {{"heading", ColumnarFileWriter::STRING}})
+                .AddString(m_heading)
+                .EndRow();
+        }
+        else
+        {
+            m_file << m_heading << std::endl;
+        }
     }
 }
 
@@ -182,7 +257,11 @@ FileAggregator::Write1d(std::string context, double v1)
     if (m_enabled)
     {
         // Write the 1D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -216,7 +295,11 @@ FileAggregator::Write2d(std::string context, double v1, double v2)
     if (m_enabled)
     {
         // Write the 2D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -250,7 +333,11 @@ FileAggregator::Write3d(std::string context, double v1, double v2, double v3)
     if (m_enabled)
     {
         // Write the 3D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -284,7 +371,11 @@ FileAggregator::Write4d(std::string context, double v1, double v2, double v3, do
     if (m_enabled)
     {
         // Write the 4D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -319,7 +410,11 @@ FileAggregator::Write5d(std::string context, double v1, double v2, double v3, do
     if (m_enabled)
     {
         // Write the 5D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4, v5});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -361,7 +456,11 @@ FileAggregator::Write6d(std::string context,
     if (m_enabled)
     {
         // Write the 6D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4, v5, v6});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -404,7 +503,11 @@ FileAggregator::Write7d(std::string context,
     if (m_enabled)
     {
         // Write the 7D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4, v5, v6, v7});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -448,7 +551,11 @@ FileAggregator::Write8d(std::string context,
     if (m_enabled)
     {
         // Write the 8D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4, v5, v6, v7, v8});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -493,7 +600,11 @@ FileAggregator::Write9d(std::string context,
     if (m_enabled)
     {
         // Write the 9D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4, v5, v6, v7, v8, v9});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
@@ -549,7 +660,11 @@ FileAggregator::Write10d(std::string context,
     if (m_enabled)
     {
         // Write the 10D data point to the file.
-        if (m_fileType == FORMATTED)
+        if (m_fileType == COLUMNAR)
+        {
+            WriteColumnar(context, {v1, v2, v3, v4, v5, v6, v7, v8, v9, v10});
+        }
+        else if (m_fileType == FORMATTED)
         {
             // Initially, have the C-style string in the buffer, which
             // is terminated by a null character, be of length zero.
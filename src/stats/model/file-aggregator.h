@@ -23,11 +23,15 @@
 #ifndef FILE_AGGREGATOR_H
 #define FILE_AGGREGATOR_H
 
+#include "ns3/columnar-file-writer.h"
 #include "ns3/data-collection-object.h"
+#include "ns3/ptr.h"
 
 #include <fstream>
+#include <initializer_list>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace ns3
 {
@@ -36,6 +40,12 @@ namespace ns3
  * \ingroup aggregator
  *
  * This aggregator sends values it receives to a file.
+ *
+ * The COLUMNAR file type writes a binary ColumnarFileWriter file instead
+ * of text: its "contexts" table (columns "id" and "context") maps the
+ * contexts of the values to integer ids, and its "values1d" to "values10d"
+ * tables (columns "context", "v1" ... "vN") hold the values written by
+ * Write1d() to Write10d(). The heading, if any, is in the "heading" table.
  **/
 class FileAggregator : public DataCollectionObject
 {
@@ -46,7 +56,8 @@ class FileAggregator : public DataCollectionObject
         FORMATTED,
         SPACE_SEPARATED,
         COMMA_SEPARATED,
-        TAB_SEPARATED
+        TAB_SEPARATED,
+        COLUMNAR
     };
 
     /**
@@ -337,6 +348,16 @@ class FileAggregator : public DataCollectionObject
                   double v10);
 
   private:
+    /// Open the columnar file, in place of the text file.
+    void OpenColumnarFile();
+
+    /**
+     * Write a data point to the columnar file.
+     * \param context the dataset the values came from.
+     * \param values the values of the data point.
+     */
+    void WriteColumnar(const std::string& context, std::initializer_list<double> values);
+
     /// The file name.
     std::string m_outputFileName;
 
@@ -366,6 +387,15 @@ class FileAggregator : public DataCollectionObject
     std::string m_9dFormat;  //!< Format string for 9D C-style sprintf() function.
     std::string m_10dFormat; //!< Format string for 10D C-style sprintf() function.
 
+    /// Used to write values to the columnar file.
+    Ptr<ColumnarFileWriter> m_columnarFile;
+    /// Tables of the columnar file, by number of values minus one.
+    std::vector<ColumnarFileWriter::Table*> m_columnarTables;
+    /// Table of the contexts of the columnar file.
+    ColumnarFileWriter::Table* m_contextTable;
+    /// Ids of the contexts in the columnar file.
+    std::map<std::string, uint64_t> m_contextIds;
+
 }; // class FileAggregator
 
 } // namespace ns3
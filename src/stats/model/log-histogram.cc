@@ -0,0 +1,224 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-histogram.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define DEFAULT_PRECISION_BITS 4
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LogHistogram");
+
+LogHistogram::LogHistogram(uint8_t precisionBits)
+    : m_precisionBits(precisionBits),
+      m_firstExponent(0),
+      m_zeroCount(0),
+      m_count(0),
+      m_min(0),
+      m_max(0)
+{
+    NS_ASSERT_MSG(precisionBits <= 16, "Too many bits of precision");
+}
+
+LogHistogram::LogHistogram()
+    : LogHistogram(DEFAULT_PRECISION_BITS)
+{
+}
+
+uint32_t
+LogHistogram::GetSubBin(double value, int& exponent) const
+{
+    uint32_t subBins = 1U << m_precisionBits;
+    // value = mantissa * 2^exponent, with mantissa in [0.5, 1)
+    double mantissa = std::frexp(value, &exponent);
+    auto subBin = static_cast<uint32_t>((2 * mantissa - 1) * subBins);
+    return std::min(subBin, subBins - 1);
+}
+
+void
+LogHistogram::AddValue(double value)
+{
+    if (m_count == 0 || value < m_min)
+    {
+        m_min = value;
+    }
+    if (m_count == 0 || value > m_max)
+    {
+        m_max = value;
+    }
+    m_count++;
+    if (!(value > 0))
+    {
+        m_zeroCount++;
+        return;
+    }
+
+    int exponent;
+    uint32_t subBin = GetSubBin(value, exponent);
+    uint32_t subBins = 1U << m_precisionBits;
+    if (m_bins.empty())
+    {
+        m_firstExponent = exponent;
+    }
+    else if (exponent < m_firstExponent)
+    {
+        NS_LOG_DEBUG("AddValue: adding the bins of exponents " << exponent << " to "
+                                                               << m_firstExponent - 1);
+        m_bins.insert(m_bins.begin(), (m_firstExponent - exponent) * subBins, 0);
+        m_firstExponent = exponent;
+    }
+    uint32_t index = (exponent - m_firstExponent) * subBins + subBin;
+    if (index >= m_bins.size())
+    {
+        m_bins.resize(index + 1, 0);
+    }
+    m_bins[index]++;
+}
+
+void
+LogHistogram::Clear()
+{
+    m_bins.clear();
+    m_zeroCount = 0;
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+uint64_t
+LogHistogram::GetCount() const
+{
+    return m_count;
+}
+
+double
+LogHistogram::GetMin() const
+{
+    return m_min;
+}
+
+double
+LogHistogram::GetMax() const
+{
+    return m_max;
+}
+
+uint32_t
+LogHistogram::GetNBins() const
+{
+    return m_bins.size();
+}
+
+double
+LogHistogram::GetBinStart(uint32_t index) const
+{
+    uint32_t subBins = 1U << m_precisionBits;
+    int exponent = m_firstExponent + static_cast<int>(index / subBins);
+    return std::ldexp(1 + double(index % subBins) / subBins, exponent - 1);
+}
+
+double
+LogHistogram::GetBinEnd(uint32_t index) const
+{
+    uint32_t subBins = 1U << m_precisionBits;
+    int exponent = m_firstExponent + static_cast<int>(index / subBins);
+    return std::ldexp(1 + double(index % subBins + 1) / subBins, exponent - 1);
+}
+
+uint32_t
+LogHistogram::GetBinCount(uint32_t index) const
+{
+    NS_ASSERT(index < m_bins.size());
+    return m_bins[index];
+}
+
+uint32_t
+LogHistogram::GetZeroCount() const
+{
+    return m_zeroCount;
+}
+
+double
+LogHistogram::GetQuantile(double q) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(std::ceil(q * m_count));
+    rank = std::min(std::max<uint64_t>(rank, 1), m_count);
+    double value = m_max;
+    uint64_t count = m_zeroCount;
+    if (rank <= count)
+    {
+        value = 0;
+    }
+    else
+    {
+        for (uint32_t index = 0; index < m_bins.size(); index++)
+        {
+            count += m_bins[index];
+            if (rank <= count)
+            {
+                value = (GetBinStart(index) + GetBinEnd(index)) / 2;
+                break;
+            }
+        }
+    }
+    return std::min(std::max(value, m_min), m_max);
+}
+
+void
+LogHistogram::SerializeToXmlStream(std::ostream& os,
+                                   uint16_t indent,
+                                   std::string elementName) const
+{
+    os << std::string(indent, ' ') << "<" << elementName << " count=\"" << m_count << "\""
+       << " min=\"" << m_min << "\""
+       << " max=\"" << m_max << "\""
+       << " p50=\"" << GetQuantile(0.5) << "\""
+       << " p90=\"" << GetQuantile(0.9) << "\""
+       << " p99=\"" << GetQuantile(0.99) << "\""
+       << " >\n";
+    indent += 2;
+    if (m_zeroCount > 0)
+    {
+        os << std::string(indent, ' ') << "<zero count=\"" << m_zeroCount << "\" />\n";
+    }
+    for (uint32_t index = 0; index < m_bins.size(); index++)
+    {
+        if (m_bins[index])
+        {
+            os << std::string(indent, ' ');
+            os << "<bin"
+               << " index=\"" << index << "\""
+               << " start=\"" << GetBinStart(index) << "\""
+               << " end=\"" << GetBinEnd(index) << "\""
+               << " count=\"" << m_bins[index] << "\""
+               << " />\n";
+        }
+    }
+    indent -= 2;
+    os << std::string(indent, ' ') << "</" << elementName << ">\n";
+}
+
+} // namespace ns3
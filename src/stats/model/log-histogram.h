@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LOG_HISTOGRAM_H
+#define NS3_LOG_HISTOGRAM_H
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup stats
+ *
+ * \brief A streaming histogram whose bins have a bounded relative width.
+ *
+ * Each power of two is split into 2^precisionBits bins of equal width, as
+ * in an HDR histogram, so that the value of a bin is known within a
+ * relative error of 2^-(precisionBits+1). The bins are only allocated
+ * between the smallest and the largest power of two of the values added,
+ * hence the size of the histogram depends on the ratio between the
+ * extreme values rather than on their range: for example, 4 precision
+ * bits and values from 1 microsecond to 10 seconds need 384 bins. The
+ * values less than or equal to zero are counted in a separate bin.
+ */
+class LogHistogram
+{
+  public:
+    /**
+     * Constructor.
+     * \param precisionBits The number of bits of precision of the bins.
+     */
+    LogHistogram(uint8_t precisionBits);
+    LogHistogram();
+
+    /**
+     * Add a value.
+     * \param value The value.
+     */
+    void AddValue(double value);
+
+    /** Remove all the values. */
+    void Clear();
+
+    /**
+     * \return The number of values added.
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * \return The smallest value added, or 0 if there is none.
+     */
+    double GetMin() const;
+
+    /**
+     * \return The largest value added, or 0 if there is none.
+     */
+    double GetMax() const;
+
+    /**
+     * Get an approximate quantile of the values.
+     *
+     * \param q The quantile, between 0 and 1.
+     * \return The middle of the bin holding the quantile, bounded by the
+     * smallest and largest values, or 0 if there is no value.
+     */
+    double GetQuantile(double q) const;
+
+    /**
+     * \return The number of bins of positive values.
+     */
+    uint32_t GetNBins() const;
+
+    /**
+     * \param index The index of a bin.
+     * \return The start of the bin.
+     */
+    double GetBinStart(uint32_t index) const;
+
+    /**
+     * \param index The index of a bin.
+     * \return The end of the bin.
+     */
+    double GetBinEnd(uint32_t index) const;
+
+    /**
+     * \param index The index of a bin.
+     * \return The number of values in the bin.
+     */
+    uint32_t GetBinCount(uint32_t index) const;
+
+    /**
+     * \return The number of values less than or equal to zero.
+     */
+    uint32_t GetZeroCount() const;
+
+    /**
+     * Serializes the results to an std::ostream in XML format.
+     * \param os the output stream
+     * \param indent number of spaces to use as base indentation level
+     * \param elementName name of the element to serialize.
+     */
+    void SerializeToXmlStream(std::ostream& os, uint16_t indent, std::string elementName) const;
+
+  private:
+    /**
+     * \param value A positive value.
+     * \param [out] exponent The exponent of the value.
+     * \return The bin of the value within the bins of its exponent.
+     */
+    uint32_t GetSubBin(double value, int& exponent) const;
+
+    uint8_t m_precisionBits;      //!< Number of bits of precision of the bins
+    int m_firstExponent;          //!< Exponent of the first bin
+    std::vector<uint32_t> m_bins; //!< Number of values of the bins of positive values
+    uint32_t m_zeroCount;         //!< Number of values less than or equal to zero
+    uint64_t m_count;             //!< Number of values
+    double m_min;                 //!< Smallest value
+    double m_max;                 //!< Largest value
+};
+
+} // namespace ns3
+
+#endif /* NS3_LOG_HISTOGRAM_H */
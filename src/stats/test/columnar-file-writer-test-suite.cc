@@ -0,0 +1,331 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/columnar-file-writer.h"
+#include "ns3/file-aggregator.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief A minimal reader of the files of ColumnarFileWriter, which checks
+ * their structure.
+ */
+class ColumnarFileReader
+{
+  public:
+    /// A table read from a file
+    struct Table
+    {
+        std::string name;                                 //!< Name
+        std::vector<std::pair<std::string, int>> columns; //!< Names and types of the columns
+        std::vector<std::vector<uint64_t>> numbers;       //!< Numeric values, by column
+        std::vector<std::vector<std::string>> strings;    //!< String values, by column
+        uint32_t batches{0};                              //!< Number of batches
+    };
+
+    /**
+     * Read a file.
+     * \param filename the name of the file
+     * \return true if the file is well-formed
+     */
+    bool Read(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_offset = 0;
+        const char magic[8] = {'N', 'S', '3', 'C', 'O', 'L', 'S', 1};
+        if (m_data.size() < 8 || std::memcmp(m_data.data(), magic, 8) != 0)
+        {
+            return false;
+        }
+        m_offset = 8;
+        std::map<uint32_t, std::size_t> ids;
+        while (m_offset < m_data.size())
+        {
+            uint8_t type = GetInteger(1);
+            uint64_t end = GetInteger(4);
+            end += m_offset;
+            if (end > m_data.size())
+            {
+                return false;
+            }
+            uint32_t id = GetInteger(4);
+            if (type == 1)
+            {
+                ids[id] = tables.size();
+                tables.emplace_back();
+                Table& table = tables.back();
+                table.name = GetString();
+                uint16_t columns = GetInteger(2);
+                for (uint16_t i = 0; i < columns; i++)
+                {
+                    int columnType = GetInteger(1);
+                    table.columns.emplace_back(GetString(), columnType);
+                }
+                table.numbers.resize(columns);
+                table.strings.resize(columns);
+            }
+            else if (type == 2 && ids.count(id))
+            {
+                Table& table = tables[ids[id]];
+                table.batches++;
+                uint32_t rows = GetInteger(4);
+                for (std::size_t i = 0; i < table.columns.size(); i++)
+                {
+                    uint64_t columnEnd = GetInteger(4);
+                    columnEnd += m_offset;
+                    if (table.columns[i].second == ColumnarFileWriter::STRING)
+                    {
+                        std::size_t chars = m_offset + 4 * (rows + 1);
+                        uint32_t start = GetInteger(4);
+                        for (uint32_t row = 0; row < rows; row++)
+                        {
+                            uint32_t stop = GetInteger(4);
+                            table.strings[i].push_back(m_data.substr(chars + start, stop - start));
+                            start = stop;
+                        }
+                    }
+                    else
+                    {
+                        for (uint32_t row = 0; row < rows; row++)
+                        {
+                            table.numbers[i].push_back(GetInteger(8));
+                        }
+                    }
+                    m_offset = columnEnd;
+                }
+            }
+            else
+            {
+                return false;
+            }
+            if (m_offset != end)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \param name the name of a table
+     * \return the last table of this name, or nullptr
+     */
+    const Table* Find(const std::string& name) const
+    {
+        for (auto table = tables.rbegin(); table != tables.rend(); table++)
+        {
+            if (table->name == name)
+            {
+                return &*table;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * \param bits the bit pattern of a DOUBLE value
+     * \return the value
+     */
+    static double ToDouble(uint64_t bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::vector<Table> tables; //!< The tables, in the order of the file
+
+  private:
+    /**
+     * \param size the number of bytes of the integer
+     * \return the little-endian integer read
+     */
+    uint64_t GetInteger(std::size_t size)
+    {
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < size && m_offset < m_data.size(); i++)
+        {
+            value |= uint64_t(uint8_t(m_data[m_offset++])) << (8 * i);
+        }
+        return value;
+    }
+
+    /// \return the string read
+    std::string GetString()
+    {
+        uint32_t length = GetInteger(4);
+        std::string value = m_data.substr(m_offset, length);
+        m_offset += length;
+        return value;
+    }
+
+    std::string m_data;      //!< The content of the file
+    std::size_t m_offset{0}; //!< The position of the next read
+};
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief ColumnarFileWriter Test
+ */
+class ColumnarFileWriterTestCase : public TestCase
+{
+  public:
+    ColumnarFileWriterTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ColumnarFileWriterTestCase::ColumnarFileWriterTestCase()
+    : TestCase("Write tables in batches, and append to a file")
+{
+}
+
+void
+ColumnarFileWriterTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("columnar-file-writer.col");
+    {
+        ColumnarFileWriter writer(filename, 4);
+        auto& values = writer.AddTable("values",
+                                       {{"u", ColumnarFileWriter::UINT64},
+                                        {"i", ColumnarFileWriter::INT64},
+                                        {"d", ColumnarFileWriter::DOUBLE},
+                                        {"s", ColumnarFileWriter::STRING}});
+        for (int row = 0; row < 10; row++)
+        {
+            values.AddUint(row).AddInt(-row).AddDouble(row / 4.0).AddString(std::string(row, 'x'));
+            values.EndRow();
+        }
+        NS_TEST_ASSERT_MSG_EQ(values.GetRows(), 10, "Wrong number of rows");
+        NS_TEST_ASSERT_MSG_EQ(writer.IsOk(), true, "The file should be writable");
+    }
+
+    ColumnarFileReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(filename), true, "Malformed file");
+    NS_TEST_ASSERT_MSG_EQ(reader.tables.size(), 1, "Wrong number of tables");
+    const auto& table = reader.tables[0];
+    NS_TEST_EXPECT_MSG_EQ(table.name, "values", "Wrong table name");
+    NS_TEST_EXPECT_MSG_EQ(table.columns[3].first, "s", "Wrong column name");
+    NS_TEST_EXPECT_MSG_EQ(table.batches, 3, "The rows should be written in batches of 4");
+    NS_TEST_ASSERT_MSG_EQ(table.numbers[0].size(), 10, "Wrong number of rows");
+    for (int row = 0; row < 10; row++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(table.numbers[0][row], uint64_t(row), "Wrong UINT64 value");
+        NS_TEST_EXPECT_MSG_EQ(int64_t(table.numbers[1][row]), -row, "Wrong INT64 value");
+        NS_TEST_EXPECT_MSG_EQ(ColumnarFileReader::ToDouble(table.numbers[2][row]),
+                              row / 4.0,
+                              "Wrong DOUBLE value");
+        NS_TEST_EXPECT_MSG_EQ(table.strings[3][row], std::string(row, 'x'), "Wrong STRING value");
+    }
+
+    // a second writer appends its own tables
+    {
+        ColumnarFileWriter writer(filename, 4, true);
+        writer.AddTable("more", {{"u", ColumnarFileWriter::UINT64}}).AddUint(42).EndRow();
+    }
+    ColumnarFileReader appended;
+    NS_TEST_ASSERT_MSG_EQ(appended.Read(filename), true, "Malformed appended file");
+    NS_TEST_ASSERT_MSG_EQ(appended.tables.size(), 2, "Wrong number of tables");
+    NS_TEST_EXPECT_MSG_EQ(appended.tables[0].numbers[0].size(), 10, "Lost rows");
+    NS_TEST_EXPECT_MSG_EQ(appended.tables[1].numbers[0].at(0), 42, "Wrong appended value");
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief FileAggregator COLUMNAR Test
+ */
+class ColumnarFileAggregatorTestCase : public TestCase
+{
+  public:
+    ColumnarFileAggregatorTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ColumnarFileAggregatorTestCase::ColumnarFileAggregatorTestCase()
+    : TestCase("Write the values of a FileAggregator to a columnar file")
+{
+}
+
+void
+ColumnarFileAggregatorTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("file-aggregator.col");
+    {
+        Ptr<FileAggregator> aggregator =
+            CreateObject<FileAggregator>(filename, FileAggregator::COLUMNAR);
+        aggregator->SetHeading("Time Value");
+        aggregator->Enable();
+        aggregator->Write2d("probe-a", 1, 10);
+        aggregator->Write2d("probe-b", 2, 20);
+        aggregator->Write2d("probe-a", 3, 30);
+        aggregator->Write3d("probe-b", 4, 40, 400);
+    }
+
+    ColumnarFileReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(filename), true, "Malformed file");
+    const auto* heading = reader.Find("heading");
+    NS_TEST_ASSERT_MSG_NE(heading, nullptr, "Missing heading");
+    NS_TEST_EXPECT_MSG_EQ(heading->strings[0].at(0), "Time Value", "Wrong heading");
+    const auto* contexts = reader.Find("contexts");
+    NS_TEST_ASSERT_MSG_NE(contexts, nullptr, "Missing contexts");
+    NS_TEST_ASSERT_MSG_EQ(contexts->strings[1].size(), 2, "Wrong number of contexts");
+    NS_TEST_EXPECT_MSG_EQ(contexts->strings[1][1], "probe-b", "Wrong context");
+    NS_TEST_EXPECT_MSG_EQ(contexts->numbers[0][1], 1, "Wrong context id");
+    const auto* values = reader.Find("values2d");
+    NS_TEST_ASSERT_MSG_NE(values, nullptr, "Missing 2D values");
+    NS_TEST_ASSERT_MSG_EQ(values->numbers[0].size(), 3, "Wrong number of 2D values");
+    NS_TEST_EXPECT_MSG_EQ(values->numbers[0][2], 0, "Wrong context of a value");
+    NS_TEST_EXPECT_MSG_EQ(ColumnarFileReader::ToDouble(values->numbers[2][2]), 30, "Wrong value");
+    values = reader.Find("values3d");
+    NS_TEST_ASSERT_MSG_NE(values, nullptr, "Missing 3D values");
+    NS_TEST_EXPECT_MSG_EQ(ColumnarFileReader::ToDouble(values->numbers[3].at(0)),
+                          400,
+                          "Wrong 3D value");
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief ColumnarFileWriter TestSuite
+ */
+class ColumnarFileWriterTestSuite : public TestSuite
+{
+  public:
+    ColumnarFileWriterTestSuite();
+};
+
+ColumnarFileWriterTestSuite::ColumnarFileWriterTestSuite()
+    : TestSuite("columnar-file-writer", UNIT)
+{
+    AddTestCase(new ColumnarFileWriterTestCase, TestCase::QUICK);
+    AddTestCase(new ColumnarFileAggregatorTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static ColumnarFileWriterTestSuite g_columnarFileWriterTestSuite;
@@ -18,6 +18,7 @@
 //
 
 #include "ns3/histogram.h"
+#include "ns3/log-histogram.h"
 #include "ns3/test.h"
 
 using namespace ns3;
@@ -71,6 +72,60 @@ HistogramTestCase::DoRun()
     }
 }
 
+/**
+ * \ingroup stats-tests
+ *
+ * \brief LogHistogram Test
+ */
+class LogHistogramTestCase : public ns3::TestCase
+{
+  public:
+    LogHistogramTestCase();
+    void DoRun() override;
+};
+
+LogHistogramTestCase::LogHistogramTestCase()
+    : ns3::TestCase("LogHistogram")
+{
+}
+
+void
+LogHistogramTestCase::DoRun()
+{
+    LogHistogram h(4);
+    NS_TEST_EXPECT_MSG_EQ(h.GetQuantile(0.5), 0, "An empty histogram has no quantile");
+
+    // 1 ms falls in the first bin of [2^-10, 2^-9)
+    h.AddValue(0.001);
+    NS_TEST_EXPECT_MSG_EQ(h.GetNBins(), 1, "");
+    NS_TEST_EXPECT_MSG_EQ_TOL(h.GetBinStart(0), 0.0009765625, 1e-12, "");
+    NS_TEST_EXPECT_MSG_EQ_TOL(h.GetBinEnd(0), 0.0009765625 * 17 / 16, 1e-12, "");
+
+    // the bins are added on both sides of the existing ones, from 2^-13 to 2^1
+    h.AddValue(0.0001220703125);
+    h.AddValue(1.5);
+    NS_TEST_EXPECT_MSG_EQ(h.GetNBins(), 14 * 16 - 7, "");
+    NS_TEST_EXPECT_MSG_EQ(h.GetBinCount(0), 1, "");
+    NS_TEST_EXPECT_MSG_EQ(h.GetBinCount(h.GetNBins() - 1), 1, "");
+    h.AddValue(0);
+    NS_TEST_EXPECT_MSG_EQ(h.GetZeroCount(), 1, "");
+    NS_TEST_EXPECT_MSG_EQ(h.GetCount(), 4, "");
+    NS_TEST_EXPECT_MSG_EQ(h.GetMin(), 0, "");
+    NS_TEST_EXPECT_MSG_EQ(h.GetMax(), 1.5, "");
+
+    // the quantiles are known within the relative width of the bins
+    h.Clear();
+    for (int i = 1; i <= 1000; i++)
+    {
+        h.AddValue(i * 1e-6);
+    }
+    NS_TEST_EXPECT_MSG_EQ_TOL(h.GetQuantile(0.5), 500e-6, 500e-6 / 16, "Wrong median");
+    NS_TEST_EXPECT_MSG_EQ_TOL(h.GetQuantile(0.99), 990e-6, 990e-6 / 16, "Wrong 99th percentile");
+    NS_TEST_EXPECT_MSG_EQ(h.GetQuantile(1), 1000e-6, "The maximum should be exact");
+    NS_TEST_EXPECT_MSG_EQ(h.GetQuantile(0), 1e-6, "The minimum should be exact");
+    NS_TEST_EXPECT_MSG_LT(h.GetNBins(), 11 * 16, "The bins should only span 11 octaves");
+}
+
 /**
  * \ingroup stats-tests
  *
@@ -86,6 +141,7 @@ HistogramTestSuite::HistogramTestSuite()
     : TestSuite("histogram", UNIT)
 {
     AddTestCase(new HistogramTestCase, TestCase::QUICK);
+    AddTestCase(new LogHistogramTestCase, TestCase::QUICK);
 }
 
 static HistogramTestSuite g_HistogramTestSuite; //!< Static variable for test initialization
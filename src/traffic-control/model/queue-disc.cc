@@ -384,6 +384,7 @@ QueueDisc::DoDispose()
     m_classes.clear();
     m_devQueueIface = nullptr;
     m_send = nullptr;
+    m_endBurst = nullptr;
     m_requeued = nullptr;
     m_internalQueueDbeFunctor = nullptr;
     m_internalQueueDadFunctor = nullptr;
@@ -559,6 +560,20 @@ QueueDisc::GetSendCallback() const
     return m_send;
 }
 
+void
+QueueDisc::SetEndBurstCallback(EndBurstCallback func)
+{
+    NS_LOG_FUNCTION(this);
+    m_endBurst = func;
+}
+
+QueueDisc::EndBurstCallback
+QueueDisc::GetEndBurstCallback() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_endBurst;
+}
+
 void
 QueueDisc::SetQuota(const uint32_t quota)
 {
@@ -988,6 +1003,10 @@ QueueDisc::RunEnd()
 {
     NS_LOG_FUNCTION(this);
     m_running = false;
+    if (m_endBurst)
+    {
+        m_endBurst();
+    }
 }
 
 bool
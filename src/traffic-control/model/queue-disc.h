@@ -378,6 +378,23 @@ class QueueDisc : public Object
      */
     SendCallback GetSendCallback() const;
 
+    /// Callback invoked when Run has finished sending packets to the receiving object
+    typedef std::function<void()> EndBurstCallback;
+
+    /**
+     * \param func the callback to notify the receiving object of the end of a burst.
+     *
+     * Set the callback called at the end of the Run method, after the last packet
+     * of the burst sent by Run, so that the receiving object can process the
+     * packets of the burst at once (see NetDevice::SendMore).
+     */
+    void SetEndBurstCallback(EndBurstCallback func);
+
+    /**
+     * \return the callback to notify the receiving object of the end of a burst.
+     */
+    EndBurstCallback GetEndBurstCallback() const;
+
     /**
      * \brief Set the maximum number of dequeue operations following a packet enqueue
      * \param quota the maximum number of dequeue operations following a packet enqueue.
@@ -637,7 +654,7 @@ class QueueDisc : public Object
 
     /**
      * Modelled after the Linux function qdisc_run_end (include/net/sch_generic.h).
-     * Set the qdisc as not running.
+     * Set the qdisc as not running, and notify the end of the burst.
      */
     void RunEnd();
 
@@ -700,6 +717,7 @@ class QueueDisc : public Object
     uint32_t m_quota; //!< Maximum number of packets dequeued in a qdisc run
     Ptr<NetDeviceQueueInterface> m_devQueueIface; //!< NetDevice queue interface
     SendCallback m_send;           //!< Callback used to send a packet to the receiving object
+    EndBurstCallback m_endBurst;   //!< Callback used to notify the end of a burst
     bool m_running;                //!< The queue disc is performing multiple dequeue operations
     Ptr<QueueDiscItem> m_requeued; //!< The last packet that failed to be transmitted
     bool m_peeked;                 //!< A packet was dequeued because Peek was called
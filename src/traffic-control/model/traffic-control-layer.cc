@@ -203,14 +203,15 @@ TrafficControlLayer::ScanDevices()
                 ndi->second.m_queueDiscsToWake.push_back(ndi->second.m_rootQueueDisc);
             }
 
-            // set the NetDeviceQueueInterface object and the SendCallback on the queue discs
-            // into which packets are enqueued and dequeued by calling Run
+            // set the NetDeviceQueueInterface object, the SendCallback and the EndBurstCallback
+            // on the queue discs into which packets are enqueued and dequeued by calling Run
             for (auto& q : ndi->second.m_queueDiscsToWake)
             {
                 q->SetNetDeviceQueueInterface(ndqi);
                 q->SetSendCallback([dev](Ptr<QueueDiscItem> item) {
-                    dev->Send(item->GetPacket(), item->GetAddress(), item->GetProtocol());
+                    dev->SendMore(item->GetPacket(), item->GetAddress(), item->GetProtocol());
                 });
+                q->SetEndBurstCallback([dev]() { dev->EndBurst(); });
             }
         }
     }
@@ -275,6 +276,7 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice(Ptr<NetDevice> device)
     {
         q->SetNetDeviceQueueInterface(nullptr);
         q->SetSendCallback(nullptr);
+        q->SetEndBurstCallback(nullptr);
     }
     ndi->second.m_queueDiscsToWake.clear();
 
@@ -155,11 +155,6 @@ InterferenceHelper::NiChange::NiChange(double power, Ptr<Event> event)
 {
 }
 
-InterferenceHelper::NiChange::~NiChange()
-{
-    m_event = nullptr;
-}
-
 double
 InterferenceHelper::NiChange::GetPower() const
 {
@@ -172,7 +167,7 @@ InterferenceHelper::NiChange::AddPower(double power)
     m_power += power;
 }
 
-Ptr<Event>
+const Ptr<Event>&
 InterferenceHelper::NiChange::GetEvent() const
 {
     return m_event;
@@ -182,6 +177,21 @@ InterferenceHelper::NiChange::GetEvent() const
  *       The actual InterferenceHelper
  ****************************************************************/
 
+/**
+ * \param begin the first NI changes of a vector sorted by band
+ * \param end the end of the vector
+ * \param band the band to search for
+ * \return the first NI changes whose band is not lower than the given band
+ */
+template <typename It>
+static It
+LowerBoundBand(It begin, It end, const WifiSpectrumBand& band)
+{
+    return std::lower_bound(begin, end, band, [](const auto& ni, const WifiSpectrumBand& b) {
+        return ni.band < b;
+    });
+}
+
 InterferenceHelper::InterferenceHelper()
     : m_errorRateModel(nullptr),
       m_numRxAntennas(1),
@@ -209,20 +219,7 @@ void
 InterferenceHelper::DoDispose()
 {
     NS_LOG_FUNCTION(this);
-    for (auto [range, niChangesPerBand] : m_niChanges)
-    {
-        for (auto it : niChangesPerBand)
-        {
-            it.second.clear();
-        }
-        niChangesPerBand.clear();
-    }
     m_niChanges.clear();
-    for (auto it : m_firstPowers)
-    {
-        it.second.clear();
-    }
-    m_firstPowers.clear();
     m_errorRateModel = nullptr;
 }
 
@@ -259,40 +256,42 @@ void
 InterferenceHelper::RemoveBands(FrequencyRange range)
 {
     NS_LOG_FUNCTION(this << range);
-    if ((m_niChanges.count(range) == 0) && (m_firstPowers.count(range) == 0))
-    {
-        return;
-    }
-    auto niChangesPerBand = m_niChanges.at(range);
-    for (auto it : niChangesPerBand)
-    {
-        it.second.clear();
-    }
-    niChangesPerBand.clear();
     m_niChanges.erase(range);
-    m_firstPowers.at(range).clear();
-    m_firstPowers.erase(range);
 }
 
 bool
 InterferenceHelper::HasBand(WifiSpectrumBand band, const FrequencyRange& range) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
-    return (m_niChanges.count(range) > 0 && m_niChanges.at(range).count(band) > 0);
+    auto rangeIt = m_niChanges.find(range);
+    if (rangeIt == m_niChanges.end())
+    {
+        return false;
+    }
+    auto it = LowerBoundBand(rangeIt->second.cbegin(), rangeIt->second.cend(), band);
+    return it != rangeIt->second.cend() && it->band == band;
 }
 
 void
 InterferenceHelper::AddBand(WifiSpectrumBand band, const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
-    NS_ASSERT(m_niChanges.count(range) == 0 || m_niChanges.at(range).count(band) == 0);
-    NS_ASSERT(m_firstPowers.count(range) == 0 || m_firstPowers.at(range).count(band) == 0);
-    NiChanges niChanges;
-    auto result = m_niChanges[range].insert({band, niChanges});
-    NS_ASSERT(result.second);
+    NS_ASSERT(!HasBand(band, range));
+    auto& bands = m_niChanges[range];
+    auto it = LowerBoundBand(bands.begin(), bands.end(), band);
+    it = bands.insert(it, {band, {}, 0.0});
     // Always have a zero power noise event in the list
-    AddNiChangeEvent(Time(0), NiChange(0.0, nullptr), result.first);
-    m_firstPowers[range].insert({band, 0.0});
+    AddNiChangeEvent(Time(0), NiChange(0.0, nullptr), it->niChanges);
+}
+
+const InterferenceHelper::BandNiChanges&
+InterferenceHelper::GetBandNiChanges(WifiSpectrumBand band, const FrequencyRange& range) const
+{
+    auto rangeIt = m_niChanges.find(range);
+    NS_ABORT_IF(rangeIt == m_niChanges.end());
+    auto it = LowerBoundBand(rangeIt->second.cbegin(), rangeIt->second.cend(), band);
+    NS_ABORT_IF(it == rangeIt->second.cend() || it->band != band);
+    return *it;
 }
 
 void
@@ -326,15 +325,13 @@ InterferenceHelper::GetEnergyDuration(double energyW,
 {
     NS_LOG_FUNCTION(this << energyW << band.first << band.second << range);
     Time now = Simulator::Now();
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
-    auto niIt = m_niChanges.at(range).find(band);
-    NS_ABORT_IF(niIt == m_niChanges.at(range).end());
-    auto i = GetPreviousPosition(now, niIt);
-    Time end = i->first;
-    for (; i != niIt->second.end(); ++i)
+    const auto& niChanges = GetBandNiChanges(band, range).niChanges;
+    auto i = GetPreviousPosition(now, niChanges);
+    Time end = niChanges[i].first;
+    for (; i < niChanges.size(); ++i)
     {
-        double noiseInterferenceW = i->second.GetPower();
-        end = i->first;
+        double noiseInterferenceW = niChanges[i].second.GetPower();
+        end = niChanges[i].first;
         if (noiseInterferenceW < energyW)
         {
             break;
@@ -349,37 +346,41 @@ InterferenceHelper::AppendEvent(Ptr<Event> event,
                                 bool isStartOfdmaRxing)
 {
     NS_LOG_FUNCTION(this << event << range << isStartOfdmaRxing);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
-    NS_ABORT_IF(m_firstPowers.count(range) == 0);
-    for (const auto& it : event->GetRxPowerWPerBand())
+    auto rangeIt = m_niChanges.find(range);
+    NS_ABORT_IF(rangeIt == m_niChanges.end());
+    // The bands of the event and of the range are both sorted, hence each band
+    // of the event is searched for after the previous one.
+    auto niIt = rangeIt->second.begin();
+    for (const auto& [band, powerW] : event->GetRxPowerWPerBand())
     {
-        WifiSpectrumBand band = it.first;
-        auto niIt = m_niChanges.at(range).find(band);
-        NS_ABORT_IF(niIt == m_niChanges.at(range).end());
-        double previousPowerStart = 0;
-        double previousPowerEnd = 0;
-        auto previousPowerPosition = GetPreviousPosition(event->GetStartTime(), niIt);
-        previousPowerStart = previousPowerPosition->second.GetPower();
-        previousPowerEnd = GetPreviousPosition(event->GetEndTime(), niIt)->second.GetPower();
+        niIt = LowerBoundBand(niIt, rangeIt->second.end(), band);
+        NS_ABORT_IF(niIt == rangeIt->second.end() || niIt->band != band);
+        auto& niChanges = niIt->niChanges;
+        auto previousPowerPosition = GetPreviousPosition(event->GetStartTime(), niChanges);
+        double previousPowerStart = niChanges[previousPowerPosition].second.GetPower();
+        double previousPowerEnd =
+            niChanges[GetPreviousPosition(event->GetEndTime(), niChanges)].second.GetPower();
         if (!m_rxing)
         {
-            m_firstPowers.at(range).find(band)->second = previousPowerStart;
-            // Always leave the first zero power noise event in the list
-            niIt->second.erase(++(niIt->second.begin()), ++previousPowerPosition);
+            niIt->firstPower = previousPowerStart;
+            // Always leave the first zero power noise event in the list; the
+            // capacity of the vector is kept for the next NI changes
+            niChanges.erase(niChanges.begin() + 1, niChanges.begin() + previousPowerPosition + 1);
         }
         else if (isStartOfdmaRxing)
         {
-            // When the first UL-OFDMA payload is received, we need to set m_firstPowers
+            // When the first UL-OFDMA payload is received, we need to set the first power
             // so that it takes into account interferences that arrived between the start of the
             // UL MU transmission and the start of UL-OFDMA payload.
-            m_firstPowers.at(range).find(band)->second = previousPowerStart;
+            niIt->firstPower = previousPowerStart;
         }
         auto first =
-            AddNiChangeEvent(event->GetStartTime(), NiChange(previousPowerStart, event), niIt);
-        auto last = AddNiChangeEvent(event->GetEndTime(), NiChange(previousPowerEnd, event), niIt);
+            AddNiChangeEvent(event->GetStartTime(), NiChange(previousPowerStart, event), niChanges);
+        auto last =
+            AddNiChangeEvent(event->GetEndTime(), NiChange(previousPowerEnd, event), niChanges);
         for (auto i = first; i != last; ++i)
         {
-            i->second.AddPower(it.second);
+            niChanges[i].second.AddPower(powerW);
         }
     }
 }
@@ -390,18 +391,20 @@ InterferenceHelper::UpdateEvent(Ptr<Event> event,
                                 const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << event << range);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
+    auto rangeIt = m_niChanges.find(range);
+    NS_ABORT_IF(rangeIt == m_niChanges.end());
     // This is called for UL MU events, in order to scale power as long as UL MU PPDUs arrive
-    for (const auto& it : rxPower)
+    auto niIt = rangeIt->second.begin();
+    for (const auto& [band, powerW] : rxPower)
     {
-        WifiSpectrumBand band = it.first;
-        auto niIt = m_niChanges.at(range).find(band);
-        NS_ABORT_IF(niIt == m_niChanges.at(range).end());
-        auto first = GetPreviousPosition(event->GetStartTime(), niIt);
-        auto last = GetPreviousPosition(event->GetEndTime(), niIt);
+        niIt = LowerBoundBand(niIt, rangeIt->second.end(), band);
+        NS_ABORT_IF(niIt == rangeIt->second.end() || niIt->band != band);
+        auto& niChanges = niIt->niChanges;
+        auto first = GetPreviousPosition(event->GetStartTime(), niChanges);
+        auto last = GetPreviousPosition(event->GetEndTime(), niChanges);
         for (auto i = first; i != last; ++i)
         {
-            i->second.AddPower(it.second);
+            niChanges[i].second.AddPower(powerW);
         }
     }
     event->UpdateRxPowerW(rxPower);
@@ -441,37 +444,37 @@ InterferenceHelper::CalculateSnr(double signal,
 
 double
 InterferenceHelper::CalculateNoiseInterferenceW(Ptr<Event> event,
-                                                NiChangesPerBand* nis,
+                                                NiChanges* nis,
                                                 WifiSpectrumBand band,
                                                 const FrequencyRange& range) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
-    NS_ABORT_IF(m_firstPowers.count(range) == 0);
-    auto firstPower_it = m_firstPowers.at(range).find(band);
-    NS_ABORT_IF(firstPower_it == m_firstPowers.at(range).end());
-    double noiseInterferenceW = firstPower_it->second;
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
-    auto niIt = m_niChanges.at(range).find(band);
-    NS_ABORT_IF(niIt == m_niChanges.at(range).end());
-    auto it = niIt->second.find(event->GetStartTime());
-    for (; it != niIt->second.end() && it->first < Simulator::Now(); ++it)
+    const auto& bandNiChanges = GetBandNiChanges(band, range);
+    const auto& niChanges = bandNiChanges.niChanges;
+    double noiseInterferenceW = bandNiChanges.firstPower;
+    auto start = std::lower_bound(niChanges.cbegin(),
+                                  niChanges.cend(),
+                                  event->GetStartTime(),
+                                  [](const NiChanges::value_type& ni, Time t) {
+                                      return ni.first < t;
+                                  });
+    NS_ABORT_IF(start == niChanges.cend() || start->first != event->GetStartTime());
+    auto it = start;
+    for (; it != niChanges.cend() && it->first < Simulator::Now(); ++it)
     {
         noiseInterferenceW = it->second.GetPower() - event->GetRxPowerW(band);
     }
-    it = niIt->second.find(event->GetStartTime());
-    NS_ABORT_IF(it == niIt->second.end());
-    for (; it != niIt->second.end() && it->second.GetEvent() != event; ++it)
+    for (it = start; it != niChanges.cend() && it->second.GetEvent() != event; ++it)
     {
         ;
     }
-    NiChanges ni;
-    ni.emplace(event->GetStartTime(), NiChange(0, event));
-    while (++it != niIt->second.end() && it->second.GetEvent() != event)
+    nis->clear();
+    nis->emplace_back(event->GetStartTime(), NiChange(0, event));
+    while (++it != niChanges.cend() && it->second.GetEvent() != event)
     {
-        ni.insert(*it);
+        nis->push_back(*it);
     }
-    ni.emplace(event->GetEndTime(), NiChange(0, event));
-    nis->insert({band, ni});
+    nis->emplace_back(event->GetEndTime(), NiChange(0, event));
     NS_ASSERT_MSG(noiseInterferenceW >= 0,
                   "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
     return noiseInterferenceW;
@@ -523,7 +526,7 @@ InterferenceHelper::CalculatePayloadChunkSuccessRate(double snir,
 double
 InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
                                         uint16_t channelWidth,
-                                        NiChangesPerBand* nis,
+                                        const NiChanges& nis,
                                         WifiSpectrumBand band,
                                         const FrequencyRange& range,
                                         uint16_t staId,
@@ -532,8 +535,7 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
     NS_LOG_FUNCTION(this << channelWidth << band.first << band.second << staId << window.first
                          << window.second);
     double psr = 1.0; /* Packet Success Rate */
-    const auto& niIt = nis->find(band)->second;
-    auto j = niIt.cbegin();
+    auto j = nis.cbegin();
     Time previous = j->first;
     WifiMode payloadMode = event->GetTxVector().GetMode(staId);
     Time phyPayloadStart = j->first;
@@ -546,11 +548,9 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
     }
     Time windowStart = phyPayloadStart + window.first;
     Time windowEnd = phyPayloadStart + window.second;
-    NS_ABORT_IF(m_firstPowers.count(range) == 0);
-    NS_ABORT_IF(m_firstPowers.at(range).count(band) == 0);
-    double noiseInterferenceW = m_firstPowers.at(range).at(band);
+    double noiseInterferenceW = GetBandNiChanges(band, range).firstPower;
     double powerW = event->GetRxPowerW(band);
-    while (++j != niIt.cend())
+    while (++j != nis.cend())
     {
         Time current = j->first;
         NS_LOG_DEBUG("previous= " << previous << ", current=" << current);
@@ -596,7 +596,7 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
 double
 InterferenceHelper::CalculatePhyHeaderSectionPsr(
     Ptr<const Event> event,
-    NiChangesPerBand* nis,
+    const NiChanges& nis,
     uint16_t channelWidth,
     WifiSpectrumBand band,
     const FrequencyRange& range,
@@ -604,8 +604,7 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range);
     double psr = 1.0; /* Packet Success Rate */
-    auto niIt = nis->find(band)->second;
-    auto j = niIt.begin();
+    auto j = nis.cbegin();
 
     NS_ASSERT(!phyHeaderSections.empty());
     Time stopLastSection = Seconds(0);
@@ -615,11 +614,9 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
     }
 
     Time previous = j->first;
-    NS_ABORT_IF(m_firstPowers.count(range) == 0);
-    NS_ABORT_IF(m_firstPowers.at(range).count(band) == 0);
-    double noiseInterferenceW = m_firstPowers.at(range).at(band);
+    double noiseInterferenceW = GetBandNiChanges(band, range).firstPower;
     double powerW = event->GetRxPowerW(band);
-    while (++j != niIt.end())
+    while (++j != nis.cend())
     {
         Time current = j->first;
         NS_LOG_DEBUG("previous= " << previous << ", current=" << current);
@@ -661,19 +658,18 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
 
 double
 InterferenceHelper::CalculatePhyHeaderPer(Ptr<const Event> event,
-                                          NiChangesPerBand* nis,
+                                          const NiChanges& nis,
                                           uint16_t channelWidth,
                                           WifiSpectrumBand band,
                                           const FrequencyRange& range,
                                           WifiPpduField header) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << range << header);
-    auto niIt = nis->find(band)->second;
     auto phyEntity = WifiPhy::GetStaticPhyEntity(event->GetTxVector().GetModulationClass());
 
     PhyEntity::PhyHeaderSections sections;
     for (const auto& section :
-         phyEntity->GetPhyHeaderSections(event->GetTxVector(), niIt.begin()->first))
+         phyEntity->GetPhyHeaderSections(event->GetTxVector(), nis.front().first))
     {
         if (section.first == header)
         {
@@ -699,7 +695,7 @@ InterferenceHelper::CalculatePayloadSnrPer(Ptr<Event> event,
 {
     NS_LOG_FUNCTION(this << channelWidth << band.first << band.second << range << staId
                          << relativeMpduStartStop.first << relativeMpduStartStop.second);
-    NiChangesPerBand ni;
+    NiChanges ni;
     double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band, range);
     double snr = CalculateSnr(event->GetRxPowerW(band),
                               noiseInterferenceW,
@@ -710,7 +706,7 @@ InterferenceHelper::CalculatePayloadSnrPer(Ptr<Event> event,
      * all SNIR changes in the SNIR vector.
      */
     double per =
-        CalculatePayloadPer(event, channelWidth, &ni, band, range, staId, relativeMpduStartStop);
+        CalculatePayloadPer(event, channelWidth, ni, band, range, staId, relativeMpduStartStop);
 
     return PhyEntity::SnrPer(snr, per);
 }
@@ -722,7 +718,7 @@ InterferenceHelper::CalculateSnr(Ptr<Event> event,
                                  WifiSpectrumBand band,
                                  const FrequencyRange& range) const
 {
-    NiChangesPerBand ni;
+    NiChanges ni;
     double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band, range);
     double snr = CalculateSnr(event->GetRxPowerW(band), noiseInterferenceW, channelWidth, nss);
     return snr;
@@ -736,14 +732,14 @@ InterferenceHelper::CalculatePhyHeaderSnrPer(Ptr<Event> event,
                                              WifiPpduField header) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << header);
-    NiChangesPerBand ni;
+    NiChanges ni;
     double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band, range);
     double snr = CalculateSnr(event->GetRxPowerW(band), noiseInterferenceW, channelWidth, 1);
 
     /* calculate the SNIR at the start of the PHY header and accumulate
      * all SNIR changes in the SNIR vector.
      */
-    double per = CalculatePhyHeaderPer(event, &ni, channelWidth, band, range, header);
+    double per = CalculatePhyHeaderPer(event, ni, channelWidth, band, range, header);
 
     return PhyEntity::SnrPer(snr, per);
 }
@@ -752,38 +748,45 @@ void
 InterferenceHelper::EraseEvents(const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << range);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
-    NS_ABORT_IF(m_firstPowers.count(range) == 0);
-    for (auto niIt = m_niChanges.at(range).begin(); niIt != m_niChanges.at(range).end(); ++niIt)
+    auto rangeIt = m_niChanges.find(range);
+    NS_ABORT_IF(rangeIt == m_niChanges.end());
+    for (auto& bandNiChanges : rangeIt->second)
     {
-        niIt->second.clear();
+        bandNiChanges.niChanges.clear();
         // Always have a zero power noise event in the list
-        AddNiChangeEvent(Time(0), NiChange(0.0, nullptr), niIt);
-        m_firstPowers.at(range).at(niIt->first) = 0.0;
+        AddNiChangeEvent(Time(0), NiChange(0.0, nullptr), bandNiChanges.niChanges);
+        bandNiChanges.firstPower = 0.0;
     }
     m_rxing = false;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetNextPosition(Time moment, NiChangesPerBand::iterator niIt)
+std::size_t
+InterferenceHelper::GetNextPosition(Time moment, const NiChanges& niChanges)
 {
-    return niIt->second.upper_bound(moment);
+    return std::upper_bound(niChanges.cbegin(),
+                            niChanges.cend(),
+                            moment,
+                            [](Time t, const NiChanges::value_type& ni) { return t < ni.first; }) -
+           niChanges.cbegin();
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPreviousPosition(Time moment, NiChangesPerBand::iterator niIt)
+std::size_t
+InterferenceHelper::GetPreviousPosition(Time moment, const NiChanges& niChanges)
 {
-    auto it = GetNextPosition(moment, niIt);
+    auto it = GetNextPosition(moment, niChanges);
     // This is safe since there is always an NiChange at time 0,
     // before moment.
     --it;
     return it;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::AddNiChangeEvent(Time moment, NiChange change, NiChangesPerBand::iterator niIt)
+std::size_t
+InterferenceHelper::AddNiChangeEvent(Time moment, NiChange change, NiChanges& niChanges)
 {
-    return niIt->second.insert(GetNextPosition(moment, niIt), std::make_pair(moment, change));
+    auto it = niChanges.emplace(niChanges.begin() + GetNextPosition(moment, niChanges),
+                                moment,
+                                std::move(change));
+    return it - niChanges.begin();
 }
 
 void
@@ -797,16 +800,17 @@ void
 InterferenceHelper::NotifyRxEnd(Time endTime, const FrequencyRange& range)
 {
     NS_LOG_FUNCTION(this << endTime << range);
-    NS_ABORT_IF(m_niChanges.count(range) == 0);
-    NS_ABORT_IF(m_firstPowers.count(range) == 0);
+    auto rangeIt = m_niChanges.find(range);
+    NS_ABORT_IF(rangeIt == m_niChanges.end());
     m_rxing = false;
-    // Update m_firstPowers for frame capture
-    for (auto niIt = m_niChanges.at(range).begin(); niIt != m_niChanges.at(range).end(); ++niIt)
+    // Update the first powers for frame capture
+    for (auto& bandNiChanges : rangeIt->second)
     {
-        NS_ASSERT(niIt->second.size() > 1);
-        auto it = GetPreviousPosition(endTime, niIt);
+        const auto& niChanges = bandNiChanges.niChanges;
+        NS_ASSERT(niChanges.size() > 1);
+        auto it = GetPreviousPosition(endTime, niChanges);
         it--;
-        m_firstPowers.at(range).find(niIt->first)->second = it->second.GetPower();
+        bandNiChanges.firstPower = niChanges[it].second.GetPower();
     }
 }
 
@@ -386,7 +386,6 @@ class InterferenceHelper : public Object
          * \param event causes this NI change
          */
         NiChange(double power, Ptr<Event> event);
-        ~NiChange();
         /**
          * Return the power
          *
@@ -404,7 +403,7 @@ class InterferenceHelper : public Object
          *
          * \return the event
          */
-        Ptr<Event> GetEvent() const;
+        const Ptr<Event>& GetEvent() const;
 
       private:
         double m_power;     ///< power in watts
@@ -412,29 +411,40 @@ class InterferenceHelper : public Object
     };
 
     /**
-     * typedef for a multimap of NiChange
+     * Vector of NiChange, sorted by time. The NI changes occurring at the
+     * same time are kept in insertion order.
      */
-    using NiChanges = std::multimap<Time, NiChange>;
+    using NiChanges = std::vector<std::pair<Time, NiChange>>;
 
     /**
-     * Map of NiChanges per band
+     * The NI changes and the first power of a band
      */
-    using NiChangesPerBand = std::map<WifiSpectrumBand, NiChanges>;
+    struct BandNiChanges
+    {
+        WifiSpectrumBand band; ///< the band
+        NiChanges niChanges;   ///< the NI changes of the band
+        double firstPower;     ///< the first power of the band in watts
+    };
 
     /**
-     * Map of NiChanges per band and per range
+     * Vector of the NI changes of the bands of a frequency range, sorted by band
      */
-    using NiChangesPerBandPerRange = std::map<FrequencyRange, NiChangesPerBand>;
+    using NiChangesPerBand = std::vector<BandNiChanges>;
 
     /**
-     * Map of first power per band
+     * Map of NiChanges per band and per range
      */
-    using FirstPowerPerBand = std::map<WifiSpectrumBand, double>;
+    using NiChangesPerBandPerRange = std::map<FrequencyRange, NiChangesPerBand>;
 
     /**
-     * Map of first power per band and per range
+     * Find the NI changes of a band, aborting if the band or its range have not been added.
+     *
+     * \param band the band
+     * \param range the frequency range the band belongs to
+     * \return the NI changes of the band
      */
-    using FirstPowerPerBandPerRange = std::map<FrequencyRange, FirstPowerPerBand>;
+    const BandNiChanges& GetBandNiChanges(WifiSpectrumBand band,
+                                          const FrequencyRange& range) const;
 
     /**
      * Append the given Event.
@@ -450,14 +460,14 @@ class InterferenceHelper : public Object
      * Calculate noise and interference power in W.
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event, filled by this method
      * \param band the band
      * \param range the frequency range
      *
      * \return noise and interference power
      */
     double CalculateNoiseInterferenceW(Ptr<Event> event,
-                                       NiChangesPerBand* nis,
+                                       NiChanges* nis,
                                        WifiSpectrumBand band,
                                        const FrequencyRange& range) const;
     /**
@@ -467,7 +477,7 @@ class InterferenceHelper : public Object
      *
      * \param event the event
      * \param channelWidth the channel width used to transmit the PSDU (in MHz)
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event
      * \param band identify the band used by the PSDU
      * \param range the frequency range the band belongs to
      * \param staId the station ID of the PSDU (only used for MU)
@@ -477,7 +487,7 @@ class InterferenceHelper : public Object
      */
     double CalculatePayloadPer(Ptr<const Event> event,
                                uint16_t channelWidth,
-                               NiChangesPerBand* nis,
+                               const NiChanges& nis,
                                WifiSpectrumBand band,
                                const FrequencyRange& range,
                                uint16_t staId,
@@ -487,7 +497,7 @@ class InterferenceHelper : public Object
      * can be divided into multiple chunks (e.g. due to interference from other transmissions).
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event
      * \param channelWidth the channel width (in MHz) for header measurement
      * \param band the band
      * \param range the frequency range
@@ -496,7 +506,7 @@ class InterferenceHelper : public Object
      * \return the error rate of the HT PHY header
      */
     double CalculatePhyHeaderPer(Ptr<const Event> event,
-                                 NiChangesPerBand* nis,
+                                 const NiChanges& nis,
                                  uint16_t channelWidth,
                                  WifiSpectrumBand band,
                                  const FrequencyRange& range,
@@ -505,7 +515,7 @@ class InterferenceHelper : public Object
      * Calculate the success rate of the PHY header sections for the provided event.
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event
      * \param channelWidth the channel width (in MHz) for header measurement
      * \param band the band
      * \param range the frequency range
@@ -514,7 +524,7 @@ class InterferenceHelper : public Object
      * \return the success rate of the PHY header sections
      */
     double CalculatePhyHeaderSectionPsr(Ptr<const Event> event,
-                                        NiChangesPerBand* nis,
+                                        const NiChanges& nis,
                                         uint16_t channelWidth,
                                         WifiSpectrumBand band,
                                         const FrequencyRange& range,
@@ -523,39 +533,36 @@ class InterferenceHelper : public Object
     double m_noiseFigure;                 //!< noise figure (linear)
     Ptr<ErrorRateModel> m_errorRateModel; //!< error rate model
     uint8_t m_numRxAntennas; //!< the number of RX antennas in the corresponding receiver
-    NiChangesPerBandPerRange m_niChanges;    //!< NI Changes for each band in each range
-    FirstPowerPerBandPerRange m_firstPowers; //!< first power of each band in watts
-    bool m_rxing;                            //!< flag whether it is in receiving state
+    NiChangesPerBandPerRange m_niChanges; //!< NI Changes and first power of each band
+    bool m_rxing;                         //!< flag whether it is in receiving state
 
     /**
-     * Returns an iterator to the first NiChange that is later than moment
+     * Returns the index of the first NiChange that is later than moment
      *
      * \param moment time to check from
-     * \param niIt iterator of the band to check
-     * \returns an iterator to the list of NiChanges
+     * \param niChanges the NI changes of the band to check
+     * \returns the index of the NiChange, or the number of NI changes
      */
-    NiChanges::iterator GetNextPosition(Time moment, NiChangesPerBand::iterator niIt);
+    static std::size_t GetNextPosition(Time moment, const NiChanges& niChanges);
     /**
-     * Returns an iterator to the last NiChange that is before than moment
+     * Returns the index of the last NiChange that is before than moment
      *
      * \param moment time to check from
-     * \param niIt iterator of the band to check
-     * \returns an iterator to the list of NiChanges
+     * \param niChanges the NI changes of the band to check
+     * \returns the index of the NiChange
      */
-    NiChanges::iterator GetPreviousPosition(Time moment, NiChangesPerBand::iterator niIt);
+    static std::size_t GetPreviousPosition(Time moment, const NiChanges& niChanges);
 
     /**
      * Add NiChange to the list at the appropriate position and
-     * return the iterator of the new event.
+     * return the index of the new event.
      *
      * \param moment time to check from
      * \param change the NiChange to add
-     * \param niIt iterator of the band to check
-     * \returns the iterator of the new event
+     * \param niChanges the NI changes of the band
+     * \returns the index of the new event
      */
-    NiChanges::iterator AddNiChangeEvent(Time moment,
-                                         NiChange change,
-                                         NiChangesPerBand::iterator niIt);
+    static std::size_t AddNiChangeEvent(Time moment, NiChange change, NiChanges& niChanges);
 };
 
 } // namespace ns3
@@ -193,6 +193,8 @@ SpectrumWifiPhy::UpdateInterferenceHelperBands()
             bands.push_back(bandRuPair.first);
         }
     }
+    // the interference helper keeps the bands sorted: add them in order
+    std::sort(bands.begin(), bands.end());
     const auto bandsChanged = std::any_of(bands.cbegin(), bands.cend(), [&](const auto& band) {
         return !m_interference->HasBand(band, GetCurrentFrequencyRange());
     });
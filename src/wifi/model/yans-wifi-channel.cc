@@ -24,6 +24,7 @@
 #include "wifi-utils.h"
 #include "yans-wifi-phy.h"
 
+#include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
@@ -31,8 +32,11 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
+#include "ns3/spatial-index.h"
 #include "ns3/wifi-net-device.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -57,7 +61,23 @@ YansWifiChannel::GetTypeId()
                           "A pointer to the propagation delay model attached to this channel.",
                           PointerValue(),
                           MakePointerAccessor(&YansWifiChannel::m_delay),
-                          MakePointerChecker<PropagationDelayModel>());
+                          MakePointerChecker<PropagationDelayModel>())
+            .AddAttribute("MaxRange",
+                          "If strictly positive, PPDUs are not delivered to the receivers located "
+                          "further than this distance (m) from the sender, and neither the "
+                          "propagation loss nor the propagation delay is computed for them. "
+                          "Note that stochastic propagation loss models then draw fewer "
+                          "random variates.",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&YansWifiChannel::m_maxRange),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SpatialIndex",
+                          "If set and MaxRange is strictly positive, the spatial index used to "
+                          "find the receivers located within MaxRange of the sender, instead of "
+                          "visiting every receiver. It must not be shared with other channels.",
+                          PointerValue(),
+                          MakePointerAccessor(&YansWifiChannel::m_spatialIndex),
+                          MakePointerChecker<SpatialIndex>());
     return tid;
 }
 
@@ -92,53 +112,112 @@ YansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
     NS_LOG_FUNCTION(this << sender << ppdu << txPowerDbm);
     Ptr<MobilityModel> senderMobility = sender->GetMobility();
     NS_ASSERT(senderMobility);
-    for (PhyList::const_iterator i = m_phyList.begin(); i != m_phyList.end(); i++)
+
+    if (m_maxRange > 0 && m_spatialIndex)
     {
-        if (sender != (*i))
+        UpdateSpatialIndex();
+        std::vector<uint32_t> candidates;
+        m_spatialIndex->GetCandidates(senderMobility->GetPosition(), m_maxRange, candidates);
+        // visit the candidates in the same order as the PHY list, so that the receptions
+        // are scheduled in the same order as without spatial index
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto id : candidates)
         {
-            // For now don't account for inter channel interference nor channel bonding
-            if ((*i)->GetChannelNumber() != sender->GetChannelNumber())
-            {
-                continue;
-            }
-
-            Ptr<MobilityModel> receiverMobility = (*i)->GetMobility()->GetObject<MobilityModel>();
-            Time delay = m_delay->GetDelay(senderMobility, receiverMobility);
-            double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm, senderMobility, receiverMobility);
-            NS_LOG_DEBUG("propagation: txPower="
-                         << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, "
-                         << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
-                         << "m, delay=" << delay);
-            Ptr<NetDevice> dstNetDevice = (*i)->GetDevice();
-            uint32_t dstNode;
-            if (!dstNetDevice)
-            {
-                dstNode = 0xffffffff;
-            }
-            else
-            {
-                dstNode = dstNetDevice->GetNode()->GetId();
-            }
-
-            Simulator::ScheduleWithContext(dstNode,
-                                           delay,
-                                           &YansWifiChannel::Receive,
-                                           (*i),
-                                           ppdu,
-                                           rxPowerDbm);
+            SendTo(sender, senderMobility, m_phyList[id], ppdu, txPowerDbm);
         }
+        return;
+    }
+
+    for (PhyList::const_iterator i = m_phyList.begin(); i != m_phyList.end(); i++)
+    {
+        SendTo(sender, senderMobility, *i, ppdu, txPowerDbm);
     }
 }
 
 void
-YansWifiChannel::Receive(Ptr<YansWifiPhy> phy, Ptr<const WifiPpdu> ppdu, double rxPowerDbm)
+YansWifiChannel::SendTo(Ptr<YansWifiPhy> sender,
+                        Ptr<MobilityModel> senderMobility,
+                        Ptr<YansWifiPhy> receiver,
+                        Ptr<const WifiPpdu> ppdu,
+                        double txPowerDbm) const
+{
+    if (sender == receiver)
+    {
+        return;
+    }
+    // For now don't account for inter channel interference nor channel bonding
+    if (receiver->GetChannelNumber() != sender->GetChannelNumber())
+    {
+        return;
+    }
+
+    Ptr<MobilityModel> receiverMobility = receiver->GetMobility()->GetObject<MobilityModel>();
+    if (m_maxRange > 0 && senderMobility->GetDistanceFrom(receiverMobility) > m_maxRange)
+    {
+        NS_LOG_DEBUG("receiver " << receiver << " out of range: distance="
+                                 << senderMobility->GetDistanceFrom(receiverMobility) << "m");
+        return;
+    }
+    Time delay = m_delay->GetDelay(senderMobility, receiverMobility);
+    double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm, senderMobility, receiverMobility);
+    NS_LOG_DEBUG("propagation: txPower="
+                 << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, "
+                 << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
+                 << "m, delay=" << delay);
+    // Do not schedule the reception of a signal that will be discarded upon arrival
+    if (IsBelowRxSensitivity(receiver, ppdu, rxPowerDbm))
+    {
+        NS_LOG_INFO("Received signal too weak to process: " << rxPowerDbm << " dBm");
+        return;
+    }
+    Ptr<NetDevice> dstNetDevice = receiver->GetDevice();
+    uint32_t dstNode;
+    if (!dstNetDevice)
+    {
+        dstNode = 0xffffffff;
+    }
+    else
+    {
+        dstNode = dstNetDevice->GetNode()->GetId();
+    }
+
+    Simulator::ScheduleWithContext(dstNode,
+                                   delay,
+                                   &YansWifiChannel::Receive,
+                                   receiver,
+                                   ppdu,
+                                   rxPowerDbm);
+}
+
+void
+YansWifiChannel::UpdateSpatialIndex() const
+{
+    // PHYs are never removed from the channel, hence their position in the PHY list
+    // is used as identifier and the PHYs not indexed yet are at the end of the list
+    for (auto id = m_spatialIndex->GetN(); id < m_phyList.size(); ++id)
+    {
+        m_spatialIndex->Add(m_phyList[id]->GetMobility(), id);
+    }
+}
+
+bool
+YansWifiChannel::IsBelowRxSensitivity(Ptr<YansWifiPhy> receiver,
+                                      Ptr<const WifiPpdu> ppdu,
+                                      double rxPowerDbm)
 {
-    NS_LOG_FUNCTION(phy << ppdu << rxPowerDbm);
-    // Do no further processing if signal is too weak
     // Current implementation assumes constant RX power over the PPDU duration
     // Compare received TX power per MHz to normalized RX sensitivity
     uint16_t txWidth = ppdu->GetTransmissionChannelWidth();
-    if ((rxPowerDbm + phy->GetRxGain()) < phy->GetRxSensitivity() + RatioToDb(txWidth / 20.0))
+    return (rxPowerDbm + receiver->GetRxGain()) <
+           receiver->GetRxSensitivity() + RatioToDb(txWidth / 20.0);
+}
+
+void
+YansWifiChannel::Receive(Ptr<YansWifiPhy> phy, Ptr<const WifiPpdu> ppdu, double rxPowerDbm)
+{
+    NS_LOG_FUNCTION(phy << ppdu << rxPowerDbm);
+    // Do no further processing if signal is too weak
+    if (IsBelowRxSensitivity(phy, ppdu, rxPowerDbm))
     {
         NS_LOG_INFO("Received signal too weak to process: " << rxPowerDbm << " dBm");
         return;
@@ -28,6 +28,8 @@ namespace ns3
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class MobilityModel;
+class SpatialIndex;
 class YansWifiPhy;
 class Packet;
 class Time;
@@ -81,7 +83,9 @@ class YansWifiChannel : public Channel
      * This method should not be invoked by normal users. It is
      * currently invoked only from YansWifiPhy::StartTx.  The channel
      * attempts to deliver the PPDU to all other YansWifiPhy objects
-     * on the channel (except for the sender).
+     * on the channel (except for the sender) that are located within
+     * MaxRange of the sender, if set. The PPDU is not delivered to the
+     * receivers at which it is received below the RX sensitivity.
      */
     void Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
 
@@ -113,9 +117,43 @@ class YansWifiChannel : public Channel
      */
     static void Receive(Ptr<YansWifiPhy> receiver, Ptr<const WifiPpdu> ppdu, double txPowerDbm);
 
+    /**
+     * \param receiver the device to which the packet is destined
+     * \param ppdu the PPDU being sent
+     * \param rxPowerDbm the power at which the PPDU is received (dBm)
+     * \return true if the PPDU is received below the RX sensitivity of the receiver
+     */
+    static bool IsBelowRxSensitivity(Ptr<YansWifiPhy> receiver,
+                                     Ptr<const WifiPpdu> ppdu,
+                                     double rxPowerDbm);
+
+    /**
+     * Attempt to deliver a PPDU to a given YansWifiPhy. This is called by
+     * Send for each candidate receiver.
+     *
+     * \param sender the PHY object from which the packet is originating
+     * \param senderMobility the mobility model of the sender
+     * \param receiver the device to which the packet is destined
+     * \param ppdu the PPDU to send
+     * \param txPowerDbm the TX power associated to the packet, in dBm
+     */
+    void SendTo(Ptr<YansWifiPhy> sender,
+                Ptr<MobilityModel> senderMobility,
+                Ptr<YansWifiPhy> receiver,
+                Ptr<const WifiPpdu> ppdu,
+                double txPowerDbm) const;
+
+    /**
+     * Add to the spatial index the PHYs that have been added to this channel
+     * since the last transmission.
+     */
+    void UpdateSpatialIndex() const;
+
     PhyList m_phyList;                  //!< List of YansWifiPhys connected to this YansWifiChannel
     Ptr<PropagationLossModel> m_loss;   //!< Propagation loss model
     Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+    double m_maxRange;                  //!< Maximum distance to a receiver (m), 0 if unlimited
+    Ptr<SpatialIndex> m_spatialIndex;   //!< Spatial index of the PHYs, used if m_maxRange > 0
 };
 
 } // namespace ns3
@@ -24,6 +24,7 @@
 #include "ns3/ap-wifi-mac.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
 #include "ns3/error-model.h"
 #include "ns3/fcfs-wifi-queue-scheduler.h"
 #include "ns3/frame-exchange-manager.h"
@@ -37,9 +38,11 @@
 #include "ns3/packet-socket-helper.h"
 #include "ns3/packet-socket-server.h"
 #include "ns3/pointer.h"
+#include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/socket.h"
+#include "ns3/spatial-index.h"
 #include "ns3/spectrum-wifi-helper.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
@@ -3779,6 +3782,118 @@ WifiMgtHeaderTest::DoRun()
     TestHeaderSerialization(frame);
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the YansWifiChannel does not deliver PPDUs to the receivers
+ * located further than MaxRange from the sender, with and without spatial index.
+ *
+ * The scenario considers three ad hoc stations on a line, at 0, 10 and 100 meters.
+ * A fixed RSS propagation loss model is used, so that every station would receive
+ * the PPDUs sent by the others. The channel MaxRange is set to 50 meters, hence
+ * the broadcast frame sent by the first station must only reach the second one.
+ */
+class YansWifiChannelMaxRangeTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param useSpatialIndex whether a spatial index is set on the channel
+     */
+    YansWifiChannelMaxRangeTest(bool useSpatialIndex);
+
+    void DoRun() override;
+
+  private:
+    /**
+     * Callback invoked when a PHY starts receiving a PPDU
+     * \param index the index of the receiving station
+     * \param p the packet
+     * \param rxPowersW the received power per channel band in watts
+     */
+    void RxBegin(std::size_t index, Ptr<const Packet> p, RxPowerWattPerChannelBand rxPowersW);
+
+    bool m_useSpatialIndex;            ///< whether a spatial index is set on the channel
+    std::vector<std::size_t> m_counts; ///< number of receptions started by each station
+};
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest(bool useSpatialIndex)
+    : TestCase(std::string("Check YansWifiChannel MaxRange ") +
+               (useSpatialIndex ? "with" : "without") + " spatial index"),
+      m_useSpatialIndex(useSpatialIndex)
+{
+}
+
+void
+YansWifiChannelMaxRangeTest::RxBegin(std::size_t index,
+                                     Ptr<const Packet> p,
+                                     RxPowerWattPerChannelBand rxPowersW)
+{
+    m_counts.at(index)++;
+}
+
+void
+YansWifiChannelMaxRangeTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+
+    auto channel = CreateObject<YansWifiChannel>();
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+    channel->SetPropagationLossModel(
+        CreateObjectWithAttributes<FixedRssLossModel>("Rss", DoubleValue(-50)));
+    channel->SetAttribute("MaxRange", DoubleValue(50));
+    if (m_useSpatialIndex)
+    {
+        channel->SetAttribute(
+            "SpatialIndex",
+            PointerValue(
+                CreateObjectWithAttributes<GridSpatialIndex>("CellSize", DoubleValue(20))));
+    }
+
+    YansWifiPhyHelper phy;
+    phy.SetChannel(channel);
+
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager");
+
+    WifiMacHelper mac;
+    mac.SetType("ns3::AdhocWifiMac");
+    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0.0, 0.0, 0.0));
+    positionAlloc->Add(Vector(10.0, 0.0, 0.0));
+    positionAlloc->Add(Vector(100.0, 0.0, 0.0));
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(nodes);
+
+    m_counts.assign(devices.GetN(), 0);
+    for (std::size_t i = 0; i < devices.GetN(); i++)
+    {
+        DynamicCast<WifiNetDevice>(devices.Get(i))
+            ->GetPhy()
+            ->TraceConnectWithoutContext(
+                "PhyRxBegin",
+                MakeCallback(&YansWifiChannelMaxRangeTest::RxBegin, this, i));
+    }
+
+    Simulator::Schedule(Seconds(1.0), [&]() {
+        devices.Get(0)->Send(Create<Packet>(1000), devices.Get(0)->GetBroadcast(), 1);
+    });
+
+    Simulator::Stop(Seconds(2.0));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_counts[0], 0, "The sender must not receive its own PPDU");
+    NS_TEST_EXPECT_MSG_EQ(m_counts[1], 1, "The station within range must receive the PPDU");
+    NS_TEST_EXPECT_MSG_EQ(m_counts[2], 0, "The station out of range must not receive the PPDU");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -3812,6 +3927,8 @@ WifiTestSuite::WifiTestSuite()
     AddTestCase(new IdealRateManagerMimoTest, TestCase::QUICK);
     AddTestCase(new HeRuMcsDataRateTestCase, TestCase::QUICK);
     AddTestCase(new WifiMgtHeaderTest, TestCase::QUICK);
+    AddTestCase(new YansWifiChannelMaxRangeTest(false), TestCase::QUICK);
+    AddTestCase(new YansWifiChannelMaxRangeTest(true), TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
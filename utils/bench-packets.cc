@@ -22,6 +22,7 @@
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
 #include "ns3/command-line.h"
+#include "ns3/packet-data-allocator.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
 #include "ns3/system-wall-clock-ms.h"
@@ -32,6 +33,7 @@
 #include <sstream>
 #include <stdlib.h> // for exit ()
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -350,6 +352,35 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchAllocation(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    BenchTag<16> tag;
+    const uint32_t sizes[] = {40, 576, 1500, 9000};
+
+    // keep the packets in a window, as in a device queue, so that the
+    // storage of a packet is not simply released to the next one
+    std::vector<Ptr<Packet>> window(64);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(sizes[i % 4]);
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        p->AddByteTag(tag);
+        window[i % window.size()] = p;
+    }
+}
+
+static void
+printAllocationStats()
+{
+    PacketDataAllocator::Stats stats = PacketDataAllocator::GetStats();
+    std::cout << "  allocations: " << stats.allocations << ", reused: " << stats.reuses
+              << ", cached: " << stats.cachedBytes << " bytes" << std::endl;
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -407,6 +438,14 @@ main(int argc, char* argv[])
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchAllocation, n, minIterations, "Allocate packets of mixed sizes");
+    printAllocationStats();
+    PacketDataAllocator::EnableFreeLists(false);
+    runBench(&benchAllocation,
+             n,
+             minIterations,
+             "Allocate packets of mixed sizes, without free lists");
+    PacketDataAllocator::EnableFreeLists(true);
 
     return 0;
 }
@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the SpectrumValue operations used
+// by the interference models on each chunk, for the spectrum models of a
+// 100-RB LTE carrier and of 1 MHz and 160 MHz Wi-Fi channels.
+// Sample usage:  ./ns3 run 'bench-spectrum-value --n=100000'
+
+#include "ns3/command-line.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create a spectrum model made of contiguous bands.
+ *
+ * \param centerFrequency The center frequency of the model, in Hz.
+ * \param bandWidth The width of each band, in Hz.
+ * \param nBands The number of bands.
+ * \return The spectrum model.
+ */
+static Ptr<const SpectrumModel>
+CreateModel(double centerFrequency, double bandWidth, uint32_t nBands)
+{
+    Bands bands;
+    double fl = centerFrequency - nBands * bandWidth / 2;
+    for (uint32_t i = 0; i < nBands; i++)
+    {
+        BandInfo band;
+        band.fl = fl + i * bandWidth;
+        band.fc = band.fl + bandWidth / 2;
+        band.fh = band.fl + bandWidth;
+        bands.push_back(band);
+    }
+    return Create<SpectrumModel>(bands);
+}
+
+/**
+ * Run an operation and print its throughput.
+ *
+ * \param op The operation, called with the iteration index.
+ * \param n The number of iterations.
+ * \param minIterations The number of runs to take the minimum duration over.
+ * \param name The name of the operation.
+ */
+static void
+RunBench(const std::function<void(uint32_t)>& op,
+         uint32_t n,
+         uint32_t minIterations,
+         const std::string& name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t j = 0; j < minIterations; j++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        for (uint32_t i = 0; i < n; i++)
+        {
+            op(i);
+        }
+        minDelay = std::min(minDelay, static_cast<uint64_t>(time.End()));
+    }
+    double ops = n;
+    ops *= 1000;
+    ops /= std::max<uint64_t>(minDelay, 1);
+    std::cout << ops << " ops/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+/**
+ * Benchmark the operations of the interference models on a spectrum model.
+ *
+ * \param model The spectrum model.
+ * \param n The number of iterations.
+ * \param minIterations The number of runs to take the minimum duration over.
+ * \param name The name of the spectrum model.
+ */
+static void
+BenchModel(Ptr<const SpectrumModel> model,
+           uint32_t n,
+           uint32_t minIterations,
+           const std::string& name)
+{
+    std::cout << name << " (" << model->GetNumBands() << " bands)" << std::endl;
+
+    SpectrumValue rx(model);
+    SpectrumValue all(model);
+    SpectrumValue noise(model);
+    SpectrumValue sum(model);
+    for (uint32_t i = 0; i < model->GetNumBands(); i++)
+    {
+        rx[i] = 1e-12 * (1 + i % 7);
+        all[i] = rx[i] + 1e-13 * (1 + i % 5);
+        noise[i] = 4e-21;
+    }
+    double result = 0;
+
+    RunBench([&](uint32_t) { all += rx; }, n, minIterations, "signals += psd");
+    RunBench([&](uint32_t) { all -= rx; }, n, minIterations, "signals -= psd");
+    RunBench(
+        [&](uint32_t) {
+            SpectrumValue sinr = rx / (all - rx + noise);
+            result += sinr[0];
+        },
+        n,
+        minIterations,
+        "sinr = rx / (signals - rx + noise)");
+    RunBench(
+        [&](uint32_t i) { sum.AddScaled(rx, 1e-6 * (i % 3)); },
+        n,
+        minIterations,
+        "sum.AddScaled (sinr, duration)");
+    RunBench(
+        [&](uint32_t) { result += Integral(rx); },
+        n,
+        minIterations,
+        "Integral (psd)");
+    RunBench(
+        [&](uint32_t) { result += Sum(Log10(rx / noise)); },
+        n,
+        minIterations,
+        "Sum (Log10 (rx / noise))");
+
+    // print the result, so that the computations are not optimized out
+    std::cout << "(result: " << result + sum[0] << ")" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark SpectrumValue operations");
+    cmd.AddValue("n", "number of iterations", n);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-spectrum-value with n=" << n << std::endl;
+
+    BenchModel(CreateModel(2.12e9, 180e3, 100), n, minIterations, "LTE, 100 RBs");
+    BenchModel(CreateModel(920e6, 31.25e3, 32), n, minIterations, "Wi-Fi, 1 MHz channel");
+    BenchModel(CreateModel(5.25e9, 78.125e3, 2048), n, minIterations, "Wi-Fi, 160 MHz channel");
+
+    return 0;
+}